@@ -29,6 +29,12 @@
 #define CONFIG_ENABLE_USBH_DRIVER_FS    1
 #define CONFIG_ENABLE_USBH_DEBUG        0
 
+// MIDI buffer sizes (power of two)
+#define CONFIG_MIDI_RX_BUFFER_SIZE      64      // bytes
+#define CONFIG_MIDI_TX_BUFFER_SIZE      64      // bytes
+#define CONFIG_USB_MIDI_RX_QUEUE_SIZE   16      // messages
+#define CONFIG_USB_MIDI_TX_QUEUE_SIZE   128     // messages
+
 // LCD
 #define CONFIG_LCD_WIDTH                256
 #define CONFIG_LCD_HEIGHT               64
@@ -58,6 +58,10 @@
 #define CONFIG_USER_SCALE_COUNT         4
 #define CONFIG_USER_SCALE_SIZE          32
 
+// Storage
+// Write project files block compressed (both compressed and uncompressed files can be read)
+#define CONFIG_ENABLE_PROJECT_COMPRESSION 1
+
 
 #define CONFIG_ENABLE_ASTEROIDS
 // #define CONFIG_ENABLE_INTRO
@@ -74,7 +74,8 @@ static SdCard sdCard;
 
 static fs::Volume volume(sdCard);
 
-static CCMRAM_BSS uint8_t midiMessagePayloadPool[32];
+// 4 payload slots of 64 bytes (batched launchpad led updates are sent as system exclusive messages)
+static CCMRAM_BSS uint8_t midiMessagePayloadPool[4 * 64];
 
 static CCMRAM_BSS Profiler profiler;
 
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "Config.h"
 
 #include "drivers/Adc.h"
@@ -42,7 +44,8 @@ struct SequencerApp {
     // filesystem
     fs::Volume volume;
 
-    uint8_t midiMessagePayloadPool[32];
+    // 4 payload slots of 64 bytes (batched launchpad led updates are sent as system exclusive messages)
+    uint8_t midiMessagePayloadPool[4 * 64];
 
     // application
     Model model;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "SequencerApp.h"
+
+#include "model/ProjectVersion.h"
+
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+
+#include "sim/Target.h"
+
+#include <memory>
+#include <vector>
+
+// Saves and restores the state of a simulated SequencerApp for replay checkpoints.
+// The checkpoint holds the project followed by the engine state (see Engine::writeState), so a replay
+// continues a running session exactly. Checkpoints are only valid for the build that wrote them.
+class SequencerCheckpoint : public sim::TargetCheckpointHandler {
+public:
+    SequencerCheckpoint(std::unique_ptr<SequencerApp> &app) :
+        _app(app)
+    {}
+
+    bool saveCheckpoint(std::vector<uint8_t> &data) override {
+        if (!_app) {
+            return false;
+        }
+
+        VersionedSerializedWriter writer(
+            [&data] (const void *buf, size_t len) {
+                auto bytes = static_cast<const uint8_t *>(buf);
+                data.insert(data.end(), bytes, bytes + len);
+            },
+            ProjectVersion::Latest, true
+        );
+        _app->model.project().write(writer);
+        _app->engine.writeState(writer);
+
+        return true;
+    }
+
+    bool restoreCheckpoint(const std::vector<uint8_t> &data) override {
+        if (!_app) {
+            return false;
+        }
+
+        VersionedSerializedReader reader(data.data(), data.size(), ProjectVersion::Latest);
+        return _app->model.project().read(reader) && _app->engine.readState(reader) && !reader.overrun();
+    }
+
+private:
+    std::unique_ptr<SequencerApp> &_app;
+};
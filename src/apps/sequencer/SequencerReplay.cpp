@@ -0,0 +1,156 @@
+#include "SequencerApp.h"
+#include "SequencerCheckpoint.h"
+
+#include "sim/Simulator.h"
+#include "sim/TargetTraceRecorder.h"
+#include "sim/TraceFile.h"
+#include "sim/TraceReplay.h"
+
+#include "args.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace sim;
+
+// Replays the inputs of a recorded session (see the simulator --record option) through a headless
+// sequencer as fast as possible. The outputs of the replay can be recorded and compared to the session
+// with tracediff. Checkpoints written during a replay allow to start later replays close to the point of
+// interest instead of from boot.
+int main(int argc, char *argv[]) {
+    args::ArgumentParser parser("PER|FORMER Replay", "Replays a recorded session at maximum speed.");
+    args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
+    args::ValueFlag<std::string> outputFilename(parser, "file", "Record the outputs of the replay to a trace file", { 'o', "output" });
+    args::ValueFlag<std::string> checkpointFilename(parser, "file", "Start the replay from a checkpoint", { 'c', "checkpoint" });
+    args::ValueFlag<int> checkpointInterval(parser, "ticks", "Write a checkpoint every n ticks", { 'i', "checkpoint-interval" }, 0);
+    args::ValueFlag<std::string> checkpointPrefix(parser, "prefix", "Filename prefix of written checkpoints", { 'p', "checkpoint-prefix" }, "replay");
+    args::ValueFlag<int> endTick(parser, "tick", "Stop the replay at the given tick", { 'e', "end" }, 0);
+    args::ValueFlag<int> slowestCount(parser, "count", "Number of slowest ticks to report", { 's', "slowest" }, 10);
+    args::Positional<std::string> traceFilename(parser, "trace", "Recorded session trace file");
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (const args::Help &) {
+        std::cout << parser;
+        return 0;
+    } catch (const args::ParseError &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    if (!traceFilename) {
+        std::cerr << parser;
+        return 1;
+    }
+
+    TraceFile traceFile;
+    if (!traceFile.open(args::get(traceFilename))) {
+        std::cerr << "cannot read trace file " << args::get(traceFilename) << std::endl;
+        return 1;
+    }
+
+    TraceCheckpoint startCheckpoint;
+    if (checkpointFilename && !startCheckpoint.load(args::get(checkpointFilename))) {
+        std::cerr << "cannot read checkpoint " << args::get(checkpointFilename) << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<SequencerApp> app;
+
+    Simulator simulator({
+        .create = [&] () {
+            app.reset(new SequencerApp());
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+
+    SequencerCheckpoint checkpointHandler(app);
+    TraceReplay replay(simulator, traceFile, &checkpointHandler);
+
+    std::unique_ptr<TraceFileWriter> outputWriter;
+    std::unique_ptr<TargetTraceRecorder> outputRecorder;
+    if (outputFilename) {
+        outputWriter.reset(new TraceFileWriter(args::get(outputFilename)));
+        if (!outputWriter->isOpen()) {
+            std::cerr << "cannot write " << args::get(outputFilename) << std::endl;
+            return 1;
+        }
+        outputRecorder.reset(new TargetTraceRecorder(*outputWriter));
+        simulator.registerTargetOutputObserver(outputRecorder.get());
+        replay.registerTickObserver(outputRecorder.get());
+    }
+
+    if (checkpointFilename) {
+        if (!replay.start(startCheckpoint)) {
+            std::cerr << "cannot restore checkpoint " << args::get(checkpointFilename) << std::endl;
+            return 1;
+        }
+    } else {
+        replay.start();
+    }
+
+    uint32_t startTick = replay.tick();
+    uint32_t lastTick = args::get(endTick) > 0 ? uint32_t(args::get(endTick)) : replay.endTick() + 1;
+    uint32_t interval = std::max(0, args::get(checkpointInterval));
+    size_t slowest = std::max(0, args::get(slowestCount));
+
+    // (duration in us, tick) of the slowest ticks, sorted by descending duration
+    std::vector<std::pair<double, uint32_t>> slowestTicks;
+
+    auto start = std::chrono::steady_clock::now();
+
+    while (replay.tick() < lastTick) {
+        if (interval > 0 && replay.tick() > startTick && replay.tick() % interval == 0) {
+            TraceCheckpoint checkpoint;
+            std::string filename = args::get(checkpointPrefix) + "-" + std::to_string(replay.tick()) + ".checkpoint";
+            if (!replay.saveCheckpoint(checkpoint) || !checkpoint.save(filename)) {
+                std::cerr << "cannot write checkpoint " << filename << std::endl;
+                return 1;
+            }
+        }
+
+        uint32_t tick = replay.tick();
+        auto tickStart = std::chrono::steady_clock::now();
+        replay.step();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tickStart).count();
+
+        if (slowest > 0 && (slowestTicks.size() < slowest || us > slowestTicks.back().first)) {
+            auto it = std::upper_bound(slowestTicks.begin(), slowestTicks.end(), std::make_pair(us, tick), [] (const std::pair<double, uint32_t> &a, const std::pair<double, uint32_t> &b) {
+                return a.first > b.first;
+            });
+            slowestTicks.insert(it, std::make_pair(us, tick));
+            if (slowestTicks.size() > slowest) {
+                slowestTicks.pop_back();
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint32_t ticks = replay.tick() - startTick;
+
+    if (outputWriter) {
+        outputWriter->close();
+    }
+
+    std::cout << "replayed ticks " << startTick << " to " << replay.tick() << " in " << seconds << " s"
+              << " (" << (seconds > 0 ? ticks * 0.001 / seconds : 0.0) << "x realtime)" << std::endl;
+    if (!slowestTicks.empty()) {
+        std::cout << "slowest ticks:" << std::endl;
+        for (const auto &slowTick : slowestTicks) {
+            std::cout << "  tick " << slowTick.second << ": " << slowTick.first << " us" << std::endl;
+        }
+    }
+
+    return 0;
+}
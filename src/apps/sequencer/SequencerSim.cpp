@@ -19,6 +19,7 @@ int main(int argc, char *argv[]) {
             app->update();
         }
     });
+    sim.setSdCardImage("sdcard.iso");
 
     sim::Frontend frontend(sim);
 
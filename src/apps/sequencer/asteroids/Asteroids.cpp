@@ -21,7 +21,7 @@ static Vec2 directionFromAngle(float angle) {
     return Vec2(std::sin(angle), -std::cos(angle));
 }
 
-static Random rng;
+static INSTANCE_LOCAL Random rng;
 
 static float randomFloat() {
     union {
@@ -49,7 +49,7 @@ static const std::array<Vec2, 4> playerShape = {{
 }};
 
 using AsteroidShape = std::array<Vec2, 16>;
-static std::array<AsteroidShape, 4> asteroidShapes;
+static INSTANCE_LOCAL std::array<AsteroidShape, 4> asteroidShapes;
 
 static void drawShape(Canvas &canvas, Mat3 &transform, const Vec2 *vertices, size_t count) {
     Vec2 a, b;
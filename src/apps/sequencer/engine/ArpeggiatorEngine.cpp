@@ -10,7 +10,7 @@
 
 #include <cinttypes>
 
-static Random rng;
+static INSTANCE_LOCAL Random rng;
 
 ArpeggiatorEngine::ArpeggiatorEngine(const Arpeggiator &arpeggiator) :
     _arpeggiator(arpeggiator)
@@ -79,6 +79,38 @@ bool ArpeggiatorEngine::getEvent(uint32_t tick, Event &event) {
     return false;
 }
 
+void ArpeggiatorEngine::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_stepIndex);
+    writer.write(_noteIndex);
+    writer.write(_noteOrder);
+    writer.write(_octave);
+    writer.write(_octaveDirection);
+    writer.write(_notes);
+    writer.write(_noteCount);
+    writer.write(_noteHoldCount);
+    writer.write(_eventQueue);
+}
+
+void ArpeggiatorEngine::readState(VersionedSerializedReader &reader) {
+    reader.read(_stepIndex);
+    reader.read(_noteIndex);
+    reader.read(_noteOrder);
+    reader.read(_octave);
+    reader.read(_octaveDirection);
+    reader.read(_notes);
+    reader.read(_noteCount);
+    reader.read(_noteHoldCount);
+    reader.read(_eventQueue);
+}
+
+void ArpeggiatorEngine::writeSharedState(VersionedSerializedWriter &writer) {
+    writer.write(rng);
+}
+
+void ArpeggiatorEngine::readSharedState(VersionedSerializedReader &reader) {
+    reader.read(rng);
+}
+
 void ArpeggiatorEngine::addNote(int note) {
     // exit if note set is full
     if (_noteCount >= MaxNotes) {
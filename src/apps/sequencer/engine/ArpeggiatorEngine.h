@@ -4,6 +4,9 @@
 
 #include "model/Arpeggiator.h"
 
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+
 #include <array>
 
 #include <cstdint>
@@ -31,6 +34,14 @@ public:
 
     bool getEvent(uint32_t tick, Event &event);
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
+    // state shared by all arpeggiator engines
+    static void writeSharedState(VersionedSerializedWriter &writer);
+    static void readSharedState(VersionedSerializedReader &reader);
+
 private:
     void addNote(int note);
     void removeNote(int note);
@@ -309,6 +309,90 @@ bool Clock::checkTick(uint32_t *tick) {
     return false;
 }
 
+void Clock::seek(uint32_t tick) {
+    os::InterruptLock lock;
+
+    _tick = tick;
+    _tickProcessed = tick;
+    _slaveSubTicksPending = 0;
+
+    // next output clock on the output divisor grid
+    uint32_t divisor = _output.divisor;
+    _output.nextTick = divisor > 0 ? ((tick + divisor - 1) / divisor) * divisor : tick;
+}
+
+void Clock::writeState(VersionedSerializedWriter &writer) const {
+    os::InterruptLock lock;
+
+    writer.write(_ppqn);
+    writer.write(_mode);
+    writer.write(_masterBpm);
+    writer.write(_slaves);
+    writer.write(_output);
+    writer.write(_outputState);
+    writer.write(_requestedEvents);
+    writer.write(_state);
+    writer.write(uint32_t(_tick));
+    writer.write(uint32_t(_tickProcessed));
+    writer.write(int32_t(_activeSlave));
+    writer.write(_elapsedUs);
+    writer.write(_lastSlaveTickUs);
+    writer.write(_slaveTickPeriodUs);
+    writer.write(_slaveSubTicksPending);
+    writer.write(_slaveSubTickPeriodUs);
+    writer.write(_nextSlaveSubTickUs);
+    writer.write(_slaveBpmFiltered);
+    writer.write(_slaveBpmAvg);
+    writer.write(_slaveBpm);
+    writer.write(_timer.period());
+#ifdef PLATFORM_SIM
+    writer.write(_timer.phase());
+#endif
+}
+
+void Clock::readState(VersionedSerializedReader &reader) {
+    os::InterruptLock lock;
+
+    reader.read(_ppqn);
+    reader.read(_mode);
+    reader.read(_masterBpm);
+    reader.read(_slaves);
+    reader.read(_output);
+    reader.read(_outputState);
+    reader.read(_requestedEvents);
+    reader.read(_state);
+    reader.readAs<uint32_t>(_tick);
+    reader.readAs<uint32_t>(_tickProcessed);
+    reader.readAs<int32_t>(_activeSlave);
+    reader.read(_elapsedUs);
+    reader.read(_lastSlaveTickUs);
+    reader.read(_slaveTickPeriodUs);
+    reader.read(_slaveSubTicksPending);
+    reader.read(_slaveSubTickPeriodUs);
+    reader.read(_nextSlaveSubTickUs);
+    reader.read(_slaveBpmFiltered);
+    reader.read(_slaveBpmAvg);
+    reader.read(_slaveBpm);
+
+    // the timer runs whenever the clock is not idle
+    uint32_t period;
+    reader.read(period);
+    _timer.disable();
+    _timer.setPeriod(period);
+    if (_state != State::Idle) {
+        _timer.enable();
+    }
+#ifdef PLATFORM_SIM
+    double phase;
+    reader.read(phase);
+    _timer.setPhase(phase);
+#endif
+
+    if (_listener) {
+        _listener->onClockOutput(_outputState);
+    }
+}
+
 void Clock::onClockTimerTick() {
     os::InterruptLock lock;
 
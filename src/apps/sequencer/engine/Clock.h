@@ -4,6 +4,9 @@
 
 #include "core/utils/MovingAverage.h"
 
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+
 #include "drivers/ClockTimer.h"
 
 #include <array>
@@ -82,6 +85,12 @@ public:
     // Sequencer interface
     Event checkEvent();
     bool checkTick(uint32_t *tick);
+    // continue counting from the given tick (used when seeking)
+    void seek(uint32_t tick);
+
+    // State snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
 
 private:
     enum class State {
@@ -15,7 +15,7 @@
 #include "model/Curve.h"
 #include "model/Types.h"
 
-static Random rng;
+static INSTANCE_LOCAL Random rng;
 
 static float applyDjFilter(float input, float &lpfState, float control, float resonance) {
     // 1. Dead zone
@@ -259,6 +259,71 @@ void CurveTrackEngine::changePattern() {
     _fillSequence = &_curveTrack.sequence(std::min(pattern() + 1, CONFIG_PATTERN_COUNT - 1));
 }
 
+void CurveTrackEngine::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_linkData.divisor);
+    writer.write(_linkData.relativeTick);
+    writer.write(_recordValue);
+    writer.write(_recorder);
+    writer.write(_monitorStepIndex);
+    writer.write(_monitorStepLevel);
+    writer.write(_sequenceState);
+    writer.write(_currentStep);
+    writer.write(_currentStepFraction);
+    writer.write(_shapeVariation);
+    writer.write(_fillMode);
+    writer.write(_phasedStep);
+    writer.write(_phasedStepFraction);
+    writer.write(_latoocarfian);
+    writer.write(_lorenz);
+    writer.write(_chaosValue);
+    writer.write(_chaosPhase);
+    writer.write(_activity);
+    writer.write(_gateOutput);
+    writer.write(_cvOutput);
+    writer.write(_cvOutputTarget);
+    writer.write(_lpfState);
+    writer.write(_feedbackState);
+    writer.write(_gateQueue);
+}
+
+void CurveTrackEngine::readState(VersionedSerializedReader &reader) {
+    changePattern();
+
+    reader.read(_linkData.divisor);
+    reader.read(_linkData.relativeTick);
+    _linkData.sequenceState = &_sequenceState;
+    reader.read(_recordValue);
+    reader.read(_recorder);
+    reader.read(_monitorStepIndex);
+    reader.read(_monitorStepLevel);
+    reader.read(_sequenceState);
+    reader.read(_currentStep);
+    reader.read(_currentStepFraction);
+    reader.read(_shapeVariation);
+    reader.read(_fillMode);
+    reader.read(_phasedStep);
+    reader.read(_phasedStepFraction);
+    reader.read(_latoocarfian);
+    reader.read(_lorenz);
+    reader.read(_chaosValue);
+    reader.read(_chaosPhase);
+    reader.read(_activity);
+    reader.read(_gateOutput);
+    reader.read(_cvOutput);
+    reader.read(_cvOutputTarget);
+    reader.read(_lpfState);
+    reader.read(_feedbackState);
+    reader.read(_gateQueue);
+}
+
+void CurveTrackEngine::writeSharedState(VersionedSerializedWriter &writer) {
+    writer.write(rng);
+}
+
+void CurveTrackEngine::readSharedState(VersionedSerializedReader &reader) {
+    reader.read(rng);
+}
+
 void CurveTrackEngine::triggerStep(uint32_t tick, uint32_t divisor) {
     int rotate = _curveTrack.rotate();
     int shapeProbabilityBias = _curveTrack.shapeProbabilityBias();
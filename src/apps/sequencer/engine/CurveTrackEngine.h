@@ -51,6 +51,14 @@ public:
     void setMonitorStep(int index) { _monitorStepIndex = (index >= 0 && index < CONFIG_STEP_COUNT) ? index : -1; }
     void setMonitorStepLevel(MonitorLevel level) { _monitorStepLevel = level; }
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
+    // state shared by all curve track engines
+    static void writeSharedState(VersionedSerializedWriter &writer);
+    static void readSharedState(VersionedSerializedReader &reader);
+
 private:
     void triggerStep(uint32_t tick, uint32_t divisor);
     void updateOutput(uint32_t relativeTick, uint32_t divisor);
@@ -2,6 +2,8 @@
 
 #include "core/midi/MidiMessage.h"
 #include "core/math/Math.h"
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
 
 #include <functional>
 
@@ -49,6 +51,21 @@ public:
         }
     }
 
+    // state snapshot, the time of the last gate off is stored relative to now
+    void writeState(VersionedSerializedWriter &writer) const {
+        writer.write(uint32_t(os::ticks() - _lastGateOff));
+        writer.write(_gate);
+        writer.write(_note);
+    }
+
+    void readState(VersionedSerializedReader &reader) {
+        uint32_t elapsed;
+        reader.read(elapsed);
+        _lastGateOff = os::ticks() - elapsed;
+        reader.read(_gate);
+        reader.read(_note);
+    }
+
 private:
     static constexpr uint32_t GateOnDelay = os::time::ms(5);
 
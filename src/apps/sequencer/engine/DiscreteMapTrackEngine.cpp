@@ -305,6 +305,84 @@ bool DiscreteMapTrackEngine::updateExternalOnce() {
     return _extOnceDone || !_extOnceArmed;
 }
 
+void DiscreteMapTrackEngine::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_rampPhase);
+    writer.write(_rampValue);
+    writer.write(_running);
+
+    writer.write(_currentInput);
+    writer.write(_prevInput);
+    writer.write(_prevSync);
+    writer.write(_prevLoop);
+
+    writer.write(_lengthThresholds);
+    writer.write(_positionThresholds);
+    writer.write(_thresholdsDirty);
+    writer.write(_prevRangeHigh);
+    writer.write(_prevRangeLow);
+    writer.write(_prevThresholdMode);
+
+    writer.write(_activeStage);
+    writer.write(_cvOutput);
+    writer.write(_targetCv);
+    writer.write(_gateTimer);
+
+    writer.write(_sampledOctave);
+    writer.write(_sampledTranspose);
+    writer.write(_sampledRootNote);
+
+    writer.write(_activity);
+    writer.write(_activityTimer);
+
+    writer.write(_extOnceArmed);
+    writer.write(_extOnceDone);
+    writer.write(_extMinSeen);
+    writer.write(_extMaxSeen);
+    writer.write(_lastScannerSegment);
+
+    writer.write(_resetTickOffset);
+}
+
+void DiscreteMapTrackEngine::readState(VersionedSerializedReader &reader) {
+    changePattern();
+
+    reader.read(_rampPhase);
+    reader.read(_rampValue);
+    reader.read(_running);
+
+    reader.read(_currentInput);
+    reader.read(_prevInput);
+    reader.read(_prevSync);
+    reader.read(_prevLoop);
+
+    reader.read(_lengthThresholds);
+    reader.read(_positionThresholds);
+    reader.read(_thresholdsDirty);
+    reader.read(_prevRangeHigh);
+    reader.read(_prevRangeLow);
+    reader.read(_prevThresholdMode);
+
+    reader.read(_activeStage);
+    reader.read(_cvOutput);
+    reader.read(_targetCv);
+    reader.read(_gateTimer);
+
+    reader.read(_sampledOctave);
+    reader.read(_sampledTranspose);
+    reader.read(_sampledRootNote);
+
+    reader.read(_activity);
+    reader.read(_activityTimer);
+
+    reader.read(_extOnceArmed);
+    reader.read(_extOnceDone);
+    reader.read(_extMinSeen);
+    reader.read(_extMaxSeen);
+    reader.read(_lastScannerSegment);
+
+    reader.read(_resetTickOffset);
+}
+
 void DiscreteMapTrackEngine::update(float dt) {
     // No per-frame updates needed
     (void)dt;
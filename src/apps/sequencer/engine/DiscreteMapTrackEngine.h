@@ -49,6 +49,10 @@ public:
     void recalculatePositionThresholds();
     float getThresholdVoltage(int stageIndex);
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
 private:
     static constexpr float kInternalRampMin = -5.0f;
     static constexpr float kInternalRampMax = 5.0f;
@@ -6,8 +6,12 @@
 #include "core/Debug.h"
 #include "core/midi/MidiMessage.h"
 
+#include "drivers/HighResolutionTimer.h"
+
 #include "os/os.h"
 
+#include <algorithm>
+
 Engine::Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &dio, GateOutput &gateOutput, Midi &midi, UsbMidi &usbMidi) :
     _model(model),
     _project(model.project()),
@@ -52,6 +56,7 @@ void Engine::update() {
         return;
     }
 
+    uint32_t updateStart = HighResolutionTimer::us();
     uint32_t systemTicks = os::ticks();
     float dt = (0.001f * (systemTicks - _lastSystemTicks)) / os::time::ms(1);
     _lastSystemTicks = systemTicks;
@@ -129,8 +134,10 @@ void Engine::update() {
     _routingEngine.update();
 
     uint32_t tick;
+    uint32_t tickCount = 0;
     while (_clock.checkTick(&tick)) {
         _tick = tick;
+        ++tickCount;
 
         // update play state
         updatePlayState(true);
@@ -174,6 +181,11 @@ void Engine::update() {
     // update cv/gate outputs
     _cvOutput.update();
     _gateOutput.update();
+
+    // track load, peak update time decays by 1/16 per update
+    uint32_t updateTime = HighResolutionTimer::us() - updateStart;
+    _updateTime = std::max(updateTime, _updateTime - (_updateTime >> 4));
+    _tickBacklog = tickCount;
 }
 
 void Engine::lock() {
@@ -391,11 +403,251 @@ void Engine::setMessageHandler(MessageHandler handler) {
 Engine::Stats Engine::stats() const {
     return {
         .uptime = os::ticks() / os::time::ms(1000),
-        .midiRxOverflow = _midi.rxOverflow(),
-        .usbMidiRxOverflow = _usbMidi.rxOverflow()
+        .midi = _midi.stats(),
+        .usbMidi = _usbMidi.stats(),
+        .updateTime = _updateTime,
+        .tickBacklog = _tickBacklog
     };
 }
 
+void Engine::writeState(VersionedSerializedWriter &writer) const {
+    uint32_t systemTicks = os::ticks();
+
+    writer.write(_state);
+    writer.write(_tick);
+    writer.write(uint32_t(systemTicks - _lastSystemTicks));
+    writer.write(_nudgeTempo);
+    _clock.writeState(writer);
+
+    // track engines may not match the track modes of the project until the next update
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        const auto &trackEngine = *_trackEngines[trackIndex];
+        auto trackMode = trackEngine.trackMode();
+        writer.write(uint8_t(trackMode));
+        switch (trackMode) {
+        case Track::TrackMode::Note:
+            static_cast<const NoteTrackEngine &>(trackEngine).writeState(writer);
+            break;
+        case Track::TrackMode::Curve:
+            static_cast<const CurveTrackEngine &>(trackEngine).writeState(writer);
+            break;
+        case Track::TrackMode::MidiCv:
+            static_cast<const MidiCvTrackEngine &>(trackEngine).writeState(writer);
+            break;
+        case Track::TrackMode::Tuesday:
+            static_cast<const TuesdayTrackEngine &>(trackEngine).writeState(writer);
+            break;
+        case Track::TrackMode::DiscreteMap:
+            static_cast<const DiscreteMapTrackEngine &>(trackEngine).writeState(writer);
+            break;
+        case Track::TrackMode::Indexed:
+            static_cast<const IndexedTrackEngine &>(trackEngine).writeState(writer);
+            break;
+        case Track::TrackMode::Last:
+            break;
+        }
+        _trackUpdateReducers[trackIndex].writeState(writer);
+    }
+
+    NoteTrackEngine::writeSharedState(writer);
+    CurveTrackEngine::writeSharedState(writer);
+    ArpeggiatorEngine::writeSharedState(writer);
+    Accumulator::writeSharedState(writer);
+
+    _routingEngine.writeState(writer);
+    _midiOutputEngine.writeState(writer);
+    _cvGateToMidiConverter.writeState(writer);
+
+    writer.write(_midiMonitoring);
+    writer.write(_midiHasSentInitialPgmChange);
+    writer.write(_midiLastInitialProgramOffset);
+    writer.write(_pendingPreHandle);
+
+    // outputs as last passed to the drivers
+    for (int channel = 0; channel < CvOutput::Channels; ++channel) {
+        writer.write(_cvOutput.channel(channel));
+    }
+    writer.write(_gateOutput.gates());
+
+    _project.playState().writeState(writer);
+
+    writer.writeHash();
+}
+
+bool Engine::readState(VersionedSerializedReader &reader) {
+    uint32_t systemTicks = os::ticks();
+
+    // create the track engines for the track modes of the project
+    updateTrackSetups();
+
+    reader.read(_state);
+    reader.read(_tick);
+    uint32_t elapsed;
+    reader.read(elapsed);
+    _lastSystemTicks = systemTicks - elapsed;
+    reader.read(_nudgeTempo);
+    _clock.readState(reader);
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        auto &trackEngine = *_trackEngines[trackIndex];
+        uint8_t trackMode;
+        reader.read(trackMode);
+        if (Track::TrackMode(trackMode) != trackEngine.trackMode()) {
+            return false;
+        }
+        switch (trackEngine.trackMode()) {
+        case Track::TrackMode::Note:
+            trackEngine.as<NoteTrackEngine>().readState(reader);
+            break;
+        case Track::TrackMode::Curve:
+            trackEngine.as<CurveTrackEngine>().readState(reader);
+            break;
+        case Track::TrackMode::MidiCv:
+            trackEngine.as<MidiCvTrackEngine>().readState(reader);
+            break;
+        case Track::TrackMode::Tuesday:
+            trackEngine.as<TuesdayTrackEngine>().readState(reader);
+            break;
+        case Track::TrackMode::DiscreteMap:
+            trackEngine.as<DiscreteMapTrackEngine>().readState(reader);
+            break;
+        case Track::TrackMode::Indexed:
+            trackEngine.as<IndexedTrackEngine>().readState(reader);
+            break;
+        case Track::TrackMode::Last:
+            break;
+        }
+        _trackUpdateReducers[trackIndex].readState(reader);
+    }
+
+    NoteTrackEngine::readSharedState(reader);
+    CurveTrackEngine::readSharedState(reader);
+    ArpeggiatorEngine::readSharedState(reader);
+    Accumulator::readSharedState(reader);
+
+    _routingEngine.readState(reader);
+    _midiOutputEngine.readState(reader);
+    _cvGateToMidiConverter.readState(reader);
+
+    reader.read(_midiMonitoring);
+    reader.read(_midiHasSentInitialPgmChange);
+    reader.read(_midiLastInitialProgramOffset);
+    reader.read(_pendingPreHandle);
+
+    for (int channel = 0; channel < CvOutput::Channels; ++channel) {
+        float value;
+        reader.read(value);
+        _cvOutput.setChannel(channel, value);
+    }
+    uint8_t gates;
+    reader.read(gates);
+    _gateOutput.setGates(gates);
+
+    _project.playState().readState(reader);
+
+    return reader.checkHash();
+}
+
+void Engine::seek(uint32_t tick) {
+    auto &songState = _project.playState().songState();
+    const auto &song = _project.song();
+    bool songPlaying = songState.playing() && song.slotCount() > 0;
+
+    // play as if the clock was started, without recording
+    bool running = _state.running();
+    bool recording = _state.recording();
+    _state.setRunning(true);
+    _state.setRecording(false);
+
+    updateTrackSetups();
+
+    if (songPlaying) {
+        songState.setCurrentSlot(0);
+        songState.setCurrentRepeat(0);
+        activateSongSlot(song.slot(0));
+    }
+
+    reset();
+
+    // process the tracks tick by tick in track order, skipping the ticks none of the tracks needs (see TrackEngine::seek)
+    std::array<uint32_t, CONFIG_TRACK_COUNT> trackTicks;
+    trackTicks.fill(0);
+    uint32_t measureDivisor = this->measureDivisor();
+    uint32_t measureTick = measureDivisor;
+    // playback updates the tracks by 1ms on every tick and by the elapsed time in between
+    float tickUpdateTime = 0.001f + _clock.tickDuration();
+
+    uint32_t linkedTracks = 0;
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        if (_trackEngines[trackIndex]->linkedTrackEngine()) {
+            linkedTracks |= 1 << _project.track(trackIndex).linkTrack();
+        }
+    }
+
+    while (true) {
+        uint32_t currentTick = *std::min_element(trackTicks.begin(), trackTicks.end());
+        if (currentTick >= tick) {
+            break;
+        }
+
+        _tick = currentTick;
+
+        // the song advances and the track engines change pattern at every measure,
+        // so the tracks are always processed at measure ticks
+        if (currentTick == measureTick) {
+            if (songPlaying) {
+                advanceSong();
+            }
+            for (auto trackEngine : _trackEngines) {
+                trackEngine->changePattern();
+            }
+            measureTick += measureDivisor;
+        }
+
+        uint32_t endTick = std::min(tick, measureTick);
+
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            if (trackTicks[trackIndex] != currentTick) {
+                continue;
+            }
+            auto &trackEngine = *_trackEngines[trackIndex];
+            if (_project.track(trackIndex).runGate()) {
+                // tracks linked to this track read its link data on every tick
+                uint32_t trackEndTick = linkedTracks & (1 << trackIndex) ? currentTick + 1 : endTick;
+                trackTicks[trackIndex] = std::max(currentTick + 1, trackEngine.seek(currentTick, trackEndTick));
+            } else {
+                trackEngine.update(tickUpdateTime * (endTick - currentTick));
+                trackTicks[trackIndex] = endTick;
+            }
+        }
+    }
+
+    // continue with the tick
+    _tick = tick > 0 ? tick - 1 : 0;
+    _pendingPreHandle = PreHandleNone;
+    _clock.seek(tick);
+
+    _state.setRunning(running);
+    _state.setRecording(recording);
+}
+
+void Engine::seekSongSlot(int slot) {
+    auto &songState = _project.playState().songState();
+    const auto &song = _project.song();
+
+    if (slot < 0 || slot >= song.slotCount()) {
+        return;
+    }
+
+    uint32_t measures = 0;
+    for (int slotIndex = 0; slotIndex < slot; ++slotIndex) {
+        measures += song.slot(slotIndex).repeats();
+    }
+
+    songState.setPlaying(true);
+    seek(measures * measureDivisor());
+}
+
 void Engine::onClockOutput(const Clock::OutputState &state) {
     _dio.clockOutput.set(state.clock);
     switch (_project.clockSetup().clockOutputMode()) {
@@ -411,14 +663,14 @@ void Engine::onClockOutput(const Clock::OutputState &state) {
 }
 
 void Engine::onClockMidi(uint8_t data) {
-    // TODO we should send a single byte with priority
+    // real-time bytes are sent ahead of pending messages to keep the clock steady
     const auto &clockSetup = _project.clockSetup();
     if (clockSetup.midiTx()) {
-        _midi.send(MidiMessage(data));
+        _midi.sendRealtime(data);
     }
     if (clockSetup.usbTx()) {
         // always send clock on cable 0
-        _usbMidi.send(0, MidiMessage(data));
+        _usbMidi.sendRealtime(0, data);
     }
 }
 
@@ -627,16 +879,6 @@ void Engine::updatePlayState(bool ticked) {
 
     // handle song requests
 
-    auto activateSongSlot = [&] (const Song::Slot &slot) {
-        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
-            playState.trackState(trackIndex).setPattern(slot.pattern(trackIndex));
-            // only set mutes if track in song contains any mutes at all
-            if (song.trackHasMutes(trackIndex)) {
-                playState.trackState(trackIndex).setMute(slot.mute(trackIndex));
-            }
-        }
-    };
-
     if (hasRequests) {
         int playRequests = PlayState::SongState::ImmediatePlayRequest |
             (handleSyncedRequests ? PlayState::SongState::SyncedPlayRequest : 0) |
@@ -714,24 +956,7 @@ void Engine::updatePlayState(bool ticked) {
         }
 
         if (handleSongAdvance) {
-            if (currentRepeat + 1 < slot.repeats()) {
-                // next repeat
-                songState.setCurrentRepeat(currentRepeat + 1);
-            } else {
-                // next slot
-                songState.setCurrentRepeat(0);
-                if (currentSlot + 1 < song.slotCount()) {
-                    songState.setCurrentSlot(currentSlot + 1);
-                } else {
-                    songState.setCurrentSlot(0);
-                }
-
-                // update patterns
-                activateSongSlot(song.slot(songState.currentSlot()));
-                for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
-                    _trackEngines[trackIndex]->restart();
-                }
-            }
+            advanceSong();
         }
     }
 
@@ -749,6 +974,46 @@ void Engine::updatePlayState(bool ticked) {
     }
 }
 
+void Engine::activateSongSlot(const Song::Slot &slot) {
+    auto &playState = _project.playState();
+    const auto &song = _project.song();
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        playState.trackState(trackIndex).setPattern(slot.pattern(trackIndex));
+        // only set mutes if track in song contains any mutes at all
+        if (song.trackHasMutes(trackIndex)) {
+            playState.trackState(trackIndex).setMute(slot.mute(trackIndex));
+        }
+    }
+}
+
+void Engine::advanceSong() {
+    auto &songState = _project.playState().songState();
+    const auto &song = _project.song();
+
+    int currentSlot = songState.currentSlot();
+    int currentRepeat = songState.currentRepeat();
+
+    if (currentRepeat + 1 < song.slot(currentSlot).repeats()) {
+        // next repeat
+        songState.setCurrentRepeat(currentRepeat + 1);
+    } else {
+        // next slot
+        songState.setCurrentRepeat(0);
+        if (currentSlot + 1 < song.slotCount()) {
+            songState.setCurrentSlot(currentSlot + 1);
+        } else {
+            songState.setCurrentSlot(0);
+        }
+
+        // update patterns
+        activateSongSlot(song.slot(songState.currentSlot()));
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            _trackEngines[trackIndex]->restart();
+        }
+    }
+}
+
 void Engine::updateOverrides() {
     // overrides
     if (_gateOutputOverride) {
@@ -781,6 +1046,9 @@ void Engine::receiveMidi() {
         }
     }
 
+    // rebuild dispatch tables if routing or track MIDI config has changed
+    _midiInputDispatch.update(_project);
+
     // receive MIDI messages from ports
     MidiMessage message;
     while (_midi.recv(&message)) {
@@ -853,15 +1121,18 @@ void Engine::receiveMidi(MidiPort port, uint8_t cable, const MidiMessage &messag
     }
 
     // let routing engine consume messages
-    if (_routingEngine.receiveMidi(port, message)) {
+    if (_routingEngine.receiveMidi(port, message, _midiInputDispatch.routes(port, message))) {
         return;
     }
 
-    // let track engines consume messages (only MIDI/CV tracks)
+    // let track engines consume messages (only MIDI/CV tracks listening to the port/channel)
     // allow all tracks to receive messages even if one of them consumes it
     bool consumed = false;
-    for (auto trackEngine : _trackEngines) {
-        consumed |= trackEngine->receiveMidi(port, message);
+    auto tracks = _midiInputDispatch.tracks(port, message);
+    for (int trackIndex = 0; tracks != 0; ++trackIndex, tracks >>= 1) {
+        if (tracks & 1) {
+            consumed |= _trackEngines[trackIndex]->receiveMidi(port, message);
+        }
     }
     if (consumed) {
         return;
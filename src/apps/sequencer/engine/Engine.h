@@ -17,6 +17,7 @@
 #include "MidiOutputEngine.h"
 #include "MidiPort.h"
 #include "MidiLearn.h"
+#include "MidiInputDispatch.h"
 #include "CvGateToMidiConverter.h"
 #include "UpdateReducer.h"
 
@@ -30,6 +31,8 @@
 #include "drivers/Midi.h"
 #include "drivers/UsbMidi.h"
 
+#include "core/midi/MidiPortStats.h"
+
 #include <array>
 
 #include <cstdint>
@@ -56,8 +59,10 @@ public:
 
     struct Stats {
         uint32_t uptime;
-        uint32_t midiRxOverflow;
-        uint32_t usbMidiRxOverflow;
+        MidiPortStats midi;
+        MidiPortStats usbMidi;
+        uint32_t updateTime;
+        uint32_t tickBacklog;
     };
 
     Engine(Model &model, ClockTimer &clockTimer, Adc &adc, Dac &dac, Dio &dio, GateOutput &gateOutput, Midi &midi, UsbMidi &usbMidi);
@@ -85,6 +90,14 @@ public:
     void clockReset();
     bool clockRunning() const;
 
+    // seeking
+    // moves to the given tick as if the clock had been started and run up to it, without producing output.
+    // a playing song is played from its first slot. the clock continues from the tick, use clockContinue() to
+    // start playback from there. pending play state requests are left to the next update.
+    void seek(uint32_t tick);
+    // moves to the start of the given song slot and plays the song
+    void seekSongSlot(int slot);
+
     // recording
     void toggleRecording();
     void setRecording(bool recording);
@@ -163,6 +176,18 @@ public:
 
     Stats stats() const;
 
+    // state snapshot of the engine and the runtime state of the play state, used to save and restore a running
+    // session in the simulator (the project is written separately). tap tempo, overrides and midi learn are
+    // not included. snapshots are only valid for the build that wrote them.
+    void writeState(VersionedSerializedWriter &writer) const;
+    bool readState(VersionedSerializedReader &reader);
+
+    // load (read by the ui to reduce its own work while the engine is busy)
+    // peak time of a full engine update in microseconds (decays over time)
+    uint32_t updateTime() const { return _updateTime; }
+    // number of clock ticks processed in the last update (more than one means the engine fell behind)
+    uint32_t tickBacklog() const { return _tickBacklog; }
+
 private:
     // Clock::Listener
     virtual void onClockOutput(const Clock::OutputState &state) override;
@@ -172,6 +197,8 @@ private:
     void updateTrackOutputs();
     void reset();
     void updatePlayState(bool ticked);
+    void activateSongSlot(const Song::Slot &slot);
+    void advanceSong();
     void updateOverrides();
 
     void usbMidiConnect(uint16_t vendorId, uint16_t productId);
@@ -208,6 +235,7 @@ private:
 
     RoutingEngine _routingEngine;
     MidiLearn _midiLearn;
+    MidiInputDispatch _midiInputDispatch;
     MidiReceiveHandler _midiReceiveHandler;
     UsbMidiConnectHandler _usbMidiConnectHandler;
     UsbMidiDisconnectHandler _usbMidiDisconnectHandler;
@@ -226,6 +254,9 @@ private:
 
     uint32_t _lastSystemTicks = 0;
 
+    volatile uint32_t _updateTime = 0;
+    volatile uint32_t _tickBacklog = 0;
+
     // midi monitoring
     struct {
         Types::MidiInputMode lastMidiInputMode;
@@ -242,6 +242,46 @@ TrackEngine::TickResult IndexedTrackEngine::tick(uint32_t tick) {
     return TickResult::NoUpdate;
 }
 
+uint32_t IndexedTrackEngine::seek(uint32_t tick, uint32_t endTick) {
+    IndexedTrackEngine::tick(tick);
+
+    uint32_t seekTick = endTick;
+
+    switch (_sequence->syncMode()) {
+    case IndexedSequence::SyncMode::ResetMeasure: {
+        uint32_t resetDivisor = _sequence->resetMeasure() * _engine.measureDivisor();
+        if (resetDivisor > 0) {
+            seekTick = std::min(seekTick, tick + resetDivisor - tick % resetDivisor);
+        }
+        break;
+    }
+    case IndexedSequence::SyncMode::External:
+        // sync input is sampled every tick
+        seekTick = tick + 1;
+        break;
+    case IndexedSequence::SyncMode::Off:
+    case IndexedSequence::SyncMode::Last:
+        break;
+    }
+
+    // between steps the step and gate timers just count
+    if (_running) {
+        const uint16_t stepDuration = static_cast<uint16_t>(_effectiveStepDuration);
+        if (stepDuration > 0) {
+            seekTick = std::min(seekTick, tick + (_stepTimer < stepDuration ? stepDuration - _stepTimer : 1));
+        }
+        uint32_t skipped = seekTick - tick - 1;
+        _gateTimer -= std::min(_gateTimer, skipped);
+        if (stepDuration > 0) {
+            _stepTimer += skipped;
+        }
+    }
+
+    update((0.001f + _engine.clock().tickDuration()) * (seekTick - tick));
+
+    return seekTick;
+}
+
 void IndexedTrackEngine::update(float dt) {
     if (_slideActive && _indexedTrack.slideTime() > 0) {
         _cvOutput = Slide::applySlide(_cvOutput, _cvOutputTarget, _indexedTrack.slideTime(), dt);
@@ -250,6 +290,50 @@ void IndexedTrackEngine::update(float dt) {
     }
 }
 
+void IndexedTrackEngine::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_cachedPattern);
+
+    writer.write(_stepTimer);
+    writer.write(_gateTimer);
+    writer.write(_effectiveStepDuration);
+    writer.write(_currentStepIndex);
+    writer.write(_running);
+    writer.write(_pendingTrigger);
+    writer.write(_prevSync);
+    writer.write(_stepsRemaining);
+
+    writer.write(_cvOutput);
+    writer.write(_cvOutputTarget);
+    writer.write(_activity);
+    writer.write(_slideActive);
+
+    writer.write(_sequenceState);
+    writer.write(_rng);
+}
+
+void IndexedTrackEngine::readState(VersionedSerializedReader &reader) {
+    changePattern();
+
+    reader.read(_cachedPattern);
+
+    reader.read(_stepTimer);
+    reader.read(_gateTimer);
+    reader.read(_effectiveStepDuration);
+    reader.read(_currentStepIndex);
+    reader.read(_running);
+    reader.read(_pendingTrigger);
+    reader.read(_prevSync);
+    reader.read(_stepsRemaining);
+
+    reader.read(_cvOutput);
+    reader.read(_cvOutputTarget);
+    reader.read(_activity);
+    reader.read(_slideActive);
+
+    reader.read(_sequenceState);
+    reader.read(_rng);
+}
+
 void IndexedTrackEngine::advanceStep() {
     const int activeLength = _sequence->activeLength();
     if (activeLength <= 0) {
@@ -27,6 +27,7 @@ public:
     virtual void update(float dt) override;
 
     virtual void changePattern() override;
+    virtual uint32_t seek(uint32_t tick, uint32_t endTick) override;
 
     virtual bool activity() const override { return gateOutput(0); }
     virtual bool gateOutput(int index) const override;
@@ -39,6 +40,10 @@ public:
     // For Testing/UI
     int currentStep() const { return _currentStepIndex; }
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
 private:
     // Constants for step parameters
     static constexpr uint32_t TRIGGER_PULSE_TICKS = 3;
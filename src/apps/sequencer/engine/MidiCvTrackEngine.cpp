@@ -5,6 +5,7 @@
 
 #include "os/os.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cinttypes>
 
@@ -139,6 +140,65 @@ float MidiCvTrackEngine::cvOutput(int index) const {
     return 0.f;
 }
 
+void MidiCvTrackEngine::writeState(VersionedSerializedWriter &writer) const {
+    _arpeggiatorEngine.writeState(writer);
+    writer.write(_arpeggiatorEnabled);
+    writer.write(_arpeggiatorTime);
+    writer.write(_arpeggiatorTick);
+
+    // voice timestamps are system ticks, store them relative to now
+    uint32_t currentTicks = os::ticks();
+    for (const auto &voice : _voices) {
+        bool active = voice.isActive();
+        uint32_t age = active ? currentTicks - voice.ticks : 0;
+        writer.write(active);
+        writer.write(age);
+        writer.write(voice.note);
+        writer.write(voice.velocity);
+        writer.write(voice.pressure);
+        writer.write(voice.output);
+    }
+    writer.write(_voiceByOutput);
+    writer.write(_nextOutput);
+
+    writer.write(_activity);
+    writer.write(_pitchBend);
+    writer.write(_channelPressure);
+    writer.write(_slideActive);
+    writer.write(_pitchCvOutputTarget);
+    writer.write(_pitchCvOutput);
+}
+
+void MidiCvTrackEngine::readState(VersionedSerializedReader &reader) {
+    _arpeggiatorEngine.readState(reader);
+    reader.read(_arpeggiatorEnabled);
+    reader.read(_arpeggiatorTime);
+    reader.read(_arpeggiatorTick);
+
+    uint32_t currentTicks = os::ticks();
+    for (auto &voice : _voices) {
+        bool active;
+        uint32_t age;
+        reader.read(active);
+        reader.read(age);
+        // a tick of 0 marks an inactive voice
+        voice.ticks = active ? std::max(currentTicks - age, uint32_t(1)) : 0;
+        reader.read(voice.note);
+        reader.read(voice.velocity);
+        reader.read(voice.pressure);
+        reader.read(voice.output);
+    }
+    reader.read(_voiceByOutput);
+    reader.read(_nextOutput);
+
+    reader.read(_activity);
+    reader.read(_pitchBend);
+    reader.read(_channelPressure);
+    reader.read(_slideActive);
+    reader.read(_pitchCvOutputTarget);
+    reader.read(_pitchCvOutput);
+}
+
 void MidiCvTrackEngine::updateActivity() {
     _activity = std::any_of(_voices.begin(), _voices.end(), [] (const Voice &voice) {
         return voice.isActive();
@@ -28,6 +28,10 @@ public:
     virtual bool gateOutput(int index) const override;
     virtual float cvOutput(int index) const override;
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
 private:
     static constexpr size_t VoiceCount = 8;
     static constexpr int RetriggerDelay = 2;
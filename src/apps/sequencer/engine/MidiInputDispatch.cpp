@@ -0,0 +1,121 @@
+#include "MidiInputDispatch.h"
+
+#include <algorithm>
+
+bool MidiInputDispatch::update(const Project &project) {
+    // the stored configuration is not initialized before the first rebuild
+    bool changed = !_valid;
+
+    const auto &routing = project.routing();
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        const auto &route = routing.route(routeIndex);
+        auto &config = _routes[routeIndex];
+        bool midi = route.active() && route.source() == Routing::Source::Midi;
+        if (!_valid || midi != config.midi || (midi && !(route.midiSource() == config.source))) {
+            config.midi = midi;
+            config.source = route.midiSource();
+            changed = true;
+        }
+    }
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        const auto &track = project.track(trackIndex);
+        auto &config = _tracks[trackIndex];
+        bool midiCv = track.trackMode() == Track::TrackMode::MidiCv;
+        if (!_valid || midiCv != config.midiCv || (midiCv && track.midiCvTrack().source() != config.source)) {
+            config.midiCv = midiCv;
+            if (midiCv) {
+                config.source = track.midiCvTrack().source();
+            }
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        rebuild();
+        _valid = true;
+    }
+
+    return changed;
+}
+
+void MidiInputDispatch::rebuild() {
+    for (auto &table : _ports) {
+        table.controlRoutes.fill(0);
+        table.noteRoutes.fill(0);
+        table.pitchBendRoutes.fill(0);
+        table.tracks.fill(0);
+        table.controlNumberRoutes.fill(0);
+        table.noteNumberRoutes.fill(0);
+    }
+
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        const auto &config = _routes[routeIndex];
+        if (!config.midi) {
+            continue;
+        }
+
+        const auto &source = config.source.source();
+        auto &table = _ports[int(source.port())];
+        RouteMask mask = 1 << routeIndex;
+
+        RouteMask *channelRoutes = nullptr;
+        int firstNumber = 0;
+        int lastNumber = -1;
+        RouteMask *numberRoutes = nullptr;
+
+        switch (config.source.event()) {
+        case Routing::MidiSource::Event::ControlAbsolute:
+        case Routing::MidiSource::Event::ControlRelative:
+            channelRoutes = table.controlRoutes.data();
+            numberRoutes = table.controlNumberRoutes.data();
+            firstNumber = lastNumber = config.source.controlNumber();
+            break;
+        case Routing::MidiSource::Event::PitchBend:
+            channelRoutes = table.pitchBendRoutes.data();
+            break;
+        case Routing::MidiSource::Event::NoteMomentary:
+        case Routing::MidiSource::Event::NoteToggle:
+        case Routing::MidiSource::Event::NoteVelocity:
+            channelRoutes = table.noteRoutes.data();
+            numberRoutes = table.noteNumberRoutes.data();
+            firstNumber = lastNumber = config.source.note();
+            break;
+        case Routing::MidiSource::Event::NoteRange:
+            channelRoutes = table.noteRoutes.data();
+            numberRoutes = table.noteNumberRoutes.data();
+            firstNumber = config.source.note();
+            lastNumber = std::min(127, firstNumber + config.source.noteRange() - 1);
+            break;
+        case Routing::MidiSource::Event::Last:
+            break;
+        }
+
+        if (channelRoutes) {
+            for (int channel = 0; channel < ChannelCount; ++channel) {
+                if (source.isOmni() || source.channel() == channel) {
+                    channelRoutes[channel] |= mask;
+                }
+            }
+        }
+        if (numberRoutes) {
+            for (int number = firstNumber; number <= lastNumber; ++number) {
+                numberRoutes[number] |= mask;
+            }
+        }
+    }
+
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        const auto &config = _tracks[trackIndex];
+        if (!config.midiCv) {
+            continue;
+        }
+
+        auto &table = _ports[int(config.source.port())];
+        for (int channel = 0; channel < ChannelCount; ++channel) {
+            if (config.source.isOmni() || config.source.channel() == channel) {
+                table.tracks[channel] |= 1 << trackIndex;
+            }
+        }
+    }
+}
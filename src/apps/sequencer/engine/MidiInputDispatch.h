@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Config.h"
+
+#include "MidiPort.h"
+
+#include "model/Project.h"
+
+#include "core/midi/MidiMessage.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Precomputed index of the routes and tracks interested in incoming midi messages.
+// Instead of matching every message against all routes and tracks, the tables map
+// (port, channel, message type) and (port, message type, number) to bit masks of routes/tracks.
+// As every route listens to a single channel (or all) and a single controller/note (range),
+// the intersection of both masks gives exactly the routes interested in a message.
+// The tables are rebuilt whenever the midi configuration of routes or tracks changes.
+class MidiInputDispatch {
+public:
+    static_assert(CONFIG_ROUTE_COUNT <= 16, "route mask too small");
+    static_assert(CONFIG_TRACK_COUNT <= 8, "track mask too small");
+
+    typedef uint16_t RouteMask;
+    typedef uint8_t TrackMask;
+
+    // checks for configuration changes, returns true if the tables were rebuilt
+    bool update(const Project &project);
+
+    RouteMask routes(MidiPort port, const MidiMessage &message) const {
+        if (!isValidPort(port)) {
+            return 0;
+        }
+        const auto &table = _ports[int(port)];
+        int channel = message.channel();
+        if (message.isControlChange()) {
+            return table.controlRoutes[channel] & table.controlNumberRoutes[message.controlNumber()];
+        } else if (message.isNoteOn() || message.isNoteOff()) {
+            return table.noteRoutes[channel] & table.noteNumberRoutes[message.note()];
+        } else if (message.isPitchBend()) {
+            return table.pitchBendRoutes[channel];
+        }
+        return 0;
+    }
+
+    TrackMask tracks(MidiPort port, const MidiMessage &message) const {
+        if (!isValidPort(port)) {
+            return 0;
+        }
+        if (message.isNoteOn() || message.isNoteOff() || message.isKeyPressure() ||
+            message.isChannelPressure() || message.isPitchBend()) {
+            return _ports[int(port)].tracks[message.channel()];
+        }
+        return 0;
+    }
+
+private:
+    static constexpr int PortCount = int(Types::MidiPort::Last);
+    static constexpr int ChannelCount = 16;
+
+    static bool isValidPort(MidiPort port) { return int(port) < PortCount; }
+
+    void rebuild();
+
+    struct PortTable {
+        std::array<RouteMask, ChannelCount> controlRoutes;
+        std::array<RouteMask, ChannelCount> noteRoutes;
+        std::array<RouteMask, ChannelCount> pitchBendRoutes;
+        std::array<TrackMask, ChannelCount> tracks;
+        std::array<RouteMask, 128> controlNumberRoutes;
+        std::array<RouteMask, 128> noteNumberRoutes;
+    };
+
+    std::array<PortTable, PortCount> _ports;
+
+    // configuration the tables were built from
+    struct RouteConfig {
+        bool midi;
+        Routing::MidiSource source;
+    };
+
+    struct TrackConfig {
+        bool midiCv;
+        MidiSourceConfig source;
+    };
+
+    std::array<RouteConfig, CONFIG_ROUTE_COUNT> _routes;
+    std::array<TrackConfig, CONFIG_TRACK_COUNT> _tracks;
+    bool _valid = false;
+};
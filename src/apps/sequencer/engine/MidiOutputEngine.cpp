@@ -8,7 +8,8 @@
 
 MidiOutputEngine::MidiOutputEngine(Engine &engine, Model &model):
     _engine(engine),
-    _midiOutput(model.project().midiOutput())
+    _midiOutput(model.project().midiOutput()),
+    _schedulers({{ MidiOutputScheduler(MidiBytesPerSecond), MidiOutputScheduler(UsbMidiBytesPerSecond) }})
 {
 }
 
@@ -16,20 +17,15 @@ void MidiOutputEngine::reset() {
     for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
         resetOutput(outputIndex);
     }
+    for (auto &scheduler : _schedulers) {
+        scheduler.reset();
+    }
 }
 
 void MidiOutputEngine::update(bool forceSendCC) {
-    // determine the rate for sending MIDI CC events:
-    // 3250 bytes per second
-    // 3 bytes per message
-    // 16 outputs
-    // gives roughly 67 events per second per track
-    // be conservative and make this 50 events per second
-    bool sendCC = forceSendCC;
     uint32_t ticks = os::ticks();
-    if (ticks >= _lastSendCCTicks + os::time::ms(1000 / 50)) {
-        sendCC = true;
-        _lastSendCCTicks = ticks;
+    for (auto &scheduler : _schedulers) {
+        scheduler.update(ticks);
     }
 
     for (int outputIndex = 0; outputIndex < CONFIG_MIDI_OUTPUT_COUNT; ++outputIndex) {
@@ -52,7 +48,7 @@ void MidiOutputEngine::update(bool forceSendCC) {
 
         // send slide requests
         if (outputState.hasRequest(OutputState::Slide)) {
-            sendMidi(port, MidiMessage::makeControlChange(channel, 65, outputState.slide ? 127 : 0));
+            enqueueMidi(outputIndex, port, MidiMessage::makeControlChange(channel, 65, outputState.slide ? 127 : 0), MidiOutputScheduler::Priority::Control);
             outputState.clearRequest(OutputState::Slide);
         }
 
@@ -72,16 +68,17 @@ void MidiOutputEngine::update(bool forceSendCC) {
             }
 
             if (outputState.hasRequest(OutputState::NoteOn) && outputState.activeNote != note) {
-                sendMidi(port, MidiMessage::makeNoteOn(channel, note, velocity));
+                enqueueMidi(outputIndex, port, MidiMessage::makeNoteOn(channel, note, velocity), MidiOutputScheduler::Priority::NoteOn);
             }
 
             if (outputState.hasRequest(OutputState::NoteOff) && outputState.activeNote != -1) {
-                sendMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
+                enqueueMidi(outputIndex, port, MidiMessage::makeNoteOff(channel, outputState.activeNote), MidiOutputScheduler::Priority::NoteOff);
                 outputState.activeNote = -1;
             }
 
+            // legato, the previous note is released after the new note started
             if (outputState.hasRequest(OutputState::NoteOn) && outputState.activeNote != -1 && outputState.activeNote != note) {
-                sendMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
+                enqueueMidi(outputIndex, port, MidiMessage::makeNoteOff(channel, outputState.activeNote), MidiOutputScheduler::Priority::LegatoNoteOff);
                 outputState.activeNote = -1;
             }
 
@@ -92,12 +89,36 @@ void MidiOutputEngine::update(bool forceSendCC) {
             outputState.clearRequest(OutputState::NoteOn | OutputState::NoteOff);
         }
 
-        // send control change requests
-        if (sendCC && outputState.hasRequest(OutputState::ControlChange)) {
-            sendMidi(port, MidiMessage::makeControlChange(channel, output.controlNumber(), outputState.control));
+        // send control change requests (merged with pending values and sent when bandwidth is available)
+        if (outputState.hasRequest(OutputState::ControlChange)) {
+            enqueueMidi(outputIndex, port, MidiMessage::makeControlChange(channel, output.controlNumber(), outputState.control), MidiOutputScheduler::Priority::ControlChange);
             outputState.clearRequest(OutputState::ControlChange);
         }
     }
+
+    // send scheduled messages, force sending CC on first clock tick
+    for (size_t portIndex = 0; portIndex < _schedulers.size(); ++portIndex) {
+        MidiMessage message;
+        while (_schedulers[portIndex].dequeue(message, forceSendCC)) {
+            sendMidi(MidiPort(portIndex), message);
+        }
+    }
+}
+
+void MidiOutputEngine::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_outputStates);
+    uint32_t ticks = os::ticks();
+    for (const auto &scheduler : _schedulers) {
+        scheduler.writeState(writer, ticks);
+    }
+}
+
+void MidiOutputEngine::readState(VersionedSerializedReader &reader) {
+    reader.read(_outputStates);
+    uint32_t ticks = os::ticks();
+    for (auto &scheduler : _schedulers) {
+        scheduler.readState(reader, ticks);
+    }
 }
 
 void MidiOutputEngine::sendGate(int trackIndex, bool gate) {
@@ -174,6 +195,11 @@ void MidiOutputEngine::resetOutput(int outputIndex) {
     MidiPort port = MidiPort(outputState.target.port());
     int channel = outputState.target.channel();
 
+    // drop messages still waiting for bandwidth (i.e. control changes), they belong to the previous target
+    if (size_t(port) < _schedulers.size()) {
+        _schedulers[size_t(port)].cancel(outputIndex);
+    }
+
     if (outputState.activeNote >= 0) {
         sendMidi(port, MidiMessage::makeNoteOff(channel, outputState.activeNote));
     }
@@ -188,6 +214,12 @@ void MidiOutputEngine::resetOutput(int outputIndex) {
     outputState.reset();
 }
 
+void MidiOutputEngine::enqueueMidi(int outputIndex, MidiPort port, const MidiMessage &message, MidiOutputScheduler::Priority priority) {
+    if (size_t(port) < _schedulers.size()) {
+        _schedulers[size_t(port)].enqueue(message, priority, outputIndex);
+    }
+}
+
 void MidiOutputEngine::sendMidi(MidiPort port, const MidiMessage &message) {
     // MidiMessage::dump(message);
     // always use cable 0
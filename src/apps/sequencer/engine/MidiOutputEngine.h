@@ -3,6 +3,7 @@
 #include "Config.h"
 
 #include "MidiPort.h"
+#include "MidiOutputScheduler.h"
 
 #include "model/MidiConfig.h"
 #include "model/MidiOutput.h"
@@ -31,6 +32,10 @@ public:
     void sendMalekkoSelectReleaseHandshake(int channel);
     void sendMalekkoSaveHandshake(int channel);
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
 private:
     struct OutputState {
         enum Requests {
@@ -70,10 +75,16 @@ private:
 
     void resetOutput(int outputIndex);
 
+    void enqueueMidi(int outputIndex, MidiPort port, const MidiMessage &message, MidiOutputScheduler::Priority priority);
     void sendMidi(MidiPort port, const MidiMessage &message);
 
+    // bandwidth used for scheduling control changes (serial midi is 31250 baud with 10 bits per byte)
+    static constexpr uint32_t MidiBytesPerSecond = 3125;
+    static constexpr uint32_t UsbMidiBytesPerSecond = 10 * MidiBytesPerSecond;
+
     Engine &_engine;
     const MidiOutput &_midiOutput;
     std::array<OutputState, CONFIG_MIDI_OUTPUT_COUNT> _outputStates;
-    uint32_t _lastSendCCTicks = 0;
+    // schedulers for MidiPort::Midi and MidiPort::UsbMidi
+    std::array<MidiOutputScheduler, 2> _schedulers;
 };
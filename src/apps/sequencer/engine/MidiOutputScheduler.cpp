@@ -0,0 +1,137 @@
+#include "MidiOutputScheduler.h"
+
+#include "core/math/Math.h"
+
+#include <algorithm>
+
+MidiOutputScheduler::MidiOutputScheduler(uint32_t bytesPerSecond) :
+    _bytesPerSecond(bytesPerSecond)
+{
+    reset();
+}
+
+void MidiOutputScheduler::reset() {
+    _count = 0;
+    _credit = MaxCredit * 1000;
+    _runningStatus.reset();
+}
+
+void MidiOutputScheduler::update(uint32_t ticks) {
+    uint32_t elapsed = std::min(ticks - _lastTicks, uint32_t(CONFIG_TICK_FREQUENCY));
+    _lastTicks = ticks;
+
+    // credit never drops below 100ms of bandwidth, so a burst of notes cannot block controllers for too long
+    int32_t credit = _credit + int32_t(elapsed * (_bytesPerSecond * 1000 / CONFIG_TICK_FREQUENCY));
+    _credit = clamp(credit, -int32_t(_bytesPerSecond * 100), MaxCredit * 1000);
+
+    // messages of one update are sent as a burst, the output driver sends the status byte again after idle
+    _runningStatus.reset();
+}
+
+void MidiOutputScheduler::writeState(VersionedSerializedWriter &writer, uint32_t ticks) const {
+    writer.write(uint32_t(ticks - _lastTicks));
+    writer.write(_credit);
+    writer.write(_runningStatus);
+    // messages are written by value, they never hold a payload
+    writer.write(_count);
+    for (int i = 0; i < _count; ++i) {
+        const auto &entry = _entries[i];
+        writer.write(entry.message.raw(), 3);
+        writer.write(entry.message.length());
+        writer.write(entry.priority);
+        writer.write(entry.output);
+    }
+}
+
+void MidiOutputScheduler::readState(VersionedSerializedReader &reader, uint32_t ticks) {
+    uint32_t elapsed;
+    reader.read(elapsed);
+    _lastTicks = ticks - elapsed;
+    reader.read(_credit);
+    reader.read(_runningStatus);
+    reader.read(_count);
+    _count = std::min(int(_count), QueueSize);
+    for (int i = 0; i < _count; ++i) {
+        auto &entry = _entries[i];
+        uint8_t raw[3];
+        uint8_t length;
+        reader.read(raw);
+        reader.read(length);
+        reader.read(entry.priority);
+        reader.read(entry.output);
+        switch (length) {
+        case 1:  entry.message = MidiMessage(raw[0]); break;
+        case 2:  entry.message = MidiMessage(raw[0], raw[1]); break;
+        default: entry.message = MidiMessage(raw[0], raw[1], raw[2]); break;
+        }
+    }
+}
+
+void MidiOutputScheduler::enqueue(const MidiMessage &message, Priority priority, int output) {
+    if (priority == Priority::ControlChange) {
+        // replace pending value of the same controller
+        for (int i = 0; i < _count; ++i) {
+            auto &entry = _entries[i];
+            if (entry.priority == Priority::ControlChange &&
+                entry.output == output &&
+                entry.message.status() == message.status() &&
+                entry.message.controlNumber() == message.controlNumber()) {
+                entry.message = message;
+                ++_stats.mergedControlChanges;
+                return;
+            }
+        }
+    }
+
+    if (_count >= QueueSize) {
+        ++_stats.dropped;
+        return;
+    }
+
+    _entries[_count++] = { message, priority, uint8_t(output) };
+}
+
+void MidiOutputScheduler::cancel(int output) {
+    auto end = std::remove_if(_entries.begin(), _entries.begin() + _count, [output] (const Entry &entry) {
+        return entry.output == output;
+    });
+    _count = end - _entries.begin();
+}
+
+bool MidiOutputScheduler::dequeue(MidiMessage &message, bool forceControlChange) {
+    // find highest priority entry, prefer entries using the running status, otherwise keep order
+    int best = -1;
+    for (int i = 0; i < _count; ++i) {
+        const auto &entry = _entries[i];
+        if (best == -1 || entry.priority < _entries[best].priority) {
+            best = i;
+        } else if (entry.priority == _entries[best].priority &&
+            _runningStatus.length(entry.message) < entry.message.length() &&
+            _runningStatus.length(_entries[best].message) == _entries[best].message.length()) {
+            best = i;
+        }
+    }
+
+    if (best == -1) {
+        return false;
+    }
+
+    const auto &entry = _entries[best];
+    int length = _runningStatus.length(entry.message);
+
+    if (entry.priority == Priority::ControlChange && !forceControlChange && _credit < length * 1000) {
+        ++_stats.deferredControlChanges;
+        return false;
+    }
+
+    message = entry.message;
+    _credit -= length * 1000;
+    _runningStatus.update(message);
+    ++_stats.messages;
+    _stats.bytes += length;
+
+    std::copy(_entries.begin() + best + 1, _entries.begin() + _count, _entries.begin() + best);
+    --_count;
+
+    return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Config.h"
+
+#include "core/midi/MidiMessage.h"
+#include "core/midi/MidiRunningStatus.h"
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+
+#include <array>
+
+#include <cstdint>
+
+// Collects the midi messages of a single output port and releases them in priority order.
+// Note offs are sent first, followed by control messages (i.e. portamento) and note ons. The note off of a
+// legato note change is sent after the note ons, so the notes still overlap on the receiver. Messages of the
+// same priority are ordered to make use of running status. Continuous controller messages are merged
+// (only the latest value per controller is kept) and only sent if there is spare bandwidth on the port.
+// Bandwidth is tracked with a credit that refills at the port's byte rate and is used up by every
+// message sent, so the controller rate adapts to the note traffic.
+class MidiOutputScheduler {
+public:
+    enum class Priority : uint8_t {
+        NoteOff,
+        Control,
+        NoteOn,
+        LegatoNoteOff,  // note off of the previous note when changing notes without a gap
+        ControlChange,
+    };
+
+    struct Stats {
+        uint32_t messages = 0;
+        uint32_t bytes = 0;
+        uint32_t mergedControlChanges = 0;
+        uint32_t deferredControlChanges = 0;
+        uint32_t dropped = 0;
+    };
+
+    static constexpr int QueueSize = 4 * CONFIG_MIDI_OUTPUT_COUNT;
+
+    MidiOutputScheduler(uint32_t bytesPerSecond);
+
+    void reset();
+
+    // refills the bandwidth credit, called once per update before sending
+    void update(uint32_t ticks);
+
+    // queues a message of the given midi output (outputs can share a port)
+    void enqueue(const MidiMessage &message, Priority priority, int output = 0);
+
+    // drops all pending messages of the given midi output
+    void cancel(int output);
+
+    // returns the next message to send, returns false if the queue is empty or only
+    // control changes are left and there is not enough bandwidth (unless forced)
+    bool dequeue(MidiMessage &message, bool forceControlChange = false);
+
+    int pending() const { return _count; }
+
+    const Stats &stats() const { return _stats; }
+
+    // state snapshot, the time of the last update is stored relative to the given ticks (statistics are not included)
+    void writeState(VersionedSerializedWriter &writer, uint32_t ticks) const;
+    void readState(VersionedSerializedReader &reader, uint32_t ticks);
+
+private:
+    // maximum credit in bytes, limits controller bursts (and with it the delay of following notes)
+    static constexpr int32_t MaxCredit = 9;
+
+    struct Entry {
+        MidiMessage message;
+        Priority priority;
+        uint8_t output;
+    };
+
+    uint32_t _bytesPerSecond;
+    uint32_t _lastTicks = 0;
+    int32_t _credit = 0; // 1/1000 bytes
+    MidiRunningStatus _runningStatus;
+
+    std::array<Entry, QueueSize> _entries;
+    uint8_t _count = 0;
+
+    Stats _stats;
+};
@@ -12,7 +12,7 @@
 #include "model/Scale.h"
 #include "model/HarmonyEngine.h"
 
-static Random rng;
+static INSTANCE_LOCAL Random rng;
 
 // evaluate if step gate is active
 static bool evalStepGate(const NoteSequence::Step &step, int probabilityBias) {
@@ -237,8 +237,9 @@ TrackEngine::TickResult NoteTrackEngine::tick(uint32_t tick) {
         case Types::PlayMode::Aligned:
             if (relativeTick % divisor == 0) {
                 // Pulse count logic: Get current step's pulse count from sequence state
+                // the sequence state is at step -1 until the first advance after a reset
                 int currentStepIndex = _sequenceState.step();
-                int stepPulseCount = sequence.step(currentStepIndex).pulseCount();
+                int stepPulseCount = currentStepIndex >= 0 ? sequence.step(currentStepIndex).pulseCount() : 0;
 
                 // Increment pulse counter
                 _pulseCounter++;
@@ -263,8 +264,9 @@ TrackEngine::TickResult NoteTrackEngine::tick(uint32_t tick) {
             }
             if (relativeTick == 0) {
                 // Pulse count logic: Get current step's pulse count from sequence state
+                // the sequence state is at step -1 until the first advance after a reset
                 int currentStepIndex = _sequenceState.step();
-                int stepPulseCount = sequence.step(currentStepIndex).pulseCount();
+                int stepPulseCount = currentStepIndex >= 0 ? sequence.step(currentStepIndex).pulseCount() : 0;
 
                 // Increment pulse counter
                 _pulseCounter++;
@@ -343,6 +345,63 @@ TrackEngine::TickResult NoteTrackEngine::tick(uint32_t tick) {
     return result;
 }
 
+uint32_t NoteTrackEngine::seek(uint32_t tick, uint32_t endTick) {
+    NoteTrackEngine::tick(tick);
+
+    // linked tracks step whenever the linked track does
+    if (_linkedTrackEngine && _linkedTrackEngine->linkData()) {
+        update(0.001f);
+        return tick + 1;
+    }
+
+    // between steps only the queued gate and cv events change the state
+    const auto &sequence = *_sequence;
+    uint32_t divisor = sequence.divisor() * (CONFIG_PPQN / CONFIG_SEQUENCE_PPQN);
+    uint32_t resetDivisor = sequence.resetMeasure() * _engine.measureDivisor();
+    uint32_t nextTick = tick + 1;
+    uint32_t relativeTick = resetDivisor == 0 ? nextTick : nextTick % resetDivisor;
+
+    uint32_t seekTick = endTick;
+    if (resetDivisor != 0) {
+        seekTick = std::min(seekTick, nextTick + (resetDivisor - relativeTick) % resetDivisor);
+    }
+    switch (_noteTrack.playMode()) {
+    case Types::PlayMode::Aligned:
+        seekTick = std::min(seekTick, nextTick + (divisor - relativeTick % divisor) % divisor);
+        break;
+    case Types::PlayMode::Free:
+        // the free running counter wraps right away if the divisor was reduced
+        seekTick = std::min(seekTick, nextTick + (_freeRelativeTick == 0 ? 0 : (_freeRelativeTick < divisor ? divisor - _freeRelativeTick : 1)));
+        break;
+    case Types::PlayMode::Last:
+        break;
+    }
+    if (!_gateQueue.empty()) {
+        seekTick = std::min(seekTick, _gateQueue.front().tick);
+    }
+    if (!_cvQueue.empty()) {
+        seekTick = std::min(seekTick, _cvQueue.front().tick);
+    }
+
+    // the link data holds the relative tick of the last skipped tick
+    if (seekTick > nextTick) {
+        if (_noteTrack.playMode() == Types::PlayMode::Free) {
+            _freeRelativeTick += seekTick - nextTick;
+            _linkData.relativeTick = _freeRelativeTick - 1;
+            if (_freeRelativeTick >= divisor) {
+                _freeRelativeTick = 0;
+            }
+        } else {
+            _linkData.relativeTick = resetDivisor == 0 ? seekTick - 1 : (seekTick - 1) % resetDivisor;
+        }
+    }
+
+    // playback updates the track by 1ms on every tick and by the elapsed time in between
+    update((0.001f + _engine.clock().tickDuration()) * (seekTick - tick));
+
+    return seekTick;
+}
+
 void NoteTrackEngine::update(float dt) {
     bool running = _engine.state().running();
     bool recording = _engine.state().recording();
@@ -452,6 +511,60 @@ void NoteTrackEngine::setMonitorStep(int index) {
     }
 }
 
+void NoteTrackEngine::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_linkData.divisor);
+    writer.write(_linkData.relativeTick);
+    writer.write(_freeRelativeTick);
+    writer.write(_sequenceState);
+    writer.write(_currentStep);
+    writer.write(_prevCondition);
+    writer.write(_pulseCounter);
+    writer.write(_monitorStepIndex);
+    writer.write(_recordHistory);
+    writer.write(_monitorOverrideActive);
+    writer.write(_stepRecorder);
+    writer.write(_activity);
+    writer.write(_gateOutput);
+    writer.write(_cvOutput);
+    writer.write(_cvOutputTarget);
+    writer.write(_slideActive);
+    writer.write(_gateQueue);
+    writer.write(_cvQueue);
+}
+
+void NoteTrackEngine::readState(VersionedSerializedReader &reader) {
+    // select the sequences first, changing the pattern may clear the queues
+    changePattern();
+
+    reader.read(_linkData.divisor);
+    reader.read(_linkData.relativeTick);
+    _linkData.sequenceState = &_sequenceState;
+    reader.read(_freeRelativeTick);
+    reader.read(_sequenceState);
+    reader.read(_currentStep);
+    reader.read(_prevCondition);
+    reader.read(_pulseCounter);
+    reader.read(_monitorStepIndex);
+    reader.read(_recordHistory);
+    reader.read(_monitorOverrideActive);
+    reader.read(_stepRecorder);
+    reader.read(_activity);
+    reader.read(_gateOutput);
+    reader.read(_cvOutput);
+    reader.read(_cvOutputTarget);
+    reader.read(_slideActive);
+    reader.read(_gateQueue);
+    reader.read(_cvQueue);
+}
+
+void NoteTrackEngine::writeSharedState(VersionedSerializedWriter &writer) {
+    writer.write(rng);
+}
+
+void NoteTrackEngine::readSharedState(VersionedSerializedReader &reader) {
+    reader.read(rng);
+}
+
 void NoteTrackEngine::triggerStep(uint32_t tick, uint32_t divisor) {
     int octave = _noteTrack.octave();
     int transpose = _noteTrack.transpose();
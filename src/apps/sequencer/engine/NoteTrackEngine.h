@@ -47,6 +47,7 @@ public:
     virtual void update(float dt) override;
 
     virtual void changePattern() override;
+    virtual uint32_t seek(uint32_t tick, uint32_t endTick) override;
 
     virtual void monitorMidi(uint32_t tick, const MidiMessage &message) override;
     virtual void clearMidiMonitoring() override;
@@ -68,6 +69,14 @@ public:
 
     void setMonitorStep(int index);
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
+    // state shared by all note track engines
+    static void writeSharedState(VersionedSerializedWriter &writer);
+    static void readSharedState(VersionedSerializedReader &reader);
+
 private:
     void triggerStep(uint32_t tick, uint32_t divisor);
     void recordStep(uint32_t tick, uint32_t divisor);
@@ -1,7 +1,6 @@
 #include "RoutingEngine.h"
 
 #include "Engine.h"
-#include "MidiUtils.h"
 #include "core/math/Math.h"
 
 // Apply per-track bias/depth to the normalized source (0..1) before the route window is applied.
@@ -155,20 +154,44 @@ void RoutingEngine::resetShaperState() {
     }
 }
 
+void RoutingEngine::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_sourceValues);
+    writer.write(_routeStates);
+    writer.write(_lastPlayToggleActive);
+    writer.write(_lastRecordToggleActive);
+    writer.write(_lastTapTempoActive);
+    writer.write(_lastResetActive);
+}
+
+void RoutingEngine::readState(VersionedSerializedReader &reader) {
+    // the set of routed targets follows the route states
+    for (const auto &routeState : _routeStates) {
+        Routing::setRouted(routeState.target, routeState.tracks, false);
+    }
+
+    reader.read(_sourceValues);
+    reader.read(_routeStates);
+    reader.read(_lastPlayToggleActive);
+    reader.read(_lastRecordToggleActive);
+    reader.read(_lastTapTempoActive);
+    reader.read(_lastResetActive);
+
+    for (const auto &routeState : _routeStates) {
+        Routing::setRouted(routeState.target, routeState.tracks, true);
+    }
+}
+
 void RoutingEngine::update() {
     updateSources();
     updateSinks();
 }
 
-bool RoutingEngine::receiveMidi(MidiPort port, const MidiMessage &message) {
+bool RoutingEngine::receiveMidi(MidiPort port, const MidiMessage &message, uint16_t routes) {
     bool consumed = false;
 
-    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
-        const auto &route = _routing.route(routeIndex);
-        if (route.active() &&
-            route.source() == Routing::Source::Midi &&
-            MidiUtils::matchSource(port, message, route.midiSource().source())
-        ) {
+    for (int routeIndex = 0; routes != 0; ++routeIndex, routes >>= 1) {
+        if (routes & 1) {
+            const auto &route = _routing.route(routeIndex);
             const auto &midiSource = route.midiSource();
             auto &sourceValue = _sourceValues[routeIndex];
             switch (midiSource.event()) {
@@ -437,14 +460,11 @@ void RoutingEngine::writeEngineTarget(Routing::Target target, float normalized)
         }
         break;
     case Routing::Target::TapTempo:
-        {
-            static bool lastActive = false;
-            if (active != lastActive) {
-                if (active) {
-                    _engine.tapTempoTap();
-                }
-                lastActive = active;
+        if (active != _lastTapTempoActive) {
+            if (active) {
+                _engine.tapTempoTap();
             }
+            _lastTapTempoActive = active;
         }
         break;
     default:
@@ -20,10 +20,15 @@ public:
 
     void update();
 
-    bool receiveMidi(MidiPort port, const MidiMessage &message);
+    // handles a midi message for the given routes (see MidiInputDispatch)
+    bool receiveMidi(MidiPort port, const MidiMessage &message, uint16_t routes);
 
     void resetShaperState();
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
     struct RouteState {
         Routing::Target target = Routing::Target::None;
         uint8_t tracks = 0;
@@ -63,6 +68,7 @@ private:
 
     uint8_t _lastPlayToggleActive = false;
     uint8_t _lastRecordToggleActive = false;
+    uint8_t _lastTapTempoActive = false;
     std::array<uint8_t, CONFIG_TRACK_COUNT> _lastResetActive{};
 
     static float applyProgressiveDivider(float srcNormalized, RouteState::TrackState &st);
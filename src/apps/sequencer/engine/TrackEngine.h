@@ -76,6 +76,16 @@ public:
 
     virtual void changePattern() {}
 
+    // Fast-forward used by Engine::seek(). Processes `tick` like tick() followed by update(), then skips ahead to
+    // the next tick that needs to be processed and returns it (at most `endTick`). Skipped ticks must not consume
+    // random numbers shared with other tracks, which keeps the order in which the tracks draw them the same as
+    // when playing. The default implementation does not skip any ticks.
+    virtual uint32_t seek(uint32_t tick, uint32_t endTick) {
+        this->tick(tick);
+        update(0.001f);
+        return tick + 1;
+    }
+
     virtual bool receiveMidi(MidiPort port, const MidiMessage &message) { return false; }
     virtual void monitorMidi(uint32_t tick, const MidiMessage &message) {}
     virtual void clearMidiMonitoring() {}
@@ -337,6 +337,126 @@ void TuesdayTrackEngine::restart() {
     reset();
 }
 
+void TuesdayTrackEngine::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_rng);
+    writer.write(_extraRng);
+    writer.write(_uiRng);
+
+    writer.write(_cachedAlgorithm);
+    writer.write(_cachedFlow);
+    writer.write(_cachedOrnament);
+    writer.write(_cachedLoopLength);
+
+    writer.write(_stepIndex);
+    writer.write(_displayStep);
+    writer.write(_gateLength);
+    writer.write(_gateTicks);
+
+    writer.write(_coolDown);
+    writer.write(_coolDownMax);
+    writer.write(_microCoolDown);
+    writer.write(_microCoolDownMax);
+
+    writer.write(_gatePercent);
+    writer.write(_gateOffset);
+    writer.write(_microGateQueue);
+    writer.write(_tieActive);
+
+    writer.write(_retriggerCount);
+    writer.write(_retriggerPeriod);
+    writer.write(_retriggerLength);
+    writer.write(_retriggerTimer);
+    writer.write(_isTrillNote);
+    writer.write(_trillCvTarget);
+    writer.write(_retriggerArmed);
+
+    writer.write(_polySubStep);
+    writer.write(_polyAlgoActive);
+    writer.write(_ratchetInterval);
+
+    writer.write(_slide);
+    writer.write(_cvTarget);
+    writer.write(_cvCurrent);
+    writer.write(_cvDelta);
+    writer.write(_slideCountDown);
+
+    writer.write(_algoState);
+
+    writer.write(_activity);
+    writer.write(_gateOutput);
+    writer.write(_cvOutput);
+    writer.write(_lastGatedCv);
+
+    writer.write(_primeMaskCounter);
+    writer.write(_primeMaskState);
+    writer.write(_cachedPrimePattern);
+    writer.write(_cachedPrimeParam);
+    writer.write(_cachedTimeMode);
+    writer.write(_timeModeStartTick);
+    writer.write(_currentMaskArrayIndex);
+    writer.write(_cachedMaskProgression);
+}
+
+void TuesdayTrackEngine::readState(VersionedSerializedReader &reader) {
+    reader.read(_rng);
+    reader.read(_extraRng);
+    reader.read(_uiRng);
+
+    reader.read(_cachedAlgorithm);
+    reader.read(_cachedFlow);
+    reader.read(_cachedOrnament);
+    reader.read(_cachedLoopLength);
+
+    reader.read(_stepIndex);
+    reader.read(_displayStep);
+    reader.read(_gateLength);
+    reader.read(_gateTicks);
+
+    reader.read(_coolDown);
+    reader.read(_coolDownMax);
+    reader.read(_microCoolDown);
+    reader.read(_microCoolDownMax);
+
+    reader.read(_gatePercent);
+    reader.read(_gateOffset);
+    reader.read(_microGateQueue);
+    reader.read(_tieActive);
+
+    reader.read(_retriggerCount);
+    reader.read(_retriggerPeriod);
+    reader.read(_retriggerLength);
+    reader.read(_retriggerTimer);
+    reader.read(_isTrillNote);
+    reader.read(_trillCvTarget);
+    reader.read(_retriggerArmed);
+
+    reader.read(_polySubStep);
+    reader.read(_polyAlgoActive);
+    reader.read(_ratchetInterval);
+
+    reader.read(_slide);
+    reader.read(_cvTarget);
+    reader.read(_cvCurrent);
+    reader.read(_cvDelta);
+    reader.read(_slideCountDown);
+
+    reader.read(_algoState);
+
+    reader.read(_activity);
+    reader.read(_gateOutput);
+    reader.read(_cvOutput);
+    reader.read(_lastGatedCv);
+
+    reader.read(_primeMaskCounter);
+    reader.read(_primeMaskState);
+    reader.read(_cachedPrimePattern);
+    reader.read(_cachedPrimeParam);
+    reader.read(_cachedTimeMode);
+    reader.read(_timeModeStartTick);
+    reader.read(_currentMaskArrayIndex);
+    reader.read(_cachedMaskProgression);
+}
+
 void TuesdayTrackEngine::reseed() {
     // Reset step to beginning
     _stepIndex = 0;
@@ -1710,6 +1830,27 @@ TuesdayTrackEngine::TuesdayTickResult TuesdayTrackEngine::generateStep(uint32_t
     }
 }
 
+uint32_t TuesdayTrackEngine::startTicks(const TuesdaySequence &sequence) const {
+    uint32_t divisor = sequence.divisor() * (CONFIG_PPQN / CONFIG_SEQUENCE_PPQN);
+    uint32_t baseStartTicks = sequence.start() * divisor;
+
+    // Get mask parameter to possibly extend start delay
+    int maskParameter = sequence.maskParameter();
+    uint32_t extendedStartTicks = baseStartTicks;
+
+    // Only extend start delay if not in special states (ALL or NONE)
+    if (maskParameter > 0 && maskParameter < 15) {
+        // Map maskParameter 1-14 to array values to extend start delay
+        static const int MASK_VALUES[] = {2, 3, 5, 11, 19, 31, 43, 61, 89, 131, 197, 277, 409, 599};
+        const int MASK_COUNT = sizeof(MASK_VALUES) / sizeof(MASK_VALUES[0]);
+        int index = (maskParameter - 1) % MASK_COUNT;  // Adjust to 0-indexed array (for params 1-14)
+        int maskValue = MASK_VALUES[index];
+        extendedStartTicks += maskValue;
+    }
+
+    return extendedStartTicks;
+}
+
 TrackEngine::TickResult TuesdayTrackEngine::tick(uint32_t tick) {
     if (mute()) { _gateOutput=false; _cvOutput=0.f; _activity=false; return TickResult::NoUpdate; }
     
@@ -1730,21 +1871,7 @@ TrackEngine::TickResult TuesdayTrackEngine::tick(uint32_t tick) {
     uint32_t divisor = sequence.divisor() * (CONFIG_PPQN / CONFIG_SEQUENCE_PPQN);
 
     // Apply Start Delay with Mask Extension (Time Shift)
-    uint32_t baseStartTicks = sequence.start() * divisor;
-
-    // Get mask parameter to possibly extend start delay
-    int maskParameter = sequence.maskParameter();
-    uint32_t extendedStartTicks = baseStartTicks;
-
-    // Only extend start delay if not in special states (ALL or NONE)
-    if (maskParameter > 0 && maskParameter < 15) {
-        // Map maskParameter 1-14 to array values to extend start delay
-        static const int MASK_VALUES[] = {2, 3, 5, 11, 19, 31, 43, 61, 89, 131, 197, 277, 409, 599};
-        const int MASK_COUNT = sizeof(MASK_VALUES) / sizeof(MASK_VALUES[0]);
-        int index = (maskParameter - 1) % MASK_COUNT;  // Adjust to 0-indexed array (for params 1-14)
-        int maskValue = MASK_VALUES[index];
-        extendedStartTicks += maskValue;
-    }
+    uint32_t extendedStartTicks = startTicks(sequence);
 
     if (tick < extendedStartTicks) {
         _gateOutput = false;
@@ -2176,6 +2303,42 @@ TrackEngine::TickResult TuesdayTrackEngine::tick(uint32_t tick) {
     return TickResult::NoUpdate;
 }
 
+uint32_t TuesdayTrackEngine::seek(uint32_t tick, uint32_t endTick) {
+    TuesdayTrackEngine::tick(tick);
+    update(0.001f);
+
+    // gate timers, slides, ratchets and the prime mask count every tick
+    const auto &sequence = tuesdayTrack().sequence(pattern());
+    int maskParameter = sequence.maskParameter();
+    if (_gateTicks > 0 || _slideCountDown > 0 || _retriggerArmed || (maskParameter > 0 && maskParameter < 15 && !mute())) {
+        return tick + 1;
+    }
+
+    // otherwise nothing happens until the next step or queued micro gate
+    uint32_t seekTick = endTick;
+    if (!mute()) {
+        uint32_t divisor = sequence.divisor() * (CONFIG_PPQN / CONFIG_SEQUENCE_PPQN);
+        uint32_t extendedStartTicks = startTicks(sequence);
+        uint32_t nextTick = tick + 1;
+        if (nextTick < extendedStartTicks) {
+            seekTick = std::min(seekTick, extendedStartTicks);
+        } else {
+            int loopLength = sequence.actualLoopLength();
+            uint32_t resetDivisor = (loopLength > 0) ? (loopLength * divisor) : 0;
+            uint32_t relativeTick = nextTick - extendedStartTicks;
+            if (resetDivisor > 0) {
+                relativeTick %= resetDivisor;
+            }
+            seekTick = std::min(seekTick, nextTick + (divisor - relativeTick % divisor) % divisor);
+        }
+        if (!_microGateQueue.empty()) {
+            seekTick = std::min(seekTick, std::max(nextTick, _microGateQueue.front().tick + extendedStartTicks));
+        }
+    }
+
+    return seekTick;
+}
+
 void TuesdayTrackEngine::update(float dt) {
     // CV Slide Update
     if (_slideCountDown > 0) {
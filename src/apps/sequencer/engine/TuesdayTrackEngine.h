@@ -21,6 +21,7 @@ public:
     virtual void restart() override;
     virtual TickResult tick(uint32_t tick) override;
     virtual void update(float dt) override;
+    virtual uint32_t seek(uint32_t tick, uint32_t endTick) override;
 
     virtual bool activity() const override { return _activity; }
     virtual bool gateOutput(int index) const override { return _gateOutput; }
@@ -43,8 +44,13 @@ public:
     // Current step index for UI display
     int currentStep() const { return _displayStep; }
 
+    // state snapshot
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
 private:
     void initAlgorithm();
+    uint32_t startTicks(const TuesdaySequence &sequence) const;
     
     // The "Contract": Abstract step result from the generation engine
     struct TuesdayTickResult {
@@ -2,6 +2,9 @@
 
 #include "os/os.h"
 
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+
 #include <cstdint>
 
 template<uint32_t Interval>
@@ -9,13 +12,24 @@ class UpdateReducer {
 public:
     bool update() {
         uint32_t currentTick = os::ticks();
-        if (currentTick >= _lastUpdate + Interval) {
+        if (currentTick - _lastUpdate >= Interval) {
             _lastUpdate = currentTick;
             return true;
         }
         return false;
     }
 
+    // state snapshot, the time of the last update is stored relative to now
+    void writeState(VersionedSerializedWriter &writer) const {
+        writer.write(uint32_t(os::ticks() - _lastUpdate));
+    }
+
+    void readState(VersionedSerializedReader &reader) {
+        uint32_t elapsed;
+        reader.read(elapsed);
+        _lastUpdate = os::ticks() - elapsed;
+    }
+
 private:
     uint32_t _lastUpdate = 0;
 };
@@ -5,9 +5,9 @@
 
 #include "core/utils/Container.h"
 
-static Container<EuclideanGenerator, RandomGenerator> generatorContainer;
-static EuclideanGenerator::Params euclideanParams;
-static RandomGenerator::Params randomParams;
+static INSTANCE_LOCAL Container<EuclideanGenerator, RandomGenerator> generatorContainer;
+static INSTANCE_LOCAL EuclideanGenerator::Params euclideanParams;
+static INSTANCE_LOCAL RandomGenerator::Params randomParams;
 
 static void initLayer(SequenceBuilder &builder) {
     builder.clearLayer();
@@ -1,9 +1,13 @@
 #include "Accumulator.h"
+
+#include "SystemConfig.h"
 #include "core/utils/Random.h"
 #include "core/io/VersionedSerializedWriter.h"
 #include "core/io/VersionedSerializedReader.h"
 #include <algorithm> // For std::min and std::max
 
+static INSTANCE_LOCAL ::Random rng;  // Use global namespace to avoid naming conflict with enum
+
 Accumulator::Accumulator() :
     _mode(Track),
     _polarity(Unipolar),
@@ -88,8 +92,6 @@ void Accumulator::tickWithPendulum() const {
 void Accumulator::tickWithRandom() const {
     if (_direction == Freeze) return;
 
-    static ::Random rng;  // Use global namespace to avoid naming conflict with enum
-
     if (_minValue == _maxValue) {
         // If min equals max, just set to that value
         const_cast<Accumulator*>(this)->_currentValue = _minValue;
@@ -158,4 +160,12 @@ void Accumulator::read(VersionedSerializedReader &reader) {
     reader.read(flags2);
     _hasStarted = (flags2 & 0x01) != 0;
     _triggerMode = (flags2 >> 1) & 0x03;
+}
+
+void Accumulator::writeSharedState(VersionedSerializedWriter &writer) {
+    writer.write(rng);
+}
+
+void Accumulator::readSharedState(VersionedSerializedReader &reader) {
+    reader.read(rng);
 }
\ No newline at end of file
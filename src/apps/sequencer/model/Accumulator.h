@@ -51,6 +51,10 @@ public:
     void write(VersionedSerializedWriter &writer) const;
     void read(VersionedSerializedReader &reader);
 
+    // engine state snapshot of the random generator shared by all accumulators
+    static void writeSharedState(VersionedSerializedWriter &writer);
+    static void readSharedState(VersionedSerializedReader &reader);
+
 private:
     void tickWithWrap() const;
     void tickWithPendulum() const;
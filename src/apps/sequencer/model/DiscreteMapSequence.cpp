@@ -3,7 +3,7 @@
 #include "core/utils/Random.h"
 #include "os/os.h"
 
-static Random rng;
+static INSTANCE_LOCAL Random rng;
 
 //----------------------------------------
 // Stage
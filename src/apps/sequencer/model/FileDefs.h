@@ -11,6 +11,13 @@ enum class FileType : uint8_t {
     Settings    = 255
 };
 
+// Storage format of the data following the file header (stored in FileHeader::version)
+enum class FileFormat : uint8_t {
+    Raw         = 0,
+    Compressed  = 1,    // block compressed (see CompressedStream)
+    Last
+};
+
 struct FileHeader {
     static constexpr size_t NameLength = 8;
 
@@ -35,3 +42,60 @@ struct FileHeader {
 
 } __attribute__((packed));
 
+// Slot index file (e.g. PROJECTS/INDEX) holding the metadata of all slots of a file type.
+// Layout: SlotIndexHeader followed by SlotIndexHeader::SlotCount SlotIndexEntry records.
+
+struct SlotIndexHeader {
+    static constexpr uint32_t Magic = 0x58444953; // 'SIDX'
+    static constexpr uint8_t Version = 2;
+    static constexpr size_t SlotCount = 128;
+
+    uint32_t magic;
+    uint8_t version;
+    uint8_t slotCount;
+    uint16_t reserved;
+    uint32_t modification;
+
+    SlotIndexHeader() = default;
+
+    SlotIndexHeader(uint32_t modification) :
+        magic(Magic),
+        version(Version),
+        slotCount(SlotCount),
+        reserved(0),
+        modification(modification)
+    {}
+
+    bool valid() const {
+        return magic == Magic && version == Version && slotCount == SlotCount;
+    }
+
+} __attribute__((packed));
+
+struct SlotIndexEntry {
+    enum State : uint8_t {
+        Empty   = 0,    // no file
+        Used    = 1,    // file with valid header
+        Invalid = 2,    // file without valid header
+    };
+
+    State state;
+    char name[FileHeader::NameLength];
+    uint32_t version;
+    uint32_t size;
+    uint32_t modification;
+    uint32_t hash;
+    // modification date and time of the slot file (FAT format)
+    uint16_t date;
+    uint16_t time;
+
+    void clear() {
+        std::memset(this, 0, sizeof(*this));
+    }
+
+    void readName(char *name, size_t len) const {
+        std::memcpy(name, this->name, std::min(sizeof(this->name), len));
+        name[std::min(sizeof(this->name), len - 1)] = '\0';
+    }
+
+} __attribute__((packed));
@@ -1,7 +1,13 @@
 #include "FileManager.h"
 #include "ProjectVersion.h"
 
+#include "Config.h"
+
 #include "core/utils/StringBuilder.h"
+#include "core/hash/FnvHash.h"
+#include "core/io/SerializedHash.h"
+#include "core/io/CompressedWriter.h"
+#include "core/io/CompressedReader.h"
 #include "core/fs/FileSystem.h"
 #include "core/fs/FileWriter.h"
 #include "core/fs/FileReader.h"
@@ -12,15 +18,28 @@
 
 #include <cstring>
 
-uint32_t FileManager::_volumeState = 0;
-uint32_t FileManager::_nextVolumeStateCheckTicks = 0;
+INSTANCE_LOCAL uint32_t FileManager::_volumeState = 0;
+INSTANCE_LOCAL uint32_t FileManager::_nextVolumeStateCheckTicks = 0;
+
+INSTANCE_LOCAL std::array<FileManager::IndexState, 2> FileManager::_indexState;
+INSTANCE_LOCAL std::array<uint32_t, 2> FileManager::_indexModification;
+INSTANCE_LOCAL std::array<int, 2> FileManager::_indexRebuildSlot;
+
+INSTANCE_LOCAL std::array<FileManager::CachedSlotInfo, 2 * FileManager::IndexBlockSize> FileManager::_cachedSlotInfos;
+INSTANCE_LOCAL uint32_t FileManager::_cachedSlotInfoTicket = 0;
+INSTANCE_LOCAL std::array<int, 2> FileManager::_requestedSlot;
+
+// buffers for compressing/decompressing project files (only used from the file task)
+static INSTANCE_LOCAL CCMRAM_BSS CompressedStream::Workspace compressionWorkspace;
 
-std::array<FileManager::CachedSlotInfo, 4> FileManager::_cachedSlotInfos;
-uint32_t FileManager::_cachedSlotInfoTicket = 0;
+// serialized size of the last project read or written, estimates the progress of writing a project
+// (the size depends on the track modes, so it is exact when saving the project that was loaded)
+static INSTANCE_LOCAL size_t lastProjectSize = 0;
 
-FileManager::TaskExecuteCallback FileManager::_taskExecuteCallback;
-FileManager::TaskResultCallback FileManager::_taskResultCallback;
-volatile uint32_t FileManager::_taskPending;
+INSTANCE_LOCAL std::array<FileManager::Task, FileManager::TaskQueueSize> FileManager::_tasks;
+INSTANCE_LOCAL FileManager::TaskId FileManager::_nextTaskId = 1;
+INSTANCE_LOCAL volatile FileManager::TaskId FileManager::_runningTaskId = 0;
+INSTANCE_LOCAL volatile float FileManager::_taskProgress = -1.f;
 
 struct FileTypeInfo {
     const char *dir;
@@ -37,12 +56,143 @@ static void slotPath(StringBuilder &str, FileType type, int slot) {
     str("%s/%03d.%s", info.dir, slot + 1, info.ext);
 }
 
+static void indexPath(StringBuilder &str, FileType type) {
+    const auto &info = fileTypeInfos[int(type)];
+    str("%s/INDEX", info.dir);
+}
+
+static size_t indexEntryOffset(int slot) {
+    return sizeof(SlotIndexHeader) + slot * sizeof(SlotIndexEntry);
+}
+
+// returns the slot of a slot file name (i.e. 001.PRO) or -1 if name is not a slot file
+static int parseSlotName(const char *name, const char *ext) {
+    int slot = 0;
+    for (int i = 0; i < 3; ++i) {
+        if (name[i] < '0' || name[i] > '9') {
+            return -1;
+        }
+        slot = slot * 10 + name[i] - '0';
+    }
+    if (name[3] != '.' || std::strcmp(&name[4], ext) != 0 || slot < 1 || slot > FileManager::SlotCount) {
+        return -1;
+    }
+    return slot - 1;
+}
+
+// order independent signature of a slot file used to compare the index with the directory
+static uint32_t slotSignature(int slot, uint32_t size, uint16_t date, uint16_t time) {
+    FnvHash hash;
+    hash(&slot, sizeof(slot));
+    hash(&size, sizeof(size));
+    hash(&date, sizeof(date));
+    hash(&time, sizeof(time));
+    return hash.result();
+}
+
+// reads the index entry of a slot from the slot file itself
+static void scanSlot(const char *path, SlotIndexEntry &entry) {
+    entry.clear();
+
+    fs::File file(path, fs::File::Read);
+    if (file.error() != fs::OK) {
+        return;
+    }
+
+    entry.state = SlotIndexEntry::Invalid;
+    entry.size = file.size();
+
+    fs::FileInfo info;
+    if (fs::stat(path, info) == fs::OK) {
+        entry.date = info.date();
+        entry.time = info.time();
+    }
+
+    FileHeader header;
+    size_t lenRead;
+    if (file.read(&header, sizeof(header), &lenRead) != fs::OK || lenRead != sizeof(header)) {
+        return;
+    }
+
+    entry.state = SlotIndexEntry::Used;
+    std::memcpy(entry.name, header.name, sizeof(entry.name));
+
+    uint32_t version;
+
+    if (header.version == uint8_t(FileFormat::Compressed)) {
+        // the version is at the start of the first block
+        CompressedReader reader([&file] (void *data, size_t len) { file.read(data, len); }, compressionWorkspace);
+        if (reader.read(&version, sizeof(version)) == sizeof(version)) {
+            entry.version = version & SerializedHash::VersionMask;
+        }
+
+        // walk the block headers to find the last two blocks, only these are decompressed to get to
+        // the hash at the end (the last block may hold less than the hash)
+        size_t offset = sizeof(header);
+        size_t lastBlock = 0;
+        size_t previousBlock = 0;
+        while (true) {
+            uint16_t blockHeader;
+            if (file.seek(offset) != fs::OK || file.read(&blockHeader, sizeof(blockHeader), &lenRead) != fs::OK || lenRead != sizeof(blockHeader)) {
+                return;
+            }
+            size_t len = blockHeader & CompressedStream::LengthMask;
+            if (len == 0) {
+                break;
+            }
+            if (len > CompressedStream::BlockSize) {
+                return;
+            }
+            previousBlock = lastBlock;
+            lastBlock = offset;
+            offset += sizeof(blockHeader) + len;
+        }
+        if (lastBlock == 0 || file.seek(previousBlock != 0 ? previousBlock : lastBlock) != fs::OK) {
+            return;
+        }
+
+        // keep last bytes in a ring
+        CompressedReader tailReader([&file] (void *data, size_t len) { file.read(data, len); }, compressionWorkspace);
+        uint8_t buffer[64];
+        uint8_t tail[sizeof(entry.hash)];
+        size_t total = 0;
+        while (!tailReader.end() && !tailReader.error()) {
+            size_t len = tailReader.read(buffer, sizeof(buffer));
+            for (size_t i = 0; i < len; ++i) {
+                tail[total++ % sizeof(tail)] = buffer[i];
+            }
+        }
+        if (!tailReader.error() && total >= sizeof(tail)) {
+            uint8_t hash[sizeof(entry.hash)];
+            for (size_t i = 0; i < sizeof(hash); ++i) {
+                hash[i] = tail[(total + i) % sizeof(tail)];
+            }
+            std::memcpy(&entry.hash, hash, sizeof(entry.hash));
+        }
+        return;
+    }
+
+    if (file.read(&version, sizeof(version), &lenRead) == fs::OK && lenRead == sizeof(version)) {
+        entry.version = version & SerializedHash::VersionMask;
+    }
+
+    // serialized data ends with its hash
+    if (entry.size >= sizeof(header) + sizeof(version) + sizeof(entry.hash) && file.seek(entry.size - sizeof(entry.hash)) == fs::OK) {
+        file.read(&entry.hash, sizeof(entry.hash), &lenRead);
+    }
+}
+
 void FileManager::init() {
     _volumeState = 0;
     _nextVolumeStateCheckTicks = 0;
-    _taskExecuteCallback = nullptr;
-    _taskResultCallback = nullptr;
-    _taskPending = 0;
+    _tasks.fill(Task());
+    _runningTaskId = 0;
+    _taskProgress = -1.f;
+    _indexState.fill(IndexState::Unchecked);
+    _indexModification.fill(0);
+    _indexRebuildSlot.fill(0);
+    _requestedSlot.fill(-1);
+    invalidateAllSlots();
 }
 
 bool FileManager::volumeAvailable() {
@@ -55,6 +205,7 @@ bool FileManager::volumeMounted() {
 
 fs::Error FileManager::format() {
     invalidateAllSlots();
+    _indexState.fill(IndexState::Unchecked);
     return fs::volume().format();
 }
 
@@ -111,16 +262,40 @@ fs::Error FileManager::writeProject(const Project &project, const char *path) {
         return fileWriter.error();
     }
 
-    FileHeader header(FileType::Project, 0, project.name());
+    bool compressed = CONFIG_ENABLE_PROJECT_COMPRESSION;
+    FileFormat format = compressed ? FileFormat::Compressed : FileFormat::Raw;
+
+    FileHeader header(FileType::Project, uint8_t(format), project.name());
     fileWriter.write(&header, sizeof(header));
 
-    VersionedSerializedWriter writer(
+    size_t written = 0;
+
+    CompressedWriter compressedWriter(
         [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
-        ProjectVersion::Latest
+        compressionWorkspace
+    );
+
+    VersionedSerializedWriter writer(
+        [&] (const void *data, size_t len) {
+            written += len;
+            reportTaskProgress(written, lastProjectSize);
+            if (compressed) {
+                compressedWriter.write(data, len);
+            } else {
+                fileWriter.write(data, len);
+            }
+        },
+        ProjectVersion::Latest, true
     );
 
     project.write(writer);
 
+    if (compressed) {
+        compressedWriter.finish();
+    }
+
+    lastProjectSize = written;
+
     return fileWriter.finish();
 }
 
@@ -133,12 +308,35 @@ fs::Error FileManager::readProject(Project &project, const char *path) {
     FileHeader header;
     fileReader.read(&header, sizeof(header));
 
-    VersionedSerializedReader reader(
+    if (fileReader.error() == fs::OK && header.version >= uint8_t(FileFormat::Last)) {
+        return fs::INVALID_CHECKSUM;
+    }
+    bool compressed = header.version == uint8_t(FileFormat::Compressed);
+
+    CompressedReader compressedReader(
         [&fileReader] (void *data, size_t len) { fileReader.read(data, len); },
+        compressionWorkspace
+    );
+
+    size_t read = 0;
+
+    VersionedSerializedReader reader(
+        [&] (void *data, size_t len) {
+            read += len;
+            if (compressed) {
+                compressedReader.read(data, len);
+            } else {
+                fileReader.read(data, len);
+            }
+            reportTaskProgress(fileReader.position(), fileReader.size());
+        },
         ProjectVersion::Latest
     );
 
-    bool success = project.read(reader);
+    bool success = project.read(reader) && !compressedReader.error();
+    if (success) {
+        lastProjectSize = read;
+    }
 
     auto error = fileReader.finish();
     if (error == fs::OK && !success) {
@@ -159,7 +357,7 @@ fs::Error FileManager::writeUserScale(const UserScale &userScale, const char *pa
 
     VersionedSerializedWriter writer(
         [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
-        ProjectVersion::Latest
+        ProjectVersion::Latest, true
     );
 
     userScale.write(writer);
@@ -202,7 +400,7 @@ fs::Error FileManager::writeSettings(const Settings &settings, const char *path)
 
     VersionedSerializedWriter writer(
         [&fileWriter] (const void *data, size_t len) { fileWriter.write(data, len); },
-        Settings::Version
+        Settings::Version, true
     );
 
     settings.write(writer);
@@ -234,39 +432,56 @@ fs::Error FileManager::readSettings(Settings &settings, const char *path) {
     return error;
 }
 
-void FileManager::slotInfo(FileType type, int slot, SlotInfo &info) {
+bool FileManager::slotInfo(FileType type, int slot, SlotInfo &info) {
     if (cachedSlot(type, slot, info)) {
-        return;
+        return true;
+    }
+
+    {
+        os::InterruptLock lock;
+        _requestedSlot[int(type)] = slot;
     }
 
     info.used = false;
+    info.name[0] = '\0';
+    return false;
+}
 
-    FixedStringBuilder<32> path;
-    slotPath(path, type, slot);
+bool FileManager::slotUsed(FileType type, int slot) {
+    SlotInfo info;
+    return !slotInfo(type, slot, info) || info.used;
+}
 
-    if (fs::exists(path)) {
-        fs::File file(path, fs::File::Read);
-        FileHeader header;
-        size_t lenRead;
-        if (file.read(&header, sizeof(header), &lenRead) == fs::OK && lenRead == sizeof(header)) {
-            header.readName(info.name, sizeof(info.name));
-            info.used = true;
+FileManager::TaskId FileManager::task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback, TaskPriority priority) {
+    {
+        os::InterruptLock lock;
+        auto it = std::find_if(_tasks.begin(), _tasks.end(), [] (const Task &task) { return task.id == 0; });
+        if (it != _tasks.end()) {
+            TaskId id = _nextTaskId++;
+            if (_nextTaskId == 0) {
+                _nextTaskId = 1;
+            }
+            it->priority = priority;
+            it->executeCallback = std::move(executeCallback);
+            it->resultCallback = std::move(resultCallback);
+            it->id = id;
+            return id;
         }
     }
 
-    cacheSlot(type, slot, info);
+    resultCallback(fs::CANCELLED);
+    return 0;
 }
 
-bool FileManager::slotUsed(FileType type, int slot) {
-    SlotInfo info;
-    slotInfo(type, slot, info);
-    return info.used;
+bool FileManager::taskBusy() {
+    if (_runningTaskId != 0) {
+        return true;
+    }
+    return std::any_of(_tasks.begin(), _tasks.end(), [] (const Task &task) { return task.id != 0; });
 }
 
-void FileManager::task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback) {
-    _taskExecuteCallback = executeCallback;
-    _taskResultCallback = resultCallback;
-    _taskPending = 1;
+float FileManager::taskProgress() {
+    return _taskProgress;
 }
 
 void FileManager::processTask() {
@@ -284,18 +499,48 @@ void FileManager::processTask() {
             }
         } else {
             invalidateAllSlots();
+            _indexState.fill(IndexState::Unchecked);
         }
 
         _volumeState = newVolumeState;
     }
 
-    if (_taskPending) {
-        fs::Error result = _taskExecuteCallback();
-        _taskPending = 0;
-        _taskResultCallback(result);
+    // take the next task from the queue (task ids wrap around, so submission order is compared by distance)
+    Task task;
+    {
+        os::InterruptLock lock;
+        auto it = _tasks.end();
+        for (auto candidate = _tasks.begin(); candidate != _tasks.end(); ++candidate) {
+            if (candidate->id != 0 && (it == _tasks.end() ||
+                candidate->priority > it->priority ||
+                (candidate->priority == it->priority && int32_t(candidate->id - it->id) < 0))) {
+                it = candidate;
+            }
+        }
+        if (it != _tasks.end()) {
+            task = std::move(*it);
+            *it = Task();
+            _taskProgress = -1.f;
+            _runningTaskId = task.id;
+        }
+    }
+
+    if (task.id != 0) {
+        fs::Error result = task.executeCallback();
+        _runningTaskId = 0;
+        _taskProgress = -1.f;
+        task.resultCallback(result);
+        return;
+    }
+
+    // bring slot indices up to date
+    if (_volumeState & Mounted) {
+        processIndex();
     }
-}
 
+    // after index maintenance, which invalidates the slot cache when starting a rebuild
+    processSlotRequests();
+}
 
 fs::Error FileManager::writeFile(FileType type, int slot, std::function<fs::Error(const char *)> write) {
     const auto &info = fileTypeInfos[int(type)];
@@ -308,6 +553,10 @@ fs::Error FileManager::writeFile(FileType type, int slot, std::function<fs::Erro
 
     auto result = write(path);
     if (result == fs::OK) {
+        auto &indexState = _indexState[int(type)];
+        if (indexState != IndexState::Valid || updateIndex(type, slot) != fs::OK) {
+            indexState = IndexState::Stale;
+        }
         invalidateSlot(type, slot);
     }
 
@@ -350,7 +599,236 @@ fs::Error FileManager::readLastProject(int &slot) {
     return fileReader.finish();
 }
 
+void FileManager::reportTaskProgress(size_t done, size_t total) {
+    if (total > 0) {
+        _taskProgress = std::min(1.f, float(done) / total);
+    }
+}
+
+// Does one step of slot index maintenance (check or rebuild one block of slots).
+void FileManager::processIndex() {
+    for (auto type : { FileType::Project, FileType::UserScale }) {
+        auto &indexState = _indexState[int(type)];
+        switch (indexState) {
+        case IndexState::Unchecked:
+            checkIndex(type);
+            return;
+        case IndexState::Stale:
+            _indexRebuildSlot[int(type)] = 0;
+            indexState = IndexState::Rebuilding;
+            // fall through
+        case IndexState::Rebuilding:
+            if (rebuildIndex(type) != fs::OK) {
+                indexState = IndexState::Invalid;
+            } else if (_indexRebuildSlot[int(type)] >= SlotCount) {
+                indexState = IndexState::Valid;
+            }
+            return;
+        case IndexState::Valid:
+        case IndexState::Invalid:
+            break;
+        }
+    }
+}
+
+// Checks the slot index against the slot files in the directory and rebuilds it if missing or stale.
+// Only the presence, size and modification time of slot files is compared, which does not require
+// opening them.
+void FileManager::checkIndex(FileType type) {
+    const auto &typeInfo = fileTypeInfos[int(type)];
+    if (!fs::exists(typeInfo.dir)) {
+        fs::mkdir(typeInfo.dir);
+    }
+
+    uint32_t directorySignature = 0;
+    {
+        fs::Directory directory(typeInfo.dir);
+        while (directory.next()) {
+            int slot = parseSlotName(directory.info().name(), typeInfo.ext);
+            if (slot >= 0) {
+                const auto &info = directory.info();
+                directorySignature += slotSignature(slot, info.size(), info.date(), info.time());
+            }
+        }
+    }
+
+    FixedStringBuilder<32> path;
+    indexPath(path, type);
+
+    bool valid = false;
+    {
+        fs::FileReader fileReader(path);
+        SlotIndexHeader header;
+        if (fileReader.read(&header, sizeof(header)) == fs::OK && header.valid()) {
+            uint32_t indexSignature = 0;
+            for (int slot = 0; slot < SlotCount; ++slot) {
+                SlotIndexEntry entry;
+                if (fileReader.read(&entry, sizeof(entry)) != fs::OK) {
+                    break;
+                }
+                if (entry.state != SlotIndexEntry::Empty) {
+                    indexSignature += slotSignature(slot, entry.size, entry.date, entry.time);
+                }
+            }
+            valid = fileReader.finish() == fs::OK && indexSignature == directorySignature;
+            _indexModification[int(type)] = header.modification;
+        }
+    }
+
+    _indexState[int(type)] = valid ? IndexState::Valid : IndexState::Stale;
+}
+
+// Rebuilds the slot index by scanning all slot files.
+// Each call scans and appends one block of slots, starting at _indexRebuildSlot, so that only a
+// single file is open at any time and queued tasks are not delayed by a full rebuild.
+fs::Error FileManager::rebuildIndex(FileType type) {
+    int &firstSlot = _indexRebuildSlot[int(type)];
+
+    FixedStringBuilder<32> path;
+    indexPath(path, type);
+
+    uint32_t modification = _indexModification[int(type)];
+
+    if (firstSlot == 0) {
+        invalidateAllSlots();
+
+        fs::FileWriter fileWriter(path);
+        SlotIndexHeader header(modification);
+        fileWriter.write(&header, sizeof(header));
+        auto result = fileWriter.finish();
+        if (result != fs::OK) {
+            return result;
+        }
+    }
+
+    std::array<SlotIndexEntry, IndexBlockSize> entries;
+    for (int i = 0; i < IndexBlockSize; ++i) {
+        FixedStringBuilder<32> slotFile;
+        slotPath(slotFile, type, firstSlot + i);
+        scanSlot(slotFile, entries[i]);
+        entries[i].modification = modification;
+    }
+
+    fs::File file(path, fs::File::Append);
+    auto result = file.error();
+    if (result == fs::OK) {
+        result = file.writeAll(entries.data(), sizeof(entries));
+    }
+    if (result == fs::OK) {
+        result = file.close();
+    }
+    if (result == fs::OK) {
+        firstSlot += IndexBlockSize;
+    }
+
+    return result;
+}
+
+// Updates the index entry of a slot after its file was written.
+fs::Error FileManager::updateIndex(FileType type, int slot) {
+    FixedStringBuilder<32> path;
+    slotPath(path, type, slot);
+
+    SlotIndexEntry entry;
+    scanSlot(path, entry);
+    entry.modification = ++_indexModification[int(type)];
+
+    path.reset();
+    indexPath(path, type);
+
+    SlotIndexHeader header(entry.modification);
+
+    fs::File file(path, fs::File::ReadWrite);
+    auto result = file.error();
+    if (result == fs::OK) {
+        result = file.seek(indexEntryOffset(slot));
+    }
+    if (result == fs::OK) {
+        result = file.writeAll(&entry, sizeof(entry));
+    }
+    if (result == fs::OK) {
+        result = file.seek(0);
+    }
+    if (result == fs::OK) {
+        result = file.writeAll(&header, sizeof(header));
+    }
+    if (result == fs::OK) {
+        result = file.close();
+    }
+
+    return result;
+}
+
+// Reads slots requested by the ui into the slot cache.
+void FileManager::processSlotRequests() {
+    for (auto type : { FileType::Project, FileType::UserScale }) {
+        int slot;
+        {
+            os::InterruptLock lock;
+            slot = _requestedSlot[int(type)];
+            _requestedSlot[int(type)] = -1;
+        }
+        SlotInfo info;
+        if (slot >= 0 && !cachedSlot(type, slot, info)) {
+            loadSlot(type, slot);
+        }
+    }
+}
+
+// Reads a slot into the slot cache, from the index if valid and from the slot file otherwise.
+void FileManager::loadSlot(FileType type, int slot) {
+    SlotInfo info;
+    if (_indexState[int(type)] == IndexState::Valid && readIndex(type, slot) && cachedSlot(type, slot, info)) {
+        return;
+    }
+
+    info.used = false;
+
+    FixedStringBuilder<32> path;
+    slotPath(path, type, slot);
+
+    if (fs::exists(path)) {
+        fs::File file(path, fs::File::Read);
+        FileHeader header;
+        size_t lenRead;
+        if (file.read(&header, sizeof(header), &lenRead) == fs::OK && lenRead == sizeof(header)) {
+            header.readName(info.name, sizeof(info.name));
+            info.used = true;
+        }
+    }
+
+    cacheSlot(type, slot, info);
+}
+
+// Reads the block of index entries containing the given slot into the slot cache.
+bool FileManager::readIndex(FileType type, int slot) {
+    FixedStringBuilder<32> path;
+    indexPath(path, type);
+
+    int firstSlot = slot - slot % IndexBlockSize;
+    std::array<SlotIndexEntry, IndexBlockSize> entries;
+
+    fs::File file(path, fs::File::Read);
+    size_t lenRead;
+    if (file.error() != fs::OK ||
+        file.seek(indexEntryOffset(firstSlot)) != fs::OK ||
+        file.read(entries.data(), sizeof(entries), &lenRead) != fs::OK ||
+        lenRead != sizeof(entries)) {
+        return false;
+    }
+
+    for (int i = 0; i < IndexBlockSize; ++i) {
+        SlotInfo info;
+        info.used = entries[i].state == SlotIndexEntry::Used;
+        entries[i].readName(info.name, sizeof(info.name));
+        cacheSlot(type, firstSlot + i, info);
+    }
+
+    return true;
+}
+
 bool FileManager::cachedSlot(FileType type, int slot, SlotInfo &info) {
+    os::InterruptLock lock;
     for (auto &cachedSlotInfo : _cachedSlotInfos) {
         if (cachedSlotInfo.ticket != 0 && cachedSlotInfo.type == type && cachedSlotInfo.slot == slot) {
             info = cachedSlotInfo.info;
@@ -362,7 +840,13 @@ bool FileManager::cachedSlot(FileType type, int slot, SlotInfo &info) {
 }
 
 void FileManager::cacheSlot(FileType type, int slot, const SlotInfo &info) {
-    auto cachedSlotInfo = std::min_element(_cachedSlotInfos.begin(), _cachedSlotInfos.end());
+    os::InterruptLock lock;
+    auto cachedSlotInfo = std::find_if(_cachedSlotInfos.begin(), _cachedSlotInfos.end(), [type, slot] (const CachedSlotInfo &cachedSlotInfo) {
+        return cachedSlotInfo.ticket != 0 && cachedSlotInfo.type == type && cachedSlotInfo.slot == slot;
+    });
+    if (cachedSlotInfo == _cachedSlotInfos.end()) {
+        cachedSlotInfo = std::min_element(_cachedSlotInfos.begin(), _cachedSlotInfos.end());
+    }
     cachedSlotInfo->type = type;
     cachedSlotInfo->slot = slot;
     cachedSlotInfo->info = info;
@@ -370,6 +854,7 @@ void FileManager::cacheSlot(FileType type, int slot, const SlotInfo &info) {
 }
 
 void FileManager::invalidateSlot(FileType type, int slot) {
+    os::InterruptLock lock;
     for (auto &cachedSlotInfo : _cachedSlotInfos) {
         if (cachedSlotInfo.ticket != 0 && cachedSlotInfo.type == type && cachedSlotInfo.slot == slot) {
             cachedSlotInfo.ticket = 0;
@@ -378,6 +863,7 @@ void FileManager::invalidateSlot(FileType type, int slot) {
 }
 
 void FileManager::invalidateAllSlots() {
+    os::InterruptLock lock;
     for (auto &cachedSlotInfo : _cachedSlotInfos) {
         cachedSlotInfo.ticket = 0;
     }
@@ -39,20 +39,48 @@ public:
 
     // Slot information
 
+    static constexpr int SlotCount = SlotIndexHeader::SlotCount;
+
     struct SlotInfo {
         bool used;
         char name[FileHeader::NameLength + 1];
     };
 
-    static void slotInfo(FileType type, int slot, SlotInfo &info);
+    // Slot information is read by the file task and served from a cache, so the ui never accesses
+    // the file system. Returns false if the slot is not cached yet, it is then requested from the
+    // file task and info.used is false.
+    static bool slotInfo(FileType type, int slot, SlotInfo &info);
+    // Returns true if the slot is used or not known yet (so it is not overwritten without asking).
     static bool slotUsed(FileType type, int slot);
 
     // File tasks
+    //
+    // Tasks are queued and executed by the file task, highest priority first and in order of
+    // submission within the same priority. Slot index maintenance only runs in small steps while
+    // no task is queued, so a queued task is started within one file task period.
+
+    enum class TaskPriority : uint8_t {
+        Background,
+        Normal,         // saving
+        Interactive,    // loading, the user is waiting for the result
+    };
 
+    using TaskId = uint32_t;
     using TaskExecuteCallback = std::function<fs::Error(void)>;
     using TaskResultCallback = std::function<void(fs::Error)>;
 
-    static void task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback);
+    static constexpr int TaskQueueSize = 4;
+
+    // Queues a task and returns its id. If the queue is full, the result callback is called
+    // immediately with fs::CANCELLED and 0 is returned.
+    static TaskId task(TaskExecuteCallback executeCallback, TaskResultCallback resultCallback, TaskPriority priority = TaskPriority::Normal);
+
+    // Returns true if any task is queued or running.
+    static bool taskBusy();
+
+    // Returns the progress of the running task (0..1) or a negative value if not known.
+    static float taskProgress();
+
     static void processTask();
 
 private:
@@ -62,6 +90,19 @@ private:
     static fs::Error writeLastProject(int slot);
     static fs::Error readLastProject(int &slot);
 
+    static void reportTaskProgress(size_t done, size_t total);
+
+    // Slot index
+
+    static void processIndex();
+    static void checkIndex(FileType type);
+    static fs::Error rebuildIndex(FileType type);
+    static fs::Error updateIndex(FileType type, int slot);
+    static bool readIndex(FileType type, int slot);
+
+    static void processSlotRequests();
+    static void loadSlot(FileType type, int slot);
+
     static bool cachedSlot(FileType type, int slot, SlotInfo &info);
     static void cacheSlot(FileType type, int slot, const SlotInfo &info);
     static void invalidateSlot(FileType type, int slot);
@@ -84,13 +125,40 @@ private:
         Mounted     = (1<<1),
     };
 
-    static uint32_t _volumeState;
-    static uint32_t _nextVolumeStateCheckTicks;
+    static INSTANCE_LOCAL uint32_t _volumeState;
+    static INSTANCE_LOCAL uint32_t _nextVolumeStateCheckTicks;
+
+    enum class IndexState : uint8_t {
+        Unchecked,  // index needs to be checked against the directory
+        Stale,      // index needs to be rebuilt
+        Rebuilding, // index is rebuilt one block of slots at a time
+        Valid,
+        Invalid,    // index could not be written
+    };
+
+    // entries read from the slot index at once
+    static constexpr int IndexBlockSize = 8;
+
+    static INSTANCE_LOCAL std::array<IndexState, 2> _indexState;
+    static INSTANCE_LOCAL std::array<uint32_t, 2> _indexModification;
+    static INSTANCE_LOCAL std::array<int, 2> _indexRebuildSlot;
+
+    static INSTANCE_LOCAL std::array<CachedSlotInfo, 2 * IndexBlockSize> _cachedSlotInfos;
+    static INSTANCE_LOCAL uint32_t _cachedSlotInfoTicket;
+    // slot requested by the ui per file type (-1 if none)
+    static INSTANCE_LOCAL std::array<int, 2> _requestedSlot;
+
+    struct Task {
+        TaskId id = 0;  // 0 if unused
+        TaskPriority priority;
+        TaskExecuteCallback executeCallback;
+        TaskResultCallback resultCallback;
+    };
 
-    static std::array<CachedSlotInfo, 4> _cachedSlotInfos;
-    static uint32_t _cachedSlotInfoTicket;
+    static INSTANCE_LOCAL std::array<Task, TaskQueueSize> _tasks;
+    static INSTANCE_LOCAL TaskId _nextTaskId;
+    static INSTANCE_LOCAL volatile TaskId _runningTaskId;
+    static INSTANCE_LOCAL volatile float _taskProgress;
 
-    static TaskExecuteCallback _taskExecuteCallback;
-    static TaskResultCallback _taskResultCallback;
-    static volatile uint32_t _taskPending;
+    friend struct FileManagerTest;
 };
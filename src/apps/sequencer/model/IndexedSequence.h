@@ -110,11 +110,7 @@ public:
             _groupMask = 0;
         }
 
-        void write(VersionedSerializedWriter &writer) const {
-            writer.write(_packed);
-            writer.write(_groupMask);
-        }
-
+        // Used for data older than Version34, steps are stored as packed 64-bit words since.
         void read(VersionedSerializedReader &reader) {
             reader.read(_packed);
             reader.read(_groupMask);
@@ -123,8 +119,11 @@ public:
     private:
         uint32_t _packed = 0;      // Bit-packed: note(7) + duration(15) + gate(9) + slide(1)
         uint8_t _groupMask = 0;    // Groups A-D (bits 0-3)
+        uint8_t _reserved[3] = {}; // Explicit padding, keeps the stored step image deterministic
     };
 
+    static_assert(sizeof(Step) == 2 * sizeof(uint32_t), "Step must be packed for bulk serialization");
+
     //----------------------------------------
     // Route Configuration
     //----------------------------------------
@@ -495,9 +494,7 @@ public:
         _routeB.write(writer);
         writer.write(static_cast<uint8_t>(_routeCombineMode));
 
-        for (const auto &s : _steps) {
-            s.write(writer);
-        }
+        writePackedArray(writer, _steps);
     }
 
     void read(VersionedSerializedReader &reader) {
@@ -523,9 +520,7 @@ public:
         reader.read(mode);
         _routeCombineMode = ModelUtils::clampedEnum(static_cast<RouteCombineMode>(mode));
 
-        for (auto &s : _steps) {
-            s.read(reader);
-        }
+        readPackedArray(reader, _steps, ProjectVersion::Version34);
     }
     void setTrackIndex(int trackIndex) { _trackIndex = trackIndex; }
 
@@ -339,7 +339,7 @@ void NoteSequence::write(VersionedSerializedWriter &writer) const {
     writer.write(_firstStep.base);
     writer.write(_lastStep.base);
 
-    writeArray(writer, _steps);
+    writePackedArray(writer, _steps);
 
     // Write accumulator state (Version33+)
     _accumulator.write(writer);
@@ -373,7 +373,7 @@ void NoteSequence::read(VersionedSerializedReader &reader) {
     reader.read(_firstStep.base);
     reader.read(_lastStep.base);
 
-    readArray(reader, _steps);
+    readPackedArray(reader, _steps, ProjectVersion::Version27);
 
     // Read accumulator state (Version33+)
     _accumulator.read(reader);
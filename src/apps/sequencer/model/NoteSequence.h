@@ -361,6 +361,8 @@ public:
         } _data1;
     };
 
+    static_assert(sizeof(Step) == 2 * sizeof(uint32_t), "Step must be packed for bulk serialization");
+
     using StepArray = std::array<Step, CONFIG_STEP_COUNT>;
 
     //----------------------------------------
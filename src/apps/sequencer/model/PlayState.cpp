@@ -33,6 +33,9 @@ void PlayState::TrackState::read(VersionedSerializedReader &reader) {
 
 void PlayState::SongState::clear() {
     _state = 0;
+    _requestedSlot = 0;
+    _currentSlot = 0;
+    _currentRepeat = 0;
 }
 
 // PlayState
@@ -244,6 +247,26 @@ void PlayState::read(VersionedSerializedReader &reader) {
     notify(Immediate);
 }
 
+void PlayState::writeState(VersionedSerializedWriter &writer) const {
+    writer.write(_trackStates);
+    writer.write(_songState);
+    writer.write(_executeLatchedRequests);
+    writer.write(_hasImmediateRequests);
+    writer.write(_hasSyncedRequests);
+    writer.write(_hasLatchedRequests);
+    writer.write(_snapshot);
+}
+
+void PlayState::readState(VersionedSerializedReader &reader) {
+    reader.read(_trackStates);
+    reader.read(_songState);
+    reader.read(_executeLatchedRequests);
+    reader.read(_hasImmediateRequests);
+    reader.read(_hasSyncedRequests);
+    reader.read(_hasLatchedRequests);
+    reader.read(_snapshot);
+}
+
 void PlayState::selectTrackPatternUnsafe(int track, int pattern, ExecuteType executeType) {
     auto &trackState = _trackStates[track];
     trackState.setRequests(TrackState::patternRequestFromExecuteType(executeType));
@@ -310,6 +310,10 @@ public:
     void write(VersionedSerializedWriter &writer) const;
     void read(VersionedSerializedReader &reader);
 
+    // engine state snapshot, includes pending requests, song and snapshot state
+    void writeState(VersionedSerializedWriter &writer) const;
+    void readState(VersionedSerializedReader &reader);
+
     //----------------------------------------
     // Routing
     //----------------------------------------
@@ -189,13 +189,14 @@ bool Project::read(VersionedSerializedReader &reader) {
     reader.read(_rootNote);
     reader.read(_monitorMode, ProjectVersion::Version30);
     reader.read(_recordMode);
-    if (reader.dataVersion() >= ProjectVersion::Version29) {
-        reader.read(_midiInputMode);
-        _midiInputSource.read(reader);
-    }
     if (reader.dataVersion() >= ProjectVersion::Version32) {
+        reader.read(_midiInputMode);
         reader.read(_midiIntegrationMode);
         reader.read(_midiProgramOffset);
+        _midiInputSource.read(reader);
+    } else if (reader.dataVersion() >= ProjectVersion::Version29) {
+        reader.read(_midiInputMode);
+        _midiInputSource.read(reader);
     }
     reader.read(_cvGateInput, ProjectVersion::Version6);
     reader.read(_curveCvInput, ProjectVersion::Version11);
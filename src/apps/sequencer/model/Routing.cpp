@@ -112,13 +112,7 @@ void Routing::Route::read(VersionedSerializedReader &reader) {
     for (int i = 0; i < CONFIG_TRACK_COUNT; ++i) {
         reader.read(_biasPct[i]);
         reader.read(_depthPct[i]);
-    }
-
-    for (int i = 0; i < CONFIG_TRACK_COUNT; ++i) {
         reader.read(_creaseEnabled[i]);
-    }
-
-    for (int i = 0; i < CONFIG_TRACK_COUNT; ++i) {
         reader.read(_shaper[i]);
     }
     reader.read(_source);
@@ -300,7 +294,7 @@ void Routing::read(VersionedSerializedReader &reader) {
     readArray(reader, _routes);
 }
 
-static std::array<uint8_t, size_t(Routing::Target::Last)> routedSet;
+static INSTANCE_LOCAL std::array<uint8_t, size_t(Routing::Target::Last)> routedSet;
 static_assert(sizeof(uint8_t) * 8 >= CONFIG_TRACK_COUNT, "track bits do not fit");
 
 bool Routing::isRouted(Target target, int trackIndex) {
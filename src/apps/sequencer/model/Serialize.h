@@ -4,6 +4,7 @@
 #include "core/io/VersionedSerializedReader.h"
 
 #include <array>
+#include <type_traits>
 
 #include <cstdlib>
 #include <cstdint>
@@ -35,3 +36,27 @@ static void readArray(VersionedSerializedReader &reader, std::array<uint8_t, N>
         reader.read(array[i]);
     }
 }
+
+// Packed arrays are serialized as their in-memory image with a single write/read call. This is only
+// valid for trivially copyable elements without implicit padding on a little endian target (the
+// byte order used by all stored data). Data older than packedInVersion is read element by element.
+
+template<typename T, size_t N>
+static void writePackedArray(VersionedSerializedWriter &writer, const std::array<T, N> &array) {
+    static_assert(std::is_trivially_copyable<T>::value, "packed array element must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "packed array element must be word sized");
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "packed arrays require a little endian target");
+    writer.write(array.data(), sizeof(T) * N);
+}
+
+template<typename T, size_t N>
+static void readPackedArray(VersionedSerializedReader &reader, std::array<T, N> &array, uint32_t packedInVersion) {
+    static_assert(std::is_trivially_copyable<T>::value, "packed array element must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "packed array element must be word sized");
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "packed arrays require a little endian target");
+    if (reader.dataVersion() >= packedInVersion) {
+        reader.read(array.data(), sizeof(T) * N, packedInVersion);
+    } else {
+        readArray(reader, array);
+    }
+}
@@ -39,7 +39,7 @@ void Settings::writeToFlash() const {
 
     VersionedSerializedWriter writer(
         [&flashWriter] (const void *data, size_t len) { flashWriter.write(data, len); },
-        Version
+        Version, true
     );
 
     write(writer);
@@ -1,7 +1,7 @@
 #include "UserScale.h"
 #include "ProjectVersion.h"
 
-UserScale::Array UserScale::userScales;
+INSTANCE_LOCAL UserScale::Array UserScale::userScales;
 
 UserScale::UserScale() :
     Scale("")
@@ -42,8 +42,14 @@ bool UserScale::read(VersionedSerializedReader &reader) {
     reader.read(_mode);
     reader.read(_size);
 
+    // corrupted data is rejected by the hash check, but must not be used to index the items before that
+    _name[NameLength] = '\0';
+    _mode = ModelUtils::clampedEnum(_mode);
+    setSize(_size);
+
     for (int i = 0; i < _size; ++i) {
         reader.read(_items[i]);
+        setItem(i, _items[i]);
     }
 
     bool success = reader.checkHash();
@@ -195,7 +195,7 @@ public:
         return _mode == Mode::Chromatic ? _size : _size - 1;
     }
 
-    static Array userScales;
+    static INSTANCE_LOCAL Array userScales;
 
 private:
     void noteNameChromaticMode(StringBuilder &str, int note, int rootNote, Format format) const {
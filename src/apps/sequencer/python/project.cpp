@@ -1,6 +1,8 @@
 #include "model/Project.h"
 #include "model/ProjectVersion.h"
 
+#include "core/io/CompressedReader.h"
+
 #include <pybind11/pybind11.h>
 
 #include <string>
@@ -19,12 +21,26 @@ static void loadProject(Project &project, const std::string &filename) {
     FileHeader header;
     ifs.read(reinterpret_cast<char *>(&header), sizeof(header));
 
-    VersionedSerializedReader reader(
+    bool compressed = header.version == uint8_t(FileFormat::Compressed);
+
+    static INSTANCE_LOCAL CompressedStream::Workspace workspace;
+    CompressedReader compressedReader(
         [&ifs] (void *data, size_t len) { ifs.read(reinterpret_cast<char *>(data), len); },
+        workspace
+    );
+
+    VersionedSerializedReader reader(
+        [&] (void *data, size_t len) {
+            if (compressed) {
+                compressedReader.read(data, len);
+            } else {
+                ifs.read(reinterpret_cast<char *>(data), len);
+            }
+        },
         ProjectVersion::Latest
     );
 
-    if (!project.read(reader)) {
+    if (!project.read(reader) || compressedReader.error()) {
         throw std::runtime_error("Failed to load project");
     }
 }
@@ -40,7 +56,7 @@ static void saveProject(const Project &project, const std::string &filename) {
 
     VersionedSerializedWriter writer(
         [&ofs] (const void *data, size_t len) { ofs.write(reinterpret_cast<const char *>(data), len); },
-        ProjectVersion::Latest
+        ProjectVersion::Latest, true
     );
 
     project.write(writer);
@@ -1,29 +1,93 @@
 #include "sim/Simulator.h"
+#include "sim/TargetUtils.h"
 
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 
 namespace py = pybind11;
+using namespace py::literals;
 
 using namespace sim;
 
+// A simulator must only be used from the thread it was created on (see Simulator), which also makes
+// it safe to release the GIL while it runs.
+Simulator &checkThread(Simulator &simulator) {
+    if (!simulator.pinnedToCallingThread()) {
+        throw std::runtime_error("simulator used from a different thread than it was created on");
+    }
+    return simulator;
+}
+
+template<typename... Args>
+static std::function<void(Simulator &, Args...)> pinned(void (Simulator::*method)(Args...)) {
+    return [method] (Simulator &simulator, Args... args) {
+        (checkThread(simulator).*method)(args...);
+    };
+}
+
+// Runs the simulator natively for the given number of ticks (1 tick = 1 ms) and returns the output
+// for each tick as numpy arrays: dac values (ticks x channels), gate bitmasks (ticks) and a structured
+// array of midi output messages.
+static py::dict render(Simulator &simulator, int ticks) {
+    if (ticks < 0) {
+        throw std::invalid_argument("ticks must not be negative");
+    }
+
+    checkThread(simulator);
+
+    uint32_t tick = simulator.ticks();
+    py::array_t<uint16_t> dac({ ticks, TargetConfig::DacChannels });
+    py::array_t<uint8_t> gates(ticks);
+    std::vector<Simulator::RenderedMidiMessage> midi;
+
+    uint16_t *dacData = dac.mutable_data();
+    uint8_t *gatesData = gates.mutable_data();
+    {
+        py::gil_scoped_release release;
+        simulator.render(ticks, dacData, gatesData, &midi);
+    }
+
+    py::array_t<Simulator::RenderedMidiMessage> midiArray(midi.size());
+    std::copy(midi.begin(), midi.end(), midiArray.mutable_data());
+
+    return py::dict("tick"_a = tick, "dac"_a = dac, "gates"_a = gates, "midi"_a = midiArray);
+}
+
 void register_simulator(py::module &m) {
+    PYBIND11_NUMPY_DTYPE(Simulator::RenderedMidiMessage, tick, port, length, data);
+
     // ------------------------------------------------------------------------
     // Simulator
     // ------------------------------------------------------------------------
 
     py::class_<Simulator> simulator(m, "Simulator", py::dynamic_attr());
     simulator
-        .def("wait", &Simulator::wait)
-        .def("setButton", &Simulator::setButton)
-        .def("setEncoder", &Simulator::setEncoder)
-        .def("rotateEncoder", &Simulator::rotateEncoder)
-        .def("setAdc", &Simulator::setAdc)
-        .def("setDio", &Simulator::setDio)
-        .def("sendMidi", &Simulator::sendMidi)
-        .def("screenshot", &Simulator::screenshot)
-        .def_property_readonly("targetState", &Simulator::targetState, py::return_value_policy::reference)
+        // release the GIL while simulating so environments can run on multiple threads
+        .def("wait", [] (Simulator &simulator, int ms) {
+            checkThread(simulator);
+            py::gil_scoped_release release;
+            simulator.wait(ms);
+        })
+        .def("setButton", pinned(&Simulator::setButton))
+        .def("setEncoder", pinned(&Simulator::setEncoder))
+        .def("rotateEncoder", pinned(&Simulator::rotateEncoder))
+        .def("setAdc", pinned(&Simulator::setAdc))
+        .def("setDio", pinned(&Simulator::setDio))
+        .def("sendMidi", pinned(&Simulator::sendMidi))
+        .def("screenshot", pinned(&Simulator::screenshot))
+        .def("render", &render, py::arg("ticks"))
+        .def_property_readonly("targetState", [] (Simulator &simulator) -> const TargetState & {
+            return checkThread(simulator).targetState();
+        }, py::return_value_policy::reference)
     ;
 
+    // converts raw dac values (scalars or arrays) to voltages
+    m.def("dacToVoltage", py::vectorize([] (uint16_t value) { return dacToVoltage(value); }));
+
     // ------------------------------------------------------------------------
     // TargetTrace
     // ------------------------------------------------------------------------
@@ -3,14 +3,25 @@
 
 #include <pybind11/pybind11.h>
 
+#include <stdexcept>
+#include <string>
+
 namespace py = pybind11;
 
 void register_core(py::module &m);
 void register_simulator(py::module &m);
 void register_sequencer(py::module &m);
 
+sim::Simulator &checkThread(sim::Simulator &simulator);
+
+// A sequencer running in its own simulator. The application state exists once per thread, so there can
+// only be one environment per thread and it must only be used from the thread it was created on.
+// The SD card is kept in memory unless a disk image is given.
 struct Environment {
-    Environment() {
+    Environment(const std::string &sdCardImage) {
+        if (sim::Simulator::current()) {
+            throw std::runtime_error("only one environment per thread");
+        }
         simulator.reset(new sim::Simulator({
             .create = [this] () {
                 sequencer.reset(new SequencerApp());
@@ -22,6 +33,7 @@ struct Environment {
                 sequencer->update();
             }
         }));
+        simulator->setSdCardImage(sdCardImage);
     }
 
     std::unique_ptr<SequencerApp> sequencer;
@@ -45,12 +57,13 @@ PYBIND11_MODULE(testsim, m) {
 
     py::class_<Environment> environment(m, "Environment", py::dynamic_attr());
     environment
-        .def(py::init<>())
+        .def(py::init<const std::string &>(), py::arg("sdcard") = "")
 
         .def_property_readonly("simulator", [] (Environment &env) {
-            return env.simulator.get();
+            return &checkThread(*env.simulator);
         })
         .def_property_readonly("sequencer", [] (Environment &env) {
+            checkThread(*env.simulator);
             return env.sequencer.get();
         })
     ;
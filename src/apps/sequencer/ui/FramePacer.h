@@ -0,0 +1,83 @@
+#pragma once
+
+#include "os/os.h"
+
+#include <algorithm>
+
+#include <cstdint>
+
+// Adapts the ui frame rate to the engine load.
+// While the engine update takes a large part of its 1ms period or falls behind on clock ticks,
+// the frame rate is halved (down to a quarter) and led updates are only done together with frames.
+// Full rate is restored one step at a time once the load stayed low for a while.
+class FramePacer {
+public:
+    static constexpr uint32_t HighLoadTime = 500;   // us
+    static constexpr uint32_t LowLoadTime = 250;    // us
+    static constexpr uint32_t HighTickBacklog = 1;
+    static constexpr int MaxLevel = 2;
+    static constexpr int MinFps = 10;
+
+    struct Stats {
+        int fps;
+        uint32_t frames;
+        uint32_t skippedFrames;
+        uint32_t deferredLedUpdates;
+    };
+
+    // updates the load level from the engine load, called on every ui update
+    void update(uint32_t engineUpdateTime, uint32_t tickBacklog, uint32_t ticks) {
+        bool highLoad = engineUpdateTime >= HighLoadTime || tickBacklog > HighTickBacklog;
+        bool lowLoad = engineUpdateTime < LowLoadTime && tickBacklog <= HighTickBacklog;
+
+        if (highLoad) {
+            if (_level < MaxLevel && ticks - _levelTicks >= os::time::ms(RaiseInterval)) {
+                ++_level;
+                _levelTicks = ticks;
+            }
+            _lowLoadTicks = ticks;
+        } else if (!lowLoad) {
+            _lowLoadTicks = ticks;
+        } else if (_level > 0 && ticks - _lowLoadTicks >= os::time::ms(RestoreInterval)) {
+            --_level;
+            _levelTicks = ticks;
+            _lowLoadTicks = ticks;
+        }
+    }
+
+    // frame rate to use for the given target frame rate
+    int fps(int targetFps) {
+        _targetFps = targetFps;
+        _stats.fps = std::max(std::min(targetFps, int(MinFps)), targetFps >> _level);
+        return _stats.fps;
+    }
+
+    // returns true if leds should be updated, while loaded only with frames
+    bool updateLeds(bool frame) {
+        if (_level == 0 || frame) {
+            return true;
+        }
+        ++_stats.deferredLedUpdates;
+        return false;
+    }
+
+    // called for every frame drawn, counts the frames that were skipped at the current level
+    void frameDrawn() {
+        ++_stats.frames;
+        _stats.skippedFrames += _targetFps / _stats.fps - 1;
+    }
+
+    int level() const { return _level; }
+
+    const Stats &stats() const { return _stats; }
+
+private:
+    static constexpr uint32_t RaiseInterval = 100;    // ms
+    static constexpr uint32_t RestoreInterval = 1000; // ms
+
+    int _level = 0;
+    int _targetFps = 1;
+    uint32_t _levelTicks = 0;
+    uint32_t _lowLoadTicks = 0;
+    Stats _stats = { 1, 0, 0, 0 };
+};
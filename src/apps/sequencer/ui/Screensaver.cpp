@@ -3,7 +3,7 @@
 void Screensaver::on(uint8_t gates) {
     _screenSaved = true;
     //_canvas.screensaver();
-    static uint32_t lastTicks = 0;
+    static INSTANCE_LOCAL uint32_t lastTicks = 0;
     uint32_t currentTicks = os::ticks();
     float dt = float(currentTicks - lastTicks) / os::time::ms(1000);
     lastTicks = currentTicks;
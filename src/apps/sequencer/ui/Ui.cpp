@@ -18,7 +18,7 @@ Ui::Ui(Model &model, Engine &engine, Lcd &lcd, ButtonLedMatrix &blm, Encoder &en
         _frameBuffer(CONFIG_LCD_WIDTH, CONFIG_LCD_HEIGHT, _frameBufferData),
         _canvas(_frameBuffer, settings.userSettings().get<BrightnessSetting>(SettingBrightness)->getValue()),
         _pageManager(_pages),
-        _pageContext({ _messageManager, _pageKeyState, _globalKeyState, _model, _engine }),
+        _pageContext({ _messageManager, _pageKeyState, _globalKeyState, _model, _engine, _framePacer }),
         _pages(_pageManager, _pageContext),
         _controllerManager(model, engine),
         // TODO pass as arg
@@ -82,14 +82,19 @@ void Ui::update() {
         return;
     }
 
-    _leds.clear();
-    _pageManager.updateLeds(_leds);
-    _blm.setLeds(_leds.array());
-
-    // update display at target fps
+    // update display at target fps, reduced while the engine is busy
     uint32_t currentTicks = os::ticks();
-    uint32_t intervalTicks = os::time::ms(1000 / _pageManager.fps());
-    if (currentTicks - _lastFrameBufferUpdateTicks >= intervalTicks) {
+    _framePacer.update(_engine.updateTime(), _engine.tickBacklog(), currentTicks);
+    uint32_t intervalTicks = os::time::ms(1000 / _framePacer.fps(_pageManager.fps()));
+    bool drawFrame = currentTicks - _lastFrameBufferUpdateTicks >= intervalTicks;
+
+    if (_framePacer.updateLeds(drawFrame)) {
+        _leds.clear();
+        _pageManager.updateLeds(_leds);
+        _blm.setLeds(_leds.array());
+    }
+
+    if (drawFrame) {
         _screensaver.incScreenOnTicks(intervalTicks);
         if (!_screensaver.shouldBeOn()) {
             _pageManager.draw(_canvas);
@@ -99,6 +104,7 @@ void Ui::update() {
             _screensaver.on(_engine.gateOutput());
         }
         _lcd.draw(_frameBuffer.data());
+        _framePacer.frameDrawn();
         _lastFrameBufferUpdateTicks += intervalTicks;
     }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Config.h"
+#include "FramePacer.h"
 #include "MessageManager.h"
 #include "Page.h"
 #include "PageManager.h"
@@ -55,10 +56,11 @@ private:
     };
     RingBuffer<ReceiveMidiEvent, 16> _receiveMidiEvents;
 
-    uint8_t _frameBufferData[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT];
-    FrameBuffer8bit _frameBuffer;
+    uint8_t _frameBufferData[CONFIG_LCD_WIDTH * CONFIG_LCD_HEIGHT / 2];
+    FrameBuffer4bit _frameBuffer;
     Canvas _canvas;
     uint32_t _lastFrameBufferUpdateTicks;
+    FramePacer _framePacer;
 
     KeyState _pageKeyState;
     KeyState _globalKeyState;
@@ -796,6 +796,7 @@ LaunchpadController::Color LaunchpadController::stepColor(bool active, bool curr
 }
 
 void LaunchpadController::drawNoteSequenceBits(const NoteSequence &sequence, NoteSequence::Layer layer, int currentStep) {
+    _device->setPriorityCol(currentStep >= 0 ? currentStep % 8 : -1);
     for (int row = 0; row < 8; ++row) {
         for (int col = 0; col < 8; ++col) {
             int stepIndex = row * 8 + col;
@@ -806,6 +807,7 @@ void LaunchpadController::drawNoteSequenceBits(const NoteSequence &sequence, Not
 }
 
 void LaunchpadController::drawNoteSequenceBars(const NoteSequence &sequence, NoteSequence::Layer layer, int currentStep) {
+    setPlayheadCol(currentStep);
     for (int col = 0; col < 8; ++col) {
         int stepIndex = col + _sequence.navigation.col * 8;
         const auto &step = sequence.step(stepIndex);
@@ -814,6 +816,7 @@ void LaunchpadController::drawNoteSequenceBars(const NoteSequence &sequence, Not
 }
 
 void LaunchpadController::drawNoteSequenceDots(const NoteSequence &sequence, NoteSequence::Layer layer, int currentStep) {
+    setPlayheadCol(currentStep);
     int ofs = _sequence.navigation.row * 8;
     for (int col = 0; col < 8; ++col) {
         int stepIndex = col + _sequence.navigation.col * 8;
@@ -824,6 +827,7 @@ void LaunchpadController::drawNoteSequenceDots(const NoteSequence &sequence, Not
 }
 
 void LaunchpadController::drawNoteSequenceNotes(const NoteSequence &sequence, NoteSequence::Layer layer, int currentStep) {
+    setPlayheadCol(currentStep);
     int ofs = _sequence.navigation.row * 8;
 
     // draw octave lines
@@ -845,6 +849,7 @@ void LaunchpadController::drawNoteSequenceNotes(const NoteSequence &sequence, No
 }
 
 void LaunchpadController::drawCurveSequenceBars(const CurveSequence &sequence, CurveSequence::Layer layer, int currentStep) {
+    setPlayheadCol(currentStep);
     for (int col = 0; col < 8; ++col) {
         int stepIndex = col + _sequence.navigation.col * 8;
         const auto &step = sequence.step(stepIndex);
@@ -853,6 +858,7 @@ void LaunchpadController::drawCurveSequenceBars(const CurveSequence &sequence, C
 }
 
 void LaunchpadController::drawCurveSequenceDots(const CurveSequence &sequence, CurveSequence::Layer layer, int currentStep) {
+    setPlayheadCol(currentStep);
     auto rangeMap = curveSequenceLayerRangeMap[int(_project.selectedCurveSequenceLayer())];
     int ofs = _sequence.navigation.row * 8;
     for (int col = 0; col < 8; ++col) {
@@ -866,6 +872,12 @@ void LaunchpadController::drawCurveSequenceDots(const CurveSequence &sequence, C
     }
 }
 
+void LaunchpadController::setPlayheadCol(int currentStep) {
+    // leds of the playhead column are synced first
+    int col = currentStep - _sequence.navigation.col * 8;
+    _device->setPriorityCol(currentStep >= 0 && col >= 0 && col < 8 ? col : -1);
+}
+
 void LaunchpadController::drawBar(int col, int value, bool active, bool current) {
     int ofs = _sequence.navigation.row * 8;
     if (value >= 0) {
@@ -145,6 +145,7 @@ private:
     void drawCurveSequenceBars(const CurveSequence &sequence, CurveSequence::Layer layer, int currentStep);
     void drawCurveSequenceDots(const CurveSequence &sequence, CurveSequence::Layer layer, int currentStep);
     void drawBar(int row, int value, bool active, bool current);
+    void setPlayheadCol(int currentStep);
 
     // Led handling
     void setGridLed(int row, int col, Color color);
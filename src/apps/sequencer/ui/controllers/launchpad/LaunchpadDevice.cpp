@@ -1,5 +1,9 @@
 #include "LaunchpadDevice.h"
 
+#include <algorithm>
+
+#include <cstring>
+
 //  +---+---+---+---+---+---+---+---+
 //  |104|105|106|107|108|109|110|111| < CC messages
 //  +---+---+---+---+---+---+---+---+
@@ -50,35 +54,111 @@ void LaunchpadDevice::recvMidi(uint8_t cable, const MidiMessage &message) {
 }
 
 void LaunchpadDevice::syncLeds() {
-    // grid
-    for (int row = 0; row < Rows; ++row) {
-        for (int col = 0; col < Cols; ++col) {
-            int index = row * Cols + col;
+    // collect changed leds, leds in the priority column first
+    std::array<uint8_t, ButtonCount> indices;
+    int count = 0;
+    bool hasPriorityCol = _priorityCol >= 0 && _priorityCol < Cols;
+    if (hasPriorityCol) {
+        for (int row = 0; row < Rows; ++row) {
+            int index = row * Cols + _priorityCol;
             if (_deviceLedState[index] != _ledState[index]) {
-                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, row * 16 + col, _ledState[index]))) {
-                    _deviceLedState[index] = _ledState[index];
-                }
+                indices[count++] = index;
             }
         }
     }
-
-    // scene
-    for (int col = 0; col < Cols; ++col) {
-        int index = SceneRow * Cols + col;
+    for (int index = 0; index < ButtonCount; ++index) {
+        if (hasPriorityCol && index < Rows * Cols && index % Cols == _priorityCol) {
+            continue;
+        }
         if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeNoteOn(0, col * 16 + 8, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
+            indices[count++] = index;
         }
     }
 
-    // function
-    for (int col = 0; col < Cols; ++col) {
-        int index = FunctionRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 104 + col, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
+    if (count == 0) {
+        return;
+    }
+
+    ++_syncStats.syncs;
+    int budget = LedSyncBudget;
+
+    uint8_t header[MaxBatchLength];
+    if (count >= MinBatchLeds && ledBatchHeader(header) > 0 && MidiMessage::maxPayloadLength() > 0) {
+        sendBatches(indices.data(), count, budget);
+        return;
+    }
+
+    for (int i = 0; i < count && sendLed(indices[i], budget); ++i) {}
+}
+
+MidiMessage LaunchpadDevice::ledMessage(int index, uint8_t color) const {
+    int row = index / Cols;
+    int col = index % Cols;
+    if (row < Rows) {
+        return MidiMessage::makeNoteOn(0, row * 16 + col, color);
+    } else if (row == SceneRow) {
+        return MidiMessage::makeNoteOn(0, col * 16 + 8, color);
+    } else {
+        return MidiMessage::makeControlChange(0, 104 + col, color);
+    }
+}
+
+bool LaunchpadDevice::sendLed(int index, int &budget) {
+    if (budget < 3 || !sendMidi(cable(), ledMessage(index, _ledState[index]))) {
+        return false;
+    }
+    _deviceLedState[index] = _ledState[index];
+    budget -= 3;
+    _syncStats.messages += 1;
+    _syncStats.bytes += 3;
+    _syncStats.leds += 1;
+    return true;
+}
+
+int LaunchpadDevice::sendBatches(const uint8_t *indices, int count, int &budget) {
+    uint8_t data[MaxBatchLength];
+    int maxLength = std::min(int(MaxBatchLength), int(MidiMessage::maxPayloadLength()));
+
+    int sent = 0;
+    while (sent < count) {
+        // fill batch with as many leds as fit the payload and remaining budget (+2 bytes for sysex start/end)
+        int length = ledBatchHeader(data);
+        int end = sent;
+        bool fitsPayload = true;
+        while (end < count) {
+            uint8_t entry[8];
+            int entryLength = ledBatchEntry(entry, indices[end], _ledState[indices[end]]);
+            fitsPayload = length + entryLength <= maxLength;
+            if (!fitsPayload || length + entryLength + 2 > budget) {
+                break;
             }
+            std::memcpy(data + length, entry, entryLength);
+            length += entryLength;
+            ++end;
+        }
+        if (end == sent) {
+            // payload slots too small for a single entry, send the led as a single message instead
+            if (!fitsPayload && sendLed(indices[sent], budget)) {
+                ++sent;
+                continue;
+            }
+            break;
+        }
+
+        // payload allocation fails if all payload slots are still queued, retry on next sync
+        auto message = MidiMessage::makeSystemExclusive(data, length);
+        if (!message.hasPayload() || !sendMidi(cable(), message)) {
+            break;
+        }
+
+        budget -= length + 2;
+        _syncStats.messages += 1;
+        _syncStats.bytes += length + 2;
+        _syncStats.leds += end - sent;
+        for (; sent < end; ++sent) {
+            _deviceLedState[indices[sent]] = _ledState[indices[sent]];
         }
     }
+
+    return sent;
 }
@@ -61,6 +61,12 @@ public:
 
     void clearLeds() {
         std::fill(_ledState.begin(), _ledState.end(), 0);
+        _priorityCol = -1;
+    }
+
+    // leds in this grid column (i.e. the playhead) are synced first
+    void setPriorityCol(int col) {
+        _priorityCol = col;
     }
 
     virtual void setLed(int row, int col, Color color) {
@@ -72,11 +78,38 @@ public:
         _ledState[row * Cols + col] = state;
     }
 
-    virtual void syncLeds();
+    // sends changed leds to the device, batched if supported and limited to LedSyncBudget bytes per call
+    void syncLeds();
+
+    struct SyncStats {
+        uint32_t syncs = 0;
+        uint32_t messages = 0;
+        uint32_t bytes = 0;
+        uint32_t leds = 0;
+    };
+
+    const SyncStats &syncStats() const { return _syncStats; }
 
 protected:
     static constexpr uint8_t Cable = 0;
 
+    // midi bytes sent per led sync (about 10 kB/s at 50 fps), remaining leds are sent on the next sync
+    static constexpr int LedSyncBudget = 192;
+    // minimum number of changed leds to send a batch instead of single messages
+    static constexpr int MinBatchLeds = 4;
+    // a system exclusive message (payload + 2 bytes) has to fit a single 64 byte usb packet (3 bytes per 4 byte event)
+    static constexpr int MaxBatchLength = 46;
+
+    virtual uint8_t cable() const { return Cable; }
+
+    // returns the message to set a single led (index is row * Cols + col)
+    virtual MidiMessage ledMessage(int index, uint8_t color) const;
+
+    // batched led updates (system exclusive payload), both return the number of bytes written,
+    // devices without batch support return 0 from ledBatchHeader
+    virtual int ledBatchHeader(uint8_t *data) const { return 0; }
+    virtual int ledBatchEntry(uint8_t *data, int index, uint8_t color) const { return 0; }
+
     bool sendMidi(uint8_t cable, const MidiMessage &message) {
         if (_sendMidiHandler) {
             return _sendMidiHandler(cable, message);
@@ -96,4 +129,10 @@ protected:
     std::bitset<ButtonCount> _buttonState;
     std::array<uint8_t, ButtonCount> _ledState;
     std::array<uint8_t, ButtonCount> _deviceLedState;
+    int _priorityCol = -1;
+    SyncStats _syncStats;
+
+private:
+    bool sendLed(int index, int &budget);
+    int sendBatches(const uint8_t *indices, int count, int &budget);
 };
@@ -1,5 +1,7 @@
 #include "LaunchpadMk2Device.h"
 
+#include <cstring>
+
 //  +---+---+---+---+---+---+---+---+
 //  |104|105|106|107|108|109|110|111| < CC messages
 //  +---+---+---+---+---+---+---+---+
@@ -45,36 +47,35 @@ void LaunchpadMk2Device::recvMidi(uint8_t cable, const MidiMessage &message) {
     }
 }
 
-void LaunchpadMk2Device::syncLeds() {
-    // grid
-    for (int row = 0; row < Rows; ++row) {
-        for (int col = 0; col < Cols; ++col) {
-            int index = row * Cols + col;
-            if (_deviceLedState[index] != _ledState[index]) {
-                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, 11 + 10 * (7 - row) + col, _ledState[index]))) {
-                    _deviceLedState[index] = _ledState[index];
-                }
-            }
-        }
+MidiMessage LaunchpadMk2Device::ledMessage(int index, uint8_t color) const {
+    if (index < FunctionRow * Cols) {
+        return MidiMessage::makeNoteOn(0, ledNumber(index), color);
+    } else {
+        return MidiMessage::makeControlChange(0, ledNumber(index), color);
     }
+}
 
-    // scene
-    for (int col = 0; col < Cols; ++col) {
-        int index = SceneRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeNoteOn(0, 11 + 10 * (7 - col) + 8, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
-    }
+int LaunchpadMk2Device::ledBatchHeader(uint8_t *data) const {
+    // set leds: F0h 00h 20h 29h 02h 18h 0Ah <led> <color> ... F7h
+    static const uint8_t header[] = { 0x00, 0x20, 0x29, 0x02, 0x18, 0x0a };
+    std::memcpy(data, header, sizeof(header));
+    return sizeof(header);
+}
 
-    // function
-    for (int col = 0; col < Cols; ++col) {
-        int index = FunctionRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 104 + col, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
+int LaunchpadMk2Device::ledBatchEntry(uint8_t *data, int index, uint8_t color) const {
+    data[0] = ledNumber(index);
+    data[1] = color;
+    return 2;
+}
+
+int LaunchpadMk2Device::ledNumber(int index) {
+    int row = index / Cols;
+    int col = index % Cols;
+    if (row < Rows) {
+        return 11 + 10 * (7 - row) + col;
+    } else if (row == SceneRow) {
+        return 19 + 10 * (7 - col);
+    } else {
+        return 104 + col;
     }
 }
@@ -21,11 +21,19 @@ public:
         _ledState[row * Cols + col] = mapColor(red, green);;
     }
 
-    void syncLeds() override;
+protected:
+    uint8_t cable() const override { return Cable; }
+
+    MidiMessage ledMessage(int index, uint8_t color) const override;
+    int ledBatchHeader(uint8_t *data) const override;
+    int ledBatchEntry(uint8_t *data, int index, uint8_t color) const override;
 
 private:
     static constexpr uint8_t Cable = 1;
 
+    // led number used in both midi messages and system exclusive led updates
+    static int ledNumber(int index);
+
     inline uint8_t mapColor(int red, int green) const {
         static const uint8_t map[] = {
         //  g0 g1 g2 g3
@@ -1,5 +1,7 @@
 #include "LaunchpadProDevice.h"
 
+#include <cstring>
+
 //         +---+---+---+---+---+---+---+---+
 //         | 91| 92| 93| 94| 95| 96| 97| 98| < CC messages
 //         +---+---+---+---+---+---+---+---+
@@ -50,36 +52,35 @@ void LaunchpadProDevice::recvMidi(uint8_t cable, const MidiMessage &message) {
     }
 }
 
-void LaunchpadProDevice::syncLeds() {
-    // grid
-    for (int row = 0; row < Rows; ++row) {
-        for (int col = 0; col < Cols; ++col) {
-            int index = row * Cols + col;
-            if (_deviceLedState[index] != _ledState[index]) {
-                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, 11 + 10 * (7 - row) + col, _ledState[index]))) {
-                    _deviceLedState[index] = _ledState[index];
-                }
-            }
-        }
+MidiMessage LaunchpadProDevice::ledMessage(int index, uint8_t color) const {
+    if (index < SceneRow * Cols) {
+        return MidiMessage::makeNoteOn(0, ledNumber(index), color);
+    } else {
+        return MidiMessage::makeControlChange(0, ledNumber(index), color);
     }
+}
 
-    // scene
-    for (int col = 0; col < Cols; ++col) {
-        int index = SceneRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 11 + 10 * (7 - col) + 8, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
-    }
+int LaunchpadProDevice::ledBatchHeader(uint8_t *data) const {
+    // set leds: F0h 00h 20h 29h 02h 10h 0Ah <led> <color> ... F7h
+    static const uint8_t header[] = { 0x00, 0x20, 0x29, 0x02, 0x10, 0x0a };
+    std::memcpy(data, header, sizeof(header));
+    return sizeof(header);
+}
 
-    // function
-    for (int col = 0; col < Cols; ++col) {
-        int index = FunctionRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 91 + col, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
+int LaunchpadProDevice::ledBatchEntry(uint8_t *data, int index, uint8_t color) const {
+    data[0] = ledNumber(index);
+    data[1] = color;
+    return 2;
+}
+
+int LaunchpadProDevice::ledNumber(int index) {
+    int row = index / Cols;
+    int col = index % Cols;
+    if (row < Rows) {
+        return 11 + 10 * (7 - row) + col;
+    } else if (row == SceneRow) {
+        return 19 + 10 * (7 - col);
+    } else {
+        return 91 + col;
     }
 }
@@ -1,5 +1,7 @@
 #include "LaunchpadProMk3Device.h"
 
+#include <cstring>
+
 //         +---+---+---+---+---+---+---+---+
 //         | 91| 92| 93| 94| 95| 96| 97| 98| < CC messages
 //         +---+---+---+---+---+---+---+---+
@@ -56,36 +58,36 @@ void LaunchpadProMk3Device::recvMidi(uint8_t cable, const MidiMessage &message)
     }
 }
 
-void LaunchpadProMk3Device::syncLeds() {
-    // grid
-    for (int row = 0; row < Rows; ++row) {
-        for (int col = 0; col < Cols; ++col) {
-            int index = row * Cols + col;
-            if (_deviceLedState[index] != _ledState[index]) {
-                if (sendMidi(Cable, MidiMessage::makeNoteOn(0, 11 + 10 * (7 - row) + col, _ledState[index]))) {
-                    _deviceLedState[index] = _ledState[index];
-                }
-            }
-        }
+MidiMessage LaunchpadProMk3Device::ledMessage(int index, uint8_t color) const {
+    if (index < SceneRow * Cols) {
+        return MidiMessage::makeNoteOn(0, ledNumber(index), color);
+    } else {
+        return MidiMessage::makeControlChange(0, ledNumber(index), color);
     }
+}
 
-    // scene
-    for (int col = 0; col < Cols; ++col) {
-        int index = SceneRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 11 + 10 * (7 - col) + 8, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
-    }
+int LaunchpadProMk3Device::ledBatchHeader(uint8_t *data) const {
+    // set leds: F0h 00h 20h 29h 02h 0Eh 03h <type> <led> <color> ... F7h
+    static const uint8_t header[] = { 0x00, 0x20, 0x29, 0x02, 0x0e, 0x03 };
+    std::memcpy(data, header, sizeof(header));
+    return sizeof(header);
+}
 
-    // function
-    for (int col = 0; col < Cols; ++col) {
-        int index = FunctionRow * Cols + col;
-        if (_deviceLedState[index] != _ledState[index]) {
-            if (sendMidi(Cable, MidiMessage::makeControlChange(0, 91 + col, _ledState[index]))) {
-                _deviceLedState[index] = _ledState[index];
-            }
-        }
+int LaunchpadProMk3Device::ledBatchEntry(uint8_t *data, int index, uint8_t color) const {
+    data[0] = 0; // static color
+    data[1] = ledNumber(index);
+    data[2] = color;
+    return 3;
+}
+
+int LaunchpadProMk3Device::ledNumber(int index) {
+    int row = index / Cols;
+    int col = index % Cols;
+    if (row < Rows) {
+        return 11 + 10 * (7 - row) + col;
+    } else if (row == SceneRow) {
+        return 19 + 10 * (7 - col);
+    } else {
+        return 91 + col;
     }
 }
@@ -13,7 +13,7 @@ public:
     }
 
     virtual int rows() const override {
-        return 128;
+        return FileManager::SlotCount;
     }
 
     virtual int columns() const override {
@@ -32,7 +32,11 @@ public:
 private:
     void formatName(int row, StringBuilder &str) const {
         FileManager::SlotInfo info;
-        FileManager::slotInfo(_type, row, info);
+        if (!FileManager::slotInfo(_type, row, info)) {
+            // read by the file task, shown once it is available
+            str("%d: ...", row + 1);
+            return;
+        }
         str("%d: %s", row + 1, info.used ? info.name : "(empty)");
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ui/FramePacer.h"
 #include "ui/MessageManager.h"
 #include "ui/Page.h"
 #include "ui/PageManager.h"
@@ -18,6 +19,7 @@ struct PageContext {
     KeyState &globalKeyState;
     Model &model;
     Engine &engine;
+    const FramePacer &framePacer;
 
     ContextMenu contextMenu;
 };
@@ -2,6 +2,8 @@
 
 #include "ui/painters/WindowPainter.h"
 
+#include "model/FileManager.h"
+
 static void drawProgressBar(Canvas &canvas, int x, int y, int w, int h, int stripeLength, int stripeOffset) {
     canvas.setBlendMode(BlendMode::Set);
     canvas.setColor(Color::Bright);
@@ -39,7 +41,14 @@ void BusyPage::draw(Canvas &canvas) {
 
     canvas.drawTextCentered(0, 32 - 16, Width, 8, _text);
 
-    drawProgressBar(canvas, 16, 32 - 4, Width - 32, 8, 16, (os::ticks() / os::time::ms(50)) % 16);
+    // show actual progress of file tasks reporting it, animated stripes otherwise
+    float progress = FileManager::taskProgress();
+    if (progress >= 0.f) {
+        canvas.drawRect(16, 32 - 4, Width - 32, 8);
+        canvas.fillRect(16, 32 - 4, int((Width - 32) * progress), 8);
+    } else {
+        drawProgressBar(canvas, 16, 32 - 4, Width - 32, 8, 16, (os::ticks() / os::time::ms(50)) % 16);
+    }
 }
 
 void BusyPage::updateLeds(Leds &leds) {
@@ -11,7 +11,7 @@
 #include "core/utils/Random.h"
 #include "core/utils/StringBuilder.h"
 
-static Random rng;
+static INSTANCE_LOCAL Random rng;
 
 enum class ContextAction {
     Init,
@@ -81,28 +81,6 @@ static const CurveSequenceListModel::Item quickEditItems[8] = {
     CurveSequenceListModel::Item::Last
 };
 
-static void drawCurve(Canvas &canvas, int x, int y, int w, int h, float &lastY, const Curve::Function function, float min, float max) {
-    const int Step = 1;
-
-    auto eval = [=] (float x) {
-        return (1.f - (function(x) * (max - min) + min)) * h;
-    };
-
-    float fy0 = y + eval(0.f);
-
-    if (lastY >= 0.f && lastY != fy0) {
-        canvas.line(x, lastY, x, fy0);
-    }
-
-    for (int i = 0; i < w; i += Step) {
-        float fy1 = y + eval((float(i) + Step) / w);
-        canvas.line(x + i, fy0, x + i + Step, fy1);
-        fy0 = fy1;
-    }
-
-    lastY = fy0;
-}
-
 static void drawMinMax(Canvas &canvas, int x, int y, int w, int h, float minMax) {
     y += std::round((1.f - minMax) * h);
     canvas.hline(x, y, w);
@@ -136,7 +114,7 @@ static std::pair<int, int> calculateMultiStepShapeMinMax(size_t stepsSelected,
     return std::make_pair(min, max);
 }
 
-CurveSequenceEditPage::SettingsClipboard CurveSequenceEditPage::_settingsClipboard;
+INSTANCE_LOCAL CurveSequenceEditPage::SettingsClipboard CurveSequenceEditPage::_settingsClipboard;
 
 CurveSequenceEditPage::CurveSequenceEditPage(PageManager &manager, PageContext &context) :
     BasePage(manager, context)
@@ -340,11 +318,11 @@ void CurveSequenceEditPage::draw(Canvas &canvas) {
 
         canvas.setBlendMode(BlendMode::Add);
 
-        const int stepWidth = Width / StepCount;
+        const int stepWidth = StepWidth;
         const int stepOffset = this->stepOffset();
         const int loopY = 16;
         const int curveY = 24;
-        const int curveHeight = 20;
+        const int curveHeight = CurveHeight;
         const int bottomY = 48;
         bool drawShapeVariation = layer() == Layer::ShapeVariation || layer() == Layer::ShapeVariationProbability;
 
@@ -369,6 +347,7 @@ void CurveSequenceEditPage::draw(Canvas &canvas) {
         canvas.setColor(Color::Bright);
         float lastY = -1.f;
         float lastYVariation = -1.f;
+        _shapeCache.beginFrame();
         for (int i = 0; i < StepCount; ++i) {
             int stepIndex = stepOffset + i;
             const auto &step = sequence.step(stepIndex);
@@ -390,17 +369,15 @@ void CurveSequenceEditPage::draw(Canvas &canvas) {
             }
 
             {
-                const auto function = Curve::function(Curve::Type(std::min(Curve::Last - 1, step.shape())));
                 canvas.setColor(drawShapeVariation ? Color::MediumLow : Color::Bright);
                 canvas.setBlendMode(BlendMode::Add);
-                drawCurve(canvas, x, curveY, stepWidth, curveHeight, lastY, function, min, max);
+                _shapeCache.draw(canvas, x, curveY, lastY, std::min(Curve::Last - 1, step.shape()), step.min(), step.max(), CurveSequence::Max::Max);
             }
 
             if (drawShapeVariation) {
-                const auto function = Curve::function(Curve::Type(std::min(Curve::Last - 1, step.shapeVariation())));
                 canvas.setColor(Color::Bright);
                 canvas.setBlendMode(BlendMode::Add);
-                drawCurve(canvas, x, curveY, stepWidth, curveHeight, lastYVariation, function, min, max);
+                _shapeCache.draw(canvas, x, curveY, lastYVariation, std::min(Curve::Last - 1, step.shapeVariation()), step.min(), step.max(), CurveSequence::Max::Max);
             }
 
             switch (layer()) {
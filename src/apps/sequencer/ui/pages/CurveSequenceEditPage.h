@@ -3,6 +3,7 @@
 #include "BasePage.h"
 
 #include "ui/StepSelection.h"
+#include "ui/painters/CurveShapeCache.h"
 #include "ui/model/CurveSequenceListModel.h"
 
 #include "engine/generators/SequenceBuilder.h"
@@ -28,6 +29,8 @@ private:
     using Layer = CurveSequence::Layer;
 
     static const int StepCount = 16;
+    static const int StepWidth = Width / StepCount;
+    static const int CurveHeight = 20;
 
     int stepOffset() const { return _section * StepCount; }
 
@@ -80,7 +83,7 @@ private:
         CurveSequence::ChaosAlgorithm chaosAlgo;
     };
 
-    static SettingsClipboard _settingsClipboard;
+    static INSTANCE_LOCAL SettingsClipboard _settingsClipboard;
 
     enum class EditMode {
         Step,
@@ -101,4 +104,6 @@ private:
     StepSelection<CONFIG_STEP_COUNT> _stepSelection;
 
     Container<CurveSequenceBuilder> _builderContainer;
+
+    CurveShapeCache<StepWidth, CurveHeight, 8> _shapeCache;
 };
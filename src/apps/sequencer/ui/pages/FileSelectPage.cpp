@@ -67,8 +67,7 @@ void FileSelectPage::closeWithResult(bool result) {
     // cancel if empty slot is selected but not allowed to be
     if (result && !_allowEmpty) {
         FileManager::SlotInfo info;
-        FileManager::slotInfo(_type, selectedRow(), info);
-        if (!info.used) {
+        if (!FileManager::slotInfo(_type, selectedRow(), info) || !info.used) {
             return;
         }
     }
@@ -222,14 +222,20 @@ void MonitorPage::drawStats(Canvas &canvas) {
         drawValue(0, "UPTIME:", str);
     }
 
-    {
-        FixedStringBuilder<16> str("%d", stats.midiRxOverflow);
-        drawValue(1, "MIDI OVF:", str);
-    }
+    auto drawMidiPortStats = [&] (int index, const char *name, const MidiPortStats &portStats) {
+        FixedStringBuilder<32> str("OVF %d/%d HW %d/%d LAT %dUS",
+            int(portStats.rxOverflow), int(portStats.txOverflow), int(portStats.rxHighWater), int(portStats.txHighWater), int(portStats.rxLatency)
+        );
+        drawValue(index, name, str);
+    };
+
+    drawMidiPortStats(1, "MIDI:", stats.midi);
+    drawMidiPortStats(2, "USBMIDI:", stats.usbMidi);
 
     {
-        FixedStringBuilder<16> str("%d", stats.usbMidiRxOverflow);
-        drawValue(2, "USBMIDI OVF:", str);
+        const auto &uiStats = _context.framePacer.stats();
+        FixedStringBuilder<32> str("%dUS %dFPS %d SKIP", int(stats.updateTime), uiStats.fps, int(uiStats.skippedFrames));
+        drawValue(3, "ENGINE/UI:", str);
     }
 
 }
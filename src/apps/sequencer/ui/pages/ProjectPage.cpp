@@ -214,5 +214,5 @@ void ProjectPage::loadProjectFromSlot(int slot) {
         // TODO lock ui mutex
         _manager.pages().busy.close();
         _engine.resume();
-    });
+    }, FileManager::TaskPriority::Interactive);
 }
@@ -370,7 +370,7 @@ void RoutingPage::biasOverlayContextAction(int index) {
         break;
     }
     case 1: { // RANDOM
-        static Random rng;
+        static INSTANCE_LOCAL Random rng;
         for (int i = 0; i < CONFIG_TRACK_COUNT; ++i) {
             _biasStaging[i] = clamp<int>(rng.nextRange(201) - 100, -100, 100);
             _depthStaging[i] = clamp<int>(rng.nextRange(201) - 100, -100, 100);
@@ -20,7 +20,8 @@ void StartupPage::draw(Canvas &canvas) {
         [this](fs::Error result) {
           _engine.resume();
           _state = State::Ready;
-        });
+        },
+        FileManager::TaskPriority::Interactive);
   }
 
   if (relTime() > 1.f && _state == State::Ready) {
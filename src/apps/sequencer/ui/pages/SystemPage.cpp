@@ -397,7 +397,7 @@ void SystemPage::restoreSettingsFromFile() {
         // TODO lock ui mutex
         _manager.pages().busy.close();
         _engine.resume();
-    });
+    }, FileManager::TaskPriority::Interactive);
 }
 
 void SystemPage::formatSdCard() {
@@ -10,7 +10,7 @@
 #include "model/KnownDivisor.h"
 #include "model/ModelUtils.h"
 
-static Random rng;
+static INSTANCE_LOCAL Random rng;
 
 enum class ContextAction {
     Init,
@@ -205,5 +205,5 @@ void UserScalePage::loadUserScaleFromSlot(int slot) {
         // TODO lock ui mutex
         _manager.pages().busy.close();
         _engine.resume();
-    });
+    }, FileManager::TaskPriority::Interactive);
 }
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "model/Curve.h"
+
+#include "core/gfx/Canvas.h"
+#include "core/gfx/Layer.h"
+
+#include <cstdint>
+
+// Retained renderings of curve step shapes (Width x Height pixels each).
+// Entries are keyed by shape, range and color and shared by all steps drawing the same shape, which
+// avoids evaluating curve functions and rasterizing anti-aliased lines for every step on every frame.
+// Entries drawn in the current frame are never replaced, shapes that do not fit are drawn directly.
+template<int Width, int Height, int Entries>
+class CurveShapeCache {
+public:
+    // has to be called before drawing the shapes of a frame
+    void beginFrame() {
+        ++_frame;
+    }
+
+    // draws a shape at x, y using the canvas color and blend mode,
+    // lastY is used to connect the shape to the one drawn before (negative for none)
+    void draw(Canvas &canvas, int x, int y, float &lastY, int shape, int min, int max, int range) {
+        const auto *entry = lookup(canvas.color(), shape, min, max, range);
+        if (!entry) {
+            renderShape(canvas, x, y, lastY, shape, min, max, range);
+            return;
+        }
+
+        float fy0 = y + entry->y0;
+        if (lastY >= 0.f && lastY != fy0) {
+            canvas.line(x, lastY, x, fy0);
+        }
+        canvas.drawLayer(x, y, entry->layer.frameBuffer());
+        lastY = y + entry->y1;
+    }
+
+private:
+    struct Entry {
+        // lines end one pixel past the shape and anti-aliasing spills into the next row
+        Layer<Width + 2, Height + 2> layer;
+        float y0;
+        float y1;
+        uint32_t frame = 0;
+    };
+
+    const Entry *lookup(uint8_t color, int shape, int min, int max, int range) {
+        uint32_t key = (uint32_t(color) << 24) | (uint32_t(shape) << 16) | (uint32_t(min) << 8) | uint32_t(max);
+        // replace the entry that was drawn least recently
+        Entry *replace = nullptr;
+        for (auto &entry : _entries) {
+            if (entry.layer.valid(key)) {
+                entry.frame = _frame;
+                return &entry;
+            }
+            if (entry.frame != _frame && (!replace || entry.frame < replace->frame)) {
+                replace = &entry;
+            }
+        }
+        if (!replace) {
+            return nullptr;
+        }
+
+        auto &entry = *replace;
+        entry.frame = _frame;
+        entry.layer.begin(key);
+        float brightness = 1.f;
+        Canvas canvas(entry.layer.frameBuffer(), brightness);
+        canvas.setBlendMode(BlendMode::Add);
+        canvas.setColorValue(color);
+
+        float lastY = -1.f;
+        entry.y0 = renderShape(canvas, 0, 0, lastY, shape, min, max, range);
+        entry.y1 = lastY;
+
+        return &entry;
+    }
+
+    // renders the shape at x, y and returns its first y, lastY is connected to it and set to its last y
+    static float renderShape(Canvas &canvas, int x, int y, float &lastY, int shape, int min, int max, int range) {
+        const auto function = Curve::function(Curve::Type(shape));
+        float fmin = float(min) / range;
+        float fmax = float(max) / range;
+        auto eval = [=] (float x) {
+            return (1.f - (function(x) * (fmax - fmin) + fmin)) * Height;
+        };
+
+        float fy0 = y + eval(0.f);
+        if (lastY >= 0.f && lastY != fy0) {
+            canvas.line(x, lastY, x, fy0);
+        }
+        float first = fy0;
+        for (int i = 0; i < Width; ++i) {
+            float fy1 = y + eval((float(i) + 1) / Width);
+            canvas.line(x + i, fy0, x + i + 1, fy1);
+            fy0 = fy1;
+        }
+        lastY = fy0;
+        return first;
+    }
+
+    Entry _entries[Entries];
+    uint32_t _frame = 1;
+};
@@ -0,0 +1,67 @@
+#include "sim/TraceDiff.h"
+
+#include "args.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace sim;
+
+// Compares the outputs of two recorded target traces.
+// Exits with 0 if the traces are identical, 1 if they diverge and 2 if a trace cannot be read.
+int main(int argc, char *argv[]) {
+    args::ArgumentParser parser("PER|FORMER Trace Diff", "Compares gate, cv and midi output of two target traces.");
+    args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
+    args::ValueFlag<int> tickTolerance(parser, "ticks", "Tolerated timing offset in ticks", { 't', "ticks" }, 0);
+    args::ValueFlag<int> dacTolerance(parser, "value", "Tolerated difference of raw dac values", { 'd', "dac" }, 0);
+    args::Positional<std::string> filenameA(parser, "first", "First trace file");
+    args::Positional<std::string> filenameB(parser, "second", "Second trace file");
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (const args::Help &) {
+        std::cout << parser;
+        return 0;
+    } catch (const args::ParseError &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 2;
+    }
+
+    if (!filenameA || !filenameB) {
+        std::cerr << parser;
+        return 2;
+    }
+
+    TraceDiff::Options options;
+    options.tickTolerance = std::max(0, args::get(tickTolerance));
+    options.dacTolerance = std::max(0, args::get(dacTolerance));
+    TraceDiff traceDiff(options);
+
+    auto start = std::chrono::steady_clock::now();
+
+    TraceFile traceFileA, traceFileB;
+    if (traceFileA.open(args::get(filenameA)) && traceFileB.open(args::get(filenameB))) {
+        traceDiff.diff(traceFileA, traceFileB);
+    } else {
+        // at least one trace is in the raw stream format, load both into memory
+        TargetTrace traceA, traceB;
+        for (auto filename : { args::get(filenameA), args::get(filenameB) }) {
+            if (!std::ifstream(filename)) {
+                std::cerr << "cannot open " << filename << std::endl;
+                return 2;
+            }
+        }
+        traceA.loadFromFile(args::get(filenameA));
+        traceB.loadFromFile(args::get(filenameB));
+        traceDiff.diff(traceA, traceB);
+    }
+
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    traceDiff.writeReport(std::cout);
+    std::cout << "compared in " << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << " ms" << std::endl;
+
+    return traceDiff.identical() ? 0 : 1;
+}
@@ -7,7 +7,7 @@
 
 namespace fs {
 
-static ObjectPool<FIL, 2> filePool;
+static INSTANCE_LOCAL ObjectPool<FIL, 2> filePool;
 static os::Mutex filePoolMutex;
 
 FIL *File::allocateFile() {
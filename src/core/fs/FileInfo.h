@@ -2,6 +2,8 @@
 
 #include "ff/ff.h"
 
+#include <cstdint>
+
 namespace fs {
 
 class FileInfo {
@@ -10,6 +12,10 @@ public:
 
     size_t size() const { return _info.fsize; }
 
+    // modification date and time in FAT format
+    uint16_t date() const { return _info.fdate; }
+    uint16_t time() const { return _info.ftime; }
+
 private:
     FILINFO _info;
 
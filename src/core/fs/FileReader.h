@@ -24,6 +24,11 @@ public:
 
     Error error() const { return _error; }
 
+    size_t size() const { return _file.size(); }
+
+    // number of bytes read so far
+    size_t position() const { return _file.tell() - (_bufferSize - _pos); }
+
     Error finish() {
         if (!_finished) {
             if (_error == OK) {
@@ -8,8 +8,8 @@
 
 namespace fs {
 
-static Volume *g_volume;
-static SdCard *g_sdCard;
+static INSTANCE_LOCAL Volume *g_volume;
+static INSTANCE_LOCAL SdCard *g_sdCard;
 
 void setVolume(Volume *volume) {
     ASSERT(volume == nullptr || g_volume == nullptr, "only one volume allowed");
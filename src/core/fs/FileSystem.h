@@ -17,6 +17,7 @@ Error mkdir(const char *path);
 Error rmdir(const char *path);
 Error remove(const char *path);
 Error rename(const char *oldPath, const char *newPath);
+Error stat(const char *path, FileInfo &info);
 
 bool exists(const char *path);
 
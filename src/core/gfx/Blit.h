@@ -1,23 +1,72 @@
 #pragma once
 
+#include "FrameBuffer.h"
+
+#include <algorithm>
+
 #include <cstdint>
 
+// Blit operations for 8-bit and packed 4-bit frame buffers.
+// Colors can exceed the 4-bit range (i.e. 4-bit glyph pixels are multiplied by the color). The 8-bit
+// frame buffer keeps the full value and is clamped when sent to the display, the 4-bit frame buffer
+// saturates right away. Both give the same result unless a pixel is first pushed beyond the 4-bit
+// range and then subtracted from.
+
 namespace blit {
     struct set {
         void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
             frameBuffer(x, y) = color;
         }
+        void operator()(FrameBuffer4bit &frameBuffer, int x, int y, uint8_t color) {
+            frameBuffer.set(x, y, std::min(color, uint8_t(FrameBuffer4bit::MaxValue)));
+        }
+        void span(FrameBuffer8bit &frameBuffer, int x0, int x1, int y, uint8_t color) {
+            std::fill(&frameBuffer(x0, y), &frameBuffer(x1, y) + 1, color);
+        }
+        void span(FrameBuffer4bit &frameBuffer, int x0, int x1, int y, uint8_t color) {
+            frameBuffer.fillSpan(x0, x1, y, std::min(color, uint8_t(FrameBuffer4bit::MaxValue)));
+        }
     };
     struct add {
         void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
             // frameBuffer(x, y) = std::min(0xff, int(frameBuffer(x, y)) + color);
             frameBuffer(x, y) += color;
         }
+        void operator()(FrameBuffer4bit &frameBuffer, int x, int y, uint8_t color) {
+            frameBuffer.transform(x, y, [color] (uint8_t pixel) {
+                return uint8_t(std::min(int(FrameBuffer4bit::MaxValue), pixel + color));
+            });
+        }
+        void span(FrameBuffer8bit &frameBuffer, int x0, int x1, int y, uint8_t color) {
+            for (int x = x0; x <= x1; ++x) {
+                (*this)(frameBuffer, x, y, color);
+            }
+        }
+        void span(FrameBuffer4bit &frameBuffer, int x0, int x1, int y, uint8_t color) {
+            frameBuffer.transformSpan(x0, x1, y, [color] (uint8_t pixel) {
+                return uint8_t(std::min(int(FrameBuffer4bit::MaxValue), pixel + color));
+            });
+        }
     };
     struct sub {
         void operator()(FrameBuffer8bit &frameBuffer, int x, int y, uint8_t color) {
             // frameBuffer(x, y) = std::max(0x00, int(frameBuffer(x, y)) - color);
             frameBuffer(x, y) -= std::min(frameBuffer(x, y), color);
         }
+        void operator()(FrameBuffer4bit &frameBuffer, int x, int y, uint8_t color) {
+            frameBuffer.transform(x, y, [color] (uint8_t pixel) {
+                return uint8_t(pixel - std::min(pixel, color));
+            });
+        }
+        void span(FrameBuffer8bit &frameBuffer, int x0, int x1, int y, uint8_t color) {
+            for (int x = x0; x <= x1; ++x) {
+                (*this)(frameBuffer, x, y, color);
+            }
+        }
+        void span(FrameBuffer4bit &frameBuffer, int x0, int x1, int y, uint8_t color) {
+            frameBuffer.transformSpan(x0, x1, y, [color] (uint8_t pixel) {
+                return uint8_t(pixel - std::min(pixel, color));
+            });
+        }
     };
 };
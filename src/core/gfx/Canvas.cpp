@@ -7,6 +7,8 @@
 #include "fonts/tiny5x5.h"
 #include "fonts/ati8x8.h"
 
+#include <type_traits>
+
 static const BitmapFont &bitmapFont(Font font) {
     switch (font) {
     case Font::Tiny: return tiny5x5;
@@ -32,15 +34,18 @@ static const int bitmapFontOffset(Font font) {
 }
 
 
-void Canvas::fill() {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::fill() {
     _frameBuffer.fill(_color);
 }
 
-void Canvas::screensaver() {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::screensaver() {
     _frameBuffer.fill(0x0);
 }
 
-void Canvas::point(int x, int y) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::point(int x, int y) {
     switch (_blendMode) {
     case BlendMode::Set: point<blit::set>(x, y); break;
     case BlendMode::Add: point<blit::add>(x, y); break;
@@ -48,7 +53,8 @@ void Canvas::point(int x, int y) {
     }
 }
 
-void Canvas::hline(int x, int y, int w) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::hline(int x, int y, int w) {
     switch (_blendMode) {
     case BlendMode::Set: hline<blit::set>(x, y, w); break;
     case BlendMode::Add: hline<blit::add>(x, y, w); break;
@@ -56,7 +62,8 @@ void Canvas::hline(int x, int y, int w) {
     }
 }
 
-void Canvas::vline(int x, int y, int h) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::vline(int x, int y, int h) {
     switch (_blendMode) {
     case BlendMode::Set: vline<blit::set>(x, y, h); break;
     case BlendMode::Add: vline<blit::add>(x, y, h); break;
@@ -64,7 +71,8 @@ void Canvas::vline(int x, int y, int h) {
     }
 }
 
-void Canvas::line(float x0, float y0, float x1, float y1) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::line(float x0, float y0, float x1, float y1) {
     switch (_blendMode) {
     case BlendMode::Set: line<blit::set>(x0, y0, x1, y1); break;
     case BlendMode::Add: line<blit::add>(x0, y0, x1, y1); break;
@@ -72,7 +80,8 @@ void Canvas::line(float x0, float y0, float x1, float y1) {
     }
 }
 
-void Canvas::drawRect(int x, int y, int w, int h) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::drawRect(int x, int y, int w, int h) {
     switch (_blendMode) {
     case BlendMode::Set: drawRect<blit::set>(x, y, w, h); break;
     case BlendMode::Add: drawRect<blit::add>(x, y, w, h); break;
@@ -80,7 +89,8 @@ void Canvas::drawRect(int x, int y, int w, int h) {
     }
 }
 
-void Canvas::fillRect(int x, int y, int w, int h) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::fillRect(int x, int y, int w, int h) {
     switch (_blendMode) {
     case BlendMode::Set: fillRect<blit::set>(x, y, w, h); break;
     case BlendMode::Add: fillRect<blit::add>(x, y, w, h); break;
@@ -88,7 +98,8 @@ void Canvas::fillRect(int x, int y, int w, int h) {
     }
 }
 
-void Canvas::drawBitmap1bit(int x, int y, int w, int h, const uint8_t *bitmap) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::drawBitmap1bit(int x, int y, int w, int h, const uint8_t *bitmap) {
     switch (_blendMode) {
     case BlendMode::Set: drawBitmap<blit::set, 1>(x, y, w, h, bitmap); break;
     case BlendMode::Add: drawBitmap<blit::add, 1>(x, y, w, h, bitmap); break;
@@ -96,7 +107,8 @@ void Canvas::drawBitmap1bit(int x, int y, int w, int h, const uint8_t *bitmap) {
     }
 }
 
-void Canvas::drawBitmap4bit(int x, int y, int w, int h, const uint8_t *bitmap) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::drawBitmap4bit(int x, int y, int w, int h, const uint8_t *bitmap) {
     switch (_blendMode) {
     case BlendMode::Set: drawBitmap<blit::set, 4>(x, y, w, h, bitmap); break;
     case BlendMode::Add: drawBitmap<blit::add, 4>(x, y, w, h, bitmap); break;
@@ -104,35 +116,31 @@ void Canvas::drawBitmap4bit(int x, int y, int w, int h, const uint8_t *bitmap) {
     }
 }
 
-void Canvas::drawText(int x, int y, const char *str) {
-    const auto &font = bitmapFont(_font);
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::drawLayer(int x, int y, const FrameBuffer4bit &layer) {
+    switch (_blendMode) {
+    case BlendMode::Set: drawLayer<blit::set>(x, y, layer); break;
+    case BlendMode::Add: drawLayer<blit::add>(x, y, layer); break;
+    case BlendMode::Sub: drawLayer<blit::sub>(x, y, layer); break;
+    }
+}
 
-    int ox = x;
-    while (*str != '\0') {
-        auto c = *str++;
-        if (c == '\n') {
-            x = ox;
-            y += font.yAdvance;
-            continue;
-        }
-        if (c < font.first || c > font.last) {
-            continue;
-        }
-        const auto &g = font.glyphs[c - font.first];
-        const uint8_t *bitmap = &font.bitmap[g.offset];
-        switch (font.bpp) {
-        case 1: drawBitmap1bit(x + g.xOffset, y + g.yOffset, g.width, g.height, bitmap); break;
-        case 4: drawBitmap4bit(x + g.xOffset, y + g.yOffset, g.width, g.height, bitmap); break;
-        }
-        x += g.xAdvance;
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::drawText(int x, int y, const char *str) {
+    switch (_blendMode) {
+    case BlendMode::Set: drawText<blit::set>(x, y, str); break;
+    case BlendMode::Add: drawText<blit::add>(x, y, str); break;
+    case BlendMode::Sub: drawText<blit::sub>(x, y, str); break;
     }
 }
 
-void Canvas::drawTextCentered(int x, int y, int w, int h, const char *str) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::drawTextCentered(int x, int y, int w, int h, const char *str) {
     drawTextAligned(x, y, w, h, HorizontalAlign::Center, VerticalAlign::Center, str);
 }
 
-void Canvas::drawTextAligned(int x, int y, int w, int h, HorizontalAlign horizontalAlign, VerticalAlign verticalAlign, const char *str) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::drawTextAligned(int x, int y, int w, int h, HorizontalAlign horizontalAlign, VerticalAlign verticalAlign, const char *str) {
     // drawRect(x, y, w, h);
 
     switch (horizontalAlign) {
@@ -161,7 +169,50 @@ void Canvas::drawTextAligned(int x, int y, int w, int h, HorizontalAlign horizon
     drawText(x, y, str);
 }
 
-void Canvas::drawTextMultiline(int x, int y, int w, const char *str) {
+template<typename FrameBufferType>
+void BasicCanvas<FrameBufferType>::drawTextMultiline(int x, int y, int w, const char *str) {
+    switch (_blendMode) {
+    case BlendMode::Set: drawTextMultiline<blit::set>(x, y, w, str); break;
+    case BlendMode::Add: drawTextMultiline<blit::add>(x, y, w, str); break;
+    case BlendMode::Sub: drawTextMultiline<blit::sub>(x, y, w, str); break;
+    }
+}
+
+template<typename FrameBufferType>
+int BasicCanvas<FrameBufferType>::textWidth(const char *str) {
+    const auto &font = bitmapFont(_font);
+    int width = 0;
+
+    while (*str != '\0') {
+        auto c = *str++;
+        if (c < font.first || c > font.last) {
+            continue;
+        }
+        const auto &g = font.glyphs[c - font.first];
+        width += g.xAdvance;
+    }
+
+    return width;
+}
+
+template<typename FrameBufferType>
+int BasicCanvas<FrameBufferType>::textHeight(const char *str) {
+    const auto &font = bitmapFont(_font);
+    int height = bitmapFontHeight(_font);
+
+    while (*str != '\0') {
+        auto c = *str++;
+        if (c == '\n') {
+            height += font.yAdvance;
+        }
+    }
+
+    return height;
+}
+
+template<typename FrameBufferType>
+template<typename Blit>
+void BasicCanvas<FrameBufferType>::drawText(int x, int y, const char *str) {
     const auto &font = bitmapFont(_font);
 
     int ox = x;
@@ -176,48 +227,80 @@ void Canvas::drawTextMultiline(int x, int y, int w, const char *str) {
             continue;
         }
         const auto &g = font.glyphs[c - font.first];
-        if (x + g.xAdvance >= ox + w) {
-            x = ox;
-            y += font.yAdvance;
-            str--;
-            continue;
-        }
-        const uint8_t *bitmap = &font.bitmap[g.offset];
-        switch (font.bpp) {
-        case 1: drawBitmap1bit(x + g.xOffset, y + g.yOffset, g.width, g.height, bitmap); break;
-        case 4: drawBitmap4bit(x + g.xOffset, y + g.yOffset, g.width, g.height, bitmap); break;
-        }
+        drawGlyph<Blit>(font, g, x, y);
         x += g.xAdvance;
     }
 }
 
-int Canvas::textWidth(const char *str) {
+template<typename FrameBufferType>
+template<typename Blit>
+void BasicCanvas<FrameBufferType>::drawTextMultiline(int x, int y, int w, const char *str) {
     const auto &font = bitmapFont(_font);
-    int width = 0;
 
+    int ox = x;
     while (*str != '\0') {
         auto c = *str++;
+        if (c == '\n') {
+            x = ox;
+            y += font.yAdvance;
+            continue;
+        }
         if (c < font.first || c > font.last) {
             continue;
         }
         const auto &g = font.glyphs[c - font.first];
-        width += g.xAdvance;
+        if (x + g.xAdvance >= ox + w) {
+            x = ox;
+            y += font.yAdvance;
+            str--;
+            continue;
+        }
+        drawGlyph<Blit>(font, g, x, y);
+        x += g.xAdvance;
     }
-
-    return width;
 }
 
-int Canvas::textHeight(const char *str) {
-    const auto &font = bitmapFont(_font);
-    int height = bitmapFontHeight(_font);
+template<typename FrameBufferType>
+template<typename Blit>
+void BasicCanvas<FrameBufferType>::drawGlyph(const BitmapFont &font, const BitmapFontGlyph &g, int x, int y) {
+    const uint8_t *bitmap = &font.bitmap[g.offset];
+    x += g.xOffset;
+    y += g.yOffset;
 
-    while (*str != '\0') {
-        auto c = *str++;
-        if (c == '\n') {
-            height += font.yAdvance;
+    // glyphs that are clipped or not 1-bit use the generic bitmap path
+    if (font.bpp != 1 || g.width > 8 || x < 0 || x + g.width - 1 > _right || y < 0 || y + g.height - 1 > _bottom) {
+        switch (font.bpp) {
+        case 1: drawBitmap<Blit, 1>(x, y, g.width, g.height, bitmap); break;
+        case 4: drawBitmap<Blit, 4>(x, y, g.width, g.height, bitmap); break;
         }
+        return;
     }
 
-    return height;
+    // glyph rows are extracted as bit masks (rows are not byte aligned in the font data),
+    // only the set blend mode has to write the unset pixels
+    Blit blit;
+    const bool writeUnset = std::is_same<Blit, blit::set>::value;
+    const unsigned mask = (1 << g.width) - 1;
+    int bit = 0;
+    for (int row = 0; row < g.height; ++row, bit += g.width) {
+        unsigned bits = bitmap[bit >> 3];
+        if ((bit & 7) + g.width > 8) {
+            bits |= bitmap[(bit >> 3) + 1] << 8;
+        }
+        bits = (bits >> (bit & 7)) & mask;
+        if (writeUnset) {
+            for (int i = 0; i < g.width; ++i, bits >>= 1) {
+                blit(_frameBuffer, x + i, y + row, (bits & 1) ? _color : 0);
+            }
+        } else {
+            for (int px = x; bits; ++px, bits >>= 1) {
+                if (bits & 1) {
+                    blit(_frameBuffer, px, y + row, _color);
+                }
+            }
+        }
+    }
 }
 
+template class BasicCanvas<FrameBuffer8bit>;
+template class BasicCanvas<FrameBuffer4bit>;
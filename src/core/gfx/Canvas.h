@@ -7,6 +7,9 @@
 #include <cmath>
 #include <cstdint>
 
+struct BitmapFont;
+struct BitmapFontGlyph;
+
 enum class BlendMode {
     Set,
     Add,
@@ -40,9 +43,12 @@ enum class VerticalAlign {
     Center,
 };
 
-class Canvas {
+// Canvas drawing into an 8-bit (one byte per pixel) or packed 4-bit frame buffer.
+// The UI uses the packed 4-bit canvas, which renders directly in the display format.
+template<typename FrameBufferType>
+class BasicCanvas {
 public:
-    Canvas(FrameBuffer8bit &frameBuffer, float &brightness) :
+    BasicCanvas(FrameBufferType &frameBuffer, float &brightness) :
         _frameBuffer(frameBuffer),
         _right(frameBuffer.width() - 1),
         _bottom(frameBuffer.height() - 1),
@@ -76,6 +82,9 @@ public:
     void drawBitmap1bit(int x, int y, int w, int h, const uint8_t *bitmap);
     void drawBitmap4bit(int x, int y, int w, int h, const uint8_t *bitmap);
 
+    // composites a pre-rendered layer (see Layer), zero pixels are transparent
+    void drawLayer(int x, int y, const FrameBuffer4bit &layer);
+
     void drawText(int x, int y, const char *str);
     void drawTextCentered(int x, int y, int w, int h, const char *str);
     void drawTextAligned(int x, int y, int w, int h, HorizontalAlign horizontalAlign, VerticalAlign verticalAlign, const char *str);
@@ -126,8 +135,8 @@ private:
             int x0 = x, x1 = x + w - 1;
             hclip(x0);
             hclip(x1);
-            for (int x = x0; x <= x1; ++x) {
-                blit(_frameBuffer, x, y, _color);
+            if (x0 <= x1) {
+                blit.span(_frameBuffer, x0, x1, y, _color);
             }
         }
     }
@@ -235,13 +244,22 @@ private:
         int y0 = y, y1 = y + h - 1;
         clip(x0, y0);
         clip(x1, y1);
+        if (x0 > x1) {
+            return;
+        }
         for (int y = y0; y <= y1; ++y) {
-            for (int x = x0; x <= x1; ++x) {
-                blit(_frameBuffer, x, y, _color);
-            }
+            blit.span(_frameBuffer, x0, x1, y, _color);
         }
     }
 
+    // text drawing is specialized per blend mode (see Canvas.cpp)
+    template<typename Blit>
+    void drawText(int x, int y, const char *str);
+    template<typename Blit>
+    void drawTextMultiline(int x, int y, int w, const char *str);
+    template<typename Blit>
+    void drawGlyph(const BitmapFont &font, const BitmapFontGlyph &glyph, int x, int y);
+
     template<typename Blit, size_t Bpp>
     void drawBitmap(int x, int y, int w, int h, const uint8_t *bitmap) {
         Blit blit;
@@ -251,25 +269,51 @@ private:
             return;
         }
 
+        // only visit pixels inside the frame buffer
         const uint8_t mask = (1 << Bpp) - 1;
-        int shift = 0;
-        for (int y = y0; y <= y1; ++y) {
-            for (int x = x0; x <= x1; ++x) {
-                // uint8_t pixel = ((*bitmap >> shift) & mask) << (8 - Bpp);
-                uint8_t pixel = ((*bitmap >> shift) & mask) * _color;
-                shift += Bpp;
-                if (shift >= 8) {
-                    ++bitmap;
-                    shift = 0;
+        int cx0 = std::max(0, x0), cx1 = std::min(_right, x1);
+        int cy0 = std::max(0, y0), cy1 = std::min(_bottom, y1);
+        for (int y = cy0; y <= cy1; ++y) {
+            int bit = ((y - y0) * w + (cx0 - x0)) * Bpp;
+            for (int x = cx0; x <= cx1; ++x, bit += Bpp) {
+                // uint8_t pixel = ((bitmap[bit >> 3] >> (bit & 7)) & mask) << (8 - Bpp);
+                uint8_t pixel = ((bitmap[bit >> 3] >> (bit & 7)) & mask) * _color;
+                blit(_frameBuffer, x, y, pixel);
+            }
+        }
+    }
+
+    template<typename Blit>
+    void drawLayer(int x, int y, const FrameBuffer4bit &layer) {
+        Blit blit;
+        int x0 = x, x1 = x + layer.width() - 1;
+        int y0 = y, y1 = y + layer.height() - 1;
+        if (x0 > _right || x1 < 0 || y0 > _bottom || y1 < 0) {
+            return;
+        }
+
+        int cx0 = std::max(0, x0), cx1 = std::min(_right, x1);
+        int cy0 = std::max(0, y0), cy1 = std::min(_bottom, y1);
+        // visit two pixels at a time, layers are mostly empty
+        for (int y = cy0; y <= cy1; ++y) {
+            const uint8_t *row = layer.data() + (y - y0) * layer.stride();
+            for (int i = (cx0 - x0) >> 1; i <= (cx1 - x0) >> 1; ++i) {
+                uint8_t pixels = row[i];
+                if (!pixels) {
+                    continue;
+                }
+                int x = x0 + i * 2;
+                if ((pixels >> 4) && x >= cx0) {
+                    blit(_frameBuffer, x, y, pixels >> 4);
                 }
-                if (inside(x, y)) {
-                    blit(_frameBuffer, x, y, pixel);
+                if ((pixels & 0xf) && x + 1 <= cx1) {
+                    blit(_frameBuffer, x + 1, y, pixels & 0xf);
                 }
             }
         }
     }
 
-    FrameBuffer8bit &_frameBuffer;
+    FrameBufferType &_frameBuffer;
     int _right;
     int _bottom;
     uint8_t _color = 0xf;
@@ -277,3 +321,6 @@ private:
     Font _font = Font::Default;
     float &_brightness;
 };
+
+using Canvas = BasicCanvas<FrameBuffer4bit>;
+using Canvas8bit = BasicCanvas<FrameBuffer8bit>;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstring>
+#include <cstdint>
+
+// Range of rows that differ between two frames with the same layout.
+// Used by the display drivers to only send the part of a frame that changed.
+struct DirtyRows {
+    int first = 0;
+    int last = -1;
+
+    bool empty() const { return last < first; }
+    int count() const { return empty() ? 0 : last - first + 1; }
+
+    static DirtyRows all(int height) {
+        DirtyRows rows;
+        rows.last = height - 1;
+        return rows;
+    }
+
+    static DirtyRows compare(const uint8_t *previous, const uint8_t *next, int stride, int height) {
+        DirtyRows rows;
+        int y = 0;
+        while (y < height && std::memcmp(&previous[y * stride], &next[y * stride], stride) == 0) {
+            ++y;
+        }
+        if (y == height) {
+            return rows;
+        }
+        rows.first = y;
+        y = height - 1;
+        while (y > rows.first && std::memcmp(&previous[y * stride], &next[y * stride], stride) == 0) {
+            --y;
+        }
+        rows.last = y;
+        return rows;
+    }
+};
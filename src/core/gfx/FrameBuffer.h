@@ -3,6 +3,7 @@
 #include <algorithm>
 
 #include <cstdint>
+#include <cstring>
 
 template<typename T>
 class FrameBuffer {
@@ -46,3 +47,95 @@ private:
 };
 
 using FrameBuffer8bit = FrameBuffer<uint8_t>;
+
+// Frame buffer with 4-bit pixels packed two per byte, left pixel in the high nibble.
+// This matches the pixel layout of the display, so the buffer can be sent as is.
+class FrameBuffer4bit {
+public:
+    static constexpr uint8_t MaxValue = 0xf;
+
+    FrameBuffer4bit(int width, int height, uint8_t *buffer) :
+        _width(width),
+        _height(height),
+        _stride(width / 2),
+        _data(buffer)
+    {}
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+    // bytes per row
+    int stride() const { return _stride; }
+    // bytes in total
+    int size() const { return _stride * _height; }
+
+    const uint8_t *data() const { return _data; }
+          uint8_t *data()       { return _data; }
+
+    void fill(uint8_t value) {
+        std::memset(_data, pack(std::min(value, uint8_t(MaxValue))), size());
+    }
+
+    uint8_t get(int x, int y) const {
+        return (_data[y * _stride + (x >> 1)] >> shift(x)) & 0xf;
+    }
+
+    // value must be in the range 0..MaxValue
+    void set(int x, int y, uint8_t value) {
+        uint8_t &byte = _data[y * _stride + (x >> 1)];
+        byte = (byte & ~(0xf << shift(x))) | (value << shift(x));
+    }
+
+    // replaces pixel with func(pixel)
+    template<typename Func>
+    void transform(int x, int y, Func func) {
+        uint8_t &byte = _data[y * _stride + (x >> 1)];
+        uint8_t value = func((byte >> shift(x)) & 0xf);
+        byte = (byte & ~(0xf << shift(x))) | (value << shift(x));
+    }
+
+    // sets pixels x0..x1 (inclusive) of row y to value
+    void fillSpan(int x0, int x1, int y, uint8_t value) {
+        if (x0 & 1) {
+            set(x0++, y, value);
+        }
+        if (!(x1 & 1) && x1 >= x0) {
+            set(x1--, y, value);
+        }
+        if (x1 > x0) {
+            std::memset(&_data[y * _stride + (x0 >> 1)], pack(value), (x1 - x0 + 1) >> 1);
+        }
+    }
+
+    // replaces pixels x0..x1 (inclusive) of row y with func(pixel)
+    template<typename Func>
+    void transformSpan(int x0, int x1, int y, Func func) {
+        if (x0 & 1) {
+            set(x0, y, func(get(x0, y)));
+            ++x0;
+        }
+        if (!(x1 & 1) && x1 >= x0) {
+            set(x1, y, func(get(x1, y)));
+            --x1;
+        }
+        uint8_t *byte = &_data[y * _stride + (x0 >> 1)];
+        for (int x = x0; x < x1; x += 2, ++byte) {
+            *byte = (func(*byte >> 4) << 4) | func(*byte & 0xf);
+        }
+    }
+
+private:
+    // bit position of a pixel within its byte
+    static int shift(int x) {
+        return (~x & 1) << 2;
+    }
+
+    static uint8_t pack(uint8_t value) {
+        return value | (value << 4);
+    }
+
+    int _width;
+    int _height;
+    int _stride;
+    uint8_t *_data;
+};
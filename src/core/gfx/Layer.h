@@ -0,0 +1,42 @@
+#pragma once
+
+#include "FrameBuffer.h"
+
+#include <cstdint>
+
+// Retained off-screen layer with packed 4-bit pixels.
+// Content is rendered once and then composited with Canvas::drawLayer() until the key it was
+// rendered for changes. The key has to capture everything the content depends on (including
+// the canvas brightness, which is baked into the pixels).
+template<int Width, int Height>
+class Layer {
+public:
+    static_assert(Width % 2 == 0, "layer width must be even");
+
+    Layer() :
+        _frameBuffer(Width, Height, _data)
+    {}
+
+    Layer(const Layer &) = delete;
+    Layer &operator=(const Layer &) = delete;
+
+    const FrameBuffer4bit &frameBuffer() const { return _frameBuffer; }
+          FrameBuffer4bit &frameBuffer()       { return _frameBuffer; }
+
+    bool valid(uint32_t key) const { return _valid && _key == key; }
+
+    // clears the layer and marks it as holding the content for the given key
+    void begin(uint32_t key) {
+        _frameBuffer.fill(0);
+        _key = key;
+        _valid = true;
+    }
+
+    void invalidate() { _valid = false; }
+
+private:
+    uint8_t _data[Width * Height / 2];
+    FrameBuffer4bit _frameBuffer;
+    uint32_t _key = 0;
+    bool _valid = false;
+};
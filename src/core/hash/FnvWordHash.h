@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+
+// FNV-1a variant operating on 32-bit lanes instead of single bytes.
+// Input is consumed a word at a time, partial words are carried over to the next call
+// so the result only depends on the byte stream and not on how it was split up.
+class FnvWordHash {
+public:
+    uint32_t result() const {
+        uint32_t hash = _hash;
+        if (_laneBytes > 0) {
+            hash ^= _lane;
+            hash *= Prime;
+            hash ^= _laneBytes;
+            hash *= Prime;
+        }
+        return hash;
+    }
+
+    void operator()(const void *data, size_t len) {
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+
+        // complete pending lane
+        while (_laneBytes > 0 && len > 0) {
+            _lane |= uint32_t(*src++) << (_laneBytes * 8);
+            --len;
+            if (++_laneBytes == 4) {
+                mix(_lane);
+                _lane = 0;
+                _laneBytes = 0;
+            }
+        }
+
+        // full words
+        while (len >= 4) {
+            uint32_t word;
+            std::memcpy(&word, src, 4);
+            mix(word);
+            src += 4;
+            len -= 4;
+        }
+
+        // keep remaining bytes for next call
+        while (len-- > 0) {
+            _lane |= uint32_t(*src++) << (_laneBytes * 8);
+            ++_laneBytes;
+        }
+    }
+
+private:
+    void mix(uint32_t word) {
+        _hash ^= word;
+        _hash *= Prime;
+    }
+
+    static constexpr uint32_t Hash = 0x811c9dc5;
+    static constexpr uint32_t Prime = 0x1000193;
+
+    uint32_t _hash = Hash;
+    uint32_t _lane = 0;
+    uint32_t _laneBytes = 0;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CompressedWriter.h"
+
+#include <algorithm>
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+// Reads a block compressed stream written by CompressedWriter.
+// Only a single decompressed block is held in memory.
+class CompressedReader {
+public:
+    using Reader = std::function<void(void *, size_t)>;
+
+    CompressedReader(Reader reader, CompressedStream::Workspace &workspace) :
+        _reader(reader),
+        _workspace(workspace)
+    {}
+
+    // Returns true if the stream is malformed.
+    bool error() const { return _error; }
+
+    // Returns true if the end of the stream was reached.
+    bool end() const { return _end && _pos == _len; }
+
+    // Reads up to len bytes and returns the number of bytes read, which is less than len at the end
+    // of the stream. Missing data is filled with zeros.
+    size_t read(void *data, size_t len) {
+        uint8_t *dst = static_cast<uint8_t *>(data);
+        size_t total = 0;
+        while (len > 0) {
+            if (_pos == _len && !readBlock()) {
+                std::memset(dst, 0, len);
+                break;
+            }
+            size_t chunk = std::min(len, _len - _pos);
+            std::memcpy(dst, &_workspace.block[_pos], chunk);
+            _pos += chunk;
+            dst += chunk;
+            len -= chunk;
+            total += chunk;
+        }
+        return total;
+    }
+
+private:
+    bool readBlock() {
+        if (_end || _error) {
+            return false;
+        }
+
+        uint16_t header = 0;
+        _reader(&header, sizeof(header));
+        size_t len = header & CompressedStream::LengthMask;
+
+        _pos = 0;
+        _len = 0;
+
+        if (len == 0) {
+            _end = true;
+            return false;
+        }
+        if (len > CompressedStream::BlockSize) {
+            _error = true;
+            return false;
+        }
+
+        if (header & CompressedStream::Compressed) {
+            _reader(_workspace.payload, len);
+            if (!Lz::decompress(_workspace.payload, len, _workspace.block, CompressedStream::BlockSize, _len) || _len == 0) {
+                _error = true;
+                _len = 0;
+                return false;
+            }
+        } else {
+            _reader(_workspace.block, len);
+            _len = len;
+        }
+
+        return true;
+    }
+
+    Reader _reader;
+    CompressedStream::Workspace &_workspace;
+    size_t _pos = 0;
+    size_t _len = 0;
+    bool _end = false;
+    bool _error = false;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Lz.h"
+
+#include <algorithm>
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+// Block compressed stream.
+// Data is split into blocks of up to BlockSize bytes. Each block starts with a 16-bit header holding
+// the payload length and the Compressed flag. Blocks are stored LZ compressed if that makes them
+// smaller and raw otherwise, so sections of dense data cost no more than 2 bytes per block.
+// A header of zero marks the end of the stream.
+struct CompressedStream {
+    static constexpr size_t BlockSize = 512;
+    static constexpr uint16_t Compressed = 0x8000;
+    static constexpr uint16_t LengthMask = 0x7fff;
+
+    // Buffers used for compressing/decompressing. Kept separate from the writer/reader
+    // so they can be placed in static memory instead of the task stack.
+    struct Workspace {
+        uint8_t block[BlockSize];
+        uint8_t payload[BlockSize];
+        uint16_t hashTable[Lz::HashSize];
+    };
+};
+
+class CompressedWriter {
+public:
+    using Writer = std::function<void(const void *, size_t)>;
+
+    CompressedWriter(Writer writer, CompressedStream::Workspace &workspace) :
+        _writer(writer),
+        _workspace(workspace)
+    {}
+
+    void write(const void *data, size_t len) {
+        const uint8_t *src = static_cast<const uint8_t *>(data);
+        while (len > 0) {
+            size_t chunk = std::min(len, CompressedStream::BlockSize - _pos);
+            std::memcpy(&_workspace.block[_pos], src, chunk);
+            _pos += chunk;
+            src += chunk;
+            len -= chunk;
+            if (_pos == CompressedStream::BlockSize) {
+                writeBlock();
+            }
+        }
+    }
+
+    // Writes pending data and the end of stream marker.
+    void finish() {
+        writeBlock();
+        uint16_t header = 0;
+        _writer(&header, sizeof(header));
+    }
+
+private:
+    void writeBlock() {
+        if (_pos == 0) {
+            return;
+        }
+        size_t len = Lz::compress(_workspace.block, _pos, _workspace.payload, _pos - 1, _workspace.hashTable);
+        if (len > 0) {
+            uint16_t header = len | CompressedStream::Compressed;
+            _writer(&header, sizeof(header));
+            _writer(_workspace.payload, len);
+        } else {
+            uint16_t header = _pos;
+            _writer(&header, sizeof(header));
+            _writer(_workspace.block, _pos);
+        }
+        _pos = 0;
+    }
+
+    Writer _writer;
+    CompressedStream::Workspace &_workspace;
+    size_t _pos = 0;
+};
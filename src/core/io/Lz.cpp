@@ -0,0 +1,172 @@
+#include "Lz.h"
+
+#include <cstring>
+
+// Compressed data is a sequence of:
+// - token: upper 4 bits literal count, lower 4 bits match length - MinMatch (15 = extended)
+// - extended literal count (bytes of 255 followed by the remainder)
+// - literals
+// - match offset (16 bit little endian, omitted for the last sequence)
+// - extended match length
+
+static inline uint32_t read32(const uint8_t *p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t hash32(uint32_t value) {
+    return (value * 2654435761u) >> (32 - Lz::HashBits);
+}
+
+static inline bool writeLength(uint8_t *&op, const uint8_t *oend, size_t len) {
+    while (len >= 255) {
+        if (op >= oend) {
+            return false;
+        }
+        *op++ = 255;
+        len -= 255;
+    }
+    if (op >= oend) {
+        return false;
+    }
+    *op++ = len;
+    return true;
+}
+
+static inline bool readLength(const uint8_t *&ip, const uint8_t *iend, size_t &len) {
+    uint8_t value;
+    do {
+        if (ip >= iend) {
+            return false;
+        }
+        value = *ip++;
+        len += value;
+    } while (value == 255);
+    return true;
+}
+
+static bool writeSequence(uint8_t *&op, const uint8_t *oend, const uint8_t *literals, size_t literalCount, size_t offset, size_t matchLength) {
+    if (op >= oend) {
+        return false;
+    }
+    uint8_t *token = op++;
+    *token = (literalCount < 15 ? literalCount : 15) << 4;
+    if (literalCount >= 15 && !writeLength(op, oend, literalCount - 15)) {
+        return false;
+    }
+    if (size_t(oend - op) < literalCount) {
+        return false;
+    }
+    std::memcpy(op, literals, literalCount);
+    op += literalCount;
+
+    if (matchLength > 0) {
+        if (oend - op < 2) {
+            return false;
+        }
+        *op++ = offset & 0xff;
+        *op++ = offset >> 8;
+        matchLength -= Lz::MinMatch;
+        *token |= matchLength < 15 ? matchLength : 15;
+        if (matchLength >= 15 && !writeLength(op, oend, matchLength - 15)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t Lz::compress(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstCapacity, uint16_t *hashTable) {
+    static constexpr uint16_t Empty = 0xffff;
+
+    for (size_t i = 0; i < HashSize; ++i) {
+        hashTable[i] = Empty;
+    }
+
+    uint8_t *op = dst;
+    const uint8_t *oend = dst + dstCapacity;
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    while (pos + MinMatch <= srcLen) {
+        uint32_t sequence = read32(src + pos);
+        uint32_t hash = hash32(sequence);
+        size_t ref = hashTable[hash];
+        hashTable[hash] = pos;
+
+        if (ref == Empty || read32(src + ref) != sequence) {
+            ++pos;
+            continue;
+        }
+
+        size_t matchLength = MinMatch;
+        while (pos + matchLength < srcLen && src[ref + matchLength] == src[pos + matchLength]) {
+            ++matchLength;
+        }
+
+        if (!writeSequence(op, oend, src + anchor, pos - anchor, pos - ref, matchLength)) {
+            return 0;
+        }
+
+        pos += matchLength;
+        anchor = pos;
+    }
+
+    if (!writeSequence(op, oend, src + anchor, srcLen - anchor, 0, 0)) {
+        return 0;
+    }
+
+    return op - dst;
+}
+
+bool Lz::decompress(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstCapacity, size_t &dstLen) {
+    const uint8_t *ip = src;
+    const uint8_t *iend = src + srcLen;
+    uint8_t *op = dst;
+    const uint8_t *oend = dst + dstCapacity;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(ip, iend, literalCount)) {
+            return false;
+        }
+        if (size_t(iend - ip) < literalCount || size_t(oend - op) < literalCount) {
+            return false;
+        }
+        std::memcpy(op, ip, literalCount);
+        ip += literalCount;
+        op += literalCount;
+
+        // last sequence has no match
+        if (ip == iend) {
+            break;
+        }
+
+        if (iend - ip < 2) {
+            return false;
+        }
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        size_t matchLength = token & 0xf;
+        if (matchLength == 15 && !readLength(ip, iend, matchLength)) {
+            return false;
+        }
+        matchLength += MinMatch;
+
+        if (offset == 0 || offset > size_t(op - dst) || size_t(oend - op) < matchLength) {
+            return false;
+        }
+
+        // byte wise copy to allow overlapping matches (runs)
+        const uint8_t *match = op - offset;
+        while (matchLength-- > 0) {
+            *op++ = *match++;
+        }
+    }
+
+    dstLen = op - dst;
+    return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstdint>
+
+// Small footprint LZ77 block codec (LZ4 style byte oriented sequences).
+// Matches are only searched within a block, so decoding needs no memory beyond the output block.
+class Lz {
+public:
+    static constexpr size_t MinMatch = 4;
+    static constexpr size_t HashBits = 8;
+    static constexpr size_t HashSize = 1 << HashBits;
+
+    // Compresses srcLen bytes from src into dst.
+    // Returns the compressed size or 0 if the result does not fit into dstCapacity bytes.
+    // The hash table needs to hold HashSize entries and blocks are limited to 65535 bytes.
+    static size_t compress(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstCapacity, uint16_t *hashTable);
+
+    // Decompresses srcLen bytes from src into dst.
+    // Returns false if the compressed data is malformed or does not fit into dstCapacity bytes.
+    static bool decompress(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstCapacity, size_t &dstLen);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/hash/FnvHash.h"
+#include "core/hash/FnvWordHash.h"
+
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+
+// Integrity hash used by the versioned serializer.
+// New data is hashed with FnvWordHash, which is marked by setting WordHashFlag in the stored version.
+// Data without the flag was written by older firmware and is validated with the byte wise FnvHash.
+// Small inputs are collected in a block to let the word hash run over larger chunks of data.
+class SerializedHash {
+public:
+    static constexpr uint32_t WordHashFlag = 0x80000000;
+    static constexpr uint32_t VersionMask = ~WordHashFlag;
+
+    SerializedHash(bool wordHash = true) :
+        _wordHash(wordHash)
+    {}
+
+    bool wordHash() const { return _wordHash; }
+
+    uint32_t result() const {
+        if (_wordHash) {
+            FnvWordHash hash = _fnvWordHash;
+            hash(_block, _blockPos);
+            return hash.result();
+        } else {
+            return _fnvHash.result();
+        }
+    }
+
+    void operator()(const void *data, size_t len) {
+        if (_wordHash) {
+            if (_blockPos + len > BlockSize) {
+                _fnvWordHash(_block, _blockPos);
+                _blockPos = 0;
+                if (len > BlockSize) {
+                    _fnvWordHash(data, len);
+                    return;
+                }
+            }
+            std::memcpy(reinterpret_cast<uint8_t *>(_block) + _blockPos, data, len);
+            _blockPos += len;
+        } else {
+            _fnvHash(data, len);
+        }
+    }
+
+private:
+    static constexpr size_t BlockSize = 64;
+
+    bool _wordHash;
+    FnvHash _fnvHash;
+    FnvWordHash _fnvWordHash;
+    uint32_t _block[BlockSize / 4];
+    size_t _blockPos = 0;
+};
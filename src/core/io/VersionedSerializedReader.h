@@ -1,9 +1,10 @@
 #pragma once
 
-#include "core/hash/FnvHash.h"
+#include "SerializedHash.h"
 
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 
 class VersionedSerializedReader {
@@ -14,12 +15,25 @@ public:
         _reader(reader),
         _readerVersion(readerVersion)
     {
-        _reader(&_dataVersion, sizeof(_dataVersion));
+        readHeader();
+    }
+
+    // Reads directly from a memory buffer without going through a reader function for every field.
+    // Reading past the end of the buffer returns zeros (see overrun()).
+    VersionedSerializedReader(const void *data, size_t len, uint32_t readerVersion) :
+        _data(static_cast<const uint8_t *>(data)),
+        _dataEnd(_data + len),
+        _readerVersion(readerVersion)
+    {
+        readHeader();
     }
 
     uint32_t readerVersion() const { return _readerVersion; }
     uint32_t dataVersion() const { return _dataVersion; }
 
+    // Returns true if a memory buffer reader was read past the end of the buffer.
+    bool overrun() const { return _overrun; }
+
     template<typename T>
     void read(T &value, uint32_t addedInVersion = 0) {
         read(&value, sizeof(value), addedInVersion);
@@ -53,7 +67,7 @@ public:
 
     void read(void *data, size_t len, uint32_t addedInVersion) {
         if (_dataVersion >= addedInVersion) {
-            _reader(data, len);
+            readRaw(data, len);
             _hash(data, len);
         }
     }
@@ -69,7 +83,7 @@ public:
             size_t remaining = len;
             while (remaining > 0) {
                 size_t chunk = remaining < sizeof(dummy) ? remaining : sizeof(dummy);
-                _reader(dummy, chunk);
+                readRaw(dummy, chunk);
                 _hash(dummy, chunk);
                 remaining -= chunk;
             }
@@ -78,7 +92,7 @@ public:
 
     bool checkHash() {
         uint32_t hash;
-        _reader(&hash, sizeof(hash));
+        readRaw(&hash, sizeof(hash));
         return _hash.result() == hash;
     }
 
@@ -91,9 +105,39 @@ public:
     }
 
 private:
+    void readHeader() {
+        uint32_t version = 0;
+        readRaw(&version, sizeof(version));
+        _dataVersion = version & SerializedHash::VersionMask;
+        _hash = SerializedHash(version & SerializedHash::WordHashFlag);
+        _savedHash = _hash;
+    }
+
+    void readRaw(void *data, size_t len) {
+        if (_reader) {
+            _reader(data, len);
+            return;
+        }
+        size_t available = size_t(_dataEnd - _data);
+        if (len <= available) {
+            std::memcpy(data, _data, len);
+            _data += len;
+        } else {
+            if (available > 0) {
+                std::memcpy(data, _data, available);
+            }
+            std::memset(static_cast<uint8_t *>(data) + available, 0, len - available);
+            _data = _dataEnd;
+            _overrun = true;
+        }
+    }
+
     Reader _reader;
+    const uint8_t *_data = nullptr;
+    const uint8_t *_dataEnd = nullptr;
+    bool _overrun = false;
     uint32_t _readerVersion;
     uint32_t _dataVersion;
-    FnvHash _hash;
-    FnvHash _savedHash;
+    SerializedHash _hash;
+    SerializedHash _savedHash;
 };
@@ -1,20 +1,29 @@
 #pragma once
 
-#include "core/hash/FnvHash.h"
+#include "SerializedHash.h"
 
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 
 class VersionedSerializedWriter {
 public:
     using Writer = std::function<void(const void *, size_t)>;
 
-    VersionedSerializedWriter(Writer writer, uint32_t writerVersion) :
+    // A buffered writer collects small writes and passes them to the writer in blocks. The buffer is flushed
+    // by writeHash() (the end of a serialized file) and on destruction. Otherwise every write is passed on directly.
+    VersionedSerializedWriter(Writer writer, uint32_t writerVersion, bool buffered = false) :
         _writer(writer),
-        _writerVersion(writerVersion)
+        _writerVersion(writerVersion),
+        _buffered(buffered)
     {
-        _writer(&_writerVersion, sizeof(_writerVersion));
+        uint32_t version = _writerVersion | SerializedHash::WordHashFlag;
+        _writer(&version, sizeof(version));
+    }
+
+    ~VersionedSerializedWriter() {
+        flush();
     }
 
     uint32_t writerVersion() const { return _writerVersion; }
@@ -31,17 +40,41 @@ public:
     }
 
     void write(const void *data, size_t len) {
-        _hash(data, len);
-        _writer(data, len);
+        if (!_buffered || len > BufferSize) {
+            flush();
+            _hash(data, len);
+            _writer(data, len);
+            return;
+        }
+        if (len > BufferSize - _bufferPos) {
+            flush();
+        }
+        std::memcpy(reinterpret_cast<uint8_t *>(_buffer) + _bufferPos, data, len);
+        _bufferPos += len;
     }
 
     void writeHash() {
+        flush();
         uint32_t hash = _hash.result();
         _writer(&hash, sizeof(hash));
     }
 
+    // Passes all buffered data to the writer.
+    void flush() {
+        if (_bufferPos > 0) {
+            _hash(_buffer, _bufferPos);
+            _writer(_buffer, _bufferPos);
+            _bufferPos = 0;
+        }
+    }
+
 private:
+    static constexpr size_t BufferSize = 64;
+
     Writer _writer;
     uint32_t _writerVersion;
-    FnvHash _hash;
+    bool _buffered;
+    SerializedHash _hash;
+    uint32_t _buffer[BufferSize / 4];
+    size_t _bufferPos = 0;
 };
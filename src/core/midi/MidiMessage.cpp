@@ -2,7 +2,7 @@
 
 #include "core/Debug.h"
 
-MidiMessage::PayloadPool MidiMessage::_payloadPool;
+INSTANCE_LOCAL MidiMessage::PayloadPool MidiMessage::_payloadPool;
 
 void MidiMessage::dump(const MidiMessage &msg) {
     if (msg.isChannelMessage()) {
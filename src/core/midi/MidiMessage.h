@@ -1,5 +1,7 @@
 #pragma once
 
+#include "SystemConfig.h"
+
 #include <algorithm>
 #include <array>
 
@@ -385,6 +387,11 @@ public:
 
     static void setPayloadPool(uint8_t *data, size_t length);
 
+    // maximum length of a single payload (0 if there is no payload pool)
+    static size_t maxPayloadLength() {
+        return _payloadPool.valid() ? _payloadPool.length / PayloadPool::SlotCount : 0;
+    }
+
 private:
     static PayloadID allocatePayload(size_t length);
     static void incPayloadRefCount(PayloadID id);
@@ -417,7 +424,7 @@ private:
         }
     };
 
-    static PayloadPool _payloadPool;
+    static INSTANCE_LOCAL PayloadPool _payloadPool;
 
     uint8_t _raw[3];
     uint8_t _length = 0;
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+// Buffer statistics of a midi port driver.
+struct MidiPortStats {
+    uint32_t rxOverflow = 0;    // received entries dropped because the receive buffer was full
+    uint32_t rxHighWater = 0;   // maximum number of entries in the receive buffer
+    uint32_t rxSize = 0;        // receive buffer size
+    uint32_t rxLatency = 0;     // maximum time (us) a received message waited in the receive buffer
+    uint32_t txOverflow = 0;    // number of times the transmit buffer was full
+    uint32_t txHighWater = 0;   // maximum number of entries in the transmit buffer
+    uint32_t txSize = 0;        // transmit buffer size
+};
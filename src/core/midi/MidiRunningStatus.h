@@ -0,0 +1,38 @@
+#pragma once
+
+#include "MidiMessage.h"
+
+#include <cstdint>
+
+// Tracks the running status of a serial midi byte stream.
+// Channel messages with the same status as the previous channel message are sent without their status byte.
+// Real-time messages do not affect the running status, system common and exclusive messages cancel it.
+class MidiRunningStatus {
+public:
+    // returns true if the status byte of the message has to be sent
+    bool update(const MidiMessage &message) {
+        uint8_t status = message.status();
+        if (MidiMessage::isChannelMessage(status)) {
+            if (status == _status) {
+                return false;
+            }
+            _status = status;
+        } else if (!MidiMessage::isRealTimeMessage(status)) {
+            _status = 0;
+        }
+        return true;
+    }
+
+    // returns the number of bytes needed to send the message without updating the running status
+    int length(const MidiMessage &message) const {
+        return message.length() - (message.status() == _status ? 1 : 0);
+    }
+
+    // forces the status byte to be sent with the next channel message
+    void reset() {
+        _status = 0;
+    }
+
+private:
+    uint8_t _status = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/utils/SpscRingBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Transmit byte buffer of a serial midi port with a separate lane for real-time bytes.
+// The midi specification allows real-time messages (clock, start, stop ...) to be sent between
+// any two bytes of other messages, so pending real-time bytes are always sent next, without waiting
+// for messages already in the buffer to be transmitted.
+template<size_t Size>
+class MidiTxBuffer {
+public:
+    static constexpr size_t RealtimeSize = 4;
+
+    inline size_t size() const { return Size; }
+
+    inline bool empty() const { return _realtime.empty() && _data.empty(); }
+
+    // space for message bytes (real-time bytes have their own lane)
+    inline size_t writable() const { return _data.writable(); }
+
+    // producer
+
+    // returns false and counts an overflow if the buffer is full
+    inline bool write(uint8_t data) { return _data.write(data); }
+
+    inline bool writeRealtime(uint8_t data) { return _realtime.write(data); }
+
+    // consumer
+
+    inline uint8_t read() {
+        return _realtime.empty() ? _data.read() : _realtime.read();
+    }
+
+    // statistics
+
+    uint32_t highWater() const { return _data.highWater(); }
+    uint32_t overflow() const { return _data.overflow() + _realtime.overflow(); }
+
+private:
+    SpscRingBuffer<uint8_t, RealtimeSize> _realtime;
+    SpscRingBuffer<uint8_t, Size> _data;
+};
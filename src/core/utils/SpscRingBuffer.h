@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free single producer / single consumer ring buffer.
+// Read and write positions are free running counters, the size must be a power of two so they can be
+// masked to an index and all entries can be used. The producer publishes entries with release semantics
+// and the consumer acquires them, so an entry is completely written before it becomes readable (and
+// completely read before its slot is reused). The producer also tracks the high-water mark and the
+// number of entries that did not fit (overflow).
+template<typename T, size_t Size>
+class SpscRingBuffer {
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0, "size must be a power of two");
+public:
+    inline size_t size() const { return Size; }
+
+    inline bool empty() const { return readable() == 0; }
+
+    inline bool full() const { return writable() == 0; }
+
+    inline size_t entries() const { return readable(); }
+
+    inline size_t writable() const {
+        return Size - (_write.load(std::memory_order_relaxed) - _read.load(std::memory_order_acquire));
+    }
+
+    inline size_t readable() const {
+        return _write.load(std::memory_order_acquire) - _read.load(std::memory_order_relaxed);
+    }
+
+    // producer
+
+    // returns false and counts an overflow if the buffer is full
+    inline bool write(const T &value) {
+        uint32_t write = _write.load(std::memory_order_relaxed);
+        uint32_t used = write - _read.load(std::memory_order_acquire);
+        if (used >= Size) {
+            ++_overflow;
+            return false;
+        }
+        _buffer[write & Mask] = value;
+        _write.store(write + 1, std::memory_order_release);
+        if (used + 1 > _highWater) {
+            _highWater = used + 1;
+        }
+        return true;
+    }
+
+    // consumer
+
+    inline T read() {
+        uint32_t read = _read.load(std::memory_order_relaxed);
+        T value = _buffer[read & Mask];
+        _read.store(read + 1, std::memory_order_release);
+        return value;
+    }
+
+    // reads an entry and replaces it (i.e. to release resources held by the entry)
+    inline T readAndReplace(const T &replacement = T()) {
+        uint32_t read = _read.load(std::memory_order_relaxed);
+        T value = _buffer[read & Mask];
+        _buffer[read & Mask] = replacement;
+        _read.store(read + 1, std::memory_order_release);
+        return value;
+    }
+
+    // statistics (written by the producer)
+
+    uint32_t highWater() const { return _highWater; }
+    uint32_t overflow() const { return _overflow; }
+
+private:
+    static constexpr uint32_t Mask = Size - 1;
+
+    T _buffer[Size];
+    std::atomic<uint32_t> _read{0};
+    std::atomic<uint32_t> _write{0};
+    volatile uint32_t _highWater = 0;
+    volatile uint32_t _overflow = 0;
+};
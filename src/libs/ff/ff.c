@@ -424,8 +424,8 @@ typedef struct {
 #if FF_VOLUMES < 1 || FF_VOLUMES > 10
 #error Wrong FF_VOLUMES setting
 #endif
-static FATFS *FatFs[FF_VOLUMES];	/* Pointer to the filesystem objects (logical drives) */
-static WORD Fsid;					/* File system mount ID */
+static FF_THREAD_LOCAL FATFS *FatFs[FF_VOLUMES];	/* Pointer to the filesystem objects (logical drives) */
+static FF_THREAD_LOCAL WORD Fsid;					/* File system mount ID */
 
 #if FF_FS_RPATH != 0 && FF_VOLUMES >= 2
 static BYTE CurrVol;				/* Current drive */
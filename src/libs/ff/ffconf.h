@@ -265,5 +265,14 @@
 /* #include <windows.h>	// O/S definitions  */
 
 
+#ifdef PLATFORM_SIM
+#define FF_THREAD_LOCAL	__thread
+#else
+#define FF_THREAD_LOCAL
+#endif
+/* The FF_THREAD_LOCAL defines the storage class of the volume table. The simulator
+/  runs independent instances on multiple threads, each one mounting its own volume. */
+
+
 
 /*--- End of configuration options ---*/
@@ -1,3 +1,7 @@
 #pragma once
 
 #define CCMRAM_BSS
+
+// State that exists once per running application instance. The simulator can run
+// multiple independent instances, one per thread (see sim::Simulator).
+#define INSTANCE_LOCAL thread_local
@@ -45,6 +45,15 @@ public:
         _listener = listener;
     }
 
+    // time since the last timer tick in simulator ticks (used for engine state snapshots)
+    double phase() const {
+        return _simulator.ticks() - _lastTicks;
+    }
+
+    void setPhase(double phase) {
+        _lastTicks = _simulator.ticks() - phase;
+    }
+
 private:
     void update() {
         if (!_enabled) {
@@ -5,6 +5,8 @@
 
 #include "SystemConfig.h"
 
+#include "core/gfx/DirtyRows.h"
+
 #include <cstdint>
 #include <cstring>
 
@@ -12,19 +14,58 @@ class Lcd {
 public:
     static constexpr int Width = CONFIG_LCD_WIDTH;
     static constexpr int Height = CONFIG_LCD_HEIGHT;
+    static constexpr int Stride = Width / 2;
+
+    struct Stats {
+        uint32_t frames = 0;
+        uint32_t skippedFrames = 0;
+        uint32_t bytes = 0;
+    };
 
     Lcd() :
         _simulator(sim::Simulator::instance())
     {}
 
-    void init() {}
+    void init() {
+        invalidate();
+    }
+
+    // draws a frame buffer with packed 4-bit pixels (see FrameBuffer4bit)
+    // only rows that changed since the last frame are transferred, unchanged frames are skipped
+    void draw(const uint8_t *frameBuffer) {
+        DirtyRows rows = _fullUpdate ? DirtyRows::all(Height) : DirtyRows::compare(_lastFrame, frameBuffer, Stride, Height);
+        _fullUpdate = false;
+        _stats.frames += 1;
 
-    void draw(uint8_t *frameBuffer) {
-        std::memcpy(_frameBuffer.data(), frameBuffer, _frameBuffer.size());
+        if (rows.empty()) {
+            _stats.skippedFrames += 1;
+            return;
+        }
+
+        std::memcpy(&_lastFrame[rows.first * Stride], &frameBuffer[rows.first * Stride], rows.count() * Stride);
+        _stats.bytes += rows.count() * Stride;
+
+        for (int y = rows.first; y <= rows.last; ++y) {
+            const uint8_t *src = &_lastFrame[y * Stride];
+            uint8_t *dst = &_frameBuffer[y * Width];
+            for (int x = 0; x < Stride; ++x) {
+                uint8_t pixels = *src++;
+                *dst++ = pixels >> 4;
+                *dst++ = pixels & 0xf;
+            }
+        }
         _simulator.writeLcd(_frameBuffer);
     }
 
+    // forces the next frame to be sent in full
+    void invalidate() { _fullUpdate = true; }
+
+    const Stats &stats() const { return _stats; }
+
 private:
     sim::Simulator &_simulator;
     sim::FrameBuffer _frameBuffer;
+    uint8_t _lastFrame[Width * Height / 2];
+    bool _fullUpdate = true;
+    Stats _stats;
 };
@@ -1,11 +1,18 @@
 #pragma once
 
+#include "SystemConfig.h"
+
+#include "HighResolutionTimer.h"
+
 #include "core/midi/MidiMessage.h"
+#include "core/midi/MidiParser.h"
+#include "core/midi/MidiPortStats.h"
+#include "core/utils/SpscRingBuffer.h"
 
 #include "sim/Simulator.h"
 
+#include <algorithm>
 #include <functional>
-#include <deque>
 
 #include <cstdint>
 
@@ -26,11 +33,18 @@ public:
         return true;
     }
 
+    bool sendRealtime(uint8_t data) {
+        return send(MidiMessage(data));
+    }
+
     bool recv(MidiMessage *message) {
-        if (!_recvQueue.empty()) {
-            *message = _recvQueue.front();
-            _recvQueue.pop_front();
-            return true;
+        while (!_rxBuffer.empty()) {
+            auto rxData = _rxBuffer.read();
+            if (_midiParser.feed(rxData.data)) {
+                *message = _midiParser.message();
+                _rxLatency = std::max(_rxLatency, HighResolutionTimer::us() - rxData.time);
+                return true;
+            }
         }
         return false;
     }
@@ -39,18 +53,37 @@ public:
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    MidiPortStats stats() const {
+        MidiPortStats stats;
+        stats.rxOverflow = _rxBuffer.overflow();
+        stats.rxHighWater = _rxBuffer.highWater();
+        stats.rxSize = _rxBuffer.size();
+        stats.rxLatency = _rxLatency;
+        return stats;
+    }
 
 private:
+    // received messages are serialized into the same byte buffer as on the hardware to get the same overflow behavior
     void writeMidiInput(sim::MidiEvent event) {
         if (event.port == 0 && event.kind == sim::MidiEvent::Message) {
-            if (event.message.length() != 1 || !_recvFilter || !_recvFilter(event.message.status())) {
-                _recvQueue.emplace_back(event.message);
+            uint32_t time = HighResolutionTimer::us();
+            for (uint8_t i = 0; i < event.message.length(); ++i) {
+                uint8_t data = event.message.raw()[i];
+                if (!_recvFilter || !_recvFilter(data)) {
+                    _rxBuffer.write({ time, data });
+                }
             }
         }
     }
 
+    struct RxData {
+        uint32_t time;
+        uint8_t data;
+    };
+
     sim::Simulator &_simulator;
-    std::deque<MidiMessage> _recvQueue;
+    SpscRingBuffer<RxData, CONFIG_MIDI_RX_BUFFER_SIZE> _rxBuffer;
+    uint32_t _rxLatency = 0;
+    MidiParser _midiParser;
     RecvFilter _recvFilter;
 };
@@ -2,20 +2,29 @@
 
 #include "core/Debug.h"
 
+#include "sim/Simulator.h"
+
 #include <memory>
 #include <fstream>
+#include <string>
 
 #include <cstring>
 #include <cstddef>
 #include <cstdint>
 
+// SD card backed by the disk image of the simulator (see Simulator::setSdCardImage()).
 class SdCard {
 public:
     SdCard() :
-        _data(new uint8_t[SectorCount * SectorSize])
+        _data(new uint8_t[SectorCount * SectorSize]())
     {
-        std::ifstream ifs("sdcard.iso");
-        ifs.read(reinterpret_cast<char *>(_data.get()), SectorCount * SectorSize);
+        if (auto simulator = sim::Simulator::current()) {
+            _image = simulator->sdCardImage();
+        }
+        if (!_image.empty()) {
+            std::ifstream ifs(_image);
+            ifs.read(reinterpret_cast<char *>(_data.get()), SectorCount * SectorSize);
+        }
     }
 
     void init() {
@@ -45,7 +54,10 @@ public:
     }
 
     void sync() {
-        std::ofstream ofs("sdcard.iso");
+        if (_image.empty()) {
+            return;
+        }
+        std::ofstream ofs(_image);
         ofs.write(reinterpret_cast<const char *>(_data.get()), SectorCount * SectorSize);
         ofs.close();
     }
@@ -55,4 +67,5 @@ private:
     static constexpr size_t SectorSize = 512;
 
     std::unique_ptr<uint8_t[]> _data;
+    std::string _image;
 };
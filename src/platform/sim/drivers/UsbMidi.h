@@ -1,11 +1,17 @@
 #pragma once
 
+#include "SystemConfig.h"
+
+#include "HighResolutionTimer.h"
+
 #include "core/midi/MidiMessage.h"
+#include "core/midi/MidiPortStats.h"
+#include "core/utils/SpscRingBuffer.h"
 
 #include "sim/Simulator.h"
 
+#include <algorithm>
 #include <functional>
-#include <deque>
 #include <memory>
 
 #include <cstdint>
@@ -29,11 +35,16 @@ public:
         return true;
     }
 
+    bool sendRealtime(uint8_t cable, uint8_t data) {
+        return send(cable, MidiMessage(data));
+    }
+
     bool recv(uint8_t *cable, MidiMessage *message) {
-        if (!_recvQueue.empty()) {
+        if (!_rxQueue.empty()) {
+            auto rxMessage = _rxQueue.read();
             *cable = 0;
-            *message = _recvQueue.front();
-            _recvQueue.pop_front();
+            *message = rxMessage.message;
+            _rxLatency = std::max(_rxLatency, HighResolutionTimer::us() - rxMessage.time);
             return true;
         }
         return false;
@@ -51,7 +62,14 @@ public:
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    MidiPortStats stats() const {
+        MidiPortStats stats;
+        stats.rxOverflow = _rxQueue.overflow();
+        stats.rxHighWater = _rxQueue.highWater();
+        stats.rxSize = _rxQueue.size();
+        stats.rxLatency = _rxLatency;
+        return stats;
+    }
 
 private:
     void writeMidiInput(sim::MidiEvent event) {
@@ -69,7 +87,8 @@ private:
                 break;
             case sim::MidiEvent::Message:
                 if (event.message.length() != 1 || !_recvFilter || !_recvFilter(event.message.status())) {
-                    _recvQueue.emplace_back(event.message);
+                    // dropped and counted as overflow if the rx queue is full
+                    _rxQueue.write({ event.message, HighResolutionTimer::us() });
                 }
                 break;
             }
@@ -80,6 +99,12 @@ private:
     DisconnectHandler _disconnectHandler;
     RecvFilter _recvFilter;
 
+    struct RxMessage {
+        MidiMessage message;
+        uint32_t time;
+    };
+
     sim::Simulator &_simulator;
-    std::deque<MidiMessage> _recvQueue;
+    SpscRingBuffer<RxMessage, CONFIG_USB_MIDI_RX_QUEUE_SIZE> _rxQueue;
+    uint32_t _rxLatency = 0;
 };
@@ -10,6 +10,7 @@
 
 namespace os {
 
+    // periodic tasks created at static initialization (shared by all simulator instances)
     std::vector<std::function<void(void)>> &updateCallbacks();
 
     typedef int TaskHandle;
@@ -32,7 +33,11 @@ namespace os {
     class PeriodicTask {
     public:
         PeriodicTask(const char *name, uint8_t priority, uint32_t interval, std::function<void(void)> func) {
-            os::updateCallbacks().emplace_back(func);
+            if (auto simulator = sim::Simulator::current()) {
+                simulator->addTask(func);
+            } else {
+                os::updateCallbacks().emplace_back(func);
+            }
         }
     };
 
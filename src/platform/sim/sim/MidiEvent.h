@@ -21,7 +21,7 @@ struct MidiEvent {
         uint16_t productId;
     } connect;
 
-    MidiEvent() : message() {}
+    MidiEvent() : kind(Message), port(0), message(), connect{ 0, 0 } {}
     MidiEvent(Kind kind, int port) : kind(kind), port(port) {}
     MidiEvent(const MidiEvent &other) = default;
 
@@ -16,13 +16,26 @@
 
 namespace sim {
 
-static Simulator *g_instance;
+static thread_local Simulator *g_current;
+
+Simulator::Scope::Scope(Simulator &simulator) :
+    _previous(g_current)
+{
+    ASSERT(simulator.pinnedToCallingThread(), "simulator used from a different thread");
+    g_current = &simulator;
+}
+
+Simulator::Scope::~Scope() {
+    g_current = _previous;
+}
 
 Simulator::Simulator(Target target) :
     _target(target),
+    _thread(std::this_thread::get_id()),
     _targetStateTracker(_targetState)
 {
-    g_instance = this;
+    ASSERT(!g_current, "only one simulator per thread");
+    g_current = this;
 
     registerTargetInputObserver(&_targetStateTracker);
     registerTargetOutputObserver(&_targetStateTracker);
@@ -30,7 +43,11 @@ Simulator::Simulator(Target target) :
 
 Simulator::~Simulator() {
     if (_targetCreated) {
-       _target.destroy();
+        Scope scope(*this);
+        _target.destroy();
+    }
+    if (g_current == this) {
+        g_current = nullptr;
     }
 }
 
@@ -40,6 +57,22 @@ void Simulator::wait(int ms) {
     }
 }
 
+void Simulator::render(int ticks, uint16_t *dac, uint8_t *gates, std::vector<RenderedMidiMessage> *midi) {
+    static_assert(GateOutputState::Count <= 8, "gate outputs do not fit bitmask");
+
+    _renderedMidi = midi;
+    for (int i = 0; i < ticks; ++i) {
+        step();
+        if (dac) {
+            dac = std::copy(_targetState.dac.state.begin(), _targetState.dac.state.end(), dac);
+        }
+        if (gates) {
+            *gates++ = _targetState.gateOutput.state.to_ulong();
+        }
+    }
+    _renderedMidi = nullptr;
+}
+
 void Simulator::setButton(int index, bool pressed) {
     writeButton(index, pressed);
 }
@@ -91,18 +124,34 @@ void Simulator::addUpdateCallback(UpdateCallback callback) {
     _updateCallbacks.emplace_back(callback);
 }
 
+void Simulator::addTask(UpdateCallback callback) {
+    _tasks.emplace_back(callback);
+}
+
 void Simulator::registerTargetTickObserver(TargetTickHandler *observer) {
     _targetTickObservers.emplace_back(observer);
 }
 
+void Simulator::unregisterTargetTickObserver(TargetTickHandler *observer) {
+    _targetTickObservers.erase(std::remove(_targetTickObservers.begin(), _targetTickObservers.end(), observer), _targetTickObservers.end());
+}
+
 void Simulator::registerTargetInputObserver(TargetInputHandler *observer) {
     _targetInputObservers.emplace_back(observer);
 }
 
+void Simulator::unregisterTargetInputObserver(TargetInputHandler *observer) {
+    _targetInputObservers.erase(std::remove(_targetInputObservers.begin(), _targetInputObservers.end(), observer), _targetInputObservers.end());
+}
+
 void Simulator::registerTargetOutputObserver(TargetOutputHandler *observer) {
     _targetOutputObservers.emplace_back(observer);
 }
 
+void Simulator::unregisterTargetOutputObserver(TargetOutputHandler *observer) {
+    _targetOutputObservers.erase(std::remove(_targetOutputObservers.begin(), _targetOutputObservers.end(), observer), _targetOutputObservers.end());
+}
+
 // TargetInputHandler
 
 void Simulator::writeButton(int index, bool pressed) {
@@ -168,16 +217,27 @@ void Simulator::writeLcd(const FrameBuffer &frameBuffer) {
 }
 
 void Simulator::writeMidiOutput(MidiEvent event) {
+    if (_renderedMidi && event.kind == MidiEvent::Message) {
+        RenderedMidiMessage message = { _tick, uint8_t(event.port), event.message.length(), { 0, 0, 0 } };
+        std::copy(event.message.raw(), event.message.raw() + message.length, message.data);
+        _renderedMidi->emplace_back(message);
+    }
     for (auto observer : _targetOutputObservers) {
         observer->writeMidiOutput(event);
     }
 }
 
 Simulator &Simulator::instance() {
-    return *g_instance;
+    return *g_current;
+}
+
+Simulator *Simulator::current() {
+    return g_current;
 }
 
 void Simulator::step() {
+    Scope scope(*this);
+
     if (!_targetCreated) {
         _target.create();
         _targetCreated = true;
@@ -191,6 +251,10 @@ void Simulator::step() {
         callback();
     }
 
+    for (const auto &callback : _tasks) {
+        callback();
+    }
+
     for (const auto &callback : _updateCallbacks) {
         callback();
     }
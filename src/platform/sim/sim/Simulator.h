@@ -7,14 +7,28 @@
 #include <array>
 #include <functional>
 #include <string>
+#include <thread>
 #include <vector>
 
 class MidiMessage;
 
 namespace sim {
 
+// Simulates a single target (application instance). Drivers and os primitives find their simulator
+// through the one bound to the calling thread. The application state (INSTANCE_LOCAL) exists once per
+// thread, so a simulator is pinned to the thread it is created on: there can only be one simulator per
+// thread and it must only be used from that thread. Independent instances run in parallel on separate threads.
 class Simulator : public TargetInputHandler, public TargetOutputHandler {
 public:
+    // binds a simulator to the calling thread for the lifetime of the scope (must be the thread it is pinned to)
+    class Scope {
+    public:
+        Scope(Simulator &simulator);
+        ~Scope();
+    private:
+        Simulator *_previous;
+    };
+
     Simulator(Target target);
     virtual ~Simulator();
 
@@ -28,19 +42,46 @@ public:
 
     void screenshot(const std::string &filename);
 
+    // returns true if called from the thread the simulator is pinned to
+    bool pinnedToCallingThread() const { return std::this_thread::get_id() == _thread; }
+
+    // Disk image backing the simulated SD card (must be set before the target is created).
+    // The card is loaded from and synced to the image, or only kept in memory if no image is set.
+    void setSdCardImage(const std::string &filename) { _sdCardImage = filename; }
+    const std::string &sdCardImage() const { return _sdCardImage; }
+
     const TargetState &targetState() const { return _targetState; }
 
+    // MIDI output message recorded by render()
+    struct RenderedMidiMessage {
+        uint32_t tick;
+        uint8_t port;
+        uint8_t length;
+        uint8_t data[3];
+    };
+
+    // Runs the target for the given number of ticks and writes the output state after each tick:
+    // dac values to `dac` (ticks x DacChannels) and gate outputs as bitmask to `gates` (ticks).
+    // MIDI output messages are appended to `midi`. Each of the buffers may be nullptr.
+    void render(int ticks, uint16_t *dac, uint8_t *gates, std::vector<RenderedMidiMessage> *midi);
+
     double ticks();
 
     typedef std::function<void()> UpdateCallback;
 
     void addUpdateCallback(UpdateCallback callback);
 
+    // periodic tasks created by the target (called before update callbacks)
+    void addTask(UpdateCallback callback);
+
     // Target input/output handling
 
     void registerTargetTickObserver(TargetTickHandler *observer);
+    void unregisterTargetTickObserver(TargetTickHandler *observer);
     void registerTargetInputObserver(TargetInputHandler *observer);
+    void unregisterTargetInputObserver(TargetInputHandler *observer);
     void registerTargetOutputObserver(TargetOutputHandler *observer);
+    void unregisterTargetOutputObserver(TargetOutputHandler *observer);
 
     // TargetInputHandler
     void writeButton(int index, bool pressed) override;
@@ -57,20 +98,27 @@ public:
     void writeLcd(const FrameBuffer &frameBuffer) override;
     void writeMidiOutput(MidiEvent event) override;
 
+    // returns the simulator bound to the calling thread
     static Simulator &instance();
+    static Simulator *current();
 
 private:
     void step();
 
     Target _target;
     bool _targetCreated = false;
+    std::thread::id _thread;
+    std::string _sdCardImage;
 
     uint32_t _tick = 0;
 
+    std::vector<RenderedMidiMessage> *_renderedMidi = nullptr;
+
     std::vector<TargetTickHandler *> _targetTickObservers;
     std::vector<TargetInputHandler *> _targetInputObservers;
     std::vector<TargetOutputHandler *> _targetOutputObservers;
 
+    std::vector<UpdateCallback> _tasks;
     std::vector<UpdateCallback> _updateCallbacks;
 
     TargetState _targetState;
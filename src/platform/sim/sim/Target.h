@@ -5,6 +5,7 @@
 #include "FrameBuffer.h"
 
 #include <functional>
+#include <vector>
 
 #include <cstdint>
 
@@ -37,4 +38,10 @@ struct TargetOutputHandler {
     virtual void writeMidiOutput(MidiEvent event) {}
 };
 
+// Captures and restores the state of a running target (implemented by the application).
+struct TargetCheckpointHandler {
+    virtual bool saveCheckpoint(std::vector<uint8_t> &data) { return false; }
+    virtual bool restoreCheckpoint(const std::vector<uint8_t> &data) { return false; }
+};
+
 } // namespace sim
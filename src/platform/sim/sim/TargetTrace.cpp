@@ -1,6 +1,7 @@
 #include "TargetTrace.h"
 
 #include "TargetUtils.h"
+#include "TraceFile.h"
 
 #include "tinyformat.h"
 
@@ -182,12 +183,19 @@ void TargetTrace::readStream(std::istream &stream) {
 }
 
 void TargetTrace::saveToFile(const std::string &filename) const {
-    std::ofstream ofs(filename, std::ios::binary);
-    writeStream(ofs);
-    ofs.close();
+    TraceFileWriter writer(filename);
+    writer.write(*this);
+    writer.close();
 }
 
 void TargetTrace::loadFromFile(const std::string &filename) {
+    TraceFile traceFile;
+    if (traceFile.open(filename)) {
+        traceFile.load(*this);
+        return;
+    }
+
+    // raw stream written by previous versions
     std::ifstream ifs(filename, std::ios::binary);
     readStream(ifs);
     ifs.close();
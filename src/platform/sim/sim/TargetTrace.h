@@ -134,6 +134,7 @@ struct TargetTrace {
     void writeStream(std::ostream &stream) const;
     void readStream(std::istream &stream);
 
+    // saves/loads a trace file (see TraceFile.h), loading also accepts the raw stream format
     void saveToFile(const std::string &filename) const;
     void loadFromFile(const std::string &filename);
 
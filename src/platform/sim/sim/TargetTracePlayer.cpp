@@ -7,89 +7,113 @@
 namespace sim {
 
 struct TracePlayerBase {
-    virtual ~TracePlayerBase() = 0;
+    virtual ~TracePlayerBase() {}
     virtual void play(uint32_t tick) = 0;
 };
 
-template<typename T>
+template<typename Cursor>
 struct TracePlayer : public TracePlayerBase {
-    using Record = typename T::Record;
+    using Record = typename Cursor::Record;
 
-    TracePlayer(const T &trace, std::function<void(const Record &)> func) :
-        trace(trace),
+    TracePlayer(const Cursor &cursor, std::function<void(const Record &)> func) :
+        cursor(cursor),
         func(func)
     {}
 
     ~TracePlayer() {}
 
     void play(uint32_t tick) override {
-        while (pos < trace.items().size() && trace.items()[pos].first == tick) {
-            func(trace.items()[pos].second);
-            ++pos;
+        while (cursor.valid() && cursor.tick() == tick) {
+            func(cursor.record());
+            cursor.next();
         }
     }
 
-    size_t pos = 0;
-    const T &trace;
+    Cursor cursor;
     std::function<void(const Record &)> func;
 };
 
+typedef std::vector<std::unique_ptr<TracePlayerBase>> TracePlayers;
+
+template<typename T>
+static void addTracePlayer(TracePlayers &players, const TargetTrace &targetTrace, T TargetTrace::*trace, TraceStreamId id, std::function<void(const typename T::Record &)> func) {
+    players.emplace_back(new TracePlayer<TraceItemCursor<T>>(TraceItemCursor<T>(targetTrace.*trace), func));
+}
+
+template<typename T>
+static void addTracePlayer(TracePlayers &players, const TraceFile &traceFile, T TargetTrace::*trace, TraceStreamId id, std::function<void(const typename T::Record &)> func) {
+    using Cursor = TraceCursor<typename T::Record>;
+    players.emplace_back(new TracePlayer<Cursor>(Cursor(traceFile, id), func));
+}
+
 TargetTracePlayer::TargetTracePlayer(const TargetTrace &targetTrace, TargetInputHandler *targetInputHandler, TargetOutputHandler *targetOutputHandler) :
-    _targetTrace(targetTrace),
+    _targetTrace(&targetTrace),
     _targetInputHandler(targetInputHandler),
     _targetOutputHandler(targetOutputHandler)
 {
+    setup(targetTrace);
+}
+
+TargetTracePlayer::TargetTracePlayer(const TraceFile &traceFile, TargetInputHandler *targetInputHandler, TargetOutputHandler *targetOutputHandler) :
+    _targetInputHandler(targetInputHandler),
+    _targetOutputHandler(targetOutputHandler)
+{
+    setup(traceFile);
+}
+
+template<typename Source>
+void TargetTracePlayer::setup(const Source &source) {
     if (_targetInputHandler) {
-        _tracePlayers.emplace_back(new TracePlayer<ButtonTrace>(_targetTrace.button, [this] (const ButtonState &buttonState) {
+        addTracePlayer(_tracePlayers, source, &TargetTrace::button, TraceStreamId::Button, [this] (const ButtonState &buttonState) {
             for (size_t i = 0; i < buttonState.state.size(); ++i) {
                 _targetInputHandler->writeButton(i, buttonState.state[i]);
             }
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<AdcTrace>(_targetTrace.adc, [this] (const AdcState &adcState) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::adc, TraceStreamId::AdcInput, [this] (const AdcState &adcState) {
             for (size_t i = 0; i < adcState.state.size(); ++i) {
                 _targetInputHandler->writeAdc(i, adcState.state[i]);
             }
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<DigitalInputTrace>(_targetTrace.digitalInput, [this] (const DigitalInputState &digitalInputState) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::digitalInput, TraceStreamId::DigitalInput, [this] (const DigitalInputState &digitalInputState) {
             for (size_t i = 0; i < digitalInputState.state.size(); ++i) {
                 _targetInputHandler->writeDigitalInput(i, digitalInputState.state[i]);
             }
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<EncoderTrace>(_targetTrace.encoder, [this] (const EncoderEvent &encoderEvent) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::encoder, TraceStreamId::Encoder, [this] (const EncoderEvent &encoderEvent) {
             _targetInputHandler->writeEncoder(encoderEvent);
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<MidiTrace>(_targetTrace.midiInput, [this] (const MidiEvent &midiEvent) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::midiInput, TraceStreamId::MidiInput, [this] (const MidiEvent &midiEvent) {
             _targetInputHandler->writeMidiInput(midiEvent);
-        }));
+        });
     }
 
     if (_targetOutputHandler) {
-        _tracePlayers.emplace_back(new TracePlayer<LedTrace>(_targetTrace.led, [this] (const LedState &ledState) {
+        addTracePlayer(_tracePlayers, source, &TargetTrace::led, TraceStreamId::Led, [this] (const LedState &ledState) {
             for (size_t i = 0; i < ledState.state.size() / 2; ++i) {
                 _targetOutputHandler->writeLed(i, ledState.state[i * 2], ledState.state[i * 2 + 1]);
             }
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<GateOutputTrace>(_targetTrace.gateOutput, [this] (const GateOutputState &gateOutputState) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::gateOutput, TraceStreamId::GateOutput, [this] (const GateOutputState &gateOutputState) {
             for (size_t i = 0; i < gateOutputState.state.size(); ++i) {
                 _targetOutputHandler->writeGateOutput(i, gateOutputState.state[i]);
             }
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<DacTrace>(_targetTrace.dac, [this] (const DacState &dacState) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::dac, TraceStreamId::Dac, [this] (const DacState &dacState) {
             for (size_t i = 0; i < dacState.state.size(); ++i) {
                 _targetOutputHandler->writeDac(i, dacState.state[i]);
             }
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<DigitalOutputTrace>(_targetTrace.digitalOutput, [this] (const DigitalOutputState &digitalOutputState) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::digitalOutput, TraceStreamId::DigitalOutput, [this] (const DigitalOutputState &digitalOutputState) {
             for (size_t i = 0; i < digitalOutputState.state.size(); ++i) {
                 _targetOutputHandler->writeDigitalOutput(i, digitalOutputState.state[i]);
             }
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<LcdTrace>(_targetTrace.lcd, [this] (const LcdState &lcdState) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::lcd, TraceStreamId::Lcd, [this] (const LcdState &lcdState) {
             _targetOutputHandler->writeLcd(lcdState.state);
-        }));
-        _tracePlayers.emplace_back(new TracePlayer<MidiTrace>(_targetTrace.midiOutput, [this] (const MidiEvent &midiEvent) {
+        });
+        addTracePlayer(_tracePlayers, source, &TargetTrace::midiOutput, TraceStreamId::MidiOutput, [this] (const MidiEvent &midiEvent) {
             _targetOutputHandler->writeMidiOutput(midiEvent);
-        }));
+        });
     }
 }
 
@@ -2,6 +2,7 @@
 
 #include "Target.h"
 #include "TargetTrace.h"
+#include "TraceFile.h"
 
 #include <vector>
 #include <memory>
@@ -15,14 +16,20 @@ struct TracePlayerBase;
 class TargetTracePlayer : public TargetTickHandler {
 public:
     TargetTracePlayer(const TargetTrace &targetTrace, TargetInputHandler *targetInputHandler, TargetOutputHandler *targetOutputHandler);
+    // plays a trace file, records are decoded while playing
+    TargetTracePlayer(const TraceFile &traceFile, TargetInputHandler *targetInputHandler, TargetOutputHandler *targetOutputHandler);
     ~TargetTracePlayer();
 
-    const TargetTrace &targetTrace() const { return _targetTrace; }
+    // returns nullptr when playing a trace file
+    const TargetTrace *targetTrace() const { return _targetTrace; }
 
 protected:
     virtual void setTick(uint32_t tick) override;
 
-    const TargetTrace &_targetTrace;
+    template<typename Source>
+    void setup(const Source &source);
+
+    const TargetTrace *_targetTrace = nullptr;
     TargetInputHandler *_targetInputHandler;
     TargetOutputHandler *_targetOutputHandler;
 
@@ -1,12 +1,24 @@
 #include "TargetTraceRecorder.h"
 
+#include "core/Debug.h"
+
 namespace sim {
 
 TargetTraceRecorder::TargetTraceRecorder(TargetTrace &targetTrace) :
     TargetStateTracker(_targetState),
-    _targetTrace(targetTrace)
+    _targetTrace(&targetTrace)
+{}
+
+TargetTraceRecorder::TargetTraceRecorder(TraceFileWriter &traceFileWriter) :
+    TargetStateTracker(_targetState),
+    _traceFileWriter(&traceFileWriter)
 {}
 
+TargetTrace &TargetTraceRecorder::targetTrace() {
+    ASSERT(_targetTrace, "recorder writes into a trace file");
+    return *_targetTrace;
+}
+
 // TargetTickHandler
 
 void TargetTraceRecorder::setTick(uint32_t tick) {
@@ -17,56 +29,56 @@ void TargetTraceRecorder::setTick(uint32_t tick) {
 
 void TargetTraceRecorder::writeButton(int index, bool pressed) {
     TargetStateTracker::writeButton(index, pressed);
-    _targetTrace.button.write(_tick, _targetState.button);
+    record(&TargetTrace::button, &TraceFileWriter::button, _targetState.button);
 }
 
 void TargetTraceRecorder::writeEncoder(EncoderEvent event) {
-    _targetTrace.encoder.write(_tick, event);
+    record(&TargetTrace::encoder, &TraceFileWriter::encoder, event);
 }
 
 void TargetTraceRecorder::writeAdc(int channel, uint16_t value) {
     TargetStateTracker::writeAdc(channel, value);
-    _targetTrace.adc.write(_tick, _targetState.adc);
+    record(&TargetTrace::adc, &TraceFileWriter::adc, _targetState.adc);
 }
 
 void TargetTraceRecorder::writeDigitalInput(int pin, bool value) {
     TargetStateTracker::writeDigitalInput(pin, value);
-    _targetTrace.digitalInput.write(_tick, _targetState.digitalInput);
+    record(&TargetTrace::digitalInput, &TraceFileWriter::digitalInput, _targetState.digitalInput);
 }
 
 void TargetTraceRecorder::writeMidiInput(MidiEvent event) {
-    _targetTrace.midiInput.write(_tick, event);
+    record(&TargetTrace::midiInput, &TraceFileWriter::midiInput, event);
 }
 
 // TargetOutputHandler
 
 void TargetTraceRecorder::writeLed(int index, bool red, bool green) {
     TargetStateTracker::writeLed(index, red, green);
-    _targetTrace.led.write(_tick, _targetState.led);
+    record(&TargetTrace::led, &TraceFileWriter::led, _targetState.led);
 }
 
 void TargetTraceRecorder::writeGateOutput(int channel, bool value) {
     TargetStateTracker::writeGateOutput(channel, value);
-    _targetTrace.gateOutput.write(_tick, _targetState.gateOutput);
+    record(&TargetTrace::gateOutput, &TraceFileWriter::gateOutput, _targetState.gateOutput);
 }
 
 void TargetTraceRecorder::writeDac(int channel, uint16_t value) {
     TargetStateTracker::writeDac(channel, value);
-    _targetTrace.dac.write(_tick, _targetState.dac);
+    record(&TargetTrace::dac, &TraceFileWriter::dac, _targetState.dac);
 }
 
 void TargetTraceRecorder::writeDigitalOutput(int pin, bool value) {
     TargetStateTracker::writeDigitalOutput(pin, value);
-    _targetTrace.digitalOutput.write(_tick, _targetState.digitalOutput);
+    record(&TargetTrace::digitalOutput, &TraceFileWriter::digitalOutput, _targetState.digitalOutput);
 }
 
 void TargetTraceRecorder::writeLcd(const FrameBuffer &frameBuffer) {
     TargetStateTracker::writeLcd(frameBuffer);
-    _targetTrace.lcd.write(_tick, _targetState.lcd);
+    record(&TargetTrace::lcd, &TraceFileWriter::lcd, _targetState.lcd);
 }
 
 void TargetTraceRecorder::writeMidiOutput(MidiEvent event) {
-    _targetTrace.midiOutput.write(_tick, event);
+    record(&TargetTrace::midiOutput, &TraceFileWriter::midiOutput, event);
 }
 
 } // namespace sim
@@ -2,14 +2,18 @@
 
 #include "TargetStateTracker.h"
 #include "TargetTrace.h"
+#include "TraceFile.h"
 
 namespace sim {
 
 class TargetTraceRecorder : public TargetStateTracker, public TargetTickHandler {
 public:
     TargetTraceRecorder(TargetTrace &targetTrace);
+    // records directly into a trace file while running
+    TargetTraceRecorder(TraceFileWriter &traceFileWriter);
 
-    TargetTrace &targetTrace() { return _targetTrace; }
+    // only available when recording into memory
+    TargetTrace &targetTrace();
 
     // TargetTickHandler
     virtual void setTick(uint32_t tick) override;
@@ -32,7 +36,18 @@ public:
 private:
     TargetState _targetState;
     uint32_t _tick = 0;
-    TargetTrace &_targetTrace;
+    TargetTrace *_targetTrace = nullptr;
+    TraceFileWriter *_traceFileWriter = nullptr;
+
+    template<typename Record, typename Trace, typename Writer>
+    void record(Trace TargetTrace::*trace, Writer TraceFileWriter::*writer, const Record &record) {
+        if (_targetTrace) {
+            (_targetTrace->*trace).write(_tick, record);
+        }
+        if (_traceFileWriter) {
+            (_traceFileWriter->*writer).write(_tick, record);
+        }
+    }
 };
 
 } // namespace sim
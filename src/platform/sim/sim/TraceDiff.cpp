@@ -0,0 +1,315 @@
+#include "TraceDiff.h"
+
+#include "TargetUtils.h"
+
+#include "tinyformat.h"
+
+#include <algorithm>
+#include <deque>
+
+#include <cstdlib>
+
+namespace sim {
+
+template<typename T>
+struct TraceEntry {
+    uint32_t tick;
+    T value;
+};
+
+static void diverge(TraceDiff::Channel &channel, uint32_t tick, const std::string &description) {
+    if (!channel.diverged) {
+        channel.diverged = true;
+        channel.tick = tick;
+        channel.description = description;
+    }
+}
+
+static bool equal(const MidiEvent &a, const MidiEvent &b) {
+    if (a.kind != b.kind || a.port != b.port) {
+        return false;
+    }
+    switch (a.kind) {
+    case MidiEvent::Connect:
+        return a.connect.vendorId == b.connect.vendorId && a.connect.productId == b.connect.productId;
+    case MidiEvent::Disconnect:
+        return true;
+    case MidiEvent::Message: {
+        const auto &ma = a.message;
+        const auto &mb = b.message;
+        if (ma.length() != mb.length() || std::memcmp(ma.raw(), mb.raw(), ma.length()) != 0) {
+            return false;
+        }
+        size_t payloadLength = ma.hasPayload() ? ma.payloadLength() : 0;
+        if (payloadLength != (mb.hasPayload() ? mb.payloadLength() : 0)) {
+            return false;
+        }
+        return payloadLength == 0 || std::memcmp(ma.payloadData(), mb.payloadData(), payloadLength) == 0;
+    }
+    }
+    return false;
+}
+
+static std::string describe(const MidiEvent &event) {
+    switch (event.kind) {
+    case MidiEvent::Connect:
+        return tfm::format("connect port %d (vid: %04x pid: %04x)", event.port, event.connect.vendorId, event.connect.productId);
+    case MidiEvent::Disconnect:
+        return tfm::format("disconnect port %d", event.port);
+    case MidiEvent::Message: {
+        std::string str = tfm::format("port %d msg", event.port);
+        for (int i = 0; i < event.message.length(); ++i) {
+            str += tfm::format(" %02x", int(event.message.raw()[i]));
+        }
+        if (event.message.hasPayload()) {
+            str += tfm::format(" (%d bytes payload)", event.message.payloadLength());
+        }
+        return str;
+    }
+    }
+    return "unknown";
+}
+
+// Histogram
+
+constexpr int TraceDiff::Histogram::Range;
+
+void TraceDiff::Histogram::add(int offset) {
+    _min = _count > 0 ? std::min(_min, offset) : offset;
+    _max = _count > 0 ? std::max(_max, offset) : offset;
+    _sum += offset;
+    ++_count;
+    ++_bins[std::max(-Range, std::min(Range, offset)) + Range];
+}
+
+uint32_t TraceDiff::Histogram::count(int offset) const {
+    return (offset < -Range || offset > Range) ? 0 : _bins[offset + Range];
+}
+
+// TraceDiff
+
+TraceDiff::TraceDiff(const Options &options) :
+    _options(options)
+{}
+
+void TraceDiff::diff(const TargetTrace &a, const TargetTrace &b) {
+    diff(
+        TraceItemCursor<GateOutputTrace>(a.gateOutput), TraceItemCursor<GateOutputTrace>(b.gateOutput),
+        TraceItemCursor<DacTrace>(a.dac), TraceItemCursor<DacTrace>(b.dac),
+        TraceItemCursor<MidiTrace>(a.midiOutput), TraceItemCursor<MidiTrace>(b.midiOutput)
+    );
+}
+
+void TraceDiff::diff(const TraceFile &a, const TraceFile &b) {
+    diff(
+        TraceCursor<GateOutputState>(a, TraceStreamId::GateOutput), TraceCursor<GateOutputState>(b, TraceStreamId::GateOutput),
+        TraceCursor<DacState>(a, TraceStreamId::Dac), TraceCursor<DacState>(b, TraceStreamId::Dac),
+        TraceCursor<MidiEvent>(a, TraceStreamId::MidiOutput), TraceCursor<MidiEvent>(b, TraceStreamId::MidiOutput)
+    );
+}
+
+template<typename GateCursor, typename DacCursor, typename MidiCursor>
+void TraceDiff::diff(GateCursor gateA, GateCursor gateB, DacCursor dacA, DacCursor dacB, MidiCursor midiA, MidiCursor midiB) {
+    _gate.fill(Channel());
+    _dac.fill(Channel());
+    _midiOutput = Channel();
+
+    diffGates(gateA, gateB);
+    diffDacs(dacA, dacB);
+    diffMidi(midiA, midiB);
+}
+
+// Streams both cursors in tick order, calling consume(side, cursor) for each record.
+template<typename Cursor, typename Consume>
+static void merge(Cursor &a, Cursor &b, Consume consume) {
+    while (a.valid() || b.valid()) {
+        if (a.valid() && (!b.valid() || a.tick() <= b.tick())) {
+            consume(0, a);
+            a.next();
+        } else {
+            consume(1, b);
+            b.next();
+        }
+    }
+}
+
+template<typename Cursor>
+void TraceDiff::diffGates(Cursor a, Cursor b) {
+    typedef TraceEntry<bool> Edge;
+    static constexpr int Count = GateOutputState::Count;
+
+    GateOutputState states[2];
+    std::array<std::deque<Edge>, Count> edges[2];
+
+    auto pair = [&] (int channel) {
+        auto &edgesA = edges[0][channel];
+        auto &edgesB = edges[1][channel];
+        while (!edgesA.empty() && !edgesB.empty()) {
+            const auto &edgeA = edgesA.front();
+            const auto &edgeB = edgesB.front();
+            int offset = int(edgeB.tick - edgeA.tick);
+            _gate[channel].offsets.add(offset);
+            if (edgeA.value != edgeB.value) {
+                diverge(_gate[channel], std::min(edgeA.tick, edgeB.tick), tfm::format("%s edge at %d, second trace has %s edge at %d",
+                    edgeA.value ? "rising" : "falling", edgeA.tick, edgeB.value ? "rising" : "falling", edgeB.tick));
+            } else if (uint32_t(std::abs(offset)) > _options.tickTolerance) {
+                diverge(_gate[channel], std::min(edgeA.tick, edgeB.tick), tfm::format("%s edge at %d, second trace at %d (%+d)",
+                    edgeA.value ? "rising" : "falling", edgeA.tick, edgeB.tick, offset));
+            }
+            edgesA.pop_front();
+            edgesB.pop_front();
+        }
+    };
+
+    merge(a, b, [&] (int side, const Cursor &cursor) {
+        const auto &state = cursor.record().state;
+        auto changed = state ^ states[side].state;
+        if (changed.none()) {
+            return;
+        }
+        for (int channel = 0; channel < Count; ++channel) {
+            if (changed[channel]) {
+                edges[side][channel].push_back({ cursor.tick(), state[channel] });
+                _gate[channel].count += side == 0 ? 1 : 0;
+                pair(channel);
+            }
+        }
+        states[side].state = state;
+    });
+
+    for (int channel = 0; channel < Count; ++channel) {
+        for (int side = 0; side < 2; ++side) {
+            if (!edges[side][channel].empty()) {
+                const auto &edge = edges[side][channel].front();
+                diverge(_gate[channel], edge.tick, tfm::format("%s edge at %d missing in %s trace",
+                    edge.value ? "rising" : "falling", edge.tick, side == 0 ? "second" : "first"));
+            }
+        }
+    }
+}
+
+template<typename Cursor>
+void TraceDiff::diffDacs(Cursor a, Cursor b) {
+    static constexpr int Count = DacState::Count;
+
+    DacState states[2];
+    std::array<bool, Count> mismatch;
+    std::array<TraceEntry<std::pair<uint16_t, uint16_t>>, Count> mismatchStart;
+    mismatch.fill(false);
+
+    auto check = [&] (int channel, uint32_t tick) {
+        uint16_t valueA = states[0].state[channel];
+        uint16_t valueB = states[1].state[channel];
+        bool differs = uint32_t(std::abs(int(valueA) - int(valueB))) > _options.dacTolerance;
+        if (mismatch[channel] && tick - mismatchStart[channel].tick > _options.tickTolerance) {
+            const auto &start = mismatchStart[channel];
+            diverge(_dac[channel], start.tick, tfm::format("%.3fV, second trace %.3fV",
+                dacToVoltage(start.value.first), dacToVoltage(start.value.second)));
+        }
+        if (differs && !mismatch[channel]) {
+            mismatchStart[channel] = { tick, { valueA, valueB } };
+        }
+        mismatch[channel] = differs;
+    };
+
+    // each tick holds at most one record per trace, changes of both traces are checked together
+    merge(a, b, [&] (int side, const Cursor &cursor) {
+        const auto &state = cursor.record().state;
+        for (int channel = 0; channel < Count; ++channel) {
+            _dac[channel].count += (side == 0 && state[channel] != states[0].state[channel]) ? 1 : 0;
+        }
+        states[side].state = state;
+        if (side == 0 && b.valid() && b.tick() == cursor.tick()) {
+            return;
+        }
+        for (int channel = 0; channel < Count; ++channel) {
+            check(channel, cursor.tick());
+        }
+    });
+
+    for (int channel = 0; channel < Count; ++channel) {
+        if (mismatch[channel]) {
+            const auto &start = mismatchStart[channel];
+            diverge(_dac[channel], start.tick, tfm::format("%.3fV, second trace %.3fV until end of trace",
+                dacToVoltage(start.value.first), dacToVoltage(start.value.second)));
+        }
+    }
+}
+
+template<typename Cursor>
+void TraceDiff::diffMidi(Cursor a, Cursor b) {
+    typedef TraceEntry<MidiEvent> Event;
+
+    std::deque<Event> events[2];
+
+    merge(a, b, [&] (int side, const Cursor &cursor) {
+        events[side].push_back({ cursor.tick(), cursor.record() });
+        _midiOutput.count += side == 0 ? 1 : 0;
+
+        while (!events[0].empty() && !events[1].empty()) {
+            const auto &eventA = events[0].front();
+            const auto &eventB = events[1].front();
+            int offset = int(eventB.tick - eventA.tick);
+            _midiOutput.offsets.add(offset);
+            if (!equal(eventA.value, eventB.value)) {
+                diverge(_midiOutput, std::min(eventA.tick, eventB.tick), tfm::format("%s at %d, second trace has %s at %d",
+                    describe(eventA.value), eventA.tick, describe(eventB.value), eventB.tick));
+            } else if (uint32_t(std::abs(offset)) > _options.tickTolerance) {
+                diverge(_midiOutput, std::min(eventA.tick, eventB.tick), tfm::format("%s at %d, second trace at %d (%+d)",
+                    describe(eventA.value), eventA.tick, eventB.tick, offset));
+            }
+            events[0].pop_front();
+            events[1].pop_front();
+        }
+    });
+
+    for (int side = 0; side < 2; ++side) {
+        if (!events[side].empty()) {
+            const auto &event = events[side].front();
+            diverge(_midiOutput, event.tick, tfm::format("%s at %d missing in %s trace",
+                describe(event.value), event.tick, side == 0 ? "second" : "first"));
+        }
+    }
+}
+
+bool TraceDiff::identical() const {
+    auto diverged = [] (const Channel &channel) { return channel.diverged; };
+    return std::none_of(_gate.begin(), _gate.end(), diverged) &&
+        std::none_of(_dac.begin(), _dac.end(), diverged) &&
+        !_midiOutput.diverged;
+}
+
+static void writeChannel(std::ostream &os, const std::string &name, const char *unit, const TraceDiff::Channel &channel, bool printOffsets) {
+    os << tfm::format("%-8s %8d %-7s ", name, channel.count, unit);
+    if (channel.diverged) {
+        os << tfm::format("diverged at %d: %s", channel.tick, channel.description);
+    } else {
+        os << "ok";
+    }
+    os << std::endl;
+
+    const auto &offsets = channel.offsets;
+    if (printOffsets && offsets.count() > 0 && (offsets.min() != 0 || offsets.max() != 0)) {
+        os << tfm::format("%-8s offsets min %+d max %+d mean %+.2f |", "", offsets.min(), offsets.max(), offsets.mean());
+        for (int offset = -TraceDiff::Histogram::Range; offset <= TraceDiff::Histogram::Range; ++offset) {
+            if (offsets.count(offset) > 0) {
+                bool outer = offset == -TraceDiff::Histogram::Range || offset == TraceDiff::Histogram::Range;
+                os << tfm::format(" %s%+d: %d", outer ? (offset < 0 ? "<=" : ">=") : "", offset, offsets.count(offset));
+            }
+        }
+        os << std::endl;
+    }
+}
+
+void TraceDiff::writeReport(std::ostream &os) const {
+    for (int channel = 0; channel < int(_gate.size()); ++channel) {
+        writeChannel(os, tfm::format("gate %d", channel + 1), "edges", _gate[channel], true);
+    }
+    for (int channel = 0; channel < int(_dac.size()); ++channel) {
+        writeChannel(os, tfm::format("cv %d", channel + 1), "changes", _dac[channel], false);
+    }
+    writeChannel(os, "midi", "events", _midiOutput, true);
+    os << (identical() ? "traces are identical" : "traces diverge") << std::endl;
+}
+
+} // namespace sim
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "TargetTrace.h"
+#include "TraceFile.h"
+
+#include <array>
+#include <ostream>
+#include <string>
+
+#include <cstdint>
+
+namespace sim {
+
+// Compares the outputs (gates, cv and midi) of two target traces.
+//
+// Both traces are streamed side by side in tick order. Gate edges and midi events are paired in
+// order of occurrence and may be shifted by up to `tickTolerance` ticks, dac values may differ by up
+// to `dacTolerance` for at most `tickTolerance` ticks. For each channel the first divergence is
+// reported together with a histogram of the tick offsets of paired gate edges and midi events.
+class TraceDiff {
+public:
+    struct Options {
+        // maximum offset of paired gate edges/midi events and duration of dac mismatches in ticks
+        uint32_t tickTolerance = 0;
+        // maximum difference of dac values
+        uint16_t dacTolerance = 0;
+    };
+
+    // Tick offsets (second - first trace), offsets outside +/- Range are counted in the outer bins.
+    class Histogram {
+    public:
+        static constexpr int Range = 8;
+
+        Histogram() { _bins.fill(0); }
+
+        void add(int offset);
+
+        uint32_t count() const { return _count; }
+        uint32_t count(int offset) const;
+        int min() const { return _min; }
+        int max() const { return _max; }
+        float mean() const { return _count > 0 ? float(_sum) / _count : 0.f; }
+
+    private:
+        std::array<uint32_t, Range * 2 + 1> _bins;
+        uint32_t _count = 0;
+        int64_t _sum = 0;
+        int _min = 0;
+        int _max = 0;
+    };
+
+    struct Channel {
+        // number of gate edges/dac changes/midi events in the first trace
+        uint32_t count = 0;
+        bool diverged = false;
+        // tick of the first divergence
+        uint32_t tick = 0;
+        std::string description;
+        Histogram offsets;
+    };
+
+    TraceDiff() {}
+    TraceDiff(const Options &options);
+
+    void diff(const TargetTrace &a, const TargetTrace &b);
+    // streams memory-mapped trace files, records are decoded while comparing
+    void diff(const TraceFile &a, const TraceFile &b);
+
+    // returns true if no channel diverged
+    bool identical() const;
+
+    const Channel &gate(int channel) const { return _gate[channel]; }
+    const Channel &dac(int channel) const { return _dac[channel]; }
+    const Channel &midiOutput() const { return _midiOutput; }
+
+    // writes a per channel summary
+    void writeReport(std::ostream &os) const;
+
+private:
+    template<typename GateCursor, typename DacCursor, typename MidiCursor>
+    void diff(GateCursor gateA, GateCursor gateB, DacCursor dacA, DacCursor dacB, MidiCursor midiA, MidiCursor midiB);
+
+    template<typename Cursor>
+    void diffGates(Cursor a, Cursor b);
+    template<typename Cursor>
+    void diffDacs(Cursor a, Cursor b);
+    template<typename Cursor>
+    void diffMidi(Cursor a, Cursor b);
+
+    Options _options;
+    std::array<Channel, GateOutputState::Count> _gate;
+    std::array<Channel, DacState::Count> _dac;
+    Channel _midiOutput;
+};
+
+} // namespace sim
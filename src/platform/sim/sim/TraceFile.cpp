@@ -0,0 +1,301 @@
+#include "TraceFile.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace sim {
+
+// TraceRecordCodec<MidiEvent>
+
+void TraceRecordCodec<MidiEvent>::encode(std::vector<uint8_t> &buffer, const MidiEvent &event, const MidiEvent &previous) {
+    buffer.push_back(event.kind);
+    buffer.push_back(event.port);
+    switch (event.kind) {
+    case MidiEvent::Connect:
+        tracefile::writeVarint(buffer, event.connect.vendorId);
+        tracefile::writeVarint(buffer, event.connect.productId);
+        break;
+    case MidiEvent::Disconnect:
+        break;
+    case MidiEvent::Message: {
+        const auto &message = event.message;
+        buffer.push_back(message.length());
+        buffer.insert(buffer.end(), message.raw(), message.raw() + message.length());
+        size_t payloadLength = message.hasPayload() ? message.payloadLength() : 0;
+        tracefile::writeVarint(buffer, payloadLength);
+        if (payloadLength > 0) {
+            buffer.insert(buffer.end(), message.payloadData(), message.payloadData() + payloadLength);
+        }
+        break;
+    }
+    }
+}
+
+bool TraceRecordCodec<MidiEvent>::decode(const uint8_t *&p, const uint8_t *end, MidiEvent &event) {
+    if (end - p < 2) {
+        return false;
+    }
+    int kind = *p++;
+    int port = *p++;
+    switch (kind) {
+    case MidiEvent::Connect: {
+        uint32_t vendorId, productId;
+        if (!tracefile::readVarint(p, end, vendorId) || !tracefile::readVarint(p, end, productId)) {
+            return false;
+        }
+        event = MidiEvent::makeConnect(port, vendorId, productId);
+        return true;
+    }
+    case MidiEvent::Disconnect:
+        event = MidiEvent::makeDisconnect(port);
+        return true;
+    case MidiEvent::Message: {
+        if (p >= end || *p > 3 || end - p < 1 + *p) {
+            return false;
+        }
+        int length = *p++;
+        MidiMessage message;
+        switch (length) {
+        case 1: message = MidiMessage(p[0]); break;
+        case 2: message = MidiMessage(p[0], p[1]); break;
+        case 3: message = MidiMessage(p[0], p[1], p[2]); break;
+        }
+        p += length;
+        uint32_t payloadLength;
+        if (!tracefile::readVarint(p, end, payloadLength) || payloadLength > size_t(end - p)) {
+            return false;
+        }
+        if (payloadLength > 0) {
+            message.setPayload(p, payloadLength);
+            p += payloadLength;
+        }
+        event = MidiEvent::makeMessage(port, message);
+        return true;
+    }
+    }
+    return false;
+}
+
+// TraceStreamWriterBase
+
+void TraceStreamWriterBase::beginRecord(uint32_t tick) {
+    if (_count == 0) {
+        _firstTick = _lastTick = tick;
+    }
+    tracefile::writeVarint(_buffer, tick - _lastTick);
+    _lastTick = tick;
+}
+
+bool TraceStreamWriterBase::endRecord() {
+    ++_count;
+    ++_totalCount;
+    if (_buffer.size() >= _file.chunkSize()) {
+        flushChunk();
+        return true;
+    }
+    return false;
+}
+
+void TraceStreamWriterBase::flushChunk() {
+    if (_count > 0) {
+        _file.writeChunk(_id, _count, _firstTick, _lastTick, _buffer);
+    }
+    _buffer.clear();
+    _count = 0;
+}
+
+// TraceFileWriter
+
+TraceFileWriter::TraceFileWriter(const std::string &filename, size_t chunkSize) :
+    button(*this, TraceStreamId::Button),
+    adc(*this, TraceStreamId::AdcInput),
+    digitalInput(*this, TraceStreamId::DigitalInput),
+    led(*this, TraceStreamId::Led),
+    gateOutput(*this, TraceStreamId::GateOutput),
+    dac(*this, TraceStreamId::Dac),
+    digitalOutput(*this, TraceStreamId::DigitalOutput),
+    lcd(*this, TraceStreamId::Lcd),
+    encoder(*this, TraceStreamId::Encoder),
+    midiInput(*this, TraceStreamId::MidiInput),
+    midiOutput(*this, TraceStreamId::MidiOutput),
+    _ofs(filename, std::ios::binary),
+    _chunkSize(chunkSize)
+{
+    std::vector<uint8_t> header(tracefile::Magic, tracefile::Magic + sizeof(tracefile::Magic));
+    tracefile::writeU32(header, tracefile::Version);
+    _ofs.write(reinterpret_cast<const char *>(header.data()), header.size());
+    _size += header.size();
+}
+
+TraceFileWriter::~TraceFileWriter() {
+    close();
+}
+
+void TraceFileWriter::close() {
+    if (!_ofs.is_open()) {
+        return;
+    }
+    button.flush();
+    adc.flush();
+    digitalInput.flush();
+    led.flush();
+    gateOutput.flush();
+    dac.flush();
+    digitalOutput.flush();
+    lcd.flush();
+    encoder.flush();
+    midiInput.flush();
+    midiOutput.flush();
+    _ofs.close();
+}
+
+template<typename Trace, typename Writer>
+static void writeTrace(const Trace &trace, Writer &writer) {
+    for (const auto &item : trace.items()) {
+        writer.write(item.first, item.second);
+    }
+}
+
+void TraceFileWriter::write(const TargetTrace &trace) {
+    writeTrace(trace.button, button);
+    writeTrace(trace.adc, adc);
+    writeTrace(trace.digitalInput, digitalInput);
+    writeTrace(trace.led, led);
+    writeTrace(trace.gateOutput, gateOutput);
+    writeTrace(trace.dac, dac);
+    writeTrace(trace.digitalOutput, digitalOutput);
+    writeTrace(trace.lcd, lcd);
+    writeTrace(trace.encoder, encoder);
+    writeTrace(trace.midiInput, midiInput);
+    writeTrace(trace.midiOutput, midiOutput);
+}
+
+void TraceFileWriter::writeChunk(TraceStreamId id, uint32_t count, uint32_t firstTick, uint32_t lastTick, const std::vector<uint8_t> &data) {
+    if (!_ofs.is_open()) {
+        return;
+    }
+    std::vector<uint8_t> header;
+    header.reserve(tracefile::ChunkHeaderSize);
+    header.push_back(uint8_t(id));
+    header.insert(header.end(), 3, 0);
+    tracefile::writeU32(header, data.size());
+    tracefile::writeU32(header, count);
+    tracefile::writeU32(header, firstTick);
+    tracefile::writeU32(header, lastTick);
+    _ofs.write(reinterpret_cast<const char *>(header.data()), header.size());
+    _ofs.write(reinterpret_cast<const char *>(data.data()), data.size());
+    _size += header.size() + data.size();
+}
+
+// TraceFile
+
+TraceFile::~TraceFile() {
+    close();
+}
+
+bool TraceFile::open(const std::string &filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || size_t(st.st_size) < tracefile::HeaderSize) {
+        ::close(fd);
+        return false;
+    }
+    _size = st.st_size;
+
+    void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+        _data = static_cast<const uint8_t *>(data);
+        _mapped = true;
+    } else {
+        // fall back to reading the file if it cannot be mapped
+        _buffer.resize(_size);
+        if (::read(fd, _buffer.data(), _size) == ssize_t(_size)) {
+            _data = _buffer.data();
+        }
+    }
+    ::close(fd);
+
+    if (!_data ||
+        std::memcmp(_data, tracefile::Magic, sizeof(tracefile::Magic)) != 0 ||
+        tracefile::readU32(_data + sizeof(tracefile::Magic)) != tracefile::Version) {
+        close();
+        return false;
+    }
+
+    const uint8_t *p = _data + tracefile::HeaderSize;
+    const uint8_t *end = _data + _size;
+    while (size_t(end - p) >= tracefile::ChunkHeaderSize) {
+        Chunk chunk;
+        chunk.stream = TraceStreamId(p[0]);
+        chunk.size = tracefile::readU32(p + 4);
+        chunk.count = tracefile::readU32(p + 8);
+        chunk.firstTick = tracefile::readU32(p + 12);
+        chunk.lastTick = tracefile::readU32(p + 16);
+        chunk.data = p + tracefile::ChunkHeaderSize;
+        if (chunk.stream >= TraceStreamId::Last || chunk.size > size_t(end - chunk.data)) {
+            break;
+        }
+        _chunks[int(chunk.stream)].emplace_back(chunk);
+        p = chunk.data + chunk.size;
+    }
+
+    return true;
+}
+
+void TraceFile::close() {
+    if (_mapped) {
+        munmap(const_cast<uint8_t *>(_data), _size);
+    }
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+    _buffer.clear();
+    for (auto &chunks : _chunks) {
+        chunks.clear();
+    }
+}
+
+size_t TraceFile::count(TraceStreamId id) const {
+    size_t count = 0;
+    for (const auto &chunk : chunks(id)) {
+        count += chunk.count;
+    }
+    return count;
+}
+
+template<typename Trace>
+static void loadTrace(const TraceFile &file, TraceStreamId id, Trace &trace) {
+    trace = Trace();
+    for (TraceCursor<typename Trace::Record> cursor(file, id); cursor.valid(); cursor.next()) {
+        trace.write(cursor.tick(), cursor.record());
+    }
+}
+
+void TraceFile::load(TargetTrace &trace) const {
+    loadTrace(*this, TraceStreamId::Button, trace.button);
+    loadTrace(*this, TraceStreamId::AdcInput, trace.adc);
+    loadTrace(*this, TraceStreamId::DigitalInput, trace.digitalInput);
+    loadTrace(*this, TraceStreamId::Led, trace.led);
+    loadTrace(*this, TraceStreamId::GateOutput, trace.gateOutput);
+    loadTrace(*this, TraceStreamId::Dac, trace.dac);
+    loadTrace(*this, TraceStreamId::DigitalOutput, trace.digitalOutput);
+    loadTrace(*this, TraceStreamId::Lcd, trace.lcd);
+    loadTrace(*this, TraceStreamId::Encoder, trace.encoder);
+    loadTrace(*this, TraceStreamId::MidiInput, trace.midiInput);
+    loadTrace(*this, TraceStreamId::MidiOutput, trace.midiOutput);
+}
+
+bool TraceFile::isTraceFile(const std::string &filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    char magic[sizeof(tracefile::Magic)];
+    return ifs.read(magic, sizeof(magic)) && std::memcmp(magic, tracefile::Magic, sizeof(magic)) == 0;
+}
+
+} // namespace sim
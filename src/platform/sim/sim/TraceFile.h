@@ -0,0 +1,448 @@
+#pragma once
+
+#include "TargetTrace.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+#include <cstring>
+
+namespace sim {
+
+// Chunked on-disk trace format.
+//
+// A trace file starts with a header (magic + version) followed by a sequence of chunks. Each chunk
+// holds a run of records of a single stream:
+//
+//   chunk header: stream (u8), reserved (3 bytes), size (u32), count (u32), first tick (u32), last tick (u32)
+//   record:       tick delta (varint), encoded record
+//
+// State records are stored as XOR-delta to the previous record of the chunk, with runs of unchanged
+// bytes collapsed (RLE). Event records are encoded individually. Every chunk starts from the default
+// record, so chunks can be decoded independently of each other. Files are written incrementally
+// (chunks are appended as they fill up) and memory-mapped for reading.
+
+enum class TraceStreamId : uint8_t {
+    Button,
+    AdcInput,
+    DigitalInput,
+    Led,
+    GateOutput,
+    Dac,
+    DigitalOutput,
+    Lcd,
+    Encoder,
+    MidiInput,
+    MidiOutput,
+    Last
+};
+
+namespace tracefile {
+
+    static const char Magic[8] = { 'P', 'E', 'R', 'T', 'R', 'A', 'C', 'E' };
+    static const uint32_t Version = 1;
+    static const size_t HeaderSize = 12;
+    static const size_t ChunkHeaderSize = 20;
+    static const size_t DefaultChunkSize = 64 * 1024;
+
+    inline void writeU32(std::vector<uint8_t> &buffer, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            buffer.push_back(value >> (i * 8));
+        }
+    }
+
+    inline uint32_t readU32(const uint8_t *p) {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    inline void writeVarint(std::vector<uint8_t> &buffer, uint32_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(uint8_t(value) | 0x80);
+            value >>= 7;
+        }
+        buffer.push_back(uint8_t(value));
+    }
+
+    inline bool readVarint(const uint8_t *&p, const uint8_t *end, uint32_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 35 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            value |= uint32_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Encodes `data` as XOR-delta to `previous`: alternating varint lengths of unchanged and
+    // changed byte runs, changed runs followed by their XOR bytes.
+    inline void writeDelta(std::vector<uint8_t> &buffer, const uint8_t *previous, const uint8_t *data, size_t size) {
+        size_t pos = 0;
+        while (pos < size) {
+            size_t start = pos;
+            while (pos < size && data[pos] == previous[pos]) {
+                ++pos;
+            }
+            writeVarint(buffer, pos - start);
+            if (pos == size) {
+                break;
+            }
+
+            // extend changed run over short gaps of unchanged bytes
+            start = pos;
+            size_t last = pos;
+            while (pos < size && pos - last <= 2) {
+                if (data[pos] != previous[pos]) {
+                    last = pos;
+                }
+                ++pos;
+            }
+            pos = last + 1;
+            writeVarint(buffer, pos - start);
+            for (size_t i = start; i < pos; ++i) {
+                buffer.push_back(data[i] ^ previous[i]);
+            }
+        }
+    }
+
+    inline bool readDelta(const uint8_t *&p, const uint8_t *end, uint8_t *data, size_t size) {
+        size_t pos = 0;
+        while (pos < size) {
+            uint32_t unchanged;
+            if (!readVarint(p, end, unchanged) || unchanged > size - pos) {
+                return false;
+            }
+            pos += unchanged;
+            if (pos == size) {
+                break;
+            }
+            uint32_t changed;
+            if (!readVarint(p, end, changed) || changed > size - pos || changed > size_t(end - p)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < changed; ++i) {
+                data[pos++] ^= *p++;
+            }
+        }
+        return true;
+    }
+
+} // namespace tracefile
+
+// Record encoding. State records are plain value types and are delta encoded as raw bytes.
+template<typename T>
+struct TraceRecordCodec {
+    static void encode(std::vector<uint8_t> &buffer, const T &record, const T &previous) {
+        tracefile::writeDelta(buffer, reinterpret_cast<const uint8_t *>(&previous), reinterpret_cast<const uint8_t *>(&record), sizeof(T));
+    }
+
+    // decodes into `record`, which holds the previous record of the chunk
+    static bool decode(const uint8_t *&p, const uint8_t *end, T &record) {
+        return tracefile::readDelta(p, end, reinterpret_cast<uint8_t *>(&record), sizeof(T));
+    }
+};
+
+template<>
+struct TraceRecordCodec<EncoderEvent> {
+    static void encode(std::vector<uint8_t> &buffer, const EncoderEvent &event, const EncoderEvent &previous) {
+        buffer.push_back(uint8_t(event));
+    }
+
+    static bool decode(const uint8_t *&p, const uint8_t *end, EncoderEvent &event) {
+        if (p >= end) {
+            return false;
+        }
+        event = EncoderEvent(*p++);
+        return true;
+    }
+};
+
+template<>
+struct TraceRecordCodec<MidiEvent> {
+    static void encode(std::vector<uint8_t> &buffer, const MidiEvent &event, const MidiEvent &previous);
+    static bool decode(const uint8_t *&p, const uint8_t *end, MidiEvent &event);
+};
+
+class TraceFileWriter;
+
+class TraceStreamWriterBase {
+public:
+    size_t count() const { return _totalCount; }
+
+protected:
+    TraceStreamWriterBase(TraceFileWriter &file, TraceStreamId id) :
+        _file(file),
+        _id(id)
+    {}
+
+    void beginRecord(uint32_t tick);
+    // returns true if the chunk was written out
+    bool endRecord();
+    void flushChunk();
+
+    std::vector<uint8_t> _buffer;
+
+private:
+    TraceFileWriter &_file;
+    TraceStreamId _id;
+    uint32_t _count = 0;
+    uint32_t _firstTick = 0;
+    uint32_t _lastTick = 0;
+    size_t _totalCount = 0;
+};
+
+// Writes a state stream. Same as StateTrace, only changes are recorded and the last state written
+// at a tick wins, so the most recent state is held back until the tick advances.
+template<typename T>
+class TraceStateWriter : public TraceStreamWriterBase {
+public:
+    TraceStateWriter(TraceFileWriter &file, TraceStreamId id) :
+        TraceStreamWriterBase(file, id)
+    {}
+
+    void write(uint32_t tick, const T &state) {
+        if (!_hasPending) {
+            _pendingTick = tick;
+            _pending = state;
+            _hasPending = true;
+        } else if (tick == _pendingTick) {
+            _pending = state;
+        } else if (state != _pending) {
+            commit();
+            _pendingTick = tick;
+            _pending = state;
+            _hasPending = true;
+        }
+    }
+
+    void flush() {
+        commit();
+        flushChunk();
+    }
+
+private:
+    void commit() {
+        if (!_hasPending) {
+            return;
+        }
+        beginRecord(_pendingTick);
+        TraceRecordCodec<T>::encode(_buffer, _pending, _previous);
+        _previous = _pending;
+        if (endRecord()) {
+            _previous = T();
+        }
+        _hasPending = false;
+    }
+
+    bool _hasPending = false;
+    uint32_t _pendingTick = 0;
+    T _pending;
+    T _previous;
+};
+
+template<typename T>
+class TraceEventWriter : public TraceStreamWriterBase {
+public:
+    TraceEventWriter(TraceFileWriter &file, TraceStreamId id) :
+        TraceStreamWriterBase(file, id)
+    {}
+
+    void write(uint32_t tick, const T &event) {
+        beginRecord(tick);
+        TraceRecordCodec<T>::encode(_buffer, event, _previous);
+        _previous = event;
+        if (endRecord()) {
+            _previous = T();
+        }
+    }
+
+    void flush() {
+        flushChunk();
+    }
+
+private:
+    T _previous;
+};
+
+// Writes a trace file incrementally, streams have the same layout as TargetTrace.
+class TraceFileWriter {
+public:
+    TraceFileWriter(const std::string &filename, size_t chunkSize = tracefile::DefaultChunkSize);
+    ~TraceFileWriter();
+
+    bool isOpen() const { return _ofs.is_open(); }
+    size_t chunkSize() const { return _chunkSize; }
+
+    // number of bytes written to the file so far
+    size_t size() const { return _size; }
+
+    // writes out all pending records and closes the file
+    void close();
+
+    // writes all streams of an in-memory trace
+    void write(const TargetTrace &trace);
+
+    // state streams
+    TraceStateWriter<ButtonState> button;
+    TraceStateWriter<AdcState> adc;
+    TraceStateWriter<DigitalInputState> digitalInput;
+    TraceStateWriter<LedState> led;
+    TraceStateWriter<GateOutputState> gateOutput;
+    TraceStateWriter<DacState> dac;
+    TraceStateWriter<DigitalOutputState> digitalOutput;
+    TraceStateWriter<LcdState> lcd;
+
+    // event streams
+    TraceEventWriter<EncoderEvent> encoder;
+    TraceEventWriter<MidiEvent> midiInput;
+    TraceEventWriter<MidiEvent> midiOutput;
+
+private:
+    void writeChunk(TraceStreamId id, uint32_t count, uint32_t firstTick, uint32_t lastTick, const std::vector<uint8_t> &data);
+
+    std::ofstream _ofs;
+    size_t _chunkSize;
+    size_t _size = 0;
+
+    friend class TraceStreamWriterBase;
+};
+
+// Read-only, memory-mapped trace file.
+class TraceFile {
+public:
+    struct Chunk {
+        TraceStreamId stream;
+        uint32_t count;
+        uint32_t firstTick;
+        uint32_t lastTick;
+        const uint8_t *data;
+        uint32_t size;
+    };
+
+    TraceFile() = default;
+    TraceFile(const std::string &filename) { open(filename); }
+    ~TraceFile();
+
+    TraceFile(const TraceFile &) = delete;
+    TraceFile &operator=(const TraceFile &) = delete;
+
+    // returns false if the file cannot be read or is not a trace file, a truncated last chunk is ignored
+    bool open(const std::string &filename);
+    void close();
+
+    bool isOpen() const { return _data != nullptr; }
+    size_t size() const { return _size; }
+
+    const std::vector<Chunk> &chunks(TraceStreamId id) const { return _chunks[int(id)]; }
+
+    // number of records in a stream
+    size_t count(TraceStreamId id) const;
+
+    // decodes all streams into an in-memory trace
+    void load(TargetTrace &trace) const;
+
+    static bool isTraceFile(const std::string &filename);
+
+private:
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;
+    std::vector<uint8_t> _buffer;
+    std::vector<Chunk> _chunks[int(TraceStreamId::Last)];
+};
+
+// Iterates the records of a stream in a trace file.
+template<typename T>
+class TraceCursor {
+public:
+    typedef T Record;
+
+    TraceCursor(const TraceFile &file, TraceStreamId id) :
+        _chunks(file.chunks(id))
+    {
+        beginChunk(0);
+    }
+
+    bool valid() const { return _valid; }
+    uint32_t tick() const { return _tick; }
+    const T &record() const { return _record; }
+
+    void next() {
+        if (_remaining == 0) {
+            beginChunk(_chunk + 1);
+        } else {
+            decode();
+        }
+    }
+
+    // moves to the first record at or after the given tick
+    void seek(uint32_t tick) {
+        size_t chunk = 0;
+        while (chunk + 1 < _chunks.size() && _chunks[chunk].lastTick < tick) {
+            ++chunk;
+        }
+        beginChunk(chunk);
+        while (_valid && _tick < tick) {
+            next();
+        }
+    }
+
+private:
+    void beginChunk(size_t chunk) {
+        _chunk = chunk;
+        _valid = false;
+        if (_chunk >= _chunks.size()) {
+            return;
+        }
+        const auto &c = _chunks[_chunk];
+        _p = c.data;
+        _end = c.data + c.size;
+        _remaining = c.count;
+        _tick = c.firstTick;
+        _record = T();
+        decode();
+    }
+
+    void decode() {
+        uint32_t delta;
+        _valid = _remaining > 0 &&
+            tracefile::readVarint(_p, _end, delta) &&
+            TraceRecordCodec<T>::decode(_p, _end, _record);
+        if (_valid) {
+            _tick += delta;
+            --_remaining;
+        }
+    }
+
+    const std::vector<TraceFile::Chunk> &_chunks;
+    size_t _chunk = 0;
+    const uint8_t *_p = nullptr;
+    const uint8_t *_end = nullptr;
+    uint32_t _remaining = 0;
+    uint32_t _tick = 0;
+    bool _valid = false;
+    T _record;
+};
+
+// Iterates the items of an in-memory trace, same interface as TraceCursor.
+template<typename T>
+struct TraceItemCursor {
+    using Record = typename T::Record;
+
+    TraceItemCursor(const T &trace) :
+        items(trace.items())
+    {}
+
+    bool valid() const { return pos < items.size(); }
+    uint32_t tick() const { return items[pos].first; }
+    const Record &record() const { return items[pos].second; }
+    void next() { ++pos; }
+
+    const std::vector<typename T::Item> &items;
+    size_t pos = 0;
+};
+
+} // namespace sim
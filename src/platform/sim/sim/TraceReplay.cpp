@@ -0,0 +1,214 @@
+#include "TraceReplay.h"
+
+#include "Simulator.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace sim {
+
+namespace checkpointfile {
+
+    static const char Magic[8] = { 'P', 'E', 'R', 'C', 'H', 'K', 'P', 'T' };
+    static const uint32_t Version = 1;
+
+} // namespace checkpointfile
+
+// TraceCheckpoint
+
+bool TraceCheckpoint::save(const std::string &filename) const {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) {
+        return false;
+    }
+    std::vector<uint8_t> header;
+    header.insert(header.end(), checkpointfile::Magic, checkpointfile::Magic + sizeof(checkpointfile::Magic));
+    tracefile::writeU32(header, checkpointfile::Version);
+    tracefile::writeU32(header, tick);
+    tracefile::writeU32(header, data.size());
+    ofs.write(reinterpret_cast<const char *>(header.data()), header.size());
+    ofs.write(reinterpret_cast<const char *>(data.data()), data.size());
+    return bool(ofs);
+}
+
+bool TraceCheckpoint::load(const std::string &filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    uint8_t header[sizeof(checkpointfile::Magic) + 12];
+    if (!ifs.read(reinterpret_cast<char *>(header), sizeof(header)) ||
+        std::memcmp(header, checkpointfile::Magic, sizeof(checkpointfile::Magic)) != 0 ||
+        tracefile::readU32(header + 8) != checkpointfile::Version) {
+        return false;
+    }
+    tick = tracefile::readU32(header + 12);
+    data.resize(tracefile::readU32(header + 16));
+    return bool(ifs.read(reinterpret_cast<char *>(data.data()), data.size()));
+}
+
+// TraceInputPlayer
+
+struct TraceInputPlayerBase {
+    virtual ~TraceInputPlayerBase() {}
+    // writes all records before the given tick
+    virtual void play(uint32_t tick) = 0;
+    // skips all records before the given tick, state streams write the last skipped state
+    virtual void skip(uint32_t tick) = 0;
+};
+
+template<typename T>
+struct TraceInputPlayer : public TraceInputPlayerBase {
+    // called with the record and the previously written record (nullptr for the first one)
+    typedef std::function<void(const T &, const T *)> Func;
+
+    TraceInputPlayer(const TraceFile &traceFile, TraceStreamId id, bool state, Func func) :
+        cursor(traceFile, id),
+        state(state),
+        func(func)
+    {}
+
+    void play(uint32_t tick) override {
+        while (cursor.valid() && cursor.tick() < tick) {
+            write(cursor.record());
+            cursor.next();
+        }
+    }
+
+    void skip(uint32_t tick) override {
+        bool skipped = false;
+        T last;
+        while (cursor.valid() && cursor.tick() < tick) {
+            last = cursor.record();
+            skipped = true;
+            cursor.next();
+        }
+        if (state && skipped) {
+            write(last);
+        }
+    }
+
+    void write(const T &record) {
+        func(record, written ? &previous : nullptr);
+        previous = record;
+        written = true;
+    }
+
+    TraceCursor<T> cursor;
+    bool state;
+    Func func;
+    bool written = false;
+    T previous;
+};
+
+template<typename T>
+static void addInputPlayer(std::vector<std::unique_ptr<TraceInputPlayerBase>> &players, const TraceFile &traceFile, TraceStreamId id, bool state, typename TraceInputPlayer<T>::Func func) {
+    players.emplace_back(new TraceInputPlayer<T>(traceFile, id, state, func));
+}
+
+// writes the entries of a state record that differ from the previous record
+template<typename T, typename Func>
+static void writeChanged(const T &record, const T *previous, Func func) {
+    for (size_t i = 0; i < record.state.size(); ++i) {
+        if (!previous || record.state[i] != previous->state[i]) {
+            func(i, record.state[i]);
+        }
+    }
+}
+
+// TraceReplay
+
+constexpr uint32_t TraceReplay::DefaultBootTicks;
+
+TraceReplay::TraceReplay(Simulator &simulator, const TraceFile &traceFile, TargetCheckpointHandler *checkpointHandler) :
+    _simulator(simulator),
+    _checkpointHandler(checkpointHandler)
+{
+    Simulator *input = &simulator;
+    addInputPlayer<ButtonState>(_inputPlayers, traceFile, TraceStreamId::Button, true, [input] (const ButtonState &state, const ButtonState *previous) {
+        writeChanged(state, previous, [input] (int index, bool value) { input->writeButton(index, value); });
+    });
+    addInputPlayer<AdcState>(_inputPlayers, traceFile, TraceStreamId::AdcInput, true, [input] (const AdcState &state, const AdcState *previous) {
+        writeChanged(state, previous, [input] (int channel, uint16_t value) { input->writeAdc(channel, value); });
+    });
+    addInputPlayer<DigitalInputState>(_inputPlayers, traceFile, TraceStreamId::DigitalInput, true, [input] (const DigitalInputState &state, const DigitalInputState *previous) {
+        writeChanged(state, previous, [input] (int pin, bool value) { input->writeDigitalInput(pin, value); });
+    });
+    addInputPlayer<EncoderEvent>(_inputPlayers, traceFile, TraceStreamId::Encoder, false, [input] (const EncoderEvent &event, const EncoderEvent *) {
+        input->writeEncoder(event);
+    });
+    addInputPlayer<MidiEvent>(_inputPlayers, traceFile, TraceStreamId::MidiInput, false, [input] (const MidiEvent &event, const MidiEvent *) {
+        input->writeMidiInput(event);
+    });
+
+    for (int id = 0; id < int(TraceStreamId::Last); ++id) {
+        const auto &chunks = traceFile.chunks(TraceStreamId(id));
+        if (!chunks.empty()) {
+            _endTick = std::max(_endTick, chunks.back().lastTick);
+        }
+    }
+
+    _simulator.registerTargetTickObserver(this);
+}
+
+TraceReplay::~TraceReplay() {
+    _simulator.unregisterTargetTickObserver(this);
+}
+
+void TraceReplay::start() {
+    _tickOffset = _simulator.ticks();
+    _tick = 0;
+    _started = true;
+}
+
+bool TraceReplay::start(const TraceCheckpoint &checkpoint, uint32_t bootTicks) {
+    _started = false;
+    _simulator.wait(bootTicks);
+
+    if (!_checkpointHandler || !_checkpointHandler->restoreCheckpoint(checkpoint.data)) {
+        return false;
+    }
+
+    for (auto &player : _inputPlayers) {
+        player->skip(checkpoint.tick);
+    }
+
+    _tickOffset = uint32_t(_simulator.ticks()) - checkpoint.tick;
+    _tick = checkpoint.tick;
+    _started = true;
+    return true;
+}
+
+void TraceReplay::step() {
+    _simulator.wait(1);
+    _tick = uint32_t(_simulator.ticks()) - _tickOffset;
+}
+
+void TraceReplay::run(uint32_t endTick) {
+    while (_tick < endTick) {
+        step();
+    }
+}
+
+bool TraceReplay::saveCheckpoint(TraceCheckpoint &checkpoint) {
+    checkpoint.tick = _tick;
+    checkpoint.data.clear();
+    return _checkpointHandler && _checkpointHandler->saveCheckpoint(checkpoint.data);
+}
+
+void TraceReplay::registerTickObserver(TargetTickHandler *observer) {
+    _tickObservers.emplace_back(observer);
+}
+
+void TraceReplay::setTick(uint32_t tick) {
+    if (!_started) {
+        return;
+    }
+
+    uint32_t traceTick = tick - _tickOffset;
+    for (auto observer : _tickObservers) {
+        observer->setTick(traceTick);
+    }
+    for (auto &player : _inputPlayers) {
+        player->play(traceTick);
+    }
+}
+
+} // namespace sim
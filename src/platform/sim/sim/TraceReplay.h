@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Target.h"
+#include "TraceFile.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+namespace sim {
+
+class Simulator;
+
+struct TraceInputPlayerBase;
+
+// Target state captured at a trace tick, restored to start a replay from the middle of a trace.
+struct TraceCheckpoint {
+    uint32_t tick = 0;
+    std::vector<uint8_t> data;
+
+    bool save(const std::string &filename) const;
+    bool load(const std::string &filename);
+};
+
+// Replays the recorded inputs (buttons, encoder, adc, digital inputs and midi) of a trace file through
+// a simulator as fast as it can step, to reproduce a recorded session deterministically.
+//
+// Inputs are written between simulator steps, so an input recorded at tick t was first seen by the
+// target in step t + 1 and is replayed right before that step. Outputs of the replay are recorded by
+// registering a recorder as output observer of the simulator and as tick observer of the replay,
+// which passes trace ticks (the replayed output can be compared to the recording with TraceDiff).
+//
+// A replay can start from a checkpoint instead of from boot: the target boots without inputs, the
+// checkpoint is restored through the checkpoint handler and the replay continues at the checkpoint
+// tick with the input states (buttons, adc, digital inputs) recorded at that tick.
+class TraceReplay : public TargetTickHandler {
+public:
+    static constexpr uint32_t DefaultBootTicks = 3000;
+
+    TraceReplay(Simulator &simulator, const TraceFile &traceFile, TargetCheckpointHandler *checkpointHandler = nullptr);
+    ~TraceReplay();
+
+    // starts at trace tick 0, the target is expected to boot in the first step (as when recording)
+    void start();
+    // boots the target for `bootTicks` and restores the checkpoint, returns false if it cannot be restored
+    bool start(const TraceCheckpoint &checkpoint, uint32_t bootTicks = DefaultBootTicks);
+
+    // replays a single tick
+    void step();
+    // replays up to (not including) the given trace tick
+    void run(uint32_t endTick);
+
+    // next trace tick to be replayed
+    uint32_t tick() const { return _tick; }
+    // last tick of the trace (of any stream)
+    uint32_t endTick() const { return _endTick; }
+
+    // captures a checkpoint at the current trace tick
+    bool saveCheckpoint(TraceCheckpoint &checkpoint);
+
+    // observers are passed trace ticks
+    void registerTickObserver(TargetTickHandler *observer);
+
+private:
+    // TargetTickHandler
+    virtual void setTick(uint32_t tick) override;
+
+    Simulator &_simulator;
+    TargetCheckpointHandler *_checkpointHandler;
+    std::vector<std::unique_ptr<TraceInputPlayerBase>> _inputPlayers;
+    std::vector<TargetTickHandler *> _tickObservers;
+
+    bool _started = false;
+    uint32_t _tick = 0;
+    // simulator tick of trace tick 0
+    uint32_t _tickOffset = 0;
+    uint32_t _endTick = 0;
+};
+
+} // namespace sim
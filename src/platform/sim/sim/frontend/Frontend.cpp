@@ -54,6 +54,7 @@ int Frontend::main(int argc, char *argv[]) {
     args::ArgumentParser parser("PER|FORMER Simulator", "");
     args::HelpFlag help(parser, "help", "Display this help menu", { 'h', "help" });
     args::Flag showMidiPorts(parser, "midi", "Show available MIDI ports", { 'm', "midi" });
+    args::ValueFlag<std::string> recordFilename(parser, "file", "Record the session to a trace file (for replaying with sequencer_replay)", { 'r', "record" });
 
     try {
         parser.ParseCLI(argc, argv);
@@ -71,7 +72,17 @@ int Frontend::main(int argc, char *argv[]) {
         return 0;
     }
 
-
+    if (recordFilename) {
+        _traceFileWriter.reset(new TraceFileWriter(args::get(recordFilename)));
+        if (!_traceFileWriter->isOpen()) {
+            std::cerr << "cannot write " << args::get(recordFilename) << std::endl;
+            return 1;
+        }
+        _traceRecorder.reset(new TargetTraceRecorder(*_traceFileWriter));
+        _simulator.registerTargetTickObserver(_traceRecorder.get());
+        _simulator.registerTargetInputObserver(_traceRecorder.get());
+        _simulator.registerTargetOutputObserver(_traceRecorder.get());
+    }
 
     run();
 
@@ -16,6 +16,8 @@
 #include "widgets/Jack.h"
 
 #include "sim/Simulator.h"
+#include "sim/TargetTraceRecorder.h"
+#include "sim/TraceFile.h"
 
 #include <string>
 #include <vector>
@@ -83,6 +85,9 @@ private:
 
     std::unique_ptr<ClockSource> _clockSource;
 
+    std::unique_ptr<TraceFileWriter> _traceFileWriter;
+    std::unique_ptr<TargetTraceRecorder> _traceRecorder;
+
     Window::Ptr _window;
     Encoder::Ptr _encoder;
     Display::Ptr _lcd;
@@ -1,3 +1,6 @@
 #pragma once
 
 #define CCMRAM_BSS __attribute__((section(".ccmram_bss")))
+
+// State that exists once per running application instance (see sim platform).
+#define INSTANCE_LOCAL
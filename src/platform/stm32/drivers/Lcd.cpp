@@ -1,6 +1,7 @@
 #include "Lcd.h"
 
 #include "core/Debug.h"
+#include "core/gfx/DirtyRows.h"
 
 #include "hal/Delay.h"
 
@@ -12,6 +13,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <cstring>
 
 #define LCD_PORT GPIOB
 #define LCD_CS GPIO12
@@ -121,39 +123,47 @@ void Lcd::init() {
 
     // write commands for initialization
     initialize();
+
+    invalidate();
 }
 
-void Lcd::draw(uint8_t *frameBuffer) {
+void Lcd::draw(const uint8_t *frameBuffer) {
 #ifdef LCD_USE_DMA
     // wait until previous frame is sent
     while (!txDone) {}
-    txDone = 0;
 #endif // LCD_USE_DMA
 
-    // copy buffer
-    uint8_t *src = frameBuffer;
-    uint8_t *dst = reinterpret_cast<uint8_t *>(_frameBuffer);
-    for (int i = 0; i < Width * Height / 2; ++i) {
-        uint8_t a = *src++;
-        uint8_t b = *src++;
-        *dst++ = std::min(b, uint8_t(15)) | (std::min(a, uint8_t(15)) << 4);
-        // *dst++ = (b >> 4) | ((a >> 4) << 4);
+    uint8_t *lastFrame = reinterpret_cast<uint8_t *>(_frameBuffer);
+    DirtyRows rows = _fullUpdate ? DirtyRows::all(Height) : DirtyRows::compare(lastFrame, frameBuffer, Stride, Height);
+    _fullUpdate = false;
+    _stats.frames += 1;
+
+    if (rows.empty()) {
+        _stats.skippedFrames += 1;
+        return;
     }
 
-
-#ifdef LCD_USE_DMA
+    // frame buffer is already packed in display format, copy so the caller can draw the next frame
+    size_t offset = rows.first * Stride;
+    size_t len = rows.count() * Stride;
+    std::memcpy(lastFrame + offset, frameBuffer + offset, len);
+    _stats.bytes += len;
 
     setColAddr(0x1c,0x5b);
-    setRowAddr(0x00,0x3f);
+    setRowAddr(rows.first, rows.last);
     setWrite();
 
+#ifdef LCD_USE_DMA
+
+    txDone = 0;
+
     waitTxDone();
     gpio_set(LCD_PORT, LCD_DC);
 
     dma_stream_reset(LCD_DMA, LCD_DMA_STREAM);
     dma_set_peripheral_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(&LCD_SPI_DR));
-    dma_set_memory_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(_frameBuffer));
-    dma_set_number_of_data(LCD_DMA, LCD_DMA_STREAM, sizeof(_frameBuffer));
+    dma_set_memory_address(LCD_DMA, LCD_DMA_STREAM, reinterpret_cast<uint32_t>(lastFrame + offset));
+    dma_set_number_of_data(LCD_DMA, LCD_DMA_STREAM, len);
     dma_channel_select(LCD_DMA, LCD_DMA_STREAM, LCD_DMA_CHANNEL);
     dma_set_priority(LCD_DMA, LCD_DMA_STREAM, DMA_SxCR_PL_HIGH);
 
@@ -172,15 +182,9 @@ void Lcd::draw(uint8_t *frameBuffer) {
 
 #else // LCD_USE_DMA
 
-    setColAddr(0x1c,0x5b);
-    setRowAddr(0x00,0x3f);
-    setWrite();
-
-    src = reinterpret_cast<uint8_t *>(_frameBuffer);
-    for (int y = 0; y < Height; y++) {
-        for (int x = 0; x < Width/2; x++) {
-            sendData(*src++);
-        }
+    const uint8_t *src = lastFrame + offset;
+    for (size_t i = 0; i < len; ++i) {
+        sendData(*src++);
     }
 
 #endif // LCD_USE_DMA
@@ -9,10 +9,24 @@ class Lcd {
 public:
     static constexpr int Width = CONFIG_LCD_WIDTH;
     static constexpr int Height = CONFIG_LCD_HEIGHT;
+    static constexpr int Stride = Width / 2;
+
+    struct Stats {
+        uint32_t frames = 0;
+        uint32_t skippedFrames = 0;
+        uint32_t bytes = 0;
+    };
 
     void init();
 
-    void draw(uint8_t *frameBuffer);
+    // draws a frame buffer with packed 4-bit pixels (see FrameBuffer4bit)
+    // only rows that changed since the last frame are transferred, unchanged frames are skipped
+    void draw(const uint8_t *frameBuffer);
+
+    // forces the next frame to be sent in full
+    void invalidate() { _fullUpdate = true; }
+
+    const Stats &stats() const { return _stats; }
 
 private:
     void sendCmd(uint8_t cmd);
@@ -24,5 +38,8 @@ private:
     void setRowAddr(uint8_t a, uint8_t b);
     void setWrite();
 
+    // last frame sent to the display
     uint32_t _frameBuffer[Width * Height / 8];
+    bool _fullUpdate = true;
+    Stats _stats;
 };
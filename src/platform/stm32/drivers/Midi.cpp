@@ -2,6 +2,8 @@
 
 #include "SystemConfig.h"
 
+#include "HighResolutionTimer.h"
+
 #include "os/os.h"
 
 #include <libopencm3/stm32/gpio.h>
@@ -9,6 +11,8 @@
 #include <libopencm3/stm32/usart.h>
 #include <libopencm3/cm3/nvic.h>
 
+#include <algorithm>
+
 #define MIDI_USART USART6
 
 static Midi *g_midi = nullptr;
@@ -38,23 +42,58 @@ void Midi::init() {
 }
 
 bool Midi::send(const MidiMessage &message) {
-    for (uint8_t i = 0; i < message.length(); ++i) {
+    os::InterruptLock lock;
+
+    // omit status byte if running status applies
+    uint8_t first = _txRunningStatus.update(message) ? 0 : 1;
+
+    // a message that has to wait for space in the tx buffer is counted as one overflow
+    if (_txBuffer.writable() < size_t(message.length() - first)) {
+        ++_txBlocked;
+    }
+
+    for (uint8_t i = first; i < message.length(); ++i) {
         send(message.raw()[i]);
     }
 
     return true;
 }
 
+bool Midi::sendRealtime(uint8_t data) {
+    os::InterruptLock lock;
+
+    // does not affect running status
+    bool result = _txBuffer.writeRealtime(data);
+    startTx();
+
+    return result;
+}
+
 bool Midi::recv(MidiMessage *message) {
     while (!_rxBuffer.empty()) {
-        if (_midiParser.feed(_rxBuffer.read())) {
+        auto rxData = _rxBuffer.read();
+        if (_midiParser.feed(rxData.data)) {
             *message = _midiParser.message();
+            uint32_t latency = (HighResolutionTimer::us() - rxData.time) & 0xffffff;
+            _rxLatency = std::max(_rxLatency, latency);
             return true;
         }
     }
     return false;
 }
 
+MidiPortStats Midi::stats() const {
+    MidiPortStats stats;
+    stats.rxOverflow = _rxBuffer.overflow();
+    stats.rxHighWater = _rxBuffer.highWater();
+    stats.rxSize = _rxBuffer.size();
+    stats.rxLatency = _rxLatency;
+    stats.txOverflow = _txBuffer.overflow() + _txBlocked;
+    stats.txHighWater = _txBuffer.highWater();
+    stats.txSize = _txBuffer.size();
+    return stats;
+}
+
 void Midi::setRecvFilter(RecvFilter filter) {
     _recvFilter = filter;
 }
@@ -63,15 +102,17 @@ void Midi::send(uint8_t data) {
     os::InterruptLock lock;
 
     // block until there is space in the tx buffer
-    while (_txBuffer.full()) {
+    while (_txBuffer.writable() == 0) {
         usart_wait_send_ready(MIDI_USART);
         usart_send(MIDI_USART, _txBuffer.read());
     }
-
     _txBuffer.write(data);
 
-    // start transmission if necessary
-    if (!_txActive) {
+    startTx();
+}
+
+void Midi::startTx() {
+    if (!_txActive && !_txBuffer.empty()) {
         _txActive = 1;
         usart_wait_send_ready(MIDI_USART);
         usart_send(MIDI_USART, _txBuffer.read());
@@ -85,6 +126,8 @@ void Midi::handleIrq() {
         if (_txBuffer.empty()) {
             usart_disable_tx_interrupt(MIDI_USART);
             _txActive = 0;
+            // send status byte again after the line was idle (allows receivers to sync when connected mid-stream)
+            _txRunningStatus.reset();
         } else {
             usart_send(MIDI_USART, _txBuffer.read());
         }
@@ -92,11 +135,8 @@ void Midi::handleIrq() {
     if (usart_get_flag(MIDI_USART, USART_SR_RXNE)) {
         uint8_t data = usart_recv(MIDI_USART);
         if (!_recvFilter || !_recvFilter(data)) {
-            if (_rxBuffer.full()) {
-                // overflow
-                ++_rxOverflow;
-            }
-            _rxBuffer.write(data);
+            // dropped and counted as overflow if the rx buffer is full
+            _rxBuffer.write({ HighResolutionTimer::us() & 0xffffff, data });
         }
     }
 }
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "SystemConfig.h"
+
 #include "core/midi/MidiMessage.h"
 #include "core/midi/MidiParser.h"
-#include "core/utils/RingBuffer.h"
+#include "core/midi/MidiPortStats.h"
+#include "core/midi/MidiRunningStatus.h"
+#include "core/midi/MidiTxBuffer.h"
+#include "core/utils/SpscRingBuffer.h"
 
 #include <functional>
 
@@ -15,20 +20,32 @@ public:
     void init();
 
     bool send(const MidiMessage &message);
+
+    // sends a single real-time byte (clock, start, stop ...) ahead of all pending messages
+    bool sendRealtime(uint8_t data);
     bool recv(MidiMessage *message);
 
     void setRecvFilter(RecvFilter filter);
 
-    uint32_t rxOverflow() const { return _rxOverflow; }
+    MidiPortStats stats() const;
 
     void handleIrq();
 private:
     void send(uint8_t data);
+    void startTx();
+
+    // received bytes are timestamped to measure the receive latency
+    struct RxData {
+        uint32_t time: 24;
+        uint32_t data: 8;
+    };
 
-    RingBuffer<uint8_t, 64> _txBuffer;
-    RingBuffer<uint8_t, 64> _rxBuffer;
-    volatile uint32_t _rxOverflow = 0;
+    MidiTxBuffer<CONFIG_MIDI_TX_BUFFER_SIZE> _txBuffer;
+    SpscRingBuffer<RxData, CONFIG_MIDI_RX_BUFFER_SIZE> _rxBuffer;
+    uint32_t _rxLatency = 0;
     volatile uint32_t _txActive = 0;
+    uint32_t _txBlocked = 0;
+    MidiRunningStatus _txRunningStatus;
 
     RecvFilter _recvFilter;
     MidiParser _midiParser;
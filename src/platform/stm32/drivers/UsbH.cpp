@@ -107,7 +107,8 @@ struct MidiDriverHandler {
             size_t payloadLength = message.payloadLength();
             if (payloadData && payloadLength > 0) {
                 size_t messageLength = payloadLength + 2;
-                size_t writeSize = ((messageLength + 3) / 4) * 4;
+                // each 4 byte usb event carries up to 3 bytes of the message
+                size_t writeSize = ((messageLength + 2) / 3) * 4;
                 if (writeBufferPos + writeSize >= writeBufferSize) {
                     flush(device);
                     flushed = true;
@@ -1,8 +1,16 @@
 #pragma once
 
-#include "core/utils/RingBuffer.h"
+#include "SystemConfig.h"
+
+#include "HighResolutionTimer.h"
+
+#include "core/utils/SpscRingBuffer.h"
 #include "core/midi/MidiMessage.h"
+#include "core/midi/MidiPortStats.h"
+
+#include "os/os.h"
 
+#include <algorithm>
 #include <functional>
 
 #include <cstdint>
@@ -16,11 +24,15 @@ public:
     void init() {}
 
     bool send(uint8_t cable, const MidiMessage &message) {
-        if (_txQueue.full()) {
-            return false;
-        }
-        _txQueue.write({ cable, message });
-        return true;
+        // messages are sent from multiple tasks and interrupts, serialize producers
+        os::InterruptLock lock;
+        return _txQueue.write({ cable, message, 0 });
+    }
+
+    // sends a single real-time message (clock, start, stop ...) ahead of all pending messages
+    bool sendRealtime(uint8_t cable, uint8_t data) {
+        os::InterruptLock lock;
+        return _txRealtimeQueue.write({ cable, MidiMessage(data), 0 });
     }
 
     bool recv(uint8_t *cable, MidiMessage *message) {
@@ -30,6 +42,7 @@ public:
         auto cableAndMessage = _rxQueue.read();
         *cable = cableAndMessage.cable;
         *message = cableAndMessage.message;
+        _rxLatency = std::max(_rxLatency, HighResolutionTimer::us() - cableAndMessage.time);
         return true;
     }
 
@@ -45,7 +58,17 @@ public:
         _recvFilter = filter;
     }
 
-    uint32_t rxOverflow() const { return 0; }
+    MidiPortStats stats() const {
+        MidiPortStats stats;
+        stats.rxOverflow = _rxQueue.overflow();
+        stats.rxHighWater = _rxQueue.highWater();
+        stats.rxSize = _rxQueue.size();
+        stats.rxLatency = _rxLatency;
+        stats.txOverflow = _txQueue.overflow() + _txRealtimeQueue.overflow();
+        stats.txHighWater = _txQueue.highWater();
+        stats.txSize = _txQueue.size();
+        return stats;
+    }
 
 private:
     void connect(uint16_t vendorId, uint16_t productId) {
@@ -61,11 +84,8 @@ private:
     }
 
     void enqueueMessage(uint8_t cable, const MidiMessage &message) {
-        if (_rxQueue.full()) {
-            // overflow
-            ++_rxOverflow;
-        }
-        _rxQueue.write({ cable, message });
+        // dropped and counted as overflow if the rx queue is full
+        _rxQueue.write({ cable, message, HighResolutionTimer::us() });
     }
 
     void enqueueData(uint8_t cable, uint8_t data) {
@@ -75,10 +95,14 @@ private:
     }
 
     bool dequeueMessage(uint8_t *cable, MidiMessage *message) {
-        if (_txQueue.empty()) {
+        CableAndMessage messageAndCable;
+        if (!_txRealtimeQueue.empty()) {
+            messageAndCable = _txRealtimeQueue.read();
+        } else if (!_txQueue.empty()) {
+            messageAndCable = _txQueue.readAndReplace();
+        } else {
             return false;
         }
-        auto messageAndCable = _txQueue.readAndReplace();
         *cable = messageAndCable.cable;
         *message = messageAndCable.message;
         return true;
@@ -91,11 +115,13 @@ private:
     struct CableAndMessage {
         uint8_t cable;
         MidiMessage message;
+        uint32_t time;
     };
 
-    RingBuffer<CableAndMessage, 128> _txQueue;
-    RingBuffer<CableAndMessage, 16> _rxQueue;
-    volatile uint32_t _rxOverflow = 0;
+    SpscRingBuffer<CableAndMessage, CONFIG_USB_MIDI_TX_QUEUE_SIZE> _txQueue;
+    SpscRingBuffer<CableAndMessage, 4> _txRealtimeQueue;
+    SpscRingBuffer<CableAndMessage, CONFIG_USB_MIDI_RX_QUEUE_SIZE> _rxQueue;
+    uint32_t _rxLatency = 0;
 
     friend class UsbH;
 };
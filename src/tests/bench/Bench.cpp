@@ -0,0 +1,325 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <new>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Runs all registered benchmarks and prints a summary, results are optionally written as JSON to
+// compare them across commits (see compare.py).
+//
+// usage: bench [--filter <substring>] [--json <file>] [--min-time <ms>] [--repetitions <n>] [--perf] [--quick]
+
+//----------------------------------------
+// Allocation counting
+//----------------------------------------
+
+// the replacement operators pair malloc/free on purpose
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static uint64_t g_allocations;
+
+void *operator new(size_t size) {
+    ++g_allocations;
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace bench {
+
+uint64_t allocations() {
+    return g_allocations;
+}
+
+//----------------------------------------
+// PerfCounters
+//----------------------------------------
+
+#ifdef __linux__
+
+static int openPerfEvent(uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = groupFd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+
+PerfCounters::PerfCounters() {
+    _fd = openPerfEvent(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (_fd >= 0) {
+        _instructionsFd = openPerfEvent(PERF_COUNT_HW_INSTRUCTIONS, _fd);
+        if (_instructionsFd < 0) {
+            close(_fd);
+            _fd = -1;
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    if (_instructionsFd >= 0) {
+        close(_instructionsFd);
+    }
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+void PerfCounters::start() {
+    if (_fd >= 0) {
+        ioctl(_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void PerfCounters::stop() {
+    if (_fd >= 0) {
+        ioctl(_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t values[3] = { 0, 0, 0 };
+        if (read(_fd, values, sizeof(values)) == sizeof(values) && values[0] == 2) {
+            _cycles = values[1];
+            _instructions = values[2];
+        }
+    }
+}
+
+#else // __linux__
+
+PerfCounters::PerfCounters() {}
+PerfCounters::~PerfCounters() {}
+void PerfCounters::start() {}
+void PerfCounters::stop() {}
+
+#endif // __linux__
+
+} // namespace bench
+
+//----------------------------------------
+// Runner
+//----------------------------------------
+
+struct Options {
+    const char *filter = nullptr;
+    const char *jsonFilename = nullptr;
+    double minTimeMs = 100.0;
+    int repetitions = 5;
+    bool perf = false;
+};
+
+struct Result {
+    const char *name;
+    uint64_t iterations;
+    double nsPerOp;
+    double nsPerOpMin;
+    double allocsPerOp;
+    double cyclesPerOp;
+    double instructionsPerOp;
+};
+
+static bool runBenchmark(const bench::Benchmark &benchmark, const Options &options, bench::PerfCounters *perfCounters, Result &result) {
+    const uint64_t minTimeNs = options.minTimeMs * 1e6;
+
+    // warmup and estimate the number of iterations needed for the minimum time
+    uint64_t iterations = 1;
+    while (true) {
+        bench::State state(iterations);
+        benchmark.function(state);
+        if (!state.finished()) {
+            return false;
+        }
+        if (state.elapsedNs() >= minTimeNs / 10 || iterations >= 1000000000) {
+            iterations = std::max(uint64_t(1), uint64_t(double(iterations) * minTimeNs / std::max(uint64_t(1), state.elapsedNs())));
+            break;
+        }
+        iterations *= 10;
+    }
+
+    std::vector<double> nsPerOp;
+    uint64_t allocations = 0;
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    for (int repetition = 0; repetition < options.repetitions; ++repetition) {
+        bench::State state(iterations, perfCounters);
+        benchmark.function(state);
+        nsPerOp.push_back(double(state.elapsedNs()) / iterations);
+        allocations += state.allocations();
+        if (perfCounters) {
+            cycles += perfCounters->cycles();
+            instructions += perfCounters->instructions();
+        }
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+
+    uint64_t totalIterations = iterations * options.repetitions;
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    result.nsPerOp = nsPerOp[nsPerOp.size() / 2];
+    result.nsPerOpMin = nsPerOp.front();
+    result.allocsPerOp = double(allocations) / totalIterations;
+    result.cyclesPerOp = double(cycles) / totalIterations;
+    result.instructionsPerOp = double(instructions) / totalIterations;
+    return true;
+}
+
+static bool writeJson(const char *filename, const std::vector<Result> &results, const Options &options, bool perf) {
+    FILE *file = std::strcmp(filename, "-") == 0 ? stdout : std::fopen(filename, "w");
+    if (!file) {
+        return false;
+    }
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"context\": {\n");
+    std::fprintf(file, "    \"date\": \"%s\",\n", date);
+    std::fprintf(file, "    \"compiler\": \"%s\",\n", __VERSION__);
+#ifdef NDEBUG
+    std::fprintf(file, "    \"assertions\": false,\n");
+#else
+    std::fprintf(file, "    \"assertions\": true,\n");
+#endif
+    std::fprintf(file, "    \"min_time_ms\": %g,\n", options.minTimeMs);
+    std::fprintf(file, "    \"repetitions\": %d,\n", options.repetitions);
+    std::fprintf(file, "    \"perf_counters\": %s\n", perf ? "true" : "false");
+    std::fprintf(file, "  },\n");
+    std::fprintf(file, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto &result = results[i];
+        std::fprintf(file, "    { \"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, \"ns_per_op_min\": %.3f, \"allocs_per_op\": %.3f",
+            result.name, (unsigned long long)result.iterations, result.nsPerOp, result.nsPerOpMin, result.allocsPerOp);
+        if (perf) {
+            std::fprintf(file, ", \"cycles_per_op\": %.1f, \"instructions_per_op\": %.1f", result.cyclesPerOp, result.instructionsPerOp);
+        }
+        std::fprintf(file, " }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n");
+    std::fprintf(file, "}\n");
+
+    if (file != stdout) {
+        std::fclose(file);
+    }
+    return true;
+}
+
+static void printUsage() {
+    std::printf("usage: bench [--filter <substring>] [--json <file|->] [--min-time <ms>] [--repetitions <n>] [--perf] [--quick]\n");
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(arg, "--json") == 0 && hasValue) {
+            options.jsonFilename = argv[++i];
+        } else if (std::strcmp(arg, "--min-time") == 0 && hasValue) {
+            options.minTimeMs = std::max(0.1, std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--repetitions") == 0 && hasValue) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--perf") == 0) {
+            options.perf = true;
+        } else if (std::strcmp(arg, "--quick") == 0) {
+            options.minTimeMs = 5.0;
+            options.repetitions = 1;
+        } else {
+            printUsage();
+            return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    std::unique_ptr<bench::PerfCounters> perfCounters;
+    if (options.perf) {
+        perfCounters.reset(new bench::PerfCounters());
+        if (!perfCounters->available()) {
+            std::fprintf(stderr, "perf counters not available\n");
+            perfCounters.reset();
+        }
+    }
+
+    // benchmarks register in static initialization order, sort them for stable output
+    auto benchmarks = bench::registry();
+    std::sort(benchmarks.begin(), benchmarks.end(), [] (const bench::Benchmark &a, const bench::Benchmark &b) {
+        return std::strcmp(a.name, b.name) < 0;
+    });
+
+    // write the table to stderr when the json goes to stdout
+    FILE *out = (options.jsonFilename && std::strcmp(options.jsonFilename, "-") == 0) ? stderr : stdout;
+
+    std::fprintf(out, "%-48s %12s %12s %10s", "benchmark", "ns/op", "iterations", "allocs/op");
+    if (perfCounters) {
+        std::fprintf(out, " %10s %10s", "cycles/op", "instr/op");
+    }
+    std::fprintf(out, "\n");
+
+    std::vector<Result> results;
+    bool success = true;
+    for (const auto &benchmark : benchmarks) {
+        if (options.filter && !std::strstr(benchmark.name, options.filter)) {
+            continue;
+        }
+        Result result;
+        if (!runBenchmark(benchmark, options, perfCounters.get(), result)) {
+            std::fprintf(out, "%-48s did not run all iterations\n", benchmark.name);
+            success = false;
+            continue;
+        }
+        std::fprintf(out, "%-48s %12.2f %12llu %10.2f", result.name, result.nsPerOp, (unsigned long long)result.iterations, result.allocsPerOp);
+        if (perfCounters) {
+            std::fprintf(out, " %10.1f %10.1f", result.cyclesPerOp, result.instructionsPerOp);
+        }
+        std::fprintf(out, "\n");
+        results.push_back(result);
+    }
+
+    if (options.jsonFilename && !writeJson(options.jsonFilename, results, options, bool(perfCounters))) {
+        std::fprintf(stderr, "cannot write %s\n", options.jsonFilename);
+        return 1;
+    }
+
+    return success ? 0 : 1;
+}
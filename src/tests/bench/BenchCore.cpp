@@ -0,0 +1,82 @@
+#include "Benchmark.h"
+
+#include "core/gfx/Canvas.h"
+
+#include <cstdint>
+
+static const int Width = 256;
+static const int Height = 64;
+
+// 4-bit canvas with the size of the display.
+struct CanvasFixture {
+    uint8_t data[Width * Height / 2];
+    FrameBuffer4bit frameBuffer;
+    float brightness = 1.f;
+    Canvas canvas;
+
+    CanvasFixture() :
+        frameBuffer(Width, Height, data),
+        canvas(frameBuffer, brightness)
+    {
+        canvas.setBlendMode(BlendMode::Set);
+        canvas.setColor(Color::Bright);
+    }
+};
+
+BENCHMARK("core/Canvas::fill") {
+    CanvasFixture fixture;
+    while (state.run()) {
+        fixture.canvas.fill();
+        bench::clobberMemory();
+    }
+}
+
+BENCHMARK("core/Canvas::hline") {
+    CanvasFixture fixture;
+    int y = 0;
+    while (state.run()) {
+        fixture.canvas.hline(3, y, Width - 6);
+        y = (y + 1) % Height;
+        bench::clobberMemory();
+    }
+}
+
+BENCHMARK("core/Canvas::vline") {
+    CanvasFixture fixture;
+    int x = 0;
+    while (state.run()) {
+        fixture.canvas.vline(x, 3, Height - 6);
+        x = (x + 1) % Width;
+        bench::clobberMemory();
+    }
+}
+
+BENCHMARK("core/Canvas::line") {
+    CanvasFixture fixture;
+    int x = 0;
+    while (state.run()) {
+        fixture.canvas.line(x, 0, Width - 1 - x, Height - 1);
+        x = (x + 1) % Width;
+        bench::clobberMemory();
+    }
+}
+
+BENCHMARK("core/Canvas::fillRect") {
+    CanvasFixture fixture;
+    fixture.canvas.setBlendMode(BlendMode::Add);
+    int x = 0;
+    while (state.run()) {
+        fixture.canvas.fillRect(x, 8, 32, 16);
+        x = (x + 1) % (Width - 32);
+        bench::clobberMemory();
+    }
+}
+
+BENCHMARK("core/Canvas::drawText") {
+    CanvasFixture fixture;
+    fixture.canvas.setFont(Font::Small);
+    while (state.run()) {
+        fixture.canvas.drawText(2, 20, "CLOCK 120.0 BPM");
+        bench::clobberMemory();
+    }
+}
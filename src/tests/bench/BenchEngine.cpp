@@ -0,0 +1,217 @@
+#include "Benchmark.h"
+#include "BenchEnvironment.h"
+
+#include "apps/sequencer/SequencerCheckpoint.h"
+#include "apps/sequencer/engine/MidiInputDispatch.h"
+#include "apps/sequencer/engine/MidiUtils.h"
+#include "apps/sequencer/engine/SortedQueue.h"
+
+#include <memory>
+#include <vector>
+
+static void benchmarkTrackEngine(bench::State &state, Track::TrackMode trackMode) {
+    auto &environment = Environment::instance();
+    auto &project = environment.app->model.project();
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, trackMode);
+    }
+    if (trackMode == Track::TrackMode::Note) {
+        auto &sequence = project.track(0).noteTrack().sequence(0);
+        for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+            sequence.step(stepIndex).setGate(stepIndex % 3 != 0);
+            sequence.step(stepIndex).setNote(stepIndex * 5 % 24);
+        }
+    }
+    // let the engine set up the track engines
+    environment.simulator->wait(10);
+
+    auto &trackEngine = environment.app->engine.trackEngine(0);
+    uint32_t &tick = environment.tick;
+    while (state.run()) {
+        bench::doNotOptimize(trackEngine.tick(tick++));
+    }
+}
+
+BENCHMARK("engine/TrackEngine::tick/Note") {
+    benchmarkTrackEngine(state, Track::TrackMode::Note);
+}
+
+BENCHMARK("engine/TrackEngine::tick/Curve") {
+    benchmarkTrackEngine(state, Track::TrackMode::Curve);
+}
+
+BENCHMARK("engine/TrackEngine::tick/MidiCv") {
+    benchmarkTrackEngine(state, Track::TrackMode::MidiCv);
+}
+
+BENCHMARK("engine/TrackEngine::tick/Tuesday") {
+    benchmarkTrackEngine(state, Track::TrackMode::Tuesday);
+}
+
+BENCHMARK("engine/TrackEngine::tick/DiscreteMap") {
+    benchmarkTrackEngine(state, Track::TrackMode::DiscreteMap);
+}
+
+BENCHMARK("engine/TrackEngine::tick/Indexed") {
+    benchmarkTrackEngine(state, Track::TrackMode::Indexed);
+}
+
+BENCHMARK("engine/RoutingEngine::update") {
+    auto &environment = Environment::instance();
+    auto &routing = environment.app->model.project().routing();
+    const struct {
+        Routing::Target target;
+        Routing::Source source;
+    } routes[] = {
+        { Routing::Target::Tempo, Routing::Source::CvIn1 },
+        { Routing::Target::Octave, Routing::Source::CvIn2 },
+        { Routing::Target::Transpose, Routing::Source::CvOut1 },
+        { Routing::Target::Divisor, Routing::Source::Midi },
+    };
+    for (int routeIndex = 0; routeIndex < int(sizeof(routes) / sizeof(routes[0])); ++routeIndex) {
+        auto &route = routing.route(routeIndex);
+        route.setTarget(routes[routeIndex].target);
+        route.setSource(routes[routeIndex].source);
+        route.setTracks(0xff);
+        route.setMin(0.f);
+        route.setMax(1.f);
+    }
+    environment.simulator->wait(10);
+
+    auto &routingEngine = environment.app->engine.routingEngine();
+    while (state.run()) {
+        routingEngine.update();
+    }
+
+    for (int routeIndex = 0; routeIndex < int(sizeof(routes) / sizeof(routes[0])); ++routeIndex) {
+        routing.route(routeIndex).clear();
+    }
+}
+
+// full snapshot of the running sequencer (project and engine state)
+BENCHMARK("engine/SequencerCheckpoint::save") {
+    auto &environment = Environment::instance();
+    environment.app->engine.clockStart();
+    environment.simulator->wait(100);
+
+    SequencerCheckpoint checkpoint(environment.app);
+    std::vector<uint8_t> data;
+    while (state.run()) {
+        data.clear();
+        bench::doNotOptimize(checkpoint.saveCheckpoint(data));
+    }
+
+    environment.app->engine.clockReset();
+}
+
+BENCHMARK("engine/SequencerCheckpoint::restore") {
+    auto &environment = Environment::instance();
+    environment.app->engine.clockStart();
+    environment.simulator->wait(100);
+
+    SequencerCheckpoint checkpoint(environment.app);
+    std::vector<uint8_t> data;
+    checkpoint.saveCheckpoint(data);
+    while (state.run()) {
+        bench::doNotOptimize(checkpoint.restoreCheckpoint(data));
+    }
+
+    environment.app->engine.clockReset();
+}
+
+// fast-forward to bar 500 with note tracks on every track
+BENCHMARK("engine/Engine::seek") {
+    auto &environment = Environment::instance();
+    auto &project = environment.app->model.project();
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::Note);
+    }
+    environment.simulator->wait(10);
+
+    auto &engine = environment.app->engine;
+    uint32_t tick = 500 * engine.measureDivisor();
+    while (state.run()) {
+        engine.seek(tick);
+    }
+}
+
+// controller routes on all channels and midi/cv tracks, fed with a 14-bit controller stream (cc 1 + cc 33)
+static std::unique_ptr<Project> midiInputProject() {
+    std::unique_ptr<Project> project(new Project());
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        auto &route = project->routing().route(routeIndex);
+        route.setTarget(Routing::Target::Tempo);
+        route.setSource(Routing::Source::Midi);
+        route.midiSource().source().setPort(Types::MidiPort::Midi);
+        route.midiSource().source().setChannel(routeIndex);
+        route.midiSource().setEvent(Routing::MidiSource::Event::ControlAbsolute);
+        route.midiSource().setControlNumber(1);
+    }
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project->setTrackMode(trackIndex, Track::TrackMode::MidiCv);
+    }
+    return project;
+}
+
+static MidiMessage midiInputMessage(uint32_t i) {
+    return MidiMessage::makeControlChange(i % 16, i & 1 ? 33 : 1, i & 0x7f);
+}
+
+// matching every message against all routes and tracks (as before the dispatch tables)
+BENCHMARK("engine/MidiInput::match/linear") {
+    auto project = midiInputProject();
+    uint32_t i = 0;
+    while (state.run()) {
+        MidiMessage message = midiInputMessage(i++);
+        int matches = 0;
+        for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+            const auto &route = project->routing().route(routeIndex);
+            if (route.active() && route.source() == Routing::Source::Midi &&
+                MidiUtils::matchSource(MidiPort::Midi, message, route.midiSource().source()) &&
+                message.controlNumber() == route.midiSource().controlNumber()) {
+                ++matches;
+            }
+        }
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            matches += MidiUtils::matchSource(MidiPort::Midi, message, project->track(trackIndex).midiCvTrack().source()) && message.isPitchBend();
+        }
+        bench::doNotOptimize(matches);
+    }
+}
+
+BENCHMARK("engine/MidiInput::match/dispatch") {
+    auto project = midiInputProject();
+    MidiInputDispatch dispatch;
+    dispatch.update(*project);
+    uint32_t i = 0;
+    while (state.run()) {
+        MidiMessage message = midiInputMessage(i++);
+        bench::doNotOptimize(dispatch.routes(MidiPort::Midi, message));
+        bench::doNotOptimize(dispatch.tracks(MidiPort::Midi, message));
+    }
+}
+
+// change detection done on every engine update
+BENCHMARK("engine/MidiInputDispatch::update") {
+    auto project = midiInputProject();
+    MidiInputDispatch dispatch;
+    dispatch.update(*project);
+    while (state.run()) {
+        bench::doNotOptimize(dispatch.update(*project));
+    }
+}
+
+BENCHMARK("engine/SortedQueue::push+pop") {
+    SortedQueue<uint32_t, 16> queue;
+    uint32_t tick = 0;
+    for (int i = 0; i < 8; ++i) {
+        queue.push(tick + (i * 7) % 13);
+    }
+    while (state.run()) {
+        // keep the queue half full, new entries are inserted out of order
+        queue.push(tick + 8 + (tick * 7) % 13);
+        bench::doNotOptimize(queue.front());
+        queue.pop();
+        ++tick;
+    }
+}
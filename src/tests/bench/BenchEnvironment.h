@@ -0,0 +1,51 @@
+#pragma once
+
+#include "apps/sequencer/SequencerApp.h"
+
+#include "sim/Simulator.h"
+#include "sim/TargetTraceRecorder.h"
+
+#include <memory>
+
+#include <cstdint>
+
+// Sequencer instance shared by the engine and simulator benchmarks, created on first use and never destroyed
+// (there can only be one simulator per thread).
+struct Environment {
+    std::unique_ptr<SequencerApp> app;
+    std::unique_ptr<sim::Simulator> simulator;
+    uint32_t tick = 0;
+
+    Environment() {
+        simulator.reset(new sim::Simulator({
+            .create = [this] () {
+                app.reset(new SequencerApp());
+            },
+            .destroy = [this] () {
+                app.reset();
+            },
+            .update = [this] () {
+                app->update();
+            }
+        }));
+        // let the application finish startup
+        simulator->wait(1000);
+    }
+
+    // runs the simulator for the given time and records inputs and outputs into the trace
+    void record(sim::TargetTrace &trace, int milliseconds) {
+        sim::TargetTraceRecorder recorder(trace);
+        simulator->registerTargetTickObserver(&recorder);
+        simulator->registerTargetInputObserver(&recorder);
+        simulator->registerTargetOutputObserver(&recorder);
+        simulator->wait(milliseconds);
+        simulator->unregisterTargetTickObserver(&recorder);
+        simulator->unregisterTargetInputObserver(&recorder);
+        simulator->unregisterTargetOutputObserver(&recorder);
+    }
+
+    static Environment &instance() {
+        static Environment *environment = new Environment();
+        return *environment;
+    }
+};
@@ -0,0 +1,98 @@
+#include "Benchmark.h"
+
+#include "apps/sequencer/model/Curve.h"
+#include "apps/sequencer/model/Project.h"
+#include "apps/sequencer/model/ProjectVersion.h"
+#include "apps/sequencer/model/Scale.h"
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+
+#include "../unit/core/io/MemoryReaderWriter.h"
+
+#include <memory>
+#include <vector>
+
+BENCHMARK("model/Curve::eval") {
+    float x = 0.f;
+    int type = 0;
+    while (state.run()) {
+        bench::doNotOptimize(Curve::eval(Curve::Type(type), x));
+        type = type + 1 == Curve::Last ? 0 : type + 1;
+        x = x >= 1.f ? 0.f : x + 0.0137f;
+    }
+}
+
+BENCHMARK("model/Scale::noteToVolts") {
+    int scale = 0;
+    int note = -60;
+    while (state.run()) {
+        bench::doNotOptimize(Scale::get(scale).noteToVolts(note));
+        scale = scale + 1 == Scale::Count ? 0 : scale + 1;
+        note = note == 60 ? -60 : note + 1;
+    }
+}
+
+BENCHMARK("model/Routing::writeTarget") {
+    std::unique_ptr<Project> project(new Project());
+    auto &routing = project->routing();
+    const Routing::Target targets[] = {
+        Routing::Target::Tempo,
+        Routing::Target::Octave,
+        Routing::Target::Transpose,
+        Routing::Target::Divisor,
+        Routing::Target::Scale,
+    };
+    int index = 0;
+    float value = 0.f;
+    while (state.run()) {
+        routing.writeTarget(targets[index], 0xff, value);
+        index = index + 1 == int(sizeof(targets) / sizeof(targets[0])) ? 0 : index + 1;
+        value = value >= 1.f ? 0.f : value + 0.01f;
+    }
+}
+
+BENCHMARK("model/Project::write") {
+    std::unique_ptr<Project> project(new Project());
+    std::vector<uint8_t> buffer(1 << 20);
+    while (state.run()) {
+        MemoryWriter memoryWriter(buffer.data(), buffer.size());
+        VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
+            memoryWriter.write(data, len);
+        }, ProjectVersion::Latest, true);
+        project->write(writer);
+        bench::clobberMemory();
+    }
+}
+
+BENCHMARK("model/Project::read") {
+    std::unique_ptr<Project> project(new Project());
+    std::vector<uint8_t> buffer(1 << 20);
+    MemoryWriter memoryWriter(buffer.data(), buffer.size());
+    VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
+        memoryWriter.write(data, len);
+    }, ProjectVersion::Latest, true);
+    project->write(writer);
+
+    while (state.run()) {
+        MemoryReader memoryReader(buffer.data(), buffer.size());
+        VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
+            memoryReader.read(data, len);
+        }, ProjectVersion::Latest);
+        bench::doNotOptimize(project->read(reader));
+    }
+}
+
+BENCHMARK("model/Project::read (buffer)") {
+    std::unique_ptr<Project> project(new Project());
+    std::vector<uint8_t> buffer(1 << 20);
+    MemoryWriter memoryWriter(buffer.data(), buffer.size());
+    VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
+        memoryWriter.write(data, len);
+    }, ProjectVersion::Latest, true);
+    project->write(writer);
+
+    while (state.run()) {
+        VersionedSerializedReader reader(buffer.data(), memoryWriter.bytesWritten(), ProjectVersion::Latest);
+        bench::doNotOptimize(project->read(reader));
+    }
+}
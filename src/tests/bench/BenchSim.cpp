@@ -0,0 +1,155 @@
+#include "Benchmark.h"
+#include "BenchEnvironment.h"
+
+#include "apps/sequencer/SequencerCheckpoint.h"
+#include "apps/sequencer/ui/Key.h"
+
+#include "sim/TargetTrace.h"
+#include "sim/TraceDiff.h"
+#include "sim/TraceFile.h"
+#include "sim/TraceReplay.h"
+
+#include <vector>
+
+#include <cstdio>
+
+static const char *TraceFilename = "bench.trace";
+
+// plays note sequences on all tracks with the overview page open
+static void playNoteSequences(Environment &environment) {
+    auto &project = environment.app->model.project();
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::Note);
+        auto &sequence = project.track(trackIndex).noteTrack().sequence(0);
+        for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+            sequence.step(stepIndex).setGate((stepIndex + trackIndex) % 3 != 0);
+            sequence.step(stepIndex).setNote((stepIndex * 5 + trackIndex * 3) % 24);
+        }
+    }
+    // open the overview page (page + left) to get the track activity on the lcd
+    environment.simulator->setButton(Key::Page, true);
+    environment.simulator->setButton(Key::Left, true);
+    environment.simulator->wait(20);
+    environment.simulator->setButton(Key::Left, false);
+    environment.simulator->setButton(Key::Page, false);
+    environment.simulator->wait(20);
+    environment.app->engine.clockStart();
+}
+
+// ten seconds of the sequencer playing note sequences, recorded once together with a checkpoint of
+// the session at the start of the recording
+struct RecordedSession {
+    sim::TargetTrace trace;
+    sim::TraceCheckpoint checkpoint;
+};
+
+static const RecordedSession &recordedSession() {
+    static RecordedSession *session = nullptr;
+    if (!session) {
+        auto &environment = Environment::instance();
+        // let the startup animation finish, so the trace does not depend on which benchmarks ran before
+        environment.simulator->wait(3000);
+        playNoteSequences(environment);
+        session = new RecordedSession();
+        SequencerCheckpoint checkpointHandler(environment.app);
+        session->checkpoint.tick = uint32_t(environment.simulator->ticks());
+        checkpointHandler.saveCheckpoint(session->checkpoint.data);
+        environment.record(session->trace, 10000);
+        environment.app->engine.clockStop();
+    }
+    return *session;
+}
+
+static const sim::TargetTrace &recordedTrace() {
+    return recordedSession().trace;
+}
+
+BENCHMARK("sim/TraceFile::write") {
+    const auto &trace = recordedTrace();
+    while (state.run()) {
+        sim::TraceFileWriter writer(TraceFilename);
+        writer.write(trace);
+        writer.close();
+        bench::doNotOptimize(writer.size());
+    }
+    std::remove(TraceFilename);
+}
+
+BENCHMARK("sim/TraceFile::read") {
+    {
+        sim::TraceFileWriter writer(TraceFilename);
+        writer.write(recordedTrace());
+    }
+    while (state.run()) {
+        sim::TraceFile file(TraceFilename);
+        sim::TargetTrace trace;
+        file.load(trace);
+        bench::doNotOptimize(trace.lcd.items().size());
+    }
+    std::remove(TraceFilename);
+}
+
+BENCHMARK("sim/TraceDiff::diff") {
+    const auto &trace = recordedTrace();
+    while (state.run()) {
+        sim::TraceDiff traceDiff;
+        traceDiff.diff(trace, trace);
+        bench::doNotOptimize(traceDiff.identical());
+    }
+}
+
+BENCHMARK("sim/TraceDiff::diff (file)") {
+    {
+        sim::TraceFileWriter writer(TraceFilename);
+        writer.write(recordedTrace());
+    }
+    sim::TraceFile file(TraceFilename);
+    while (state.run()) {
+        sim::TraceDiff traceDiff;
+        traceDiff.diff(file, file);
+        bench::doNotOptimize(traceDiff.identical());
+    }
+    std::remove(TraceFilename);
+}
+
+// renders one second (1000 ticks) per iteration into preallocated buffers, like a render() call from python
+BENCHMARK("sim/Simulator::render") {
+    auto &environment = Environment::instance();
+    playNoteSequences(environment);
+    const int ticks = 1000;
+    std::vector<uint16_t> dac(ticks * sim::DacState::Count);
+    std::vector<uint8_t> gates(ticks);
+    std::vector<sim::Simulator::RenderedMidiMessage> midi;
+    while (state.run()) {
+        midi.clear();
+        environment.simulator->render(ticks, dac.data(), gates.data(), &midi);
+        bench::doNotOptimize(midi.size());
+    }
+    environment.app->engine.clockStop();
+}
+
+// replays the recorded session from its checkpoint and records the outputs, as done for regression checks
+BENCHMARK("sim/TraceReplay::run") {
+    auto &environment = Environment::instance();
+    const auto &session = recordedSession();
+    {
+        sim::TraceFileWriter writer(TraceFilename);
+        writer.write(session.trace);
+    }
+    sim::TraceFile file(TraceFilename);
+    SequencerCheckpoint checkpointHandler(environment.app);
+    while (state.run()) {
+        sim::TargetTrace replayed;
+        sim::TargetTraceRecorder recorder(replayed);
+        sim::TraceReplay replay(*environment.simulator, file, &checkpointHandler);
+        environment.simulator->registerTargetOutputObserver(&recorder);
+        replay.registerTickObserver(&recorder);
+        // the target is already running, there is no need to boot it before restoring the checkpoint
+        replay.start(session.checkpoint, 0);
+        replay.run(replay.endTick());
+        environment.simulator->unregisterTargetOutputObserver(&recorder);
+        bench::doNotOptimize(replayed.gateOutput.items().size());
+    }
+    environment.app->engine.clockStop();
+    std::remove(TraceFilename);
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include <cstdint>
+
+// Minimal micro-benchmark harness.
+//
+// Benchmarks are registered with BENCHMARK(name) and measure the body of a `while (state.run())` loop,
+// code before the loop is setup and not measured:
+//
+//   BENCHMARK("core/Foo::bar") {
+//       Foo foo;
+//       while (state.run()) {
+//           bench::doNotOptimize(foo.bar());
+//       }
+//   }
+
+namespace bench {
+
+// number of heap allocations so far (counted by the operator new replacement in Bench.cpp)
+uint64_t allocations();
+
+// prevents the compiler from optimizing away a value or memory writes
+template<typename T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+// Hardware counters (cycles, instructions) using perf events, only available on linux.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    bool available() const { return _fd >= 0; }
+
+    void start();
+    void stop();
+
+    uint64_t cycles() const { return _cycles; }
+    uint64_t instructions() const { return _instructions; }
+
+private:
+    int _fd = -1;
+    int _instructionsFd = -1;
+    uint64_t _cycles = 0;
+    uint64_t _instructions = 0;
+};
+
+class State {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    State(uint64_t iterations, PerfCounters *perfCounters = nullptr) :
+        _iterations(iterations),
+        _remaining(iterations),
+        _perfCounters(perfCounters)
+    {}
+
+    // returns true while iterations are left, measures from the first to the last call
+    inline bool run() {
+        if (_running && _remaining > 0) {
+            --_remaining;
+            return true;
+        }
+        return _running ? stop() : start();
+    }
+
+    uint64_t iterations() const { return _iterations; }
+    bool finished() const { return _finished; }
+
+    uint64_t elapsedNs() const { return _elapsedNs; }
+    uint64_t allocations() const { return _allocations; }
+
+private:
+    bool start() {
+        _running = true;
+        _allocations = bench::allocations();
+        if (_perfCounters) {
+            _perfCounters->start();
+        }
+        _start = Clock::now();
+        --_remaining;
+        return true;
+    }
+
+    bool stop() {
+        auto end = Clock::now();
+        if (_perfCounters) {
+            _perfCounters->stop();
+        }
+        _allocations = bench::allocations() - _allocations;
+        _elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - _start).count();
+        _running = false;
+        _finished = true;
+        return false;
+    }
+
+    uint64_t _iterations;
+    uint64_t _remaining;
+    PerfCounters *_perfCounters;
+    bool _running = false;
+    bool _finished = false;
+    Clock::time_point _start;
+    uint64_t _elapsedNs = 0;
+    uint64_t _allocations = 0;
+};
+
+typedef void (*BenchmarkFunction)(State &state);
+
+struct Benchmark {
+    const char *name;
+    BenchmarkFunction function;
+};
+
+inline std::vector<Benchmark> &registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar {
+    Registrar(const char *name, BenchmarkFunction function) {
+        registry().push_back({ name, function });
+    }
+};
+
+} // namespace bench
+
+#define BENCHMARK_CONCAT_(_a_, _b_) _a_##_b_
+#define BENCHMARK_CONCAT(_a_, _b_) BENCHMARK_CONCAT_(_a_, _b_)
+
+#define BENCHMARK(_name_)                                                                           \
+    static void BENCHMARK_CONCAT(benchmark, __LINE__)(bench::State &state);                        \
+    static bench::Registrar BENCHMARK_CONCAT(registrar, __LINE__)(_name_, &BENCHMARK_CONCAT(benchmark, __LINE__)); \
+    static void BENCHMARK_CONCAT(benchmark, __LINE__)(bench::State &state)
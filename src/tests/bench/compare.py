@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+# Compares two benchmark result files written with `bench --json <file>`.
+#
+# usage: compare.py <baseline.json> <results.json> [--threshold <percent>]
+
+import argparse
+import json
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        return {b['name']: b for b in json.load(f)['benchmarks']}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare benchmark results')
+    parser.add_argument('baseline')
+    parser.add_argument('results')
+    parser.add_argument('--threshold', type=float, default=5.0, help='report changes above this percentage')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    results = load(args.results)
+
+    print('%-48s %12s %12s %9s %11s' % ('benchmark', 'baseline', 'ns/op', 'change', 'allocs/op'))
+    regressions = 0
+    for name in sorted(set(baseline) | set(results)):
+        if name not in baseline or name not in results:
+            print('%-48s %s' % (name, 'only in baseline' if name in baseline else 'new'))
+            continue
+        a = baseline[name]['ns_per_op']
+        b = results[name]['ns_per_op']
+        change = (b - a) / a * 100.0 if a > 0 else 0.0
+        marker = ''
+        if change > args.threshold:
+            marker = ' slower'
+            regressions += 1
+        elif change < -args.threshold:
+            marker = ' faster'
+        allocs = '%.2f -> %.2f' % (baseline[name]['allocs_per_op'], results[name]['allocs_per_op'])
+        print('%-48s %12.2f %12.2f %+8.1f%% %11s%s' % (name, a, b, change, allocs, marker))
+
+    return 1 if regressions > 0 else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
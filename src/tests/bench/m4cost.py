@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+# Cycle-approximate Cortex-M4 cost report for the engine tick paths.
+#
+# Disassembles a binary (the host `bench` executable or the stm32 firmware elf), follows direct calls
+# from the tick/update entry points and estimates the cost of every reachable function on the target
+# (STM32F4 at 168 MHz, single precision FPU only). Operations that are cheap on the host but expensive
+# on the target are flagged: double math (soft-float), libm calls, divisions and virtual dispatch.
+#
+# Estimates are per pass through the function body (branches and loops are not weighted), they are
+# meant to compare commits in review, not to replace measurements on hardware.
+#
+# usage: m4cost.py <binary> [--roots <regex>] [--filter <regex>] [--top <n>] [--json <file>]
+#                   [--baseline <file>] [--objdump <objdump>]
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+
+DEFAULT_ROOTS = r'(^|[ :])\w*Engine::(tick|update)\w*\('
+
+# approximate cortex-m4 cycles (arm cortex-m4 trm, libgcc soft-float and newlib libm)
+COST_INSTRUCTION = 1
+COST_INDIRECT = 5               # load vtable, load slot, blx and pipeline refill
+COST_DIV = 12                   # sdiv/udiv take 2-12 cycles
+COST_DIV64 = 100                # __aeabi_ldivmod/__aeabi_uldivmod
+COST_FLOAT_DIV = 14             # vdiv.f32/vsqrt.f32
+COST_DOUBLE = 60                # soft-float add/sub/mul/compare
+COST_DOUBLE_DIV = 150           # soft-float div/sqrt
+COST_DOUBLE_CONVERT = 25        # float <-> double, int <-> double
+
+LIBM = {
+    # single precision
+    'sinf': 120, 'cosf': 120, 'sincosf': 200, 'tanf': 200, 'tanhf': 250,
+    'expf': 150, 'exp2f': 150, 'logf': 150, 'log2f': 150, 'log10f': 150,
+    'powf': 300, 'fmodf': 80, 'sqrtf': 14, 'atan2f': 250, 'atanf': 200,
+    'floorf': 20, 'ceilf': 20, 'roundf': 20, 'truncf': 15, 'lroundf': 25, 'frexpf': 20, 'ldexpf': 20,
+    # double precision, all soft-float
+    'sin': 1500, 'cos': 1500, 'sincos': 2500, 'tan': 2500, 'tanh': 2500,
+    'exp': 1500, 'exp2': 1500, 'log': 1500, 'log2': 1500, 'log10': 1500,
+    'pow': 3000, 'fmod': 600, 'sqrt': 600, 'atan2': 2500, 'atan': 2000,
+    'floor': 60, 'ceil': 60, 'round': 60, 'trunc': 50, 'lround': 80, 'frexp': 60, 'ldexp': 60,
+}
+
+# arm runtime helpers
+ARM_DOUBLE = re.compile(r'^__(aeabi_d(add|sub|rsub|mul|cmp\w*)|(add|sub|mul)df3|(eq|ne|lt|le|gt|ge|un)df2)$')
+ARM_DOUBLE_DIV = re.compile(r'^__(aeabi_ddiv|divdf3)$')
+ARM_DOUBLE_CONVERT = re.compile(r'^__(aeabi_([fiul]+2d|d2[fiul]+z?)|(extendsf|truncdf)\w*|float\w*df|fix\w*df\w*)$')
+ARM_DIV64 = re.compile(r'^__(aeabi_u?ldivmod|u?divdi3|u?moddi3)$')
+ARM_DIV = re.compile(r'^__(aeabi_u?idiv(mod)?|u?divsi3|u?modsi3)$')
+
+# x86-64 host instructions
+X86_DOUBLE = re.compile(r'^(add|sub|mul|min|max)[sp]d$|^u?comisd$|^f(ld|st|add|sub|mul|div|sqrt|i|chs|abs|xch|u?comi)')
+X86_DOUBLE_DIV = re.compile(r'^(div|sqrt)[sp]d$')
+X86_DOUBLE_CONVERT = re.compile(r'^cvtt?(\w*2[sp]d|[sp]d2\w*)[lq]?$')
+X86_FLOAT_DIV = re.compile(r'^(div|sqrt)[sp]s$')
+X86_DIV = re.compile(r'^i?div[bwlq]?$')
+
+FUNCTION_LINE = re.compile(r'^([0-9a-f]+) <(.+)>:$')
+INSTRUCTION_LINE = re.compile(r'^\s+([0-9a-f]+):\s+(\S+)\s*(.*)$')
+TARGET = re.compile(r'<([^>+]+)(\+0x[0-9a-f]+)?>')
+
+
+class Function:
+    def __init__(self, name):
+        self.name = name
+        self.instructions = 0
+        self.cycles = 0
+        self.calls = set()
+        self.hazards = {'double': 0, 'libm': 0, 'div': 0, 'indirect': 0}
+        self.libm = {}
+
+    def add(self, hazard, cycles):
+        self.hazards[hazard] += 1
+        self.cycles += cycles
+
+
+def strip_symbol(name):
+    return name.split('@')[0]
+
+
+def call_target(operands):
+    match = TARGET.search(operands)
+    if not match:
+        return None, False
+    return strip_symbol(match.group(1)), match.group(2) is not None
+
+
+def add_call(function, target, arm):
+    if target in LIBM:
+        function.add('libm', LIBM[target])
+        function.libm[target] = function.libm.get(target, 0) + 1
+    elif arm and ARM_DOUBLE.match(target):
+        function.add('double', COST_DOUBLE)
+    elif arm and ARM_DOUBLE_DIV.match(target):
+        function.add('double', COST_DOUBLE_DIV)
+    elif arm and ARM_DOUBLE_CONVERT.match(target):
+        function.add('double', COST_DOUBLE_CONVERT)
+    elif arm and ARM_DIV64.match(target):
+        function.add('div', COST_DIV64)
+    elif arm and ARM_DIV.match(target):
+        function.add('div', COST_DIV)
+    else:
+        function.calls.add(target)
+
+
+def analyze_x86(function, mnemonic, operands):
+    if mnemonic.startswith('v') and mnemonic != 'vzeroupper':
+        mnemonic = mnemonic[1:]
+    if mnemonic in ('call', 'callq', 'jmp', 'jmpq'):
+        if operands.startswith('*'):
+            target, _ = call_target(operands)
+            if target:
+                # -fno-plt style call through the got
+                add_call(function, target, False)
+            elif mnemonic.startswith('call'):
+                function.add('indirect', COST_INDIRECT)
+            return
+        target, offset = call_target(operands)
+        if target and (mnemonic.startswith('call') or (not offset and target != function.name)):
+            add_call(function, target, False)
+    elif X86_DOUBLE_DIV.match(mnemonic):
+        function.add('double', COST_DOUBLE_DIV)
+    elif X86_DOUBLE_CONVERT.match(mnemonic):
+        function.add('double', COST_DOUBLE_CONVERT)
+    elif X86_DOUBLE.match(mnemonic):
+        function.add('double', COST_DOUBLE)
+    elif X86_FLOAT_DIV.match(mnemonic):
+        function.add('div', COST_FLOAT_DIV)
+    elif X86_DIV.match(mnemonic):
+        function.add('div', COST_DIV)
+
+
+def analyze_arm(function, mnemonic, operands):
+    base = mnemonic.split('.')[0]
+    if base in ('bl', 'b', 'blx') and not re.match(r'^(r\d+|ip|lr)\b', operands):
+        target, offset = call_target(operands)
+        if target and (base == 'bl' or (not offset and target != function.name)):
+            add_call(function, target, True)
+    elif base in ('blx', 'bx') and re.match(r'^(r\d+|ip)\b', operands):
+        if base == 'blx':
+            function.add('indirect', COST_INDIRECT)
+    elif base in ('sdiv', 'udiv'):
+        function.add('div', COST_DIV)
+    elif base in ('vdiv', 'vsqrt'):
+        function.add('double' if '.f64' in mnemonic else 'div', COST_DOUBLE_DIV if '.f64' in mnemonic else COST_FLOAT_DIV)
+
+
+def disassemble(objdump, binary):
+    try:
+        output = subprocess.run([objdump, '-d', '-C', '-w', '--no-show-raw-insn', binary],
+                                check=True, stdout=subprocess.PIPE, universal_newlines=True).stdout
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit('cannot disassemble %s: %s' % (binary, e))
+
+    arm = re.search(r'file format elf32-(little|big)arm', output) is not None
+    analyze = analyze_arm if arm else analyze_x86
+    functions = {}
+    function = None
+    for line in output.splitlines():
+        match = FUNCTION_LINE.match(line)
+        if match:
+            name = strip_symbol(match.group(2))
+            function = functions.setdefault(name, Function(name))
+            continue
+        match = INSTRUCTION_LINE.match(line)
+        if not match or not function:
+            continue
+        mnemonic, operands = match.group(2), match.group(3).split(';')[0].strip()
+        if mnemonic in ('notrack', 'bnd', 'rep', 'lock') and operands:
+            mnemonic, _, operands = operands.partition(' ')
+            mnemonic = mnemonic.strip()
+            operands = operands.strip()
+        if mnemonic.startswith('.') or mnemonic == '(bad)':
+            continue
+        function.instructions += 1
+        function.cycles += COST_INSTRUCTION
+        analyze(function, mnemonic, operands)
+    return functions, arm
+
+
+def reachable(functions, roots):
+    visited = set()
+    stack = list(roots)
+    while stack:
+        name = stack.pop()
+        if name in visited or name not in functions:
+            continue
+        visited.add(name)
+        stack.extend(functions[name].calls)
+    return visited
+
+
+def report(functions, args, arm):
+    roots = [name for name in functions if re.search(args.roots, name)]
+    if not roots:
+        sys.exit('no functions match %s' % args.roots)
+    names = reachable(functions, roots)
+    if args.filter:
+        names = [name for name in names if re.search(args.filter, name)]
+
+    entries = []
+    for name in names:
+        function = functions[name]
+        entries.append({
+            'name': name,
+            'root': name in roots,
+            'instructions': function.instructions,
+            'm4_cycles': function.cycles,
+            'double': function.hazards['double'],
+            'libm': function.hazards['libm'],
+            'libm_calls': function.libm,
+            'div': function.hazards['div'],
+            'indirect': function.hazards['indirect'],
+        })
+    entries.sort(key=lambda e: (-e['m4_cycles'], e['name']))
+    return {
+        'context': {
+            'binary': args.binary,
+            'target': 'arm' if arm else 'host',
+            'roots': args.roots,
+            'root_count': len(roots),
+        },
+        'functions': entries,
+    }
+
+
+def flagged(entry):
+    return entry['double'] > 0 or entry['libm'] > 0 or entry['div'] > 0 or entry['indirect'] > 0
+
+
+def print_report(result, top):
+    entries = result['functions']
+    print('%d functions reachable from %d roots (%s)' % (len(entries), result['context']['root_count'], result['context']['target']))
+    print('%-64s %8s %9s %7s %5s %5s %9s  %s' % ('function', 'instr', 'm4 cyc', 'double', 'libm', 'div', 'indirect', 'libm calls'))
+    shown = 0
+    for entry in entries:
+        # the most expensive functions and every function with a flagged operation
+        if shown >= top and not flagged(entry):
+            continue
+        shown += 1
+        name = entry['name'] if len(entry['name']) <= 64 else entry['name'][:61] + '...'
+        libm = ' '.join('%s:%d' % item for item in sorted(entry['libm_calls'].items()))
+        print('%-64s %8d %9d %7d %5d %5d %9d  %s' % (name, entry['instructions'], entry['m4_cycles'],
+              entry['double'], entry['libm'], entry['div'], entry['indirect'], libm))
+    total = sum(e['m4_cycles'] for e in entries)
+    print('total m4 cycle estimate %d (%.2f us at 168 MHz for one pass through every function)' % (total, total / 168.0))
+
+
+def compare(result, filename):
+    # returns the number of functions with new or additional flagged operations
+    with open(filename) as f:
+        baseline = {e['name']: e for e in json.load(f)['functions']}
+    regressions = 0
+    for entry in result['functions']:
+        before = baseline.get(entry['name'])
+        changes = []
+        for hazard in ('double', 'libm', 'div', 'indirect'):
+            count = before[hazard] if before else 0
+            if entry[hazard] > count:
+                changes.append('%s %d -> %d' % (hazard, count, entry[hazard]))
+        if changes:
+            regressions += 1
+            print('%-64s %s' % (entry['name'][:64], ', '.join(changes)))
+    print('%d functions with new flagged operations' % regressions)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Estimate Cortex-M4 cost of the engine tick paths')
+    parser.add_argument('binary')
+    parser.add_argument('--roots', default=DEFAULT_ROOTS, help='regex matching the entry points (default: engine tick/update)')
+    parser.add_argument('--filter', help='only report functions matching this regex')
+    parser.add_argument('--top', type=int, default=30, help='number of unflagged functions to show')
+    parser.add_argument('--json', help='write the report as json (- for stdout)')
+    parser.add_argument('--baseline', help='json report to compare flagged operations against, exits 1 on new ones')
+    parser.add_argument('--objdump', help='objdump executable (default: arm-none-eabi-objdump for arm, objdump otherwise)')
+    args = parser.parse_args()
+
+    objdump = args.objdump
+    if not objdump:
+        with open(args.binary, 'rb') as f:
+            header = f.read(20)
+        # elf machine 40 is arm
+        objdump = 'arm-none-eabi-objdump' if header[:4] == b'\x7fELF' and header[18] == 40 else 'objdump'
+
+    functions, arm = disassemble(objdump, args.binary)
+    result = report(functions, args, arm)
+
+    if args.json:
+        if args.json == '-':
+            json.dump(result, sys.stdout, indent=2)
+            print()
+        else:
+            with open(args.json, 'w') as f:
+                json.dump(result, f, indent=2)
+    if args.json != '-':
+        print_report(result, args.top)
+
+    if args.baseline:
+        sys.exit(1 if compare(result, args.baseline) > 0 else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+// Fuzz targets for the parsers of untrusted input.
+//
+// Every target implements the libFuzzer entry point, which is called with a single input and must not
+// crash, leak or read uninitialized memory for any input. Targets are either linked with libFuzzer or
+// with the standalone driver in FuzzMain.cpp (see CMakeLists.txt).
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+namespace fuzz {
+
+// Throughput the target is expected to reach with the standalone driver in a release build, the driver
+// reports targets that run slower. Fuzzing below these rates is not effective.
+extern const int TargetExecsPerSecond;
+
+} // namespace fuzz
+
+// Checks an invariant of the target, a violation aborts to let the fuzzer record the input.
+#define FUZZ_CHECK(_cond_)                                                              \
+    do {                                                                                \
+        if (!(_cond_)) {                                                                \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #_cond_); \
+            std::abort();                                                               \
+        }                                                                               \
+    } while (0)
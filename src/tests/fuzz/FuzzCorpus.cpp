@@ -0,0 +1,188 @@
+#include "apps/sequencer/model/FileDefs.h"
+#include "apps/sequencer/model/Project.h"
+#include "apps/sequencer/model/ProjectVersion.h"
+#include "apps/sequencer/model/Settings.h"
+#include "apps/sequencer/model/UserScale.h"
+
+#include "core/io/CompressedWriter.h"
+#include "core/io/VersionedSerializedWriter.h"
+#include "core/midi/MidiMessage.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+
+#include <sys/stat.h>
+
+// Writes the seed corpus of the fuzz targets, files are written in the same format as by FileManager.
+// Project and scale files from an sd card can be added to the corpus as they are.
+//
+// usage: fuzz_corpus <dir>
+
+using Data = std::vector<uint8_t>;
+
+static bool writeFile(const std::string &filename, const Data &data) {
+    FILE *file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        std::fprintf(stderr, "cannot write %s\n", filename.c_str());
+        return false;
+    }
+    bool success = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    std::fclose(file);
+    return success;
+}
+
+static void append(Data &data, const void *buf, size_t len) {
+    auto bytes = static_cast<const uint8_t *>(buf);
+    data.insert(data.end(), bytes, bytes + len);
+}
+
+template<typename T>
+static Data writeModel(const T &model, FileType type, const char *name, uint32_t version, bool compressed = false) {
+    Data data;
+    FileHeader header(type, uint8_t(compressed ? FileFormat::Compressed : FileFormat::Raw), name);
+    append(data, &header, sizeof(header));
+
+    static CompressedStream::Workspace workspace;
+    CompressedWriter compressedWriter([&data] (const void *buf, size_t len) { append(data, buf, len); }, workspace);
+    {
+        VersionedSerializedWriter writer(
+            [&] (const void *buf, size_t len) {
+                if (compressed) {
+                    compressedWriter.write(buf, len);
+                } else {
+                    append(data, buf, len);
+                }
+            },
+            version
+        );
+        model.write(writer);
+    }
+    if (compressed) {
+        compressedWriter.finish();
+    }
+
+    return data;
+}
+
+static bool writeProjects(const std::string &dir) {
+    std::unique_ptr<Project> project(new Project());
+
+    // default project (the demo project on the simulator)
+    bool success = writeFile(dir + "/default-raw", writeModel(*project, FileType::Project, project->name(), ProjectVersion::Latest));
+    success &= writeFile(dir + "/default", writeModel(*project, FileType::Project, project->name(), ProjectVersion::Latest, true));
+
+    // all tracks in the same mode with some content in every pattern
+    for (int mode = 0; mode < int(Track::TrackMode::Last); ++mode) {
+        project->clear();
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            project->setTrackMode(trackIndex, Track::TrackMode(mode));
+            if (Track::TrackMode(mode) == Track::TrackMode::Note) {
+                for (int patternIndex = 0; patternIndex < CONFIG_PATTERN_COUNT; ++patternIndex) {
+                    auto &sequence = project->noteSequence(trackIndex, patternIndex);
+                    for (int stepIndex = 0; stepIndex < CONFIG_STEP_COUNT; ++stepIndex) {
+                        sequence.step(stepIndex).setGate((stepIndex + trackIndex + patternIndex) % 3 == 0);
+                        sequence.step(stepIndex).setNote((stepIndex * 7 + patternIndex) % 24);
+                    }
+                }
+            }
+        }
+        project->setName(Track::trackModeName(Track::TrackMode(mode)));
+        std::string filename = dir + "/mode" + std::to_string(mode);
+        success &= writeFile(filename, writeModel(*project, FileType::Project, project->name(), ProjectVersion::Latest, true));
+    }
+
+    return success;
+}
+
+static bool writeUserScales(const std::string &dir) {
+    UserScale userScale;
+    bool success = writeFile(dir + "/init", writeModel(userScale, FileType::UserScale, "INIT", ProjectVersion::Latest));
+
+    static const int major[] = { 0, 2, 4, 5, 7, 9, 11 };
+    userScale.setName("MAJOR");
+    userScale.setSize(7);
+    for (int i = 0; i < 7; ++i) {
+        userScale.setItem(i, major[i]);
+    }
+    success &= writeFile(dir + "/major", writeModel(userScale, FileType::UserScale, "MAJOR", ProjectVersion::Latest));
+
+    userScale.clear();
+    userScale.setName("VOLTAGE");
+    userScale.setMode(UserScale::Mode::Voltage);
+    userScale.setSize(CONFIG_USER_SCALE_SIZE);
+    for (int i = 0; i < CONFIG_USER_SCALE_SIZE; ++i) {
+        userScale.setItem(i, i * 100);
+    }
+    success &= writeFile(dir + "/voltage", writeModel(userScale, FileType::UserScale, "VOLTAGE", ProjectVersion::Latest));
+
+    return success;
+}
+
+static bool writeSettings(const std::string &dir) {
+    Settings settings;
+    bool success = writeFile(dir + "/default", writeModel(settings, FileType::Settings, "SETTINGS", Settings::Version));
+
+    for (auto &cvOutput : settings.calibration().cvOutputs()) {
+        for (int i = 0; i < Calibration::CvOutput::ItemCount; i += 2) {
+            cvOutput.setItem(i, cvOutput.defaultItemValue(i) + 100);
+            cvOutput.setUserDefined(i, true);
+        }
+    }
+    success &= writeFile(dir + "/calibrated", writeModel(settings, FileType::Settings, "SETTINGS", Settings::Version));
+
+    return success;
+}
+
+static bool writeMidi(const std::string &dir) {
+    auto stream = [] (std::initializer_list<MidiMessage> messages) {
+        Data data;
+        for (const auto &message : messages) {
+            append(data, message.raw(), message.length());
+        }
+        return data;
+    };
+
+    bool success = writeFile(dir + "/notes", stream({
+        MidiMessage::makeNoteOn(0, 60, 100), MidiMessage::makeNoteOn(0, 64, 90),
+        MidiMessage::makeNoteOff(0, 60), MidiMessage::makeNoteOn(1, 67, 0), MidiMessage::makeNoteOff(0, 64)
+    }));
+    success &= writeFile(dir + "/controllers", stream({
+        MidiMessage::makeControlChange(2, 1, 64), MidiMessage::makePitchBend(2, -1000),
+        MidiMessage::makeProgramChange(2, 5), MidiMessage::makeChannelPressure(2, 30), MidiMessage::makeKeyPressure(2, 60, 20)
+    }));
+    success &= writeFile(dir + "/clock", stream({
+        MidiMessage(MidiMessage::Start), MidiMessage(MidiMessage::Tick), MidiMessage(MidiMessage::Tick),
+        MidiMessage(MidiMessage::Stop), MidiMessage(MidiMessage::SongPosition, 0x10, 0x02), MidiMessage(MidiMessage::Continue)
+    }));
+    // running status, real-time bytes within a message and system exclusive
+    success &= writeFile(dir + "/mixed", Data({
+        0x90, 0x3c, 0x64, 0x3e, 0x64, 0x40, 0xf8, 0x64,
+        0xf0, 0x7d, 0x01, 0x02, 0xf8, 0x03, 0xf7,
+        0xb0, 0x07, 0x7f, 0xf3, 0x01, 0xf6, 0x80, 0x3c, 0x00, 0xff
+    }));
+
+    return success;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        std::printf("usage: fuzz_corpus <dir>\n");
+        return 1;
+    }
+
+    std::string dir(argv[1]);
+    bool success = true;
+    for (const char *subdir : { "", "/project", "/userscale", "/settings", "/midi" }) {
+        mkdir((dir + subdir).c_str(), 0755);
+    }
+
+    success &= writeProjects(dir + "/project");
+    success &= writeUserScales(dir + "/userscale");
+    success &= writeSettings(dir + "/settings");
+    success &= writeMidi(dir + "/midi");
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+#include "Fuzz.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Standalone driver for fuzz targets when not linking with libFuzzer.
+//
+// Runs every input file (or every file in an input directory) once, which reproduces crashes and runs
+// the seed corpus as a regression test. Without inputs a single input is read from stdin. AFL can use
+// the driver directly by passing the input file (afl-fuzz -i <corpus> -o <findings> -- <target> @@).
+//
+// With --runs the driver additionally runs the given number of random mutations of the corpus inputs
+// and reports the throughput. This is no replacement for a coverage guided fuzzer but finds shallow
+// bugs on toolchains without libFuzzer. The input of a crashing run is written to crash-input.
+//
+// usage: <target> [--runs <n>] [--seed <n>] [--max-len <bytes>] [<file|dir>...]
+
+struct Options {
+    uint64_t runs = 0;
+    uint32_t seed = 1;
+    size_t maxLen = 1 << 20;
+    std::vector<std::string> inputs;
+};
+
+using Input = std::vector<uint8_t>;
+
+static const Input *g_currentInput;
+
+static void writeCrashInput(int signal) {
+    if (g_currentInput) {
+        FILE *file = std::fopen("crash-input", "wb");
+        if (file) {
+            std::fwrite(g_currentInput->data(), 1, g_currentInput->size(), file);
+            std::fclose(file);
+        }
+        std::fprintf(stderr, "crashing input (%d bytes) written to crash-input\n", int(g_currentInput->size()));
+    }
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+static bool readFile(const std::string &filename, Input &input) {
+    FILE *file = std::fopen(filename.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    input.clear();
+    uint8_t buf[4096];
+    size_t len;
+    while ((len = std::fread(buf, 1, sizeof(buf), file)) > 0) {
+        input.insert(input.end(), buf, buf + len);
+    }
+    std::fclose(file);
+    return true;
+}
+
+static bool isDirectory(const std::string &path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+static bool readInputs(const std::string &path, std::vector<Input> &inputs) {
+    if (!isDirectory(path)) {
+        inputs.emplace_back();
+        return readFile(path, inputs.back());
+    }
+
+    DIR *dir = opendir(path.c_str());
+    if (!dir) {
+        return false;
+    }
+    std::vector<std::string> filenames;
+    while (struct dirent *entry = readdir(dir)) {
+        std::string filename = path + "/" + entry->d_name;
+        if (entry->d_name[0] != '.' && !isDirectory(filename)) {
+            filenames.emplace_back(filename);
+        }
+    }
+    closedir(dir);
+
+    // sort for a reproducible order of mutations
+    std::sort(filenames.begin(), filenames.end());
+    for (const auto &filename : filenames) {
+        inputs.emplace_back();
+        if (!readFile(filename, inputs.back())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void runInput(const Input &input) {
+    g_currentInput = &input;
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+    g_currentInput = nullptr;
+}
+
+// Applies one to four random byte level mutations, splicing in data from another corpus input.
+static void mutate(Input &input, const std::vector<Input> &corpus, size_t maxLen, std::mt19937 &rng) {
+    static const uint8_t interesting[] = { 0x00, 0x01, 0x7f, 0x80, 0xf0, 0xf7, 0xff };
+
+    auto random = [&rng] (size_t n) { return n > 0 ? size_t(rng() % n) : 0; };
+
+    int count = 1 + random(4);
+    for (int i = 0; i < count; ++i) {
+        switch (input.empty() ? 4 : random(7)) {
+        case 0:
+            input[random(input.size())] ^= uint8_t(1 << random(8));
+            break;
+        case 1:
+            input[random(input.size())] = uint8_t(rng());
+            break;
+        case 2:
+            input[random(input.size())] = interesting[random(sizeof(interesting))];
+            break;
+        case 3: {
+            // overwrite with a little endian 16 or 32 bit value, hits sizes and counts
+            size_t width = random(2) ? 2 : 4;
+            if (input.size() >= width) {
+                size_t pos = random(input.size() - width + 1);
+                uint32_t value = random(2) ? uint32_t(rng()) : uint32_t(random(256)) - 128;
+                std::memcpy(&input[pos], &value, width);
+            }
+            break;
+        }
+        case 4:
+            if (input.size() < maxLen) {
+                input.insert(input.begin() + random(input.size() + 1), uint8_t(rng()));
+            }
+            break;
+        case 5: {
+            size_t pos = random(input.size());
+            size_t len = std::min(random(16) + 1, input.size() - pos);
+            input.erase(input.begin() + pos, input.begin() + pos + len);
+            break;
+        }
+        case 6: {
+            // copy a block from another input to the same position, keeps the surrounding structure intact
+            const auto &other = corpus[random(corpus.size())];
+            if (!other.empty()) {
+                size_t pos = random(std::min(input.size(), other.size()));
+                size_t len = std::min(random(256) + 1, std::min(input.size(), other.size()) - pos);
+                std::memcpy(&input[pos], &other[pos], len);
+            }
+            break;
+        }
+        }
+    }
+
+    if (input.size() > maxLen) {
+        input.resize(maxLen);
+    }
+}
+
+static void printUsage() {
+    std::printf("usage: <target> [--runs <n>] [--seed <n>] [--max-len <bytes>] [<file|dir>...]\n");
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--runs") == 0 && hasValue) {
+            options.runs = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--seed") == 0 && hasValue) {
+            options.seed = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(arg, "--max-len") == 0 && hasValue) {
+            options.maxLen = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg[0] == '-' && arg[1] == '-') {
+            printUsage();
+            return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+        } else {
+            options.inputs.emplace_back(arg);
+        }
+    }
+
+    for (int signal : { SIGSEGV, SIGABRT, SIGFPE, SIGILL }) {
+        std::signal(signal, writeCrashInput);
+    }
+
+    std::vector<Input> corpus;
+    if (options.inputs.empty()) {
+        corpus.emplace_back();
+        readFile("/dev/stdin", corpus.back());
+    }
+    for (const auto &path : options.inputs) {
+        if (!readInputs(path, corpus)) {
+            std::fprintf(stderr, "cannot read %s\n", path.c_str());
+            return 1;
+        }
+    }
+
+    for (const auto &input : corpus) {
+        runInput(input);
+    }
+    std::printf("ran %d inputs\n", int(corpus.size()));
+
+    if (options.runs == 0) {
+        return 0;
+    }
+
+    if (corpus.empty()) {
+        corpus.emplace_back();
+    }
+
+    std::mt19937 rng(options.seed);
+    Input input;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t run = 0; run < options.runs; ++run) {
+        input = corpus[rng() % corpus.size()];
+        mutate(input, corpus, options.maxLen, rng);
+        runInput(input);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double execsPerSecond = seconds > 0.0 ? options.runs / seconds : 0.0;
+    std::printf("ran %llu mutations in %.2f s: %.0f execs/s (target %d execs/s)\n",
+        (unsigned long long)options.runs, seconds, execsPerSecond, fuzz::TargetExecsPerSecond);
+    if (execsPerSecond < fuzz::TargetExecsPerSecond) {
+        std::printf("below target throughput\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include "Fuzz.h"
+
+#include "core/midi/MidiMessage.h"
+#include "core/midi/MidiParser.h"
+
+// Input is a raw midi byte stream as received on the midi and usb midi ports.
+
+const int fuzz::TargetExecsPerSecond = 1000000;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    // a fresh parser per input, parser state would make inputs depend on the ones run before
+    MidiParser parser;
+
+    for (size_t i = 0; i < size; ++i) {
+        if (parser.feed(data[i])) {
+            const auto &message = parser.message();
+            // emitted messages are complete and well formed
+            FUZZ_CHECK(message.status() & 0x80);
+            FUZZ_CHECK(message.length() >= 1);
+            for (int j = 1; j < message.length(); ++j) {
+                FUZZ_CHECK((message.raw()[j] & 0x80) == 0);
+            }
+            if (message.isChannelMessage()) {
+                FUZZ_CHECK(message.length() == 1 + MidiMessage::channelMessageLength(message.channelMessage()));
+            } else if (message.isRealTimeMessage() || message.isTuneRequest()) {
+                FUZZ_CHECK(message.length() == 1);
+            }
+        }
+    }
+
+    return 0;
+}
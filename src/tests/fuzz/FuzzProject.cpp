@@ -0,0 +1,85 @@
+#include "Fuzz.h"
+
+#include "apps/sequencer/model/FileDefs.h"
+#include "apps/sequencer/model/Project.h"
+#include "apps/sequencer/model/ProjectVersion.h"
+
+#include "core/io/CompressedReader.h"
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <cstring>
+
+// Input is a project file as stored on the sd card (file header followed by the raw or compressed project).
+
+const int fuzz::TargetExecsPerSecond = 2000;
+
+static std::vector<uint8_t> writeProject(const Project &project) {
+    std::vector<uint8_t> data;
+    VersionedSerializedWriter writer(
+        [&data] (const void *buf, size_t len) {
+            auto bytes = static_cast<const uint8_t *>(buf);
+            data.insert(data.end(), bytes, bytes + len);
+        },
+        ProjectVersion::Latest
+    );
+    project.write(writer);
+    return data;
+}
+
+static bool readProject(Project &project, const uint8_t *data, size_t size) {
+    FileHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    data += sizeof(header);
+    size -= sizeof(header);
+
+    // same checks as FileManager::readProject
+    if (header.version >= uint8_t(FileFormat::Last)) {
+        return false;
+    }
+
+    if (header.version == uint8_t(FileFormat::Compressed)) {
+        static CompressedStream::Workspace workspace;
+        size_t pos = 0;
+        CompressedReader compressedReader(
+            [data, size, &pos] (void *buf, size_t len) {
+                size_t available = std::min(len, size - pos);
+                std::memcpy(buf, data + pos, available);
+                std::memset(static_cast<uint8_t *>(buf) + available, 0, len - available);
+                pos += available;
+            },
+            workspace
+        );
+        VersionedSerializedReader reader(
+            [&compressedReader] (void *buf, size_t len) { compressedReader.read(buf, len); },
+            ProjectVersion::Latest
+        );
+        return project.read(reader) && !compressedReader.error();
+    }
+
+    VersionedSerializedReader reader(data, size, ProjectVersion::Latest);
+    return project.read(reader);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    // the project is too large for the stack and expensive to construct, reading clears it
+    static std::unique_ptr<Project> project(new Project());
+
+    if (readProject(*project, data, size)) {
+        // a project that was read successfully must survive a round trip unchanged
+        auto written = writeProject(*project);
+        VersionedSerializedReader reader(written.data(), written.size(), ProjectVersion::Latest);
+        FUZZ_CHECK(project->read(reader));
+        FUZZ_CHECK(!reader.overrun());
+        FUZZ_CHECK(writeProject(*project) == written);
+    }
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include "Fuzz.h"
+
+#include "apps/sequencer/model/FileDefs.h"
+#include "apps/sequencer/model/Settings.h"
+
+#include "core/io/VersionedSerializedReader.h"
+
+// Input is a settings file as stored on the sd card (file header followed by the settings).
+
+const int fuzz::TargetExecsPerSecond = 100000;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    // allocated once and never destroyed, UserSettings does not free its settings
+    static Settings &settings = *new Settings();
+
+    // the file header is skipped by FileManager::readSettings
+    if (size < sizeof(FileHeader)) {
+        return 0;
+    }
+
+    VersionedSerializedReader reader(data + sizeof(FileHeader), size - sizeof(FileHeader), Settings::Version);
+    settings.read(reader);
+
+    // calibration is applied to every cv output update
+    for (const auto &cvOutput : settings.calibration().cvOutputs()) {
+        for (float volts = -6.f; volts <= 6.f; volts += 0.25f) {
+            FUZZ_CHECK(cvOutput.voltsToValue(volts) <= 0x7fff);
+        }
+    }
+
+    return 0;
+}
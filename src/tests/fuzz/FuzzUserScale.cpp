@@ -0,0 +1,41 @@
+#include "Fuzz.h"
+
+#include "apps/sequencer/model/FileDefs.h"
+#include "apps/sequencer/model/ProjectVersion.h"
+#include "apps/sequencer/model/UserScale.h"
+
+#include "core/io/VersionedSerializedReader.h"
+#include "core/utils/StringBuilder.h"
+
+#include <cstring>
+
+// Input is a user scale file as stored on the sd card (file header followed by the scale).
+
+const int fuzz::TargetExecsPerSecond = 50000;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static UserScale userScale;
+
+    // the file header is skipped by FileManager::readUserScale
+    if (size < sizeof(FileHeader)) {
+        return 0;
+    }
+
+    VersionedSerializedReader reader(data + sizeof(FileHeader), size - sizeof(FileHeader), ProjectVersion::Latest);
+    userScale.read(reader);
+
+    // the scale is used by the engine and ui whether the read succeeded or not
+    FUZZ_CHECK(userScale.mode() < UserScale::Mode::Last);
+    FUZZ_CHECK(userScale.size() >= 1 && userScale.size() <= CONFIG_USER_SCALE_SIZE);
+    FUZZ_CHECK(std::strlen(userScale.name()) <= UserScale::NameLength);
+
+    FixedStringBuilder<16> str;
+    for (int note = -2 * CONFIG_USER_SCALE_SIZE; note <= 2 * CONFIG_USER_SCALE_SIZE; ++note) {
+        float volts = userScale.noteToVolts(note);
+        userScale.noteFromVolts(volts);
+        str.reset();
+        userScale.noteName(str, note, 0, Scale::Long);
+    }
+
+    return 0;
+}
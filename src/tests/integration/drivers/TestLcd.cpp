@@ -43,8 +43,8 @@ public:
     }
 
 private:
-    uint8_t frameBufferData[256*64];
-    FrameBuffer8bit frameBuffer;
+    uint8_t frameBufferData[256*64/2];
+    FrameBuffer4bit frameBuffer;
     Canvas canvas;
     Lcd lcd;
     Timer timer;
@@ -0,0 +1,236 @@
+#include "UnitTest.h"
+
+#include "core/gfx/Canvas.h"
+#include "core/gfx/Layer.h"
+#include "core/gfx/fonts/tiny5x5.h"
+#include "core/gfx/fonts/ati8x8.h"
+#include "core/utils/Random.h"
+
+#include <cstdint>
+
+static const int Width = 256;
+static const int Height = 64;
+
+// Renders the same drawing into an 8-bit and a packed 4-bit canvas.
+struct CanvasPair {
+    uint8_t data8bit[Width * Height];
+    uint8_t data4bit[Width * Height / 2];
+    FrameBuffer8bit frameBuffer8bit;
+    FrameBuffer4bit frameBuffer4bit;
+    float brightness = 1.f;
+    Canvas8bit canvas8bit;
+    Canvas canvas4bit;
+
+    CanvasPair() :
+        frameBuffer8bit(Width, Height, data8bit),
+        frameBuffer4bit(Width, Height, data4bit),
+        canvas8bit(frameBuffer8bit, brightness),
+        canvas4bit(frameBuffer4bit, brightness)
+    {}
+
+    // compares the 4-bit canvas with the 8-bit canvas clamped the same way the display driver did
+    int mismatches() const {
+        int count = 0;
+        for (int y = 0; y < Height; ++y) {
+            for (int x = 0; x < Width; ++x) {
+                uint8_t expected = std::min(frameBuffer8bit(x, y), uint8_t(0xf));
+                if (frameBuffer4bit.get(x, y) != expected) {
+                    ++count;
+                }
+            }
+        }
+        return count;
+    }
+};
+
+template<typename CanvasType>
+static void drawPage(CanvasType &canvas) {
+    canvas.setBlendMode(BlendMode::Set);
+    canvas.setColor(Color::None);
+    canvas.fill();
+
+    canvas.setColor(Color::Medium);
+    canvas.hline(0, 8, Width);
+    canvas.hline(0, Height - 9, Width);
+    canvas.setFont(Font::Tiny);
+    canvas.setColor(Color::Bright);
+    canvas.drawText(2, 6, "CLOCK 120.0 BPM");
+    canvas.drawTextCentered(0, Height - 8, Width / 5, 8, "PAT1");
+
+    for (int i = 0; i < 16; ++i) {
+        int x = 5 + i * 15;
+        canvas.setColor(i % 4 == 0 ? Color::Bright : Color::Low);
+        canvas.drawRect(x, 20, 11, 11);
+        if (i % 3 == 0) {
+            canvas.fillRect(x + 2, 22, 7, 7);
+        }
+    }
+
+    canvas.setFont(Font::Small);
+    canvas.fillRect(100, 34, 60, 12);
+    canvas.setBlendMode(BlendMode::Sub);
+    canvas.drawText(104, 43, "SELECT");
+
+    canvas.setBlendMode(BlendMode::Add);
+    canvas.setColor(Color::MediumLow);
+    canvas.line(0.f, 63.f, 255.f, 32.5f);
+    canvas.line(10.5f, 10.f, 20.f, 60.f);
+    canvas.vline(250, 0, Height);
+}
+
+struct Primitive {
+    int op;
+    int x, y, w, h;
+    BlendMode blendMode;
+    uint8_t color;
+    uint8_t bitmap[64];
+};
+
+template<typename CanvasType>
+static void drawPrimitive(CanvasType &canvas, const Primitive &p) {
+    canvas.setBlendMode(p.blendMode);
+    canvas.setColorValue(p.color);
+    switch (p.op) {
+    case 0: canvas.point(p.x, p.y); break;
+    case 1: canvas.hline(p.x, p.y, p.w); break;
+    case 2: canvas.vline(p.x, p.y, p.h); break;
+    case 3: canvas.drawRect(p.x, p.y, p.w, p.h); break;
+    case 4: canvas.fillRect(p.x, p.y, p.w, p.h); break;
+    case 5: canvas.drawBitmap1bit(p.x, p.y, 16, 16, p.bitmap); break;
+    case 6: canvas.drawBitmap4bit(p.x, p.y, 8, 8, p.bitmap); break;
+    }
+}
+
+// Draws text glyph by glyph through the generic bitmap path.
+static void drawTextReference(Canvas &canvas, const BitmapFont &font, int x, int y, const char *str) {
+    for (; *str; ++str) {
+        const auto &g = font.glyphs[*str - font.first];
+        canvas.drawBitmap1bit(x + g.xOffset, y + g.yOffset, g.width, g.height, &font.bitmap[g.offset]);
+        x += g.xAdvance;
+    }
+}
+
+UNIT_TEST("Canvas") {
+
+    CASE("frame buffer spans") {
+        uint8_t data[Width / 2];
+        FrameBuffer4bit frameBuffer(Width, 1, data);
+        for (int x0 = 0; x0 < 8; ++x0) {
+            for (int x1 = x0; x1 < 16; ++x1) {
+                frameBuffer.fill(0x3);
+                frameBuffer.fillSpan(x0, x1, 0, 0xc);
+                for (int x = 0; x < 24; ++x) {
+                    expectEqual(int(frameBuffer.get(x, 0)), (x >= x0 && x <= x1) ? 0xc : 0x3, "pixel value");
+                }
+                frameBuffer.transformSpan(x0, x1, 0, [] (uint8_t pixel) { return uint8_t(pixel - 1); });
+                for (int x = 0; x < 24; ++x) {
+                    expectEqual(int(frameBuffer.get(x, 0)), (x >= x0 && x <= x1) ? 0xb : 0x3, "pixel value");
+                }
+            }
+        }
+    }
+
+    CASE("page drawing matches 8-bit canvas") {
+        static CanvasPair pair;
+
+        drawPage(pair.canvas8bit);
+        drawPage(pair.canvas4bit);
+        expectEqual(pair.mismatches(), 0, "frame buffers should match");
+    }
+
+    CASE("clipped primitives match 8-bit canvas") {
+        static CanvasPair pair;
+
+        Random rng(1234);
+        auto coord = [&rng] (int range) { return int(rng.nextRange(range + 40)) - 20; };
+
+        for (int iteration = 0; iteration < 2000; ++iteration) {
+            Primitive p;
+            p.op = rng.nextRange(7);
+            p.x = coord(Width);
+            p.y = coord(Height);
+            p.w = coord(Width / 2);
+            p.h = coord(Height / 2);
+            // add is not part of this test as it may overflow the 8-bit canvas
+            p.blendMode = rng.nextBinary() ? BlendMode::Set : BlendMode::Sub;
+            p.color = rng.nextRange(16);
+            // 4-bit bitmap pixels are limited to 0/1 so they stay within the 4-bit range when multiplied by the color
+            for (auto &b : p.bitmap) {
+                b = (rng.next() >> 24) & (p.op == 6 ? 0x11 : 0xff);
+            }
+
+            drawPrimitive(pair.canvas8bit, p);
+            drawPrimitive(pair.canvas4bit, p);
+        }
+
+        expectEqual(pair.mismatches(), 0, "frame buffers should match");
+    }
+
+    CASE("text matches glyph bitmaps") {
+        static uint8_t data[2][Width * Height / 2];
+        FrameBuffer4bit frameBuffer(Width, Height, data[0]);
+        FrameBuffer4bit referenceFrameBuffer(Width, Height, data[1]);
+        float brightness = 1.f;
+        Canvas canvas(frameBuffer, brightness);
+        Canvas referenceCanvas(referenceFrameBuffer, brightness);
+
+        const char *text = "!09AZaz~ STEP 12 +0.5";
+        const BlendMode blendModes[] = { BlendMode::Set, BlendMode::Add, BlendMode::Sub };
+        Random rng(4321);
+
+        for (int iteration = 0; iteration < 500; ++iteration) {
+            bool small = rng.nextBinary();
+            int x = int(rng.nextRange(Width + 40)) - 20;
+            int y = int(rng.nextRange(Height + 20)) - 5;
+            BlendMode blendMode = blendModes[rng.nextRange(3)];
+            uint8_t color = rng.nextRange(16);
+            for (auto c : { &canvas, &referenceCanvas }) {
+                c->setFont(small ? Font::Small : Font::Tiny);
+                c->setBlendMode(blendMode);
+                c->setColorValue(color);
+            }
+            canvas.drawText(x, y, text);
+            drawTextReference(referenceCanvas, small ? ati8x8 : tiny5x5, x, y, text);
+        }
+
+        int mismatches = 0;
+        for (int y = 0; y < Height; ++y) {
+            for (int x = 0; x < Width; ++x) {
+                mismatches += frameBuffer.get(x, y) != referenceFrameBuffer.get(x, y);
+            }
+        }
+        expectEqual(mismatches, 0, "frame buffers should match");
+    }
+
+    CASE("composited layer matches direct drawing") {
+        static CanvasPair pair;
+        static Layer<18, 12> layer;
+        float brightness = 1.f;
+        Canvas layerCanvas(layer.frameBuffer(), brightness);
+
+        expectFalse(layer.valid(1), "layer should be invalid");
+        layer.begin(1);
+        expectTrue(layer.valid(1), "layer should be valid");
+        expectFalse(layer.valid(2), "layer should be invalid for other key");
+
+        layerCanvas.setBlendMode(BlendMode::Add);
+        layerCanvas.setColor(Color::Medium);
+        layerCanvas.line(0.f, 2.5f, 17.f, 10.f);
+        layerCanvas.drawRect(3, 3, 5, 5);
+
+        // clipped at all edges and odd offsets
+        const int offsets[][2] = { { 0, 0 }, { 11, 20 }, { -5, -3 }, { 245, 58 }, { 100, 33 } };
+        for (const auto &offset : offsets) {
+            int x = offset[0], y = offset[1];
+            pair.canvas4bit.setBlendMode(BlendMode::Add);
+            pair.canvas4bit.drawLayer(x, y, layer.frameBuffer());
+            pair.canvas8bit.setBlendMode(BlendMode::Add);
+            pair.canvas8bit.setColor(Color::Medium);
+            pair.canvas8bit.line(x + 0.f, y + 2.5f, x + 17.f, y + 10.f);
+            pair.canvas8bit.drawRect(x + 3, y + 3, 5, 5);
+        }
+
+        expectEqual(pair.mismatches(), 0, "frame buffers should match");
+    }
+
+}
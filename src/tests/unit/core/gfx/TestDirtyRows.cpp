@@ -0,0 +1,48 @@
+#include "UnitTest.h"
+
+#include "core/gfx/DirtyRows.h"
+
+#include <cstdint>
+#include <cstring>
+
+static const int Stride = 128;
+static const int Height = 64;
+
+UNIT_TEST("DirtyRows") {
+
+    CASE("identical frames") {
+        static uint8_t a[Stride * Height];
+        static uint8_t b[Stride * Height];
+        std::memset(a, 0x5a, sizeof(a));
+        std::memset(b, 0x5a, sizeof(b));
+        auto rows = DirtyRows::compare(a, b, Stride, Height);
+        expectTrue(rows.empty(), "rows should be empty");
+        expectEqual(rows.count(), 0, "row count");
+    }
+
+    CASE("all rows") {
+        auto rows = DirtyRows::all(Height);
+        expectEqual(rows.first, 0, "first row");
+        expectEqual(rows.last, Height - 1, "last row");
+        expectEqual(rows.count(), Height, "row count");
+    }
+
+    CASE("changed rows") {
+        static uint8_t a[Stride * Height];
+        static uint8_t b[Stride * Height];
+        for (int y0 = 0; y0 < Height; y0 += 7) {
+            for (int y1 = y0; y1 < Height; y1 += 5) {
+                std::memset(a, 0, sizeof(a));
+                std::memset(b, 0, sizeof(b));
+                // change first and last byte of the boundary rows only
+                b[y0 * Stride + Stride - 1] = 1;
+                b[y1 * Stride] = 1;
+                auto rows = DirtyRows::compare(a, b, Stride, Height);
+                expectEqual(rows.first, y0, "first row");
+                expectEqual(rows.last, y1, "last row");
+                expectEqual(rows.count(), y1 - y0 + 1, "row count");
+            }
+        }
+    }
+
+}
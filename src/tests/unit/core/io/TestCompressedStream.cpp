@@ -0,0 +1,82 @@
+#include "UnitTest.h"
+
+#include "MemoryReaderWriter.h"
+
+#include "core/io/CompressedWriter.h"
+#include "core/io/CompressedReader.h"
+#include "core/utils/Random.h"
+
+#include <vector>
+
+static CompressedStream::Workspace workspace;
+
+static std::vector<uint8_t> compress(const std::vector<uint8_t> &data, size_t chunkSize) {
+    std::vector<uint8_t> result;
+    CompressedWriter writer([&result] (const void *data, size_t len) {
+        const uint8_t *src = static_cast<const uint8_t *>(data);
+        result.insert(result.end(), src, src + len);
+    }, workspace);
+    for (size_t pos = 0; pos < data.size(); pos += chunkSize) {
+        writer.write(&data[pos], std::min(chunkSize, data.size() - pos));
+    }
+    writer.finish();
+    return result;
+}
+
+static std::vector<uint8_t> decompress(const std::vector<uint8_t> &compressed, size_t size, size_t chunkSize) {
+    std::vector<uint8_t> result(size);
+    MemoryReader memoryReader(compressed.data(), compressed.size() + 1);
+    CompressedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, workspace);
+    for (size_t pos = 0; pos < size; pos += chunkSize) {
+        reader.read(&result[pos], std::min(chunkSize, size - pos));
+    }
+    expectFalse(reader.error());
+    uint8_t dummy;
+    expectEqual(reader.read(&dummy, 1), size_t(0));
+    expectTrue(reader.end());
+    return result;
+}
+
+UNIT_TEST("CompressedStream") {
+
+    CASE("empty") {
+        std::vector<uint8_t> data;
+        auto compressed = compress(data, 1);
+        expectEqual(compressed.size(), size_t(2));
+        expectTrue(decompress(compressed, 0, 1) == data);
+    }
+
+    CASE("sparse data") {
+        std::vector<uint8_t> data(4000, 0);
+        for (size_t i = 0; i < data.size(); i += 8) {
+            data[i] = 64;
+            data[i + 3] = (i / 64) & 0xff;
+        }
+        auto compressed = compress(data, 3);
+        expectTrue(compressed.size() < data.size() / 6);
+        expectTrue(decompress(compressed, data.size(), 7) == data);
+    }
+
+    CASE("random data is stored") {
+        Random rng(1234);
+        std::vector<uint8_t> data(1500);
+        for (auto &value : data) {
+            value = rng.next() >> 16;
+        }
+        auto compressed = compress(data, 100);
+        // only block headers are added
+        expectEqual(compressed.size(), data.size() + 4 * 2);
+        expectTrue(decompress(compressed, data.size(), 1) == data);
+    }
+
+    CASE("malformed data") {
+        // compressed block referencing data before the block start
+        std::vector<uint8_t> compressed = { 2, 0x80, 0x00, 0x01 };
+        MemoryReader memoryReader(compressed.data(), compressed.size() + 1);
+        CompressedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, workspace);
+        uint8_t buf[16];
+        expectEqual(reader.read(buf, sizeof(buf)), size_t(0));
+        expectTrue(reader.error());
+    }
+
+}
@@ -4,6 +4,7 @@
 
 #include "core/io/VersionedSerializedWriter.h"
 #include "core/io/VersionedSerializedReader.h"
+#include "core/hash/FnvHash.h"
 
 #define VERSION(_x_) (_x_)
 
@@ -149,6 +150,25 @@ static void readVersion4(const void *buf, size_t len) {
     expectEqual(data.field3, expected.field3);
 }
 
+// data written by firmware using the byte wise hash (no word hash flag in version)
+static void writeLegacyVersion4(void *buf, size_t len) {
+    MemoryWriter memoryWriter(buf, len);
+    FnvHash hash;
+    auto write = [&] (const void *data, size_t len) {
+        hash(data, len);
+        memoryWriter.write(data, len);
+    };
+    uint32_t version = 4;
+    memoryWriter.write(&version, sizeof(version));
+    Data4 data;
+    write(&data.field1, sizeof(data.field1));
+    write(&data.field2, sizeof(data.field2));
+    write(&data.field5, sizeof(data.field5));
+    write(&data.field3, sizeof(data.field3));
+    uint32_t result = hash.result();
+    memoryWriter.write(&result, sizeof(result));
+}
+
 static uint8_t buf[512];
 
 static void clear() {
@@ -209,4 +229,97 @@ UNIT_TEST("VersionedSerialization") {
         readVersion4(buf, sizeof(buf));
     }
 
+    CASE("legacy hash") {
+        clear();
+        writeLegacyVersion4(buf, sizeof(buf));
+        readVersion4(buf, sizeof(buf));
+
+        // corrupted data fails validation
+        buf[5] ^= 0x10;
+        MemoryReader memoryReader(buf, sizeof(buf));
+        VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, 4);
+        Data4 data;
+        reader.read(data.field1);
+        reader.read(data.field2);
+        reader.read(data.field5);
+        reader.read(data.field3);
+        expectFalse(reader.checkHash());
+    }
+
+    CASE("buffered writes") {
+        // mix of small and large writes crossing the write buffer
+        uint8_t block[100];
+        for (size_t i = 0; i < sizeof(block); ++i) {
+            block[i] = i;
+        }
+
+        clear();
+        MemoryWriter memoryWriter(buf, sizeof(buf));
+        VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) { memoryWriter.write(data, len); }, 1, true);
+        for (int i = 0; i < 20; ++i) {
+            writer.write(uint8_t(i));
+        }
+        expectEqual(int(memoryWriter.bytesWritten()), 4, "small writes are buffered");
+        writer.write(block, sizeof(block));
+        writer.write(block, 33);
+        writer.writeHash();
+
+        MemoryReader memoryReader(buf, sizeof(buf));
+        VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) { memoryReader.read(data, len); }, 1);
+        for (int i = 0; i < 20; ++i) {
+            uint8_t value;
+            reader.read(value);
+            expectEqual(value, uint8_t(i));
+        }
+        uint8_t readBlock[100];
+        reader.read(readBlock, sizeof(readBlock), 0);
+        expectTrue(std::memcmp(readBlock, block, sizeof(block)) == 0);
+        // read back in different chunks than written
+        reader.read(readBlock, 13, 0);
+        reader.read(readBlock + 13, 20, 0);
+        expectTrue(std::memcmp(readBlock, block, 33) == 0);
+        expectTrue(reader.checkHash());
+    }
+
+    CASE("unbuffered writes are passed on directly") {
+        clear();
+        MemoryWriter memoryWriter(buf, sizeof(buf));
+        VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) { memoryWriter.write(data, len); }, 1);
+        writer.write(uint8_t(1));
+        writer.write(uint16_t(2));
+        expectEqual(int(memoryWriter.bytesWritten()), 4 + 3, "bytes written");
+    }
+
+    CASE("memory buffer") {
+        clear();
+        writeVersion3(buf, sizeof(buf));
+
+        // same result as reading through a reader function
+        VersionedSerializedReader reader(buf, sizeof(buf), 4);
+        expectEqual(reader.dataVersion(), 3u);
+        Data4 data;
+        reader.read(data.field1);
+        reader.read(data.field2);
+        reader.skip<int8_t>(VERSION(2), VERSION(4));
+        reader.read(data.field5, VERSION(3));
+        reader.read(data.field3);
+        expectTrue(reader.checkHash());
+        expectFalse(reader.overrun());
+        Data4 expected;
+        expectEqual(data.field2, expected.field2);
+        expectEqual(data.field5, expected.field5);
+        expectEqual(data.field3, expected.field3);
+
+        // truncated buffer reads zeros past the end and fails validation
+        VersionedSerializedReader truncated(buf, 8, 4);
+        truncated.read(data.field1);
+        truncated.read(data.field2);
+        truncated.skip<int8_t>(VERSION(2), VERSION(4));
+        expectFalse(truncated.overrun());
+        truncated.read(data.field5, VERSION(3));
+        expectEqual(data.field5, int16_t(0));
+        expectTrue(truncated.overrun());
+        expectFalse(truncated.checkHash());
+    }
+
 }
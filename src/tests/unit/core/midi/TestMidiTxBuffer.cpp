@@ -0,0 +1,174 @@
+#include "UnitTest.h"
+
+#include "core/midi/MidiMessage.h"
+#include "core/midi/MidiParser.h"
+#include "core/midi/MidiTxBuffer.h"
+
+#include <algorithm>
+#include <deque>
+
+#include <cmath>
+#include <cstdint>
+
+// Simulates a serial midi output (31250 baud, 320 us per byte) sending a 24 ppqn clock at 120 bpm,
+// optionally together with heavy note traffic (16 voice chord changes on every 16th note). Bytes are
+// written to a 64 byte transmit buffer, the sender blocks (bytes are kept pending) while it is full,
+// just like the hardware driver does. Measures the deviation of clock bytes from their ideal time.
+struct ClockJitter {
+    static constexpr uint32_t ByteTime = 320;
+    static constexpr uint32_t ClockPeriod = 60 * 1000000 / (120 * 24);
+    static constexpr uint32_t NotePeriod = 60 * 1000000 / (120 * 4);
+
+    MidiTxBuffer<64> buffer;
+    MidiParser parser;
+    std::deque<uint8_t> pending;
+    std::deque<uint32_t> clockTimes;
+
+    bool realtime;
+    bool noteTraffic;
+
+    uint32_t clocks = 0;
+    uint32_t maxJitter = 0;
+    double sumJitter = 0;
+    uint32_t messages = 0;
+
+    ClockJitter(bool realtime, bool noteTraffic) :
+        realtime(realtime),
+        noteTraffic(noteTraffic)
+    {}
+
+    void send(const MidiMessage &message) {
+        for (uint8_t i = 0; i < message.length(); ++i) {
+            pending.push_back(message.raw()[i]);
+        }
+    }
+
+    void run(uint32_t duration) {
+        uint32_t nextClock = 0;
+        uint32_t nextNotes = 0;
+        uint32_t lineBusyUntil = 0;
+        int chord = 0;
+
+        for (uint32_t time = 0; time < duration; time += 10) {
+            if (time >= nextClock) {
+                clockTimes.push_back(nextClock);
+                if (realtime) {
+                    buffer.writeRealtime(MidiMessage::Tick);
+                } else {
+                    send(MidiMessage(MidiMessage::Tick));
+                }
+                nextClock += ClockPeriod;
+            }
+            if (noteTraffic && time >= nextNotes) {
+                for (int voice = 0; voice < 16; ++voice) {
+                    send(MidiMessage::makeNoteOff(voice, 48 + (chord + voice) % 24));
+                    send(MidiMessage::makeNoteOn(voice, 48 + (chord + voice + 1) % 24));
+                }
+                ++chord;
+                nextNotes += NotePeriod;
+            }
+
+            // blocking sender
+            while (!pending.empty() && buffer.write(pending.front())) {
+                pending.pop_front();
+            }
+
+            // serial line
+            if (time >= lineBusyUntil && !buffer.empty()) {
+                uint8_t data = buffer.read();
+                lineBusyUntil = time + ByteTime;
+                if (parser.feed(data)) {
+                    if (parser.message().isTick()) {
+                        uint32_t jitter = time - clockTimes.front();
+                        clockTimes.pop_front();
+                        maxJitter = std::max(maxJitter, jitter);
+                        sumJitter += jitter;
+                        ++clocks;
+                    } else {
+                        ++messages;
+                    }
+                }
+            }
+        }
+    }
+
+    double averageJitter() const { return clocks > 0 ? sumJitter / clocks : 0.0; }
+};
+
+UNIT_TEST("MidiTxBuffer") {
+
+    CASE("real-time bytes are sent first") {
+        MidiTxBuffer<8> buffer;
+        buffer.write(0x90);
+        buffer.write(60);
+        buffer.writeRealtime(MidiMessage::Tick);
+        buffer.write(100);
+        buffer.writeRealtime(MidiMessage::Stop);
+
+        expectEqual(int(buffer.read()), int(MidiMessage::Tick));
+        expectEqual(int(buffer.read()), int(MidiMessage::Stop));
+        expectEqual(int(buffer.read()), 0x90);
+        expectEqual(int(buffer.read()), 60);
+        buffer.writeRealtime(MidiMessage::Start);
+        expectEqual(int(buffer.read()), int(MidiMessage::Start));
+        expectEqual(int(buffer.read()), 100);
+        expectTrue(buffer.empty(), "buffer should be empty");
+    }
+
+    CASE("writable space excludes the real-time lane") {
+        MidiTxBuffer<4> buffer;
+        buffer.write(0x90);
+        buffer.writeRealtime(MidiMessage::Tick);
+        expectEqual(int(buffer.writable()), 3, "writable");
+        buffer.write(60);
+        buffer.write(100);
+        buffer.write(0x80);
+        expectEqual(int(buffer.writable()), 0, "full");
+        expectFalse(buffer.write(60), "write to full buffer");
+        expectEqual(int(buffer.overflow()), 1, "overflow");
+    }
+
+    CASE("real-time bytes interleaved with messages are parsed") {
+        MidiTxBuffer<8> buffer;
+        MidiParser parser;
+        int ticks = 0;
+        int notes = 0;
+        buffer.write(0x90);
+        buffer.write(60);
+        buffer.write(100);
+        for (int i = 0; i < 3; ++i) {
+            if (parser.feed(buffer.read())) {
+                notes += parser.message().isNoteOn();
+            }
+            buffer.writeRealtime(MidiMessage::Tick);
+            if (parser.feed(buffer.read())) {
+                ticks += parser.message().isTick();
+            }
+        }
+        expectEqual(ticks, 3, "ticks");
+        expectEqual(notes, 1, "notes");
+    }
+
+    CASE("clock jitter") {
+        const uint32_t duration = 4 * 1000000;
+        ClockJitter idle(false, false);
+        ClockJitter queued(false, true);
+        ClockJitter realtime(true, true);
+        idle.run(duration);
+        queued.run(duration);
+        realtime.run(duration);
+
+        for (const auto *result : { &idle, &queued, &realtime }) {
+            UNIT_TEST_PRINTF("%-24s clocks=%d messages=%d jitter avg=%.0f us max=%d us\n",
+                result == &idle ? "no traffic" : result == &queued ? "note traffic (queued)" : "note traffic (real-time)",
+                int(result->clocks), int(result->messages), result->averageJitter(), int(result->maxJitter));
+        }
+
+        expectEqual(int(idle.clocks), int(duration / ClockJitter::ClockPeriod) + 1, "clocks");
+        expectTrue(idle.maxJitter < ClockJitter::ByteTime, "idle jitter");
+        expectTrue(queued.maxJitter > 10 * ClockJitter::ByteTime, "queued clock should be delayed by note traffic");
+        expectTrue(realtime.maxJitter <= ClockJitter::ByteTime, "real-time clock should only wait for the current byte");
+        expectEqual(realtime.messages, queued.messages, "all note messages should be sent");
+    }
+
+}
@@ -0,0 +1,135 @@
+#include "UnitTest.h"
+
+#include "core/utils/SpscRingBuffer.h"
+#include "core/midi/MidiMessage.h"
+#include "core/midi/MidiParser.h"
+
+#include <thread>
+
+#include <cstdint>
+
+// Feeds a byte stream of dense midi clock plus a control change flood at full midi wire rate (3125 bytes/s)
+// into a 64 byte receive buffer which is drained every millisecond, except while the consumer stalls.
+struct MidiFlood {
+    SpscRingBuffer<uint8_t, 64> buffer;
+    MidiParser parser;
+    int sent = 0;
+    int received = 0;
+    int clocks = 0;
+
+    void run(int milliseconds, int stallStart, int stallLength) {
+        uint32_t wireTime = 0;
+        uint32_t clockTime = 0;
+        uint8_t value = 0;
+        for (int ms = 0; ms < milliseconds; ++ms) {
+            // 3.125 bytes per ms: 24 ppqn clock at 300 bpm (120 ticks/s), rest of the bandwidth filled with CCs
+            while (wireTime < uint32_t(ms + 1) * 3125) {
+                if (clockTime <= wireTime) {
+                    buffer.write(MidiMessage::Tick);
+                    clockTime += 3125 * 1000 / 120;
+                    wireTime += 1000;
+                } else {
+                    buffer.write(0xb0);
+                    buffer.write(1);
+                    buffer.write(value++ & 0x7f);
+                    wireTime += 3000;
+                }
+                ++sent;
+            }
+            if (ms < stallStart || ms >= stallStart + stallLength) {
+                while (!buffer.empty()) {
+                    if (parser.feed(buffer.read())) {
+                        clocks += parser.message().isTick();
+                        ++received;
+                    }
+                }
+            }
+        }
+    }
+};
+
+UNIT_TEST("SpscRingBuffer") {
+
+    CASE("write/read") {
+        SpscRingBuffer<int, 8> buffer;
+
+        expectEqual(buffer.size(), size_t(8));
+        expectTrue(buffer.empty(), "buffer should be empty");
+        expectEqual(buffer.writable(), size_t(8));
+
+        for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < 8; ++i) {
+                expectTrue(buffer.write(round * 8 + i), "write should succeed");
+            }
+            expectTrue(buffer.full(), "buffer should be full");
+            expectEqual(buffer.readable(), size_t(8));
+            for (int i = 0; i < 8; ++i) {
+                expectEqual(buffer.read(), round * 8 + i);
+            }
+            expectTrue(buffer.empty(), "buffer should be empty");
+        }
+
+        expectEqual(int(buffer.overflow()), 0, "overflow");
+        expectEqual(int(buffer.highWater()), 8, "high water");
+    }
+
+    CASE("overflow drops new entries") {
+        SpscRingBuffer<int, 4> buffer;
+
+        for (int i = 0; i < 6; ++i) {
+            buffer.write(i);
+        }
+        expectEqual(int(buffer.overflow()), 2, "overflow");
+        expectEqual(int(buffer.highWater()), 4, "high water");
+        for (int i = 0; i < 4; ++i) {
+            expectEqual(buffer.read(), i);
+        }
+        expectTrue(buffer.empty(), "buffer should be empty");
+    }
+
+    CASE("concurrent producer and consumer") {
+        static SpscRingBuffer<uint32_t, 16> buffer;
+        const uint32_t count = 100000;
+
+        std::thread producer([&] () {
+            for (uint32_t i = 0; i < count; ++i) {
+                while (!buffer.write(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint32_t errors = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            while (buffer.empty()) {
+                std::this_thread::yield();
+            }
+            errors += buffer.read() != i;
+        }
+        producer.join();
+
+        expectEqual(int(errors), 0, "entries should be received in order");
+        expectTrue(buffer.empty(), "buffer should be empty");
+        expectTrue(buffer.highWater() <= 16, "high water should not exceed size");
+    }
+
+    CASE("midi clock and cc flood") {
+        MidiFlood flood;
+        flood.run(1000, 0, 0);
+        UNIT_TEST_PRINTF("no stall: sent=%d received=%d high water=%d overflow=%d\n",
+            flood.sent, flood.received, int(flood.buffer.highWater()), int(flood.buffer.overflow()));
+        expectEqual(flood.received, flood.sent, "all messages should be received");
+        expectEqual(flood.clocks, 120, "all clocks should be received");
+        expectEqual(int(flood.buffer.overflow()), 0, "overflow");
+
+        // consumer stalls for 50 ms, bytes exceeding the buffer are dropped
+        MidiFlood stalled;
+        stalled.run(1000, 500, 50);
+        UNIT_TEST_PRINTF("50 ms stall: sent=%d received=%d high water=%d overflow=%d\n",
+            stalled.sent, stalled.received, int(stalled.buffer.highWater()), int(stalled.buffer.overflow()));
+        expectEqual(int(stalled.buffer.highWater()), 64, "high water");
+        expectTrue(stalled.buffer.overflow() > 0, "bytes should be dropped");
+        expectTrue(stalled.received < stalled.sent, "messages should be lost");
+    }
+
+}
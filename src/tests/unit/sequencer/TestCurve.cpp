@@ -25,7 +25,7 @@ UNIT_TEST("Curve") {
         auto drawCurve = [] (int index, const char *filename) {
             uint8_t data[Width * Height];
             FrameBuffer8bit framebuffer(Width, Height, data);
-            Canvas canvas(framebuffer, brightness);
+            Canvas8bit canvas(framebuffer, brightness);
 
             canvas.setBlendMode(BlendMode::Set);
             canvas.setColor(Color::None);
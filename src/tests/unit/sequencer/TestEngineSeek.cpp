@@ -0,0 +1,271 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/SequencerApp.h"
+#include "apps/sequencer/model/ProjectVersion.h"
+
+#include "core/io/VersionedSerializedReader.h"
+#include "core/io/VersionedSerializedWriter.h"
+
+#include "sim/Simulator.h"
+
+#include <memory>
+#include <vector>
+
+using Data = std::vector<uint8_t>;
+
+// Note tracks in aligned and free mode with random steps, a linked track, an indexed, a tuesday and a discrete map track.
+static void setupProject(Project &project) {
+    for (int trackIndex = 0; trackIndex < 5; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::Note);
+        for (int patternIndex = 0; patternIndex < 3; ++patternIndex) {
+            auto &sequence = project.track(trackIndex).noteTrack().sequence(patternIndex);
+            sequence.setDivisor(3 + trackIndex * 3 + patternIndex);
+            for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+                auto &step = sequence.step(stepIndex);
+                step.setGate((stepIndex + trackIndex + patternIndex) % 3 != 0);
+                step.setGateProbability(stepIndex % 4 == 1 ? 3 : NoteSequence::GateProbability::Max);
+                step.setNote((stepIndex * 5 + trackIndex * 3 + patternIndex) % 24);
+                step.setNoteVariationRange(3);
+                step.setNoteVariationProbability(stepIndex % 5 == 0 ? 4 : 0);
+                step.setRetrigger(stepIndex % 7 == 3 ? 2 : 0);
+                step.setRetriggerProbability(5);
+                step.setLength(stepIndex % NoteSequence::Length::Range);
+                step.setAccumulatorTrigger(stepIndex % 2 == 0);
+            }
+        }
+    }
+
+    auto &accumulated = project.track(0).noteTrack().sequence(0);
+    accumulated.accumulator().setEnabled(true);
+    accumulated.accumulator().setMaxValue(7);
+    accumulated.accumulator().setStepValue(1);
+    accumulated.setRunMode(Types::RunMode::Random);
+    project.track(1).noteTrack().sequence(0).setResetMeasure(3);
+    project.track(2).noteTrack().setPlayMode(Types::PlayMode::Free);
+    project.track(4).setLinkTrack(1);
+
+    project.setTrackMode(5, Track::TrackMode::Indexed);
+    auto &indexedSequence = project.track(5).indexedTrack().sequence(0);
+    indexedSequence.setActiveLength(5);
+    for (int stepIndex = 0; stepIndex < 5; ++stepIndex) {
+        indexedSequence.step(stepIndex).setDuration(17 + stepIndex * 29);
+        indexedSequence.step(stepIndex).setGateLength(20 + stepIndex * 15);
+        indexedSequence.step(stepIndex).setNoteIndex(stepIndex * 2);
+    }
+
+    project.setTrackMode(6, Track::TrackMode::Tuesday);
+    auto &tuesdaySequence = project.track(6).tuesdayTrack().sequence(0);
+    tuesdaySequence.setLoopLength(8);
+    tuesdaySequence.setPower(12);
+    tuesdaySequence.setGlide(0);
+    tuesdaySequence.setTrill(0);
+    tuesdaySequence.setStepTrill(0);
+
+    project.setTrackMode(7, Track::TrackMode::DiscreteMap);
+    project.track(7).discreteMapTrack().sequence(0).setClockSource(DiscreteMapSequence::ClockSource::Internal);
+}
+
+// A song through the first three patterns.
+static void setupSong(Project &project) {
+    auto &song = project.song();
+    song.clear();
+    song.chainPattern(0);
+    song.chainPattern(1);
+    song.chainPattern(1);
+    song.chainPattern(2);
+    song.chainPattern(0);
+}
+
+static void writeTrackEngines(Engine &engine, VersionedSerializedWriter &writer) {
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        auto &trackEngine = engine.trackEngine(trackIndex);
+        switch (trackEngine.trackMode()) {
+        case Track::TrackMode::Note:
+            trackEngine.as<NoteTrackEngine>().writeState(writer);
+            break;
+        case Track::TrackMode::Curve:
+            trackEngine.as<CurveTrackEngine>().writeState(writer);
+            break;
+        case Track::TrackMode::MidiCv:
+            trackEngine.as<MidiCvTrackEngine>().writeState(writer);
+            break;
+        case Track::TrackMode::Tuesday:
+            trackEngine.as<TuesdayTrackEngine>().writeState(writer);
+            break;
+        case Track::TrackMode::DiscreteMap:
+            trackEngine.as<DiscreteMapTrackEngine>().writeState(writer);
+            break;
+        case Track::TrackMode::Indexed:
+            trackEngine.as<IndexedTrackEngine>().writeState(writer);
+            break;
+        case Track::TrackMode::Last:
+            break;
+        }
+    }
+}
+
+// State of the sequencer that has to be the same after playing and after seeking to the same tick:
+// the project (which holds the accumulators), the track engines and the shared random generators.
+static Data sequencerState(SequencerApp &app) {
+    Data data;
+    VersionedSerializedWriter writer(
+        [&data] (const void *buf, size_t len) {
+            auto bytes = static_cast<const uint8_t *>(buf);
+            data.insert(data.end(), bytes, bytes + len);
+        },
+        ProjectVersion::Latest
+    );
+    app.model.project().write(writer);
+    writeTrackEngines(app.engine, writer);
+    NoteTrackEngine::writeSharedState(writer);
+    CurveTrackEngine::writeSharedState(writer);
+    ArpeggiatorEngine::writeSharedState(writer);
+    Accumulator::writeSharedState(writer);
+    writer.writeHash();
+    return data;
+}
+
+static Data engineSnapshot(SequencerApp &app) {
+    Data data;
+    VersionedSerializedWriter writer(
+        [&data] (const void *buf, size_t len) {
+            auto bytes = static_cast<const uint8_t *>(buf);
+            data.insert(data.end(), bytes, bytes + len);
+        },
+        ProjectVersion::Latest
+    );
+    app.engine.writeState(writer);
+    return data;
+}
+
+static bool restoreEngineSnapshot(SequencerApp &app, const Data &data) {
+    VersionedSerializedReader reader(data.data(), data.size(), ProjectVersion::Latest);
+    return app.engine.readState(reader);
+}
+
+// Runs the simulator until the engine has processed the tick before the given one.
+static void playUntil(sim::Simulator &simulator, SequencerApp &app, uint32_t tick) {
+    while (app.engine.tick() + 1 < tick) {
+        simulator.wait(1);
+    }
+}
+
+struct SeekFixture {
+    std::unique_ptr<SequencerApp> app;
+    sim::Simulator simulator;
+    Data initialState;
+
+    SeekFixture(bool song) :
+        simulator({
+            .create = [this, song] () {
+                app.reset(new SequencerApp());
+                setupProject(app->model.project());
+                if (song) {
+                    setupSong(app->model.project());
+                }
+            },
+            .destroy = [this] () { app.reset(); },
+            .update = [this] () { app->update(); }
+        })
+    {
+        // wait for the startup page to close
+        simulator.wait(2500);
+        initialState = engineSnapshot(*app);
+    }
+
+    // restores the engine to the state before playing
+    bool rewind() {
+        sim::Simulator::Scope scope(simulator);
+        return restoreEngineSnapshot(*app, initialState);
+    }
+
+    void seek(uint32_t tick) {
+        sim::Simulator::Scope scope(simulator);
+        app->engine.seek(tick);
+    }
+};
+
+UNIT_TEST("EngineSeek") {
+
+CASE("seek matches playback") {
+    SeekFixture fixture(false);
+    auto &app = *fixture.app;
+
+    const uint32_t tick = 3333;
+    app.engine.clockStart();
+    playUntil(fixture.simulator, app, tick);
+    expectEqual(app.engine.tick(), tick - 1, "played up to tick");
+    app.engine.clockStop();
+    auto played = sequencerState(app);
+
+    expectTrue(fixture.rewind(), "rewound");
+    expectTrue(sequencerState(app) != played, "rewound state differs");
+
+    fixture.seek(tick);
+
+    expectEqual(app.engine.tick(), tick - 1, "seeked to tick");
+    expectEqual(app.engine.clock().tick(), tick, "clock continues at tick");
+    expectFalse(app.engine.clockRunning(), "clock still stopped");
+    expectTrue(sequencerState(app) == played, "seeked state matches played state");
+}
+
+CASE("playback continues after seek") {
+    SeekFixture fixture(false);
+    auto &app = *fixture.app;
+
+    const uint32_t seekTick = 1000;
+    const uint32_t tick = 1999;
+    app.engine.clockStart();
+    playUntil(fixture.simulator, app, tick);
+    app.engine.clockStop();
+    auto played = sequencerState(app);
+
+    expectTrue(fixture.rewind(), "rewound");
+    fixture.seek(seekTick);
+    app.engine.clockContinue();
+    fixture.simulator.wait(1);
+    expectTrue(app.engine.clockRunning(), "clock running");
+    playUntil(fixture.simulator, app, tick);
+    expectEqual(app.engine.tick(), tick - 1, "played up to tick");
+    app.engine.clockStop();
+
+    expectTrue(sequencerState(app) == played, "state matches uninterrupted playback");
+}
+
+CASE("seek in song mode") {
+    SeekFixture fixture(true);
+    auto &app = *fixture.app;
+    auto &songState = app.model.project().playState().songState();
+    uint32_t measure = app.engine.measureDivisor();
+
+    // third slot, second measure
+    const uint32_t tick = 3 * measure + measure / 2 + 7;
+    app.model.project().playState().playSong(0);
+    playUntil(fixture.simulator, app, tick);
+    app.engine.clockStop();
+    expectEqual(songState.currentSlot(), 2, "song slot");
+    expectEqual(songState.currentRepeat(), 0, "song repeat");
+    auto played = sequencerState(app);
+
+    expectTrue(fixture.rewind(), "rewound");
+    {
+        sim::Simulator::Scope scope(fixture.simulator);
+        app.engine.seekSongSlot(0);
+    }
+    fixture.seek(tick);
+    expectTrue(songState.playing(), "song playing");
+    expectEqual(songState.currentSlot(), 2, "song slot");
+    expectEqual(songState.currentRepeat(), 0, "song repeat");
+    expectTrue(sequencerState(app) == played, "seeked state matches played state");
+
+    // the start of a slot is the tick after all repeats of the previous slots
+    {
+        sim::Simulator::Scope scope(fixture.simulator);
+        app.engine.seekSongSlot(2);
+    }
+    expectEqual(app.engine.clock().tick(), 3 * measure, "slot start tick");
+    expectEqual(songState.currentSlot(), 1, "song slot before the slot start");
+    expectEqual(songState.currentRepeat(), 1, "song repeat before the slot start");
+}
+
+} // UNIT_TEST("EngineSeek")
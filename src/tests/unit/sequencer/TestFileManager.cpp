@@ -0,0 +1,358 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/model/FileManager.h"
+#include "apps/sequencer/model/ProjectVersion.h"
+
+#include "core/fs/File.h"
+#include "core/io/CompressedReader.h"
+#include "core/io/SerializedHash.h"
+
+#include "drivers/SdCard.h"
+
+#include "sim/Simulator.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdio>
+#include <cstring>
+
+// Access to the private state of the file manager.
+struct FileManagerTest {
+    static FileManager::TaskId &nextTaskId() { return FileManager::_nextTaskId; }
+
+    static bool indexValid(FileType type) {
+        return FileManager::_indexState[int(type)] == FileManager::IndexState::Valid;
+    }
+
+    static void setIndexInvalid(FileType type) {
+        FileManager::_indexState[int(type)] = FileManager::IndexState::Invalid;
+    }
+
+    // runs the file task until the slot indices are up to date
+    static void updateIndices() {
+        auto done = [] (FileType type) {
+            auto state = FileManager::_indexState[int(type)];
+            return state == FileManager::IndexState::Valid || state == FileManager::IndexState::Invalid;
+        };
+        for (int i = 0; i < 100 && !(done(FileType::Project) && done(FileType::UserScale)); ++i) {
+            FileManager::processTask();
+        }
+    }
+
+    // requests the slot information and runs the file task until it is cached
+    static bool slotInfo(FileType type, int slot, FileManager::SlotInfo &info) {
+        for (int i = 0; i < 10; ++i) {
+            if (FileManager::slotInfo(type, slot, info)) {
+                return true;
+            }
+            FileManager::processTask();
+        }
+        return false;
+    }
+
+    static bool slotUsed(FileType type, int slot) {
+        FileManager::SlotInfo info;
+        return slotInfo(type, slot, info) && info.used;
+    }
+};
+
+// A formatted in-memory volume. The simulator provides the os ticks used by the file manager.
+struct FileManagerFixture {
+    sim::Simulator simulator;
+    SdCard sdCard;
+    fs::Volume volume;
+
+    FileManagerFixture() :
+        simulator(sim::Target()),
+        volume(sdCard)
+    {
+        FileManager::init();
+        FileManager::format();
+        // mounts the volume
+        FileManager::processTask();
+    }
+};
+
+// Queues a task that records its execution and result under the given name.
+static FileManager::TaskId queueTask(std::vector<char> &executed, std::vector<char> &results, char name,
+                                     FileManager::TaskPriority priority = FileManager::TaskPriority::Normal) {
+    return FileManager::task(
+        [&executed, name] () { executed.push_back(name); return fs::OK; },
+        [&results, name] (fs::Error result) { results.push_back(result == fs::OK ? name : '-'); },
+        priority
+    );
+}
+
+static const char *IndexPath = "SCALES/INDEX";
+
+// slot files are numbered from 1
+static std::string slotPath(int slot) {
+    char path[32];
+    std::snprintf(path, sizeof(path), "SCALES/%03d.SCA", slot + 1);
+    return path;
+}
+
+static fs::Error writeUserScale(int slot, const char *name) {
+    UserScale userScale;
+    userScale.setName(name);
+    return FileManager::writeUserScale(userScale, slot);
+}
+
+static size_t fileSize(const std::string &path) {
+    fs::File file(path.c_str(), fs::File::Read);
+    return file.error() == fs::OK ? file.size() : 0;
+}
+
+static bool readIndexEntry(int slot, SlotIndexEntry &entry, const char *indexPath = IndexPath) {
+    fs::File file(indexPath, fs::File::Read);
+    SlotIndexHeader header;
+    size_t lenRead;
+    if (file.read(&header, sizeof(header), &lenRead) != fs::OK || lenRead != sizeof(header) || !header.valid()) {
+        return false;
+    }
+    return file.seek(sizeof(header) + slot * sizeof(entry)) == fs::OK &&
+        file.read(&entry, sizeof(entry), &lenRead) == fs::OK && lenRead == sizeof(entry);
+}
+
+static void processTasks() {
+    for (int i = 0; i < FileManager::TaskQueueSize && FileManager::taskBusy(); ++i) {
+        FileManager::processTask();
+    }
+}
+
+UNIT_TEST("FileManager") {
+
+CASE("tasks run by priority, in submission order within a priority") {
+    FileManagerFixture fixture;
+    std::vector<char> executed, results;
+
+    queueTask(executed, results, 'a', FileManager::TaskPriority::Normal);
+    queueTask(executed, results, 'b', FileManager::TaskPriority::Background);
+    queueTask(executed, results, 'c', FileManager::TaskPriority::Interactive);
+    queueTask(executed, results, 'd', FileManager::TaskPriority::Normal);
+    expectTrue(FileManager::taskBusy(), "busy");
+    expectTrue(executed.empty(), "tasks only run in the file task");
+
+    processTasks();
+    expectFalse(FileManager::taskBusy(), "idle");
+    expectTrue(executed == std::vector<char>({ 'c', 'a', 'd', 'b' }), "execution order");
+    expectTrue(results == executed, "results");
+}
+
+CASE("task ids wrap around") {
+    FileManagerFixture fixture;
+    std::vector<char> executed, results;
+
+    FileManagerTest::nextTaskId() = 0xfffffffe;
+    expectEqual(queueTask(executed, results, 'a'), 0xfffffffeu, "id");
+    expectEqual(queueTask(executed, results, 'b'), 0xffffffffu, "id");
+    expectEqual(queueTask(executed, results, 'c'), 1u, "id skips 0");
+
+    processTasks();
+    expectTrue(executed == std::vector<char>({ 'a', 'b', 'c' }), "submission order across the wrap around");
+}
+
+CASE("full queue cancels the task") {
+    FileManagerFixture fixture;
+    std::vector<char> executed, results;
+
+    for (int i = 0; i < FileManager::TaskQueueSize; ++i) {
+        expectTrue(queueTask(executed, results, 'a' + i) != 0, "queued");
+    }
+    expectEqual(queueTask(executed, results, 'x'), 0u, "not queued");
+    expectTrue(results == std::vector<char>({ '-' }), "cancelled right away");
+
+    processTasks();
+    expectTrue(executed == std::vector<char>({ 'a', 'b', 'c', 'd' }), "queued tasks executed");
+}
+
+CASE("missing index is rebuilt") {
+    FileManagerFixture fixture;
+    SlotIndexEntry entry;
+
+    expectEqual(writeUserScale(3, "SCALE3"), fs::OK, "written");
+    FileManagerTest::updateIndices();
+    expectTrue(FileManagerTest::indexValid(FileType::UserScale), "index valid");
+    expectTrue(readIndexEntry(3, entry), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Used), "slot used");
+    expectEqual(std::strncmp(entry.name, "SCALE3", sizeof(entry.name)), 0, "slot name");
+    expectEqual(size_t(entry.size), fileSize(slotPath(3)), "slot size");
+    fs::FileInfo info;
+    expectEqual(fs::stat(slotPath(3).c_str(), info), fs::OK, "slot file");
+    expectTrue(entry.date == info.date() && entry.time == info.time(), "slot modification time");
+    expectTrue(readIndexEntry(4, entry), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Empty), "slot empty");
+
+    // restart without an index
+    expectEqual(fs::remove(IndexPath), fs::OK, "index removed");
+    FileManager::init();
+    FileManagerTest::updateIndices();
+    expectTrue(FileManagerTest::indexValid(FileType::UserScale), "index valid");
+    expectTrue(readIndexEntry(3, entry), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Used), "slot used");
+    expectTrue(FileManagerTest::slotUsed(FileType::UserScale, 3), "slot used");
+    expectFalse(FileManagerTest::slotUsed(FileType::UserScale, 4), "slot empty");
+}
+
+CASE("written slots update a valid index") {
+    FileManagerFixture fixture;
+    SlotIndexEntry entry;
+
+    FileManagerTest::updateIndices();
+    expectTrue(FileManagerTest::indexValid(FileType::UserScale), "index valid");
+    expectTrue(readIndexEntry(7, entry), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Empty), "slot empty");
+
+    expectEqual(writeUserScale(7, "SCALE7"), fs::OK, "written");
+    expectTrue(FileManagerTest::indexValid(FileType::UserScale), "index still valid");
+    expectTrue(readIndexEntry(7, entry), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Used), "slot used");
+    expectEqual(size_t(entry.size), fileSize(slotPath(7)), "slot size");
+
+    FileManager::SlotInfo info;
+    FileManagerTest::slotInfo(FileType::UserScale, 7, info);
+    expectTrue(info.used, "slot used");
+    expectEqual(std::strcmp(info.name, "SCALE7"), 0, "slot name");
+}
+
+CASE("index with a stale slot size is rebuilt") {
+    FileManagerFixture fixture;
+    SlotIndexEntry entry;
+
+    expectEqual(writeUserScale(3, "SCALE3"), fs::OK, "written");
+    FileManagerTest::updateIndices();
+    size_t size = fileSize(slotPath(3));
+
+    // change the slot file without the file manager
+    {
+        fs::File file(slotPath(3).c_str(), fs::File::Append);
+        uint32_t padding = 0;
+        expectEqual(file.writeAll(&padding, sizeof(padding)), fs::OK, "appended");
+    }
+    expectEqual(fileSize(slotPath(3)), size + 4, "file size");
+    expectTrue(readIndexEntry(3, entry), "index entry");
+    expectEqual(size_t(entry.size), size, "index is stale");
+
+    FileManager::init();
+    FileManagerTest::updateIndices();
+    expectTrue(FileManagerTest::indexValid(FileType::UserScale), "index valid");
+    expectTrue(readIndexEntry(3, entry), "index entry");
+    expectEqual(size_t(entry.size), size + 4, "index updated");
+}
+
+CASE("index entry of a compressed project") {
+    FileManagerFixture fixture;
+    SlotIndexEntry entry;
+
+    std::unique_ptr<Project> project(new Project());
+    project->setName("PROJECT2");
+    expectEqual(FileManager::writeProject(*project, 2), fs::OK, "written");
+    FileManager::init();
+    FileManagerTest::updateIndices();
+    expectTrue(FileManagerTest::indexValid(FileType::Project), "index valid");
+
+    // decompress the whole file to get the hash at its end
+    std::vector<uint8_t> data;
+    {
+        fs::File file("PROJECTS/003.PRO", fs::File::Read);
+        FileHeader header;
+        file.read(&header, sizeof(header));
+        expectEqual(int(header.version), int(FileFormat::Compressed), "compressed");
+        static CompressedStream::Workspace workspace;
+        CompressedReader reader([&file] (void *data, size_t len) { file.read(data, len); }, workspace);
+        uint8_t buffer[64];
+        while (!reader.end() && !reader.error()) {
+            size_t len = reader.read(buffer, sizeof(buffer));
+            data.insert(data.end(), buffer, buffer + len);
+        }
+    }
+    expectTrue(data.size() > 2 * CompressedStream::BlockSize, "more than two blocks");
+    uint32_t hash;
+    std::memcpy(&hash, &data[data.size() - sizeof(hash)], sizeof(hash));
+
+    expectTrue(readIndexEntry(2, entry, "PROJECTS/INDEX"), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Used), "slot used");
+    expectEqual(std::strncmp(entry.name, "PROJECT2", sizeof(entry.name)), 0, "slot name");
+    expectEqual(entry.version, uint32_t(ProjectVersion::Latest), "version");
+    expectEqual(entry.hash, hash, "hash");
+}
+
+CASE("slots added and removed outside the file manager") {
+    FileManagerFixture fixture;
+    SlotIndexEntry entry;
+
+    expectEqual(writeUserScale(3, "SCALE3"), fs::OK, "written");
+    FileManagerTest::updateIndices();
+
+    // add a slot by path (which bypasses the index)
+    UserScale userScale;
+    userScale.setName("SCALE5");
+    expectEqual(FileManager::writeUserScale(userScale, slotPath(5).c_str()), fs::OK, "written");
+    expectTrue(readIndexEntry(5, entry), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Empty), "index is stale");
+
+    FileManager::init();
+    FileManagerTest::updateIndices();
+    expectTrue(readIndexEntry(5, entry), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Used), "added slot used");
+    expectTrue(FileManagerTest::slotUsed(FileType::UserScale, 5), "added slot used");
+
+    // while the index is valid, slot information is read from the index
+    expectEqual(fs::remove(slotPath(3).c_str()), fs::OK, "removed");
+    expectTrue(FileManagerTest::slotUsed(FileType::UserScale, 3), "removed slot still in index");
+
+    FileManager::init();
+    FileManagerTest::updateIndices();
+    expectTrue(FileManagerTest::indexValid(FileType::UserScale), "index valid");
+    expectTrue(readIndexEntry(3, entry), "index entry");
+    expectEqual(int(entry.state), int(SlotIndexEntry::Empty), "removed slot empty");
+    expectFalse(FileManagerTest::slotUsed(FileType::UserScale, 3), "removed slot empty");
+    expectTrue(FileManagerTest::slotUsed(FileType::UserScale, 5), "added slot used");
+}
+
+CASE("slot information is served from the cache filled by the file task") {
+    FileManagerFixture fixture;
+    FileManager::SlotInfo info;
+
+    expectEqual(writeUserScale(3, "SCALE3"), fs::OK, "written");
+    expectFalse(FileManager::slotInfo(FileType::UserScale, 3, info), "not cached");
+    expectFalse(info.used, "unknown slot");
+    expectTrue(FileManager::slotUsed(FileType::UserScale, 3), "unknown slot counts as used");
+
+    FileManager::processTask();
+    expectTrue(FileManager::slotInfo(FileType::UserScale, 3, info), "cached");
+    expectTrue(info.used, "slot used");
+    expectEqual(std::strcmp(info.name, "SCALE3"), 0, "slot name");
+}
+
+CASE("slot information falls back to slot files without a valid index") {
+    FileManagerFixture fixture;
+    FileManager::SlotInfo info;
+
+    expectEqual(writeUserScale(3, "SCALE3"), fs::OK, "written");
+
+    // unchecked index
+    FileManagerTest::slotInfo(FileType::UserScale, 3, info);
+    expectTrue(info.used, "slot used");
+    expectEqual(std::strcmp(info.name, "SCALE3"), 0, "slot name");
+
+    // index that could not be written, with bogus contents
+    FileManagerTest::updateIndices();
+    {
+        fs::File file(IndexPath, fs::File::Write);
+        uint8_t garbage[64];
+        std::memset(garbage, 0xaa, sizeof(garbage));
+        expectEqual(file.writeAll(garbage, sizeof(garbage)), fs::OK, "index overwritten");
+    }
+    FileManager::init();
+    FileManagerTest::setIndexInvalid(FileType::UserScale);
+    FileManagerTest::slotInfo(FileType::UserScale, 3, info);
+    expectTrue(info.used, "slot used");
+    expectEqual(std::strcmp(info.name, "SCALE3"), 0, "slot name");
+    FileManagerTest::slotInfo(FileType::UserScale, 4, info);
+    expectFalse(info.used, "slot empty");
+}
+
+} // UNIT_TEST("FileManager")
@@ -0,0 +1,63 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/ui/FramePacer.h"
+
+UNIT_TEST("FramePacer") {
+
+CASE("full rate while engine is idle") {
+    FramePacer pacer;
+    for (uint32_t ticks = 0; ticks < 2000; ++ticks) {
+        pacer.update(100, 1, ticks);
+        expectTrue(pacer.updateLeds(false), "leds should be updated");
+    }
+    expectEqual(pacer.level(), 0, "level");
+    expectEqual(pacer.fps(50), 50, "fps");
+    pacer.frameDrawn();
+    expectEqual(int(pacer.stats().skippedFrames), 0, "skipped frames");
+    expectEqual(int(pacer.stats().deferredLedUpdates), 0, "deferred led updates");
+}
+
+CASE("reduces rate under load and restores it") {
+    FramePacer pacer;
+    uint32_t ticks = 0;
+
+    // slow engine updates
+    for (int i = 0; i < 1000; ++i, ++ticks) {
+        pacer.update(800, 1, ticks);
+    }
+    expectEqual(pacer.level(), FramePacer::MaxLevel, "level");
+    expectEqual(pacer.fps(50), 12, "fps");
+    expectFalse(pacer.updateLeds(false), "leds should be deferred");
+    expectTrue(pacer.updateLeds(true), "leds should be updated with frames");
+    pacer.frameDrawn();
+    expectEqual(int(pacer.stats().skippedFrames), 3, "skipped frames");
+    expectEqual(int(pacer.stats().deferredLedUpdates), 1, "deferred led updates");
+
+    // never below minimum rate
+    expectEqual(pacer.fps(25), 10, "fps");
+
+    // medium load keeps the current rate
+    for (int i = 0; i < 2000; ++i, ++ticks) {
+        pacer.update(300, 1, ticks);
+    }
+    expectEqual(pacer.level(), FramePacer::MaxLevel, "level");
+
+    // low load restores one step at a time
+    for (int i = 0; i < 1000; ++i, ++ticks) {
+        pacer.update(100, 1, ticks);
+    }
+    expectEqual(pacer.level(), FramePacer::MaxLevel - 1, "level");
+    for (int i = 0; i < 1000; ++i, ++ticks) {
+        pacer.update(100, 1, ticks);
+    }
+    expectEqual(pacer.level(), 0, "level");
+    expectEqual(pacer.fps(50), 50, "fps");
+}
+
+CASE("clock tick backlog counts as load") {
+    FramePacer pacer;
+    pacer.update(100, 3, 1000);
+    expectEqual(pacer.level(), 1, "level");
+}
+
+} // UNIT_TEST("FramePacer")
@@ -0,0 +1,269 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/ui/controllers/launchpad/LaunchpadDevice.h"
+#include "apps/sequencer/ui/controllers/launchpad/LaunchpadMk2Device.h"
+#include "apps/sequencer/ui/controllers/launchpad/LaunchpadMk3Device.h"
+#include "apps/sequencer/ui/controllers/launchpad/LaunchpadProDevice.h"
+
+#include <vector>
+
+namespace {
+
+static uint8_t payloadPool[4 * 64];
+
+// Records all messages sent by a device. Messages are kept (holding their payload) until drained,
+// just like the midi output queue does.
+struct MidiRecorder {
+    std::vector<MidiMessage> messages;
+    size_t limit = 1024;
+
+    MidiRecorder(LaunchpadDevice &device) {
+        MidiMessage::setPayloadPool(payloadPool, sizeof(payloadPool));
+        device.setSendMidiHandler([this] (uint8_t cable, const MidiMessage &message) {
+            if (messages.size() >= limit) {
+                return false;
+            }
+            messages.emplace_back(message);
+            return true;
+        });
+    }
+
+    ~MidiRecorder() {
+        messages.clear();
+        MidiMessage::setPayloadPool(nullptr, 0);
+    }
+
+    int drain() {
+        int count = messages.size();
+        messages.clear();
+        return count;
+    }
+
+    int bytes() const {
+        int count = 0;
+        for (const auto &message : messages) {
+            count += message.isSystemExclusive() ? message.payloadLength() + 2 : 3;
+        }
+        return count;
+    }
+};
+
+static void setAllLeds(LaunchpadDevice &device, int red, int green) {
+    for (int row = 0; row < LaunchpadDevice::Rows + LaunchpadDevice::ExtraRows; ++row) {
+        for (int col = 0; col < LaunchpadDevice::Cols; ++col) {
+            device.setLed(row, col, red, green);
+        }
+    }
+}
+
+// Draws a gate pattern with a playhead (like the note sequence gate layer).
+static void drawGates(LaunchpadDevice &device, int currentStep) {
+    device.clearLeds();
+    device.setPriorityCol(currentStep % 8);
+    for (int step = 0; step < 64; ++step) {
+        device.setLed(step / 8, step % 8, step == currentStep, step % 3 == 0);
+    }
+}
+
+struct FrameStats {
+    float messages = 0.f;
+    float bytes = 0.f;
+};
+
+// Returns the average number of messages and bytes per frame to redraw the full grid and to move the playhead.
+static void measure(LaunchpadDevice &device, FrameStats &full, FrameStats &playhead) {
+    MidiRecorder recorder(device);
+
+    const int frames = 16;
+    for (int frame = 0; frame < frames; ++frame) {
+        setAllLeds(device, frame % 2 + 1, frame % 2);
+        device.syncLeds();
+        full.bytes += recorder.bytes();
+        full.messages += recorder.drain();
+    }
+    for (int frame = 0; frame < frames; ++frame) {
+        drawGates(device, frame);
+        device.syncLeds();
+        playhead.bytes += recorder.bytes();
+        playhead.messages += recorder.drain();
+    }
+    full.messages /= frames;
+    full.bytes /= frames;
+    playhead.messages /= frames;
+    playhead.bytes /= frames;
+}
+
+} // namespace
+
+UNIT_TEST("LaunchpadDevice") {
+
+CASE("devices without batch support send single messages") {
+    LaunchpadDevice device;
+    MidiRecorder recorder(device);
+
+    setAllLeds(device, 1, 0);
+    device.syncLeds();
+    expectEqual(int(recorder.messages.size()), 64, "leds within budget should be sent");
+    for (const auto &message : recorder.messages) {
+        expectFalse(message.isSystemExclusive(), "message should not be a batch");
+    }
+    recorder.drain();
+
+    device.syncLeds();
+    expectEqual(recorder.drain(), 16, "remaining leds should be sent");
+
+    device.syncLeds();
+    expectEqual(recorder.drain(), 0, "unchanged leds should not be sent");
+}
+
+CASE("batched updates") {
+    LaunchpadMk2Device device;
+    MidiRecorder recorder(device);
+
+    setAllLeds(device, 0, 1);
+    device.syncLeds();
+
+    int leds = 0;
+    for (const auto &message : recorder.messages) {
+        expectTrue(message.isSystemExclusive(), "message should be a batch");
+        expectTrue(message.payloadLength() <= 46, "batch should fit a usb packet");
+        const uint8_t *data = message.payloadData();
+        expectEqual(int(data[4]), 0x18, "device id");
+        expectEqual(int(data[5]), 0x0a, "set leds command");
+        for (size_t i = 6; i < message.payloadLength(); i += 2) {
+            expectEqual(int(data[i + 1]), 23, "led color");
+            ++leds;
+        }
+    }
+    expectEqual(leds, 80, "all leds should be sent");
+    expectEqual(int(recorder.messages.size()), 4, "batch count");
+    recorder.drain();
+
+    // few changes are sent as single messages
+    device.setLed(0, 0, 1, 0);
+    device.setLed(LaunchpadDevice::FunctionRow, 7, 1, 0);
+    device.syncLeds();
+    expectEqual(int(recorder.messages.size()), 2, "single messages");
+    expectTrue(recorder.messages[0].isNoteOn(), "grid led");
+    expectEqual(int(recorder.messages[0].note()), 81, "grid led number");
+    expectTrue(recorder.messages[1].isControlChange(), "function led");
+    expectEqual(int(recorder.messages[1].controlNumber()), 111, "function led number");
+    recorder.drain();
+
+    device.syncLeds();
+    expectEqual(recorder.drain(), 0, "unchanged leds should not be sent");
+}
+
+CASE("budget carries over to next sync") {
+    LaunchpadDevice device;
+    MidiRecorder recorder(device);
+
+    setAllLeds(device, 1, 1);
+    device.syncLeds();
+    int bytes = recorder.bytes();
+    int leds = device.syncStats().leds;
+    expectTrue(bytes <= 192, "sync should stay within budget");
+    expectTrue(leds < 80, "not all leds fit the budget");
+    recorder.drain();
+
+    device.syncLeds();
+    expectEqual(int(device.syncStats().leds), 80, "remaining leds should be sent");
+    recorder.drain();
+
+    device.syncLeds();
+    expectEqual(recorder.drain(), 0, "unchanged leds should not be sent");
+}
+
+CASE("playhead column is sent first") {
+    LaunchpadMk3Device device;
+    MidiRecorder recorder(device);
+
+    setAllLeds(device, 1, 0);
+    device.setPriorityCol(5);
+    device.syncLeds();
+    expectTrue(recorder.messages.size() > 0, "leds should be sent");
+    const auto &message = recorder.messages[0];
+    expectTrue(message.isSystemExclusive(), "message should be a batch");
+    const uint8_t *data = message.payloadData();
+    for (int row = 0; row < 8; ++row) {
+        expectEqual(int(data[6 + row * 3 + 1]), 11 + 10 * (7 - row) + 5, "playhead led number");
+    }
+}
+
+CASE("leds are resent when payloads are exhausted") {
+    LaunchpadMk3Device device;
+    MidiRecorder recorder(device);
+
+    // messages are not drained, all payload slots are in use after 4 batches
+    setAllLeds(device, 2, 0);
+    device.syncLeds();
+    expectEqual(int(recorder.messages.size()), 4, "batch count");
+    expectEqual(int(device.syncStats().leds), 4 * 13, "sent leds");
+
+    device.syncLeds();
+    expectEqual(int(recorder.messages.size()), 4, "no batch without free payload");
+
+    recorder.drain();
+    device.syncLeds();
+    expectEqual(int(device.syncStats().leds), 80, "remaining leds should be sent");
+    recorder.drain();
+
+    // output queue is full
+    recorder.limit = 0;
+    setAllLeds(device, 0, 2);
+    device.syncLeds();
+    expectEqual(int(device.syncStats().leds), 80, "no leds should be sent");
+
+    recorder.limit = 1024;
+    device.syncLeds();
+    recorder.drain();
+    device.syncLeds();
+    recorder.drain();
+    expectEqual(int(device.syncStats().leds), 160, "all leds should be sent");
+}
+
+CASE("single messages when batches do not fit the payload slots") {
+    LaunchpadMk3Device device;
+    MidiRecorder recorder(device);
+    // 8 bytes per payload slot, less than the batch header and one entry
+    static uint8_t smallPayloadPool[32];
+    MidiMessage::setPayloadPool(smallPayloadPool, sizeof(smallPayloadPool));
+
+    setAllLeds(device, 1, 0);
+    device.syncLeds();
+    expectTrue(recorder.messages.size() > 0, "leds should be sent");
+    for (const auto &message : recorder.messages) {
+        expectFalse(message.isSystemExclusive(), "message should not be a batch");
+    }
+    recorder.drain();
+
+    device.syncLeds();
+    recorder.drain();
+    expectEqual(int(device.syncStats().leds), 80, "all leds should be sent");
+}
+
+CASE("messages per frame") {
+    LaunchpadDevice launchpad;
+    LaunchpadMk2Device launchpadMk2;
+    LaunchpadMk3Device launchpadMk3;
+    LaunchpadProDevice launchpadPro;
+    struct {
+        const char *name;
+        LaunchpadDevice &device;
+    } devices[] = {
+        { "Launchpad S", launchpad },
+        { "Launchpad Mk2", launchpadMk2 },
+        { "Launchpad Mk3", launchpadMk3 },
+        { "Launchpad Pro", launchpadPro },
+    };
+
+    for (auto &entry : devices) {
+        FrameStats full, playhead;
+        measure(entry.device, full, playhead);
+        UNIT_TEST_PRINTF("%-14s full: %5.1f messages %6.1f bytes, playhead: %4.1f messages %5.1f bytes\n",
+            entry.name, full.messages, full.bytes, playhead.messages, playhead.bytes);
+        expectTrue(full.bytes <= 192, "full update should stay within budget");
+    }
+}
+
+} // UNIT_TEST("LaunchpadDevice")
@@ -0,0 +1,139 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/MidiInputDispatch.h"
+#include "apps/sequencer/engine/MidiUtils.h"
+#include "apps/sequencer/model/Project.h"
+
+
+static void setupMidiRoute(Project &project, int routeIndex, Types::MidiPort port, int channel, Routing::MidiSource::Event event, int number) {
+    auto &route = project.routing().route(routeIndex);
+    route.setTarget(Routing::Target::Tempo);
+    route.setSource(Routing::Source::Midi);
+    auto &midiSource = route.midiSource();
+    midiSource.source().setPort(port);
+    midiSource.source().setChannel(channel);
+    midiSource.setEvent(event);
+    midiSource.setControlNumber(number);
+}
+
+UNIT_TEST("MidiInputDispatch") {
+
+CASE("routes") {
+    Project project;
+    MidiInputDispatch dispatch;
+
+    setupMidiRoute(project, 0, Types::MidiPort::Midi, 1, Routing::MidiSource::Event::ControlAbsolute, 7);
+    setupMidiRoute(project, 3, Types::MidiPort::Midi, -1, Routing::MidiSource::Event::ControlRelative, 7);
+    setupMidiRoute(project, 5, Types::MidiPort::UsbMidi, -1, Routing::MidiSource::Event::PitchBend, 0);
+    setupMidiRoute(project, 9, Types::MidiPort::Midi, 0, Routing::MidiSource::Event::NoteRange, 60);
+    project.routing().route(9).midiSource().setNoteRange(4);
+    expectTrue(dispatch.update(project), "initial build");
+
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeControlChange(1, 7, 0))), (1 << 0) | (1 << 3), "cc 7 on channel 2");
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeControlChange(2, 7, 0))), (1 << 3), "cc 7 on channel 3");
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeControlChange(1, 8, 0))), 0, "cc 8");
+    expectEqual(int(dispatch.routes(MidiPort::UsbMidi, MidiMessage::makeControlChange(1, 7, 0))), 0, "cc 7 on usb");
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeNoteOn(1, 7))), 0, "note 7 is not a controller");
+    expectEqual(int(dispatch.routes(MidiPort::UsbMidi, MidiMessage::makePitchBend(12, 100))), (1 << 5), "pitch bend");
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makePitchBend(12, 100))), 0, "pitch bend on midi");
+    expectEqual(int(dispatch.routes(MidiPort::CvGate, MidiMessage::makeNoteOn(0, 60))), 0, "cv/gate");
+
+    for (int note = 58; note < 66; ++note) {
+        bool inRange = note >= 60 && note < 64;
+        expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeNoteOn(0, note))), inRange ? (1 << 9) : 0, "note range");
+        expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeNoteOn(1, note))), 0, "note range on channel 2");
+    }
+}
+
+CASE("tracks") {
+    Project project;
+    MidiInputDispatch dispatch;
+
+    project.setTrackMode(2, Track::TrackMode::MidiCv);
+    project.track(2).midiCvTrack().source().setPort(Types::MidiPort::UsbMidi);
+    project.track(2).midiCvTrack().source().setChannel(3);
+    project.setTrackMode(6, Track::TrackMode::MidiCv);
+    project.track(6).midiCvTrack().source().setPort(Types::MidiPort::UsbMidi);
+    project.track(6).midiCvTrack().source().setChannel(-1);
+    dispatch.update(project);
+
+    expectEqual(int(dispatch.tracks(MidiPort::UsbMidi, MidiMessage::makeNoteOn(3, 60))), (1 << 2) | (1 << 6), "note on channel 4");
+    expectEqual(int(dispatch.tracks(MidiPort::UsbMidi, MidiMessage::makePitchBend(0, 0))), (1 << 6), "pitch bend on channel 1");
+    expectEqual(int(dispatch.tracks(MidiPort::UsbMidi, MidiMessage::makeControlChange(3, 1, 0))), 0, "control change");
+    expectEqual(int(dispatch.tracks(MidiPort::Midi, MidiMessage::makeNoteOn(3, 60))), 0, "midi port");
+}
+
+CASE("rebuild on configuration change") {
+    Project project;
+    MidiInputDispatch dispatch;
+
+    expectTrue(dispatch.update(project), "initial build");
+    expectFalse(dispatch.update(project), "unchanged");
+
+    setupMidiRoute(project, 1, Types::MidiPort::Midi, 0, Routing::MidiSource::Event::ControlAbsolute, 1);
+    expectTrue(dispatch.update(project), "route added");
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeControlChange(0, 1, 0))), (1 << 1), "route 1");
+
+    project.routing().route(1).midiSource().setControlNumber(2);
+    expectTrue(dispatch.update(project), "controller changed");
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeControlChange(0, 1, 0))), 0, "cc 1");
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeControlChange(0, 2, 0))), (1 << 1), "cc 2");
+
+    project.routing().route(1).setTarget(Routing::Target::None);
+    expectTrue(dispatch.update(project), "route removed");
+    expectEqual(int(dispatch.routes(MidiPort::Midi, MidiMessage::makeControlChange(0, 2, 0))), 0, "cc 2");
+
+    project.setTrackMode(0, Track::TrackMode::MidiCv);
+    expectTrue(dispatch.update(project), "track mode changed");
+    project.track(0).midiCvTrack().source().setChannel(5);
+    expectTrue(dispatch.update(project), "track source changed");
+    expectFalse(dispatch.update(project), "unchanged");
+}
+
+CASE("dense controller input") {
+    Project project;
+    MidiInputDispatch dispatch;
+
+    for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+        setupMidiRoute(project, routeIndex, Types::MidiPort::Midi, routeIndex, Routing::MidiSource::Event::ControlAbsolute, 1);
+    }
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::MidiCv);
+    }
+    dispatch.update(project);
+
+    // 14-bit controller stream (cc 1 + cc 33) on all channels
+    const int count = 200000;
+    int linearMatches = 0;
+    int dispatchMatches = 0;
+
+    for (int i = 0; i < count; ++i) {
+        MidiMessage message = MidiMessage::makeControlChange(i % 16, i & 1 ? 33 : 1, i & 0x7f);
+        for (int routeIndex = 0; routeIndex < CONFIG_ROUTE_COUNT; ++routeIndex) {
+            const auto &route = project.routing().route(routeIndex);
+            if (route.active() && route.source() == Routing::Source::Midi &&
+                MidiUtils::matchSource(MidiPort::Midi, message, route.midiSource().source()) &&
+                message.controlNumber() == route.midiSource().controlNumber()) {
+                ++linearMatches;
+            }
+        }
+        for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+            linearMatches += MidiUtils::matchSource(MidiPort::Midi, message, project.track(trackIndex).midiCvTrack().source()) && message.isPitchBend();
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        MidiMessage message = MidiMessage::makeControlChange(i % 16, i & 1 ? 33 : 1, i & 0x7f);
+        for (auto routes = dispatch.routes(MidiPort::Midi, message); routes; routes &= routes - 1) {
+            ++dispatchMatches;
+        }
+        for (auto tracks = dispatch.tracks(MidiPort::Midi, message); tracks; tracks &= tracks - 1) {
+            ++dispatchMatches;
+        }
+    }
+
+    expectEqual(dispatchMatches, linearMatches, "matches");
+    expectEqual(dispatchMatches, count / 2, "matches");
+}
+
+} // UNIT_TEST("MidiInputDispatch")
@@ -0,0 +1,114 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/SequencerApp.h"
+#include "apps/sequencer/model/MidiOutput.h"
+
+#include "sim/Simulator.h"
+
+#include <memory>
+#include <vector>
+
+// Records the messages sent to the MIDI port.
+struct MidiOutputRecorder : public sim::TargetOutputHandler {
+    std::vector<MidiMessage> messages;
+
+    void writeMidiOutput(sim::MidiEvent event) override {
+        if (event.kind == sim::MidiEvent::Message && event.port == 0 && !event.message.isRealTimeMessage()) {
+            messages.emplace_back(event.message);
+        }
+    }
+};
+
+UNIT_TEST("MidiOutputEngine") {
+
+CASE("note offs first, except for legato note changes") {
+    std::unique_ptr<SequencerApp> app;
+    sim::Simulator simulator({
+        .create = [&] () { app.reset(new SequencerApp()); },
+        .destroy = [&] () { app.reset(); },
+        .update = [&] () { app->update(); }
+    });
+    MidiOutputRecorder recorder;
+    simulator.registerTargetOutputObserver(&recorder);
+
+    // wait for the startup page to close
+    simulator.wait(2500);
+
+    sim::Simulator::Scope scope(simulator);
+    auto &midiOutputEngine = app->engine.midiOutputEngine();
+
+    // two note outputs on channel 1 and 2, driven by track 1 and 2
+    auto &midiOutput = app->model.project().midiOutput();
+    for (int outputIndex = 0; outputIndex < 2; ++outputIndex) {
+        auto &output = midiOutput.output(outputIndex);
+        output.target().setPort(Types::MidiPort::Midi);
+        output.target().setChannel(outputIndex);
+        output.setEvent(MidiOutput::Output::Event::Note);
+        output.setGateSource(MidiOutput::Output::GateSource(outputIndex));
+        output.setNoteSource(MidiOutput::Output::NoteSource(outputIndex));
+    }
+    midiOutputEngine.update();
+
+    midiOutputEngine.sendCv(0, 0.f);
+    midiOutputEngine.sendGate(0, true);
+    midiOutputEngine.sendCv(1, 1.f);
+    midiOutputEngine.sendGate(1, true);
+    midiOutputEngine.update();
+    recorder.messages.clear();
+
+    // output 1 changes note without releasing the gate, output 2 releases its note
+    midiOutputEngine.sendCv(0, 1.f / 12.f);
+    midiOutputEngine.sendGate(0, true);
+    midiOutputEngine.sendGate(1, false);
+    midiOutputEngine.update();
+
+    const auto &messages = recorder.messages;
+    expectEqual(int(messages.size()), 3, "message count");
+    expectTrue(messages[0].isNoteOff() && messages[0].channel() == 1 && messages[0].note() == 72, "note off of output 2 first");
+    expectTrue(messages[1].isNoteOn() && messages[1].channel() == 0 && messages[1].note() == 61, "new note of output 1");
+    expectTrue(messages[2].isNoteOff() && messages[2].channel() == 0 && messages[2].note() == 60, "previous note of output 1 after the new note");
+}
+
+CASE("deferred control changes are dropped when the output is retargeted") {
+    std::unique_ptr<SequencerApp> app;
+    sim::Simulator simulator({
+        .create = [&] () { app.reset(new SequencerApp()); },
+        .destroy = [&] () { app.reset(); },
+        .update = [&] () { app->update(); }
+    });
+    MidiOutputRecorder recorder;
+    simulator.registerTargetOutputObserver(&recorder);
+
+    // wait for the startup page to close
+    simulator.wait(2500);
+
+    sim::Simulator::Scope scope(simulator);
+    auto &midiOutputEngine = app->engine.midiOutputEngine();
+
+    // four controller outputs on separate channels, driven by track 1 to 4
+    auto &midiOutput = app->model.project().midiOutput();
+    for (int outputIndex = 0; outputIndex < 4; ++outputIndex) {
+        auto &output = midiOutput.output(outputIndex);
+        output.target().setPort(Types::MidiPort::Midi);
+        output.target().setChannel(outputIndex);
+        output.setEvent(MidiOutput::Output::Event::ControlChange);
+        output.setControlNumber(10 + outputIndex);
+        output.setControlSource(MidiOutput::Output::ControlSource(outputIndex));
+    }
+    midiOutputEngine.update();
+    recorder.messages.clear();
+
+    // the bandwidth credit only allows three controllers in one update
+    for (int trackIndex = 0; trackIndex < 4; ++trackIndex) {
+        midiOutputEngine.sendCv(trackIndex, 2.5f);
+    }
+    midiOutputEngine.update();
+    expectEqual(int(recorder.messages.size()), 3, "controllers sent");
+    recorder.messages.clear();
+
+    midiOutput.output(3).target().setChannel(5);
+    midiOutputEngine.update(true);
+    expectEqual(int(recorder.messages.size()), 0, "deferred controller dropped");
+}
+
+} // UNIT_TEST("MidiOutputEngine")
@@ -0,0 +1,208 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/engine/MidiOutputScheduler.h"
+
+#include <algorithm>
+#include <vector>
+
+using Priority = MidiOutputScheduler::Priority;
+
+namespace {
+
+// Models a serial midi output sending 3.125 bytes per millisecond.
+struct Wire {
+    float busyUntil = 0.f;
+
+    // returns the time (ms) the last byte is sent
+    float send(float time, int bytes) {
+        busyUntil = std::max(time, busyUntil) + bytes / 3.125f;
+        return busyUntil;
+    }
+};
+
+// 16 outputs with continuously changing controllers and a note on every 16th (120 bpm) on each output.
+struct Load {
+    static constexpr int Outputs = 16;
+    static constexpr int Milliseconds = 4000;
+
+    static bool noteOn(int ms, int output) { return ms % 125 == 0 && output % 2 == 0; }
+    static bool noteOff(int ms, int output) { return ms % 125 == 60 && output % 2 == 0; }
+    static MidiMessage controlChange(int ms, int output) { return MidiMessage::makeControlChange(output, 1, (ms / 4 + output) % 128); }
+};
+
+// Previous behavior: messages are sent right away, controllers at a fixed rate of 50 Hz.
+static float legacyNoteLatency() {
+    Wire wire;
+    float maxLatency = 0.f;
+    for (int ms = 0; ms < Load::Milliseconds; ++ms) {
+        bool sendCC = ms % 20 == 0;
+        for (int output = 0; output < Load::Outputs; ++output) {
+            if (Load::noteOn(ms, output)) {
+                maxLatency = std::max(maxLatency, wire.send(ms, 3) - ms);
+            }
+            if (Load::noteOff(ms, output)) {
+                maxLatency = std::max(maxLatency, wire.send(ms, 3) - ms);
+            }
+            if (sendCC) {
+                wire.send(ms, 3);
+            }
+        }
+    }
+    return maxLatency;
+}
+
+static float scheduledNoteLatency(int &controlChanges) {
+    Wire wire;
+    MidiOutputScheduler scheduler(3125);
+    float maxLatency = 0.f;
+    controlChanges = 0;
+    for (int ms = 0; ms < Load::Milliseconds; ++ms) {
+        scheduler.update(ms);
+        for (int output = 0; output < Load::Outputs; ++output) {
+            if (Load::noteOn(ms, output)) {
+                scheduler.enqueue(MidiMessage::makeNoteOn(output, 60), Priority::NoteOn);
+            }
+            if (Load::noteOff(ms, output)) {
+                scheduler.enqueue(MidiMessage::makeNoteOff(output, 60), Priority::NoteOff);
+            }
+            scheduler.enqueue(Load::controlChange(ms, output), Priority::ControlChange);
+        }
+        MidiMessage message;
+        uint32_t bytes = scheduler.stats().bytes;
+        while (scheduler.dequeue(message)) {
+            float time = wire.send(ms, scheduler.stats().bytes - bytes);
+            bytes = scheduler.stats().bytes;
+            if (message.isNoteOn() || message.isNoteOff()) {
+                maxLatency = std::max(maxLatency, time - ms);
+            } else {
+                ++controlChanges;
+            }
+        }
+    }
+    return maxLatency;
+}
+
+static std::vector<MidiMessage> dequeueAll(MidiOutputScheduler &scheduler, bool force = true) {
+    std::vector<MidiMessage> messages;
+    MidiMessage message;
+    while (scheduler.dequeue(message, force)) {
+        messages.emplace_back(message);
+    }
+    return messages;
+}
+
+} // namespace
+
+UNIT_TEST("MidiOutputScheduler") {
+
+CASE("messages are sent in priority order") {
+    MidiOutputScheduler scheduler(3125);
+    scheduler.enqueue(MidiMessage::makeControlChange(0, 1, 10), Priority::ControlChange);
+    scheduler.enqueue(MidiMessage::makeNoteOn(0, 60), Priority::NoteOn);
+    scheduler.enqueue(MidiMessage::makeControlChange(0, 65, 127), Priority::Control);
+    scheduler.enqueue(MidiMessage::makeNoteOff(0, 48), Priority::NoteOff);
+
+    auto messages = dequeueAll(scheduler);
+    expectEqual(int(messages.size()), 4, "message count");
+    expectTrue(messages[0].isNoteOff(), "note off first");
+    expectTrue(messages[1].isControlChange() && messages[1].controlNumber() == 65, "control second");
+    expectTrue(messages[2].isNoteOn(), "note on third");
+    expectTrue(messages[3].isControlChange() && messages[3].controlNumber() == 1, "control change last");
+}
+
+CASE("legato note off follows the note on") {
+    MidiOutputScheduler scheduler(3125);
+    scheduler.enqueue(MidiMessage::makeNoteOn(0, 61), Priority::NoteOn);
+    scheduler.enqueue(MidiMessage::makeNoteOff(0, 60), Priority::LegatoNoteOff);
+    scheduler.enqueue(MidiMessage::makeNoteOff(1, 48), Priority::NoteOff);
+
+    auto messages = dequeueAll(scheduler);
+    expectEqual(int(messages.size()), 3, "message count");
+    expectTrue(messages[0].isNoteOff() && messages[0].channel() == 1, "note off of other channel first");
+    expectTrue(messages[1].isNoteOn() && messages[1].note() == 61, "legato note on");
+    expectTrue(messages[2].isNoteOff() && messages[2].note() == 60, "legato note off");
+}
+
+CASE("messages are grouped by running status") {
+    MidiOutputScheduler scheduler(3125);
+    scheduler.enqueue(MidiMessage::makeNoteOn(0, 60), Priority::NoteOn);
+    scheduler.enqueue(MidiMessage::makeNoteOn(1, 61), Priority::NoteOn);
+    scheduler.enqueue(MidiMessage::makeNoteOn(0, 62), Priority::NoteOn);
+
+    auto messages = dequeueAll(scheduler);
+    expectEqual(int(messages.size()), 3, "message count");
+    expectEqual(int(messages[0].note()), 60, "first note");
+    expectEqual(int(messages[1].note()), 62, "running status note");
+    expectEqual(int(messages[2].note()), 61, "last note");
+    expectEqual(int(scheduler.stats().bytes), 3 + 2 + 3, "bytes");
+}
+
+CASE("control changes are merged") {
+    MidiOutputScheduler scheduler(3125);
+    scheduler.enqueue(MidiMessage::makeControlChange(0, 1, 10), Priority::ControlChange);
+    scheduler.enqueue(MidiMessage::makeControlChange(0, 2, 5), Priority::ControlChange);
+    scheduler.enqueue(MidiMessage::makeControlChange(0, 1, 20), Priority::ControlChange);
+    scheduler.enqueue(MidiMessage::makeControlChange(1, 1, 30), Priority::ControlChange);
+
+    expectEqual(scheduler.pending(), 3, "pending");
+    expectEqual(int(scheduler.stats().mergedControlChanges), 1, "merged");
+
+    auto messages = dequeueAll(scheduler);
+    expectEqual(int(messages.size()), 3, "message count");
+    expectEqual(int(messages[0].controlValue()), 20, "latest value");
+}
+
+CASE("pending messages of an output are cancelled") {
+    MidiOutputScheduler scheduler(3125);
+    scheduler.enqueue(MidiMessage::makeControlChange(0, 1, 10), Priority::ControlChange, 0);
+    scheduler.enqueue(MidiMessage::makeControlChange(0, 1, 20), Priority::ControlChange, 1);
+    scheduler.enqueue(MidiMessage::makeControlChange(1, 2, 30), Priority::ControlChange, 0);
+    expectEqual(scheduler.pending(), 3, "same controller of different outputs is not merged");
+
+    scheduler.cancel(0);
+    auto messages = dequeueAll(scheduler);
+    expectEqual(int(messages.size()), 1, "message count");
+    expectEqual(int(messages[0].controlValue()), 20, "message of other output");
+}
+
+CASE("control changes use spare bandwidth") {
+    MidiOutputScheduler scheduler(3125);
+    scheduler.update(0);
+
+    // initial credit allows a short burst (3 + 2 + 2 + 2 bytes using running status)
+    for (int i = 0; i < 8; ++i) {
+        scheduler.enqueue(MidiMessage::makeControlChange(0, i, 1), Priority::ControlChange);
+    }
+    int sent = dequeueAll(scheduler, false).size();
+    expectEqual(sent, 4, "burst");
+    expectEqual(scheduler.pending(), 4, "deferred");
+
+    // about one controller per ms
+    scheduler.update(1);
+    expectEqual(int(dequeueAll(scheduler, false).size()), 1, "sent after 1 ms");
+
+    // notes use up the bandwidth
+    scheduler.update(2);
+    for (int i = 0; i < 4; ++i) {
+        scheduler.enqueue(MidiMessage::makeNoteOn(0, 60 + i), Priority::NoteOn);
+    }
+    auto messages = dequeueAll(scheduler, false);
+    expectEqual(int(messages.size()), 4, "notes are always sent");
+    scheduler.update(3);
+    expectEqual(int(dequeueAll(scheduler, false).size()), 0, "no bandwidth left");
+
+    // forced
+    expectEqual(int(dequeueAll(scheduler, true).size()), 3, "forced");
+}
+
+CASE("note latency with controller load") {
+    float legacy = legacyNoteLatency();
+    int controlChanges;
+    float scheduled = scheduledNoteLatency(controlChanges);
+    UNIT_TEST_PRINTF("max note latency: immediate %.1f ms, scheduled %.1f ms (%d CC/s)\n",
+        legacy, scheduled, controlChanges * 1000 / Load::Milliseconds);
+    expectTrue(scheduled < legacy, "scheduled notes should have less latency");
+    expectTrue(controlChanges * 1000 / Load::Milliseconds > 16 * 50 / 2, "controllers should use spare bandwidth");
+}
+
+} // UNIT_TEST("MidiOutputScheduler")
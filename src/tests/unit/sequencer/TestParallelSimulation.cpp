@@ -0,0 +1,122 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/SequencerApp.h"
+
+#include "sim/Simulator.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Hashes all gate and cv output changes of a simulated sequencer together with the tick they happen at.
+struct OutputRecorder : public sim::TargetOutputHandler {
+    sim::Simulator *simulator = nullptr;
+    uint64_t hash = 14695981039346656037ull;
+    int events = 0;
+    int gateChanges = 0;
+    uint8_t gates = 0;
+
+    void add(uint32_t value) {
+        hash = (hash ^ value) * 1099511628211ull;
+    }
+
+    void add(int kind, int channel, int value) {
+        add(uint32_t(simulator->ticks()));
+        add((kind << 24) | (channel << 16) | value);
+        ++events;
+    }
+
+    void writeGateOutput(int channel, bool value) override {
+        if (bool(gates & (1 << channel)) != value) {
+            gates ^= 1 << channel;
+            ++gateChanges;
+        }
+        add(0, channel, value);
+    }
+    void writeDac(int channel, uint16_t value) override { add(1, channel, value); }
+};
+
+struct Result {
+    uint64_t hash;
+    int events;
+    int gateChanges;
+};
+
+// Runs a complete sequencer instance playing a project derived from the given variant.
+static Result runInstance(int variant, int milliseconds) {
+    std::unique_ptr<SequencerApp> app;
+    OutputRecorder recorder;
+
+    sim::Simulator simulator({
+        .create = [&] () {
+            app.reset(new SequencerApp());
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+    recorder.simulator = &simulator;
+    simulator.registerTargetOutputObserver(&recorder);
+
+    // let the application finish startup (which stops the clock)
+    simulator.wait(1000);
+
+    auto &project = app->model.project();
+    project.setTempo(100 + variant * 7);
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::Note);
+        auto &sequence = project.track(trackIndex).noteTrack().sequence(0);
+        for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+            auto &step = sequence.step(stepIndex);
+            step.setGate((stepIndex + trackIndex + variant) % 3 != 0);
+            step.setNote((stepIndex * 5 + trackIndex * 3 + variant) % 24);
+        }
+    }
+    app->engine.clockStart();
+
+    simulator.wait(milliseconds);
+
+    return { recorder.hash, recorder.events, recorder.gateChanges };
+}
+
+static std::vector<Result> runThreads(int instances, int milliseconds, bool parallel) {
+    std::vector<Result> results(instances);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < instances; ++i) {
+        // variants repeat, so identical instances run concurrently
+        threads.emplace_back([&results, i, milliseconds] () {
+            results[i] = runInstance(i % 2, milliseconds);
+        });
+        if (!parallel) {
+            threads.back().join();
+        }
+    }
+    if (parallel) {
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+    return results;
+}
+
+UNIT_TEST("ParallelSimulation") {
+
+CASE("independent instances on multiple threads") {
+    const int instances = 4;
+    const int milliseconds = 2000;
+
+    auto serial = runThreads(instances, milliseconds, false);
+    auto parallel = runThreads(instances, milliseconds, true);
+
+    for (int i = 0; i < instances; ++i) {
+        expectTrue(serial[i].gateChanges > 0, "instance should play gates");
+        expectTrue(parallel[i].hash == serial[i].hash, "parallel instance should match serial instance");
+        expectTrue(serial[i].hash == serial[i % 2].hash, "same variant should produce same output");
+    }
+    expectTrue(serial[0].hash != serial[1].hash, "variants should produce different output");
+}
+
+} // UNIT_TEST("ParallelSimulation")
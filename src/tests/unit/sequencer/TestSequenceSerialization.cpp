@@ -0,0 +1,164 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/model/NoteSequence.h"
+#include "apps/sequencer/model/IndexedSequence.h"
+#include "apps/sequencer/model/ProjectVersion.h"
+#include "core/io/VersionedSerializedWriter.h"
+#include "core/io/VersionedSerializedReader.h"
+#include "../core/io/MemoryReaderWriter.h"
+
+#include <cstring>
+
+namespace {
+
+// Minimal element with a field by field legacy encoding (16-bit) and a packed encoding (32-bit).
+struct Word {
+    uint32_t value = 0;
+
+    void write(VersionedSerializedWriter &writer) const {
+        writer.write(uint16_t(value));
+    }
+
+    void read(VersionedSerializedReader &reader) {
+        reader.readAs<uint16_t>(value);
+    }
+};
+
+} // namespace
+
+UNIT_TEST("SequenceSerialization") {
+
+CASE("note sequence steps") {
+    static uint8_t buf[4096];
+    std::memset(buf, 0, sizeof(buf));
+
+    NoteSequence source(0);
+    for (int i = 0; i < CONFIG_STEP_COUNT; ++i) {
+        auto &step = source.step(i);
+        step.setGate(i % 3 == 0);
+        step.setNote(i - 32);
+        step.setGateOffset(i % 5 - 2);
+        step.setCondition(Types::Condition(i % 8));
+    }
+
+    MemoryWriter memoryWriter(buf, sizeof(buf));
+    VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
+        memoryWriter.write(data, len);
+    }, ProjectVersion::Latest);
+    source.write(writer);
+    writer.writeHash();
+
+    MemoryReader memoryReader(buf, sizeof(buf));
+    VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
+        memoryReader.read(data, len);
+    }, ProjectVersion::Latest);
+    NoteSequence target(0);
+    target.read(reader);
+    expectTrue(reader.checkHash(), "hash should match");
+
+    for (int i = 0; i < CONFIG_STEP_COUNT; ++i) {
+        expectTrue(target.step(i) == source.step(i), "steps should match");
+    }
+}
+
+CASE("indexed sequence steps") {
+    static uint8_t buf[4096];
+    std::memset(buf, 0, sizeof(buf));
+
+    IndexedSequence source;
+    for (int i = 0; i < IndexedSequence::MaxSteps; ++i) {
+        auto &step = source.step(i);
+        step.setNoteIndex(i - 16);
+        step.setDuration(i * 48);
+        step.setGateLength(i * 3);
+        step.setSlide(i % 2);
+        step.setGroupMask(i & 0xf);
+    }
+
+    MemoryWriter memoryWriter(buf, sizeof(buf));
+    VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
+        memoryWriter.write(data, len);
+    }, ProjectVersion::Latest);
+    source.write(writer);
+    writer.writeHash();
+
+    MemoryReader memoryReader(buf, sizeof(buf));
+    VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
+        memoryReader.read(data, len);
+    }, ProjectVersion::Latest);
+    IndexedSequence target;
+    target.read(reader);
+    expectTrue(reader.checkHash(), "hash should match");
+
+    for (int i = 0; i < IndexedSequence::MaxSteps; ++i) {
+        const auto &a = source.step(i);
+        const auto &b = target.step(i);
+        expectEqual(int(b.noteIndex()), int(a.noteIndex()), "note index should match");
+        expectEqual(int(b.duration()), int(a.duration()), "duration should match");
+        expectEqual(int(b.gateLength()), int(a.gateLength()), "gate length should match");
+        expectEqual(b.slide(), a.slide(), "slide should match");
+        expectEqual(int(b.groupMask()), int(a.groupMask()), "group mask should match");
+    }
+}
+
+CASE("packed array falls back to element reads for older data") {
+    uint8_t buf[64];
+    std::memset(buf, 0, sizeof(buf));
+
+    std::array<Word, 4> source;
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i].value = 0x1000 + i;
+    }
+
+    MemoryWriter memoryWriter(buf, sizeof(buf));
+    VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
+        memoryWriter.write(data, len);
+    }, 1);
+    writeArray(writer, source);
+    writer.writeHash();
+
+    MemoryReader memoryReader(buf, sizeof(buf));
+    VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
+        memoryReader.read(data, len);
+    }, 2);
+    std::array<Word, 4> target;
+    readPackedArray(reader, target, 2);
+    expectTrue(reader.checkHash(), "hash should match");
+
+    for (size_t i = 0; i < target.size(); ++i) {
+        expectEqual(int(target[i].value), int(source[i].value), "value should match");
+    }
+}
+
+CASE("packed array is stored as memory image") {
+    uint8_t buf[64];
+    std::memset(buf, 0, sizeof(buf));
+
+    std::array<Word, 4> source;
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i].value = 0x10000 + i;
+    }
+
+    MemoryWriter memoryWriter(buf, sizeof(buf));
+    VersionedSerializedWriter writer([&memoryWriter] (const void *data, size_t len) {
+        memoryWriter.write(data, len);
+    }, 2);
+    writePackedArray(writer, source);
+    writer.writeHash();
+
+    expectEqual(std::memcmp(buf + sizeof(uint32_t), source.data(), sizeof(source)), 0, "data should match memory image");
+
+    MemoryReader memoryReader(buf, sizeof(buf));
+    VersionedSerializedReader reader([&memoryReader] (void *data, size_t len) {
+        memoryReader.read(data, len);
+    }, 2);
+    std::array<Word, 4> target;
+    readPackedArray(reader, target, 2);
+    expectTrue(reader.checkHash(), "hash should match");
+
+    for (size_t i = 0; i < target.size(); ++i) {
+        expectEqual(int(target[i].value), int(source[i].value), "value should match");
+    }
+}
+
+} // UNIT_TEST("SequenceSerialization")
@@ -0,0 +1,100 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/SequencerApp.h"
+
+#include "sim/Simulator.h"
+#include "sim/TargetTraceRecorder.h"
+
+#include <memory>
+#include <vector>
+
+UNIT_TEST("SimulatorRender") {
+
+CASE("render matches recorded trace") {
+    const int ticks = 5000;
+
+    std::unique_ptr<SequencerApp> app;
+    sim::TargetTrace trace;
+    sim::TargetTraceRecorder recorder(trace);
+
+    sim::Simulator simulator({
+        .create = [&] () {
+            app.reset(new SequencerApp());
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+    simulator.registerTargetTickObserver(&recorder);
+    simulator.registerTargetOutputObserver(&recorder);
+
+    // let the application finish startup (which stops the clock)
+    simulator.wait(1000);
+    auto &project = app->model.project();
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::Note);
+        auto &sequence = project.track(trackIndex).noteTrack().sequence(0);
+        for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+            sequence.step(stepIndex).setGate((stepIndex + trackIndex) % 3 != 0);
+            sequence.step(stepIndex).setNote((stepIndex * 5 + trackIndex * 3) % 24);
+        }
+    }
+    app->engine.clockStart();
+
+    uint32_t startTick = simulator.ticks();
+    std::vector<uint16_t> dac(ticks * sim::DacState::Count);
+    std::vector<uint8_t> gates(ticks);
+    std::vector<sim::Simulator::RenderedMidiMessage> midi;
+
+    simulator.render(ticks, dac.data(), gates.data(), &midi);
+
+    expectEqual(uint32_t(simulator.ticks()), startTick + ticks, "ticks advanced");
+
+    // replay the recorded state traces and compare with the rendered output of each tick
+    sim::GateOutputState gateState;
+    sim::DacState dacState;
+    size_t gateIndex = 0, dacIndex = 0;
+    int gateChanges = 0;
+    bool gatesMatch = true, dacMatch = true;
+    for (int i = 0; i < ticks; ++i) {
+        uint32_t tick = startTick + i;
+        const auto &gateItems = trace.gateOutput.items();
+        while (gateIndex < gateItems.size() && gateItems[gateIndex].first <= tick) {
+            gateState = gateItems[gateIndex++].second;
+        }
+        const auto &dacItems = trace.dac.items();
+        while (dacIndex < dacItems.size() && dacItems[dacIndex].first <= tick) {
+            dacState = dacItems[dacIndex++].second;
+        }
+        gatesMatch &= gates[i] == gateState.state.to_ulong();
+        gateChanges += (i > 0 && gates[i] != gates[i - 1]) ? 1 : 0;
+        for (int channel = 0; channel < sim::DacState::Count; ++channel) {
+            dacMatch &= dac[i * sim::DacState::Count + channel] == dacState.state[channel];
+        }
+    }
+    expectTrue(gatesMatch, "gates match trace");
+    expectTrue(dacMatch, "dac values match trace");
+    expectTrue(gateChanges > 10, "gates rendered");
+
+    size_t traceMessages = 0;
+    for (const auto &item : trace.midiOutput.items()) {
+        if (item.first >= startTick && item.second.kind == sim::MidiEvent::Message) {
+            if (traceMessages < midi.size()) {
+                const auto &message = midi[traceMessages];
+                expectEqual(message.tick, item.first, "midi tick");
+                expectEqual(int(message.data[0]), int(item.second.message.raw()[0]), "midi status");
+            }
+            ++traceMessages;
+        }
+    }
+    expectEqual(midi.size(), traceMessages, "midi messages match trace");
+
+    // buffers are optional
+    simulator.render(10, nullptr, nullptr, nullptr);
+    expectEqual(uint32_t(simulator.ticks()), startTick + ticks + 10, "ticks advanced");
+}
+
+} // UNIT_TEST("SimulatorRender")
@@ -0,0 +1,249 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/SequencerApp.h"
+
+#include "sim/Simulator.h"
+#include "sim/TargetTraceRecorder.h"
+#include "sim/TraceDiff.h"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+
+static const char *TraceFilenameA = "TestTraceDiffA.trace";
+static const char *TraceFilenameB = "TestTraceDiffB.trace";
+
+static void writeGate(sim::TargetTrace &trace, uint32_t tick, int channel, bool value) {
+    sim::GateOutputState state = trace.gateOutput.items().empty() ? sim::GateOutputState() : trace.gateOutput.items().back().second;
+    state.set(channel, value);
+    trace.gateOutput.write(tick, state);
+}
+
+static void writeDac(sim::TargetTrace &trace, uint32_t tick, int channel, uint16_t value) {
+    sim::DacState state = trace.dac.items().empty() ? sim::DacState() : trace.dac.items().back().second;
+    state.set(channel, value);
+    trace.dac.write(tick, state);
+}
+
+static void writeNote(sim::TargetTrace &trace, uint32_t tick, uint8_t note) {
+    trace.midiOutput.write(tick, sim::MidiEvent::makeMessage(0, MidiMessage::makeNoteOn(0, note)));
+}
+
+// Records the outputs of a sequencer playing a few note tracks, `variant` changes a single step.
+static void recordSequencer(sim::TargetTrace &trace, int milliseconds, int variant) {
+    std::unique_ptr<SequencerApp> app;
+    sim::TargetTraceRecorder recorder(trace);
+
+    sim::Simulator simulator({
+        .create = [&] () {
+            app.reset(new SequencerApp());
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+    simulator.registerTargetTickObserver(&recorder);
+    simulator.registerTargetOutputObserver(&recorder);
+
+    // let the application finish startup (which stops the clock)
+    simulator.wait(1000);
+    auto &project = app->model.project();
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::Note);
+        auto &sequence = project.track(trackIndex).noteTrack().sequence(0);
+        for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+            sequence.step(stepIndex).setGate((stepIndex + trackIndex) % 3 != 0);
+            sequence.step(stepIndex).setNote((stepIndex * 5 + trackIndex * 3) % 24);
+        }
+    }
+    if (variant) {
+        project.track(2).noteTrack().sequence(0).step(8).setNote(variant);
+    }
+    app->engine.clockStart();
+    simulator.wait(milliseconds);
+}
+
+UNIT_TEST("TraceDiff") {
+
+CASE("identical traces") {
+    sim::TargetTrace a;
+    for (int i = 0; i < 100; ++i) {
+        writeGate(a, i * 10, i % 8, (i / 8) % 2 == 0);
+        writeDac(a, i * 10 + 1, i % 8, i * 100);
+        writeNote(a, i * 10 + 2, i);
+    }
+
+    sim::TraceDiff traceDiff;
+    traceDiff.diff(a, a);
+    expectTrue(traceDiff.identical(), "identical");
+    expectEqual(int(traceDiff.gate(0).count), 13, "gate edges");
+    expectEqual(int(traceDiff.gate(0).offsets.count(0)), 13, "gate offsets");
+    expectEqual(int(traceDiff.midiOutput().count), 100, "midi events");
+
+    std::ostringstream os;
+    traceDiff.writeReport(os);
+    expectTrue(os.str().find("traces are identical") != std::string::npos, "report");
+}
+
+CASE("gate edges") {
+    sim::TargetTrace a, b;
+    for (int i = 0; i < 10; ++i) {
+        writeGate(a, i * 100, 0, true);
+        writeGate(a, i * 100 + 50, 0, false);
+        int offset = i == 3 ? 2 : (i == 6 ? -1 : 0);
+        writeGate(b, i * 100 + offset, 0, true);
+        writeGate(b, i * 100 + 50, 0, false);
+    }
+
+    sim::TraceDiff::Options options;
+    options.tickTolerance = 2;
+    sim::TraceDiff tolerant(options);
+    tolerant.diff(a, b);
+    expectTrue(tolerant.identical(), "offsets within tolerance");
+    const auto &offsets = tolerant.gate(0).offsets;
+    expectEqual(int(offsets.count()), 20, "paired edges");
+    expectEqual(int(offsets.count(0)), 18, "aligned edges");
+    expectEqual(int(offsets.count(2)), 1, "late edge");
+    expectEqual(int(offsets.count(-1)), 1, "early edge");
+    expectEqual(offsets.min(), -1, "min offset");
+    expectEqual(offsets.max(), 2, "max offset");
+
+    sim::TraceDiff strict;
+    strict.diff(a, b);
+    expectFalse(strict.identical(), "offsets without tolerance");
+    expectTrue(strict.gate(0).diverged, "gate diverged");
+    expectEqual(int(strict.gate(0).tick), 300, "first divergence");
+    expectFalse(strict.gate(1).diverged, "other gate");
+
+    // missing pulse
+    writeGate(a, 2000, 0, true);
+    writeGate(a, 2010, 0, false);
+    tolerant.diff(a, b);
+    expectTrue(tolerant.gate(0).diverged, "missing edge diverged");
+    expectEqual(int(tolerant.gate(0).tick), 2000, "missing edge");
+}
+
+CASE("dac values") {
+    sim::TargetTrace a, b;
+    writeDac(a, 0, 3, 1000);
+    writeDac(b, 0, 3, 1002);
+    writeDac(a, 100, 3, 2000);
+    writeDac(b, 101, 3, 2000);
+    writeDac(a, 200, 3, 3000);
+    writeDac(b, 200, 3, 3500);
+    writeDac(a, 300, 3, 4000);
+    writeDac(b, 300, 3, 4000);
+
+    sim::TraceDiff::Options options;
+    options.dacTolerance = 2;
+    options.tickTolerance = 1;
+    sim::TraceDiff traceDiff(options);
+    traceDiff.diff(a, b);
+    expectFalse(traceDiff.identical(), "diverged");
+    expectEqual(int(traceDiff.dac(3).count), 4, "dac changes");
+    expectTrue(traceDiff.dac(3).diverged, "dac diverged");
+    expectEqual(int(traceDiff.dac(3).tick), 200, "first divergence");
+    expectFalse(traceDiff.dac(2).diverged, "other dac");
+
+    options.dacTolerance = 500;
+    sim::TraceDiff tolerant(options);
+    tolerant.diff(a, b);
+    expectTrue(tolerant.identical(), "within tolerance");
+
+    // mismatch until the end of the trace
+    writeDac(b, 400, 3, 0);
+    tolerant.diff(a, b);
+    expectTrue(tolerant.dac(3).diverged, "diverged at end");
+    expectEqual(int(tolerant.dac(3).tick), 400, "divergence at end");
+}
+
+CASE("midi events") {
+    sim::TargetTrace a, b;
+    for (int i = 0; i < 10; ++i) {
+        writeNote(a, i * 10, 60 + i);
+        writeNote(b, i * 10 + (i == 4 ? 1 : 0), i == 7 ? 0 : 60 + i);
+    }
+
+    sim::TraceDiff::Options options;
+    options.tickTolerance = 1;
+    sim::TraceDiff traceDiff(options);
+    traceDiff.diff(a, b);
+    expectTrue(traceDiff.midiOutput().diverged, "midi diverged");
+    expectEqual(int(traceDiff.midiOutput().tick), 70, "different message");
+    expectEqual(int(traceDiff.midiOutput().offsets.count(1)), 1, "late message");
+
+    b.midiOutput = sim::MidiTrace();
+    for (int i = 0; i < 9; ++i) {
+        writeNote(b, i * 10, 60 + i);
+    }
+    traceDiff.diff(a, b);
+    expectTrue(traceDiff.midiOutput().diverged, "midi diverged");
+    expectEqual(int(traceDiff.midiOutput().tick), 90, "missing message");
+}
+
+CASE("sequencer output") {
+    const int milliseconds = 5000;
+    sim::TargetTrace reference, same, changed;
+    recordSequencer(reference, milliseconds, 0);
+    recordSequencer(same, milliseconds, 0);
+    recordSequencer(changed, milliseconds, 12);
+
+    sim::TraceDiff traceDiff;
+    traceDiff.diff(reference, same);
+    expectTrue(traceDiff.identical(), "same project produces same output");
+    expectTrue(traceDiff.gate(0).count > 10, "gates recorded");
+
+    traceDiff.diff(reference, changed);
+    expectFalse(traceDiff.identical(), "changed step produces different output");
+    expectTrue(traceDiff.dac(2).diverged, "changed note diverges cv");
+    expectFalse(traceDiff.gate(2).diverged, "changed note keeps gates");
+    expectFalse(traceDiff.dac(0).diverged, "other tracks unchanged");
+
+    // the same result is found streaming trace files
+    reference.saveToFile(TraceFilenameA);
+    changed.saveToFile(TraceFilenameB);
+    sim::TraceFile fileA(TraceFilenameA), fileB(TraceFilenameB);
+    sim::TraceDiff fileDiff;
+    fileDiff.diff(fileA, fileB);
+    for (int channel = 0; channel < sim::DacState::Count; ++channel) {
+        expectEqual(fileDiff.dac(channel).diverged, traceDiff.dac(channel).diverged, "file diff matches");
+        expectEqual(fileDiff.dac(channel).tick, traceDiff.dac(channel).tick, "file diff matches");
+    }
+    expectEqual(fileDiff.midiOutput().count, traceDiff.midiOutput().count, "file diff matches");
+
+    std::remove(TraceFilenameA);
+    std::remove(TraceFilenameB);
+}
+
+CASE("hour long traces") {
+    // 8 gates and cvs changing every 25 ms for one hour
+    const uint32_t ticks = 60 * 60 * 1000;
+    for (auto filename : { TraceFilenameA, TraceFilenameB }) {
+        sim::TraceFileWriter writer(filename);
+        sim::GateOutputState gates;
+        sim::DacState dacs;
+        for (uint32_t tick = 0; tick < ticks; tick += 25) {
+            int channel = (tick / 25) % 8;
+            gates.set(channel, !gates.state[channel]);
+            dacs.set(channel, tick * 7 + channel);
+            writer.gateOutput.write(tick, gates);
+            writer.dac.write(tick, dacs);
+        }
+        writer.close();
+    }
+
+    sim::TraceFile fileA(TraceFilenameA), fileB(TraceFilenameB);
+    sim::TraceDiff traceDiff;
+    traceDiff.diff(fileA, fileB);
+
+    expectTrue(traceDiff.identical(), "identical");
+    expectEqual(int(traceDiff.gate(0).count), int(ticks / 25 / 8), "gate edges");
+
+    std::remove(TraceFilenameA);
+    std::remove(TraceFilenameB);
+}
+
+} // UNIT_TEST("TraceDiff")
@@ -0,0 +1,279 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/SequencerApp.h"
+
+#include "sim/Simulator.h"
+#include "sim/TargetTracePlayer.h"
+#include "sim/TargetTraceRecorder.h"
+#include "sim/TraceFile.h"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+
+static const char *TraceFilename = "TestTraceFile.trace";
+
+static bool equal(const sim::MidiEvent &a, const sim::MidiEvent &b) {
+    if (a.kind != b.kind || a.port != b.port) {
+        return false;
+    }
+    switch (a.kind) {
+    case sim::MidiEvent::Connect:
+        return a.connect.vendorId == b.connect.vendorId && a.connect.productId == b.connect.productId;
+    case sim::MidiEvent::Message:
+        return a.message.length() == b.message.length() &&
+            std::memcmp(a.message.raw(), b.message.raw(), a.message.length()) == 0 &&
+            a.message.hasPayload() == b.message.hasPayload() &&
+            (!a.message.hasPayload() || (
+                a.message.payloadLength() == b.message.payloadLength() &&
+                std::memcmp(a.message.payloadData(), b.message.payloadData(), a.message.payloadLength()) == 0
+            ));
+    }
+    return true;
+}
+
+static bool equal(sim::EncoderEvent a, sim::EncoderEvent b) { return a == b; }
+
+template<typename T>
+static bool equal(const T &a, const T &b) { return a == b; }
+
+template<typename Trace>
+static bool equalTrace(const Trace &a, const Trace &b) {
+    if (a.items().size() != b.items().size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.items().size(); ++i) {
+        if (a.items()[i].first != b.items()[i].first || !equal(a.items()[i].second, b.items()[i].second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool equalTrace(const sim::TargetTrace &a, const sim::TargetTrace &b) {
+    return
+        equalTrace(a.button, b.button) &&
+        equalTrace(a.adc, b.adc) &&
+        equalTrace(a.digitalInput, b.digitalInput) &&
+        equalTrace(a.led, b.led) &&
+        equalTrace(a.gateOutput, b.gateOutput) &&
+        equalTrace(a.dac, b.dac) &&
+        equalTrace(a.digitalOutput, b.digitalOutput) &&
+        equalTrace(a.lcd, b.lcd) &&
+        equalTrace(a.encoder, b.encoder) &&
+        equalTrace(a.midiInput, b.midiInput) &&
+        equalTrace(a.midiOutput, b.midiOutput);
+}
+
+static size_t rawStreamSize(const sim::TargetTrace &trace) {
+    std::ostringstream ss;
+    trace.writeStream(ss);
+    return ss.str().size();
+}
+
+static void buildTrace(sim::TargetTrace &trace, int ticks) {
+    sim::ButtonState button;
+    sim::DacState dac;
+    sim::LcdState lcd;
+    for (int tick = 0; tick < ticks; ++tick) {
+        if (tick % 97 == 0) {
+            button.set(tick % sim::ButtonState::Count, (tick / 97) % 2);
+            trace.button.write(tick, button);
+            trace.encoder.write(tick, sim::EncoderEvent((tick / 97) % 4));
+        }
+        if (tick % 5 == 0) {
+            dac.set((tick / 5) % sim::DacState::Count, tick & 0xffff);
+            trace.dac.write(tick, dac);
+            trace.midiOutput.write(tick, sim::MidiEvent::makeMessage(tick % 2, MidiMessage::makeNoteOn(tick % 16, tick % 128, 100)));
+        }
+        if (tick % 500 == 0) {
+            MidiMessage message(MidiMessage::SystemExclusive);
+            uint8_t payload[] = { 0x00, 0x20, 0x29, uint8_t(tick & 0x7f) };
+            message.setPayload(payload, sizeof(payload));
+            trace.midiInput.write(tick, sim::MidiEvent::makeMessage(1, message));
+            trace.midiInput.write(tick, sim::MidiEvent::makeConnect(1, 0x1235, tick & 0xffff));
+        }
+        if (tick % 16 == 0) {
+            // moving block on an otherwise static frame
+            int x = (tick / 16) % (TargetConfig::LcdWidth - 8);
+            lcd.state.fill(0);
+            for (int y = 0; y < 8; ++y) {
+                lcd.state[y * TargetConfig::LcdWidth + x] = 15;
+            }
+            trace.lcd.write(tick, lcd);
+        }
+    }
+}
+
+struct OutputCounter : public sim::TargetOutputHandler {
+    int lcd = 0;
+    int dac = 0;
+    uint32_t lastDac = 0;
+
+    void writeDac(int channel, uint16_t value) override { ++dac; lastDac = value; }
+    void writeLcd(const sim::FrameBuffer &frameBuffer) override { ++lcd; }
+};
+
+UNIT_TEST("TraceFile") {
+
+CASE("varint and delta encoding") {
+    std::vector<uint8_t> buffer;
+    uint32_t values[] = { 0, 1, 127, 128, 16383, 16384, 0xffffffff };
+    for (auto value : values) {
+        sim::tracefile::writeVarint(buffer, value);
+    }
+    const uint8_t *p = buffer.data();
+    for (auto value : values) {
+        uint32_t decoded;
+        expectTrue(sim::tracefile::readVarint(p, buffer.data() + buffer.size(), decoded), "read varint");
+        expectEqual(decoded, value, "varint");
+    }
+    expectTrue(p == buffer.data() + buffer.size(), "consumed");
+
+    uint8_t previous[64] = {};
+    uint8_t data[64] = {};
+    data[3] = 1; data[5] = 2; data[40] = 3; data[63] = 4;
+    buffer.clear();
+    sim::tracefile::writeDelta(buffer, previous, data, sizeof(data));
+    expectTrue(buffer.size() < 16, "delta is compact");
+    p = buffer.data();
+    expectTrue(sim::tracefile::readDelta(p, buffer.data() + buffer.size(), previous, sizeof(previous)), "read delta");
+    expectTrue(std::memcmp(previous, data, sizeof(data)) == 0, "delta");
+
+    p = buffer.data();
+    expectFalse(sim::tracefile::readDelta(p, buffer.data() + buffer.size() - 1, previous, sizeof(previous)), "truncated delta");
+}
+
+CASE("round trip") {
+    sim::TargetTrace trace;
+    buildTrace(trace, 20000);
+
+    trace.saveToFile(TraceFilename);
+    expectTrue(sim::TraceFile::isTraceFile(TraceFilename), "trace file");
+
+    sim::TargetTrace loaded;
+    loaded.loadFromFile(TraceFilename);
+    expectTrue(equalTrace(trace, loaded), "traces equal");
+
+    // small chunks
+    {
+        sim::TraceFileWriter writer(TraceFilename, 256);
+        writer.write(trace);
+    }
+    sim::TraceFile file;
+    expectTrue(file.open(TraceFilename), "open");
+    expectTrue(file.chunks(sim::TraceStreamId::Lcd).size() > 1, "multiple chunks");
+    expectEqual(int(file.count(sim::TraceStreamId::Dac)), int(trace.dac.items().size()), "dac count");
+    file.load(loaded);
+    expectTrue(equalTrace(trace, loaded), "traces equal");
+
+    // seek
+    sim::TraceCursor<sim::DacState> cursor(file, sim::TraceStreamId::Dac);
+    cursor.seek(12346);
+    expectTrue(cursor.valid(), "seek");
+    expectEqual(int(cursor.tick()), 12350, "seek tick");
+    expectTrue(cursor.record() == trace.dac.items()[12350 / 5].second, "seek record");
+    cursor.seek(30000);
+    expectFalse(cursor.valid(), "seek past end");
+
+    // truncated file keeps complete chunks
+    size_t size = file.size();
+    file.close();
+    {
+        std::ifstream ifs(TraceFilename, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        std::ofstream ofs(TraceFilename, std::ios::binary);
+        ofs.write(data.data(), size - 100);
+    }
+    expectTrue(file.open(TraceFilename), "open truncated");
+    expectTrue(file.count(sim::TraceStreamId::Lcd) > 0, "truncated file has records");
+
+    std::remove(TraceFilename);
+}
+
+CASE("playback") {
+    sim::TargetTrace trace;
+    buildTrace(trace, 5000);
+    trace.saveToFile(TraceFilename);
+
+    sim::TraceFile file(TraceFilename);
+    OutputCounter memoryOutput;
+    OutputCounter fileOutput;
+    sim::TargetTracePlayer memoryPlayer(trace, nullptr, &memoryOutput);
+    sim::TargetTracePlayer filePlayer(file, nullptr, &fileOutput);
+    sim::TargetTickHandler &memoryTicks = memoryPlayer;
+    sim::TargetTickHandler &fileTicks = filePlayer;
+    for (uint32_t tick = 0; tick < 5000; ++tick) {
+        memoryTicks.setTick(tick);
+        fileTicks.setTick(tick);
+    }
+
+    expectEqual(fileOutput.lcd, int(trace.lcd.items().size()), "lcd frames");
+    expectEqual(fileOutput.lcd, memoryOutput.lcd, "lcd frames");
+    expectEqual(fileOutput.dac, memoryOutput.dac, "dac writes");
+    expectEqual(fileOutput.lastDac, memoryOutput.lastDac, "dac value");
+
+    std::remove(TraceFilename);
+}
+
+CASE("recording a running sequencer") {
+    const int milliseconds = 20000;
+
+    std::unique_ptr<SequencerApp> app;
+    sim::TargetTrace trace;
+    sim::TargetTraceRecorder memoryRecorder(trace);
+    std::unique_ptr<sim::TraceFileWriter> writer(new sim::TraceFileWriter(TraceFilename));
+    sim::TargetTraceRecorder fileRecorder(*writer);
+
+    sim::Simulator simulator({
+        .create = [&] () {
+            app.reset(new SequencerApp());
+        },
+        .destroy = [&] () {
+            app.reset();
+        },
+        .update = [&] () {
+            app->update();
+        }
+    });
+    for (auto recorder : { &memoryRecorder, &fileRecorder }) {
+        simulator.registerTargetTickObserver(recorder);
+        simulator.registerTargetInputObserver(recorder);
+        simulator.registerTargetOutputObserver(recorder);
+    }
+
+    // let the application finish startup (which stops the clock)
+    simulator.wait(1000);
+    auto &project = app->model.project();
+    for (int trackIndex = 0; trackIndex < CONFIG_TRACK_COUNT; ++trackIndex) {
+        project.setTrackMode(trackIndex, Track::TrackMode::Note);
+        auto &sequence = project.track(trackIndex).noteTrack().sequence(0);
+        for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+            sequence.step(stepIndex).setGate((stepIndex + trackIndex) % 3 != 0);
+            sequence.step(stepIndex).setNote((stepIndex * 5 + trackIndex * 3) % 24);
+        }
+    }
+    app->engine.clockStart();
+    simulator.wait(milliseconds);
+
+    writer->close();
+    size_t fileSize = writer->size();
+
+    sim::TraceFile file(TraceFilename);
+    sim::TargetTrace loaded;
+    file.load(loaded);
+
+    size_t rawSize = rawStreamSize(trace);
+
+    UNIT_TEST_PRINTF("%d ms recording, %d lcd frames: raw stream %d kB, trace file %d kB (%.1fx)\n",
+        milliseconds, int(trace.lcd.items().size()), int(rawSize / 1024), int(fileSize / 1024), double(rawSize) / fileSize);
+
+    expectTrue(trace.lcd.items().size() > 10, "lcd frames recorded");
+    expectTrue(trace.gateOutput.items().size() > 10, "gates recorded");
+    expectTrue(equalTrace(trace, loaded), "recorded file matches in-memory trace");
+    expectTrue(fileSize * 20 < rawSize, "trace file is smaller than raw stream");
+
+    std::remove(TraceFilename);
+}
+
+} // UNIT_TEST("TraceFile")
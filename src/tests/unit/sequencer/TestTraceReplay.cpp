@@ -0,0 +1,279 @@
+#include "UnitTest.h"
+
+#include "apps/sequencer/SequencerApp.h"
+#include "apps/sequencer/SequencerCheckpoint.h"
+#include "apps/sequencer/ui/Key.h"
+
+#include "sim/Simulator.h"
+#include "sim/TargetTraceRecorder.h"
+#include "sim/TraceDiff.h"
+#include "sim/TraceReplay.h"
+
+#include <cstdio>
+#include <memory>
+
+static const char *SessionFilename = "TestTraceReplaySession.trace";
+
+// Creates a sequencer with a few note tracks, the session is controlled through inputs only.
+static sim::Target makeTarget(std::unique_ptr<SequencerApp> &app) {
+    return {
+        .create = [&app] () {
+            app.reset(new SequencerApp());
+            auto &project = app->model.project();
+            for (int trackIndex = 0; trackIndex < 4; ++trackIndex) {
+                project.setTrackMode(trackIndex, Track::TrackMode::Note);
+                auto &sequence = project.track(trackIndex).noteTrack().sequence(0);
+                for (int stepIndex = 0; stepIndex < 16; ++stepIndex) {
+                    sequence.step(stepIndex).setGate((stepIndex + trackIndex) % 3 != 0);
+                    sequence.step(stepIndex).setNote((stepIndex * 5 + trackIndex * 3) % 24);
+                }
+            }
+        },
+        .destroy = [&app] () {
+            app.reset();
+        },
+        .update = [&app] () {
+            app->update();
+        }
+    };
+}
+
+// Copies the states of a trace from the given tick on, starting with the state in effect at that tick.
+template<typename Trace>
+static void copyStatesFrom(const Trace &from, Trace &to, uint32_t tick) {
+    const auto &items = from.items();
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (items[i].first > tick) {
+            to.write(items[i].first, items[i].second);
+        } else if (i + 1 == items.size() || items[i + 1].first > tick) {
+            to.write(tick, items[i].second);
+        }
+    }
+}
+
+// Returns the outputs (gates, cv and midi) of a trace from the given tick on.
+static sim::TargetTrace outputsFrom(const sim::TargetTrace &trace, uint32_t tick) {
+    sim::TargetTrace outputs;
+    copyStatesFrom(trace.gateOutput, outputs.gateOutput, tick);
+    copyStatesFrom(trace.dac, outputs.dac, tick);
+    for (const auto &item : trace.midiOutput.items()) {
+        if (item.first >= tick) {
+            outputs.midiOutput.write(item.first, item.second);
+        }
+    }
+    return outputs;
+}
+
+static void pressButton(sim::Simulator &simulator, int key) {
+    simulator.writeButton(key, true);
+    simulator.wait(30);
+    simulator.writeButton(key, false);
+}
+
+// Records a session: start, stop and restart the clock, toggle some steps and send midi.
+static void recordSession(sim::TargetTrace &trace) {
+    std::unique_ptr<SequencerApp> app;
+    sim::TraceFileWriter writer(SessionFilename);
+    sim::TargetTraceRecorder fileRecorder(writer);
+    sim::TargetTraceRecorder recorder(trace);
+
+    sim::Simulator simulator(makeTarget(app));
+    for (auto observer : { &fileRecorder, &recorder }) {
+        simulator.registerTargetTickObserver(observer);
+        simulator.registerTargetInputObserver(observer);
+        simulator.registerTargetOutputObserver(observer);
+    }
+
+    // wait for the startup page to close
+    simulator.wait(2500);
+    pressButton(simulator, Key::Play);
+    simulator.wait(1500);
+    pressButton(simulator, Key::Step2);
+    simulator.wait(1000);
+    simulator.sendMidi(0, MidiMessage::makeNoteOn(0, 60, 100));
+    simulator.wait(200);
+    simulator.sendMidi(0, MidiMessage::makeNoteOff(0, 60));
+    simulator.wait(1000);
+    pressButton(simulator, Key::Play);
+    simulator.wait(1000);
+    pressButton(simulator, Key::Play);
+    simulator.wait(3000);
+
+    writer.close();
+}
+
+UNIT_TEST("TraceReplay") {
+
+CASE("replay reproduces session") {
+    sim::TargetTrace session;
+    recordSession(session);
+
+    sim::TraceFile traceFile(SessionFilename);
+    expectTrue(traceFile.isOpen(), "session recorded");
+
+    std::unique_ptr<SequencerApp> app;
+    sim::TargetTrace replayed;
+    sim::TargetTraceRecorder recorder(replayed);
+
+    sim::Simulator simulator(makeTarget(app));
+    SequencerCheckpoint checkpointHandler(app);
+    sim::TraceReplay replay(simulator, traceFile, &checkpointHandler);
+    simulator.registerTargetOutputObserver(&recorder);
+    replay.registerTickObserver(&recorder);
+
+    replay.start();
+    replay.run(replay.endTick() + 1);
+
+    sim::TraceDiff traceDiff;
+    traceDiff.diff(session, replayed);
+    expectTrue(traceDiff.gate(0).count > 10, "gates recorded");
+    expectTrue(traceDiff.identical(), "replay matches session");
+
+    std::remove(SessionFilename);
+}
+
+CASE("simulator keeps running after the replay is destroyed") {
+    sim::TargetTrace session;
+    recordSession(session);
+    sim::TraceFile traceFile(SessionFilename);
+
+    std::unique_ptr<SequencerApp> app;
+    sim::Simulator simulator(makeTarget(app));
+    {
+        SequencerCheckpoint checkpointHandler(app);
+        sim::TraceReplay replay(simulator, traceFile, &checkpointHandler);
+        replay.start();
+        replay.run(100);
+    }
+    uint32_t ticks = simulator.ticks();
+    simulator.wait(10);
+    expectEqual(uint32_t(simulator.ticks()), ticks + 10, "simulator stepped");
+
+    std::remove(SessionFilename);
+}
+
+CASE("replay from checkpoint") {
+    sim::TargetTrace session;
+    recordSession(session);
+    sim::TraceFile traceFile(SessionFilename);
+
+    // the clock is stopped at this tick and restarted at restartTick
+    const uint32_t checkpointTick = 6800;
+    const uint32_t restartTick = 7290;
+
+    sim::TraceCheckpoint checkpoint;
+    {
+        std::unique_ptr<SequencerApp> app;
+        sim::Simulator simulator(makeTarget(app));
+        SequencerCheckpoint checkpointHandler(app);
+        sim::TraceReplay replay(simulator, traceFile, &checkpointHandler);
+        replay.start();
+        replay.run(checkpointTick);
+        expectFalse(app->engine.clockRunning(), "clock stopped");
+        expectTrue(replay.saveCheckpoint(checkpoint), "checkpoint saved");
+        expectEqual(checkpoint.tick, checkpointTick, "checkpoint tick");
+    }
+
+    const char *checkpointFilename = "TestTraceReplay.checkpoint";
+    expectTrue(checkpoint.save(checkpointFilename), "checkpoint written");
+    sim::TraceCheckpoint loaded;
+    expectTrue(loaded.load(checkpointFilename), "checkpoint read");
+    expectEqual(loaded.tick, checkpoint.tick, "checkpoint tick");
+    expectTrue(loaded.data == checkpoint.data, "checkpoint data");
+    std::remove(checkpointFilename);
+
+    // restore the checkpoint into a sequencer that starts with an empty project
+    std::unique_ptr<SequencerApp> app;
+    sim::TargetTrace replayed;
+    sim::TargetTraceRecorder recorder(replayed);
+    sim::Simulator simulator({
+        .create = [&app] () { app.reset(new SequencerApp()); },
+        .destroy = [&app] () { app.reset(); },
+        .update = [&app] () { app->update(); }
+    });
+    SequencerCheckpoint checkpointHandler(app);
+    sim::TraceReplay replay(simulator, traceFile, &checkpointHandler);
+    simulator.registerTargetOutputObserver(&recorder);
+    replay.registerTickObserver(&recorder);
+
+    expectTrue(replay.start(loaded), "checkpoint restored");
+    expectEqual(replay.tick(), checkpointTick, "replay starts at checkpoint");
+    replay.run(replay.endTick() + 1);
+
+    // gates after the clock is restarted match the session
+    auto gatesFrom = [] (const sim::TargetTrace &trace, uint32_t tick) {
+        std::vector<std::pair<uint32_t, sim::GateOutputState>> gates;
+        for (const auto &item : trace.gateOutput.items()) {
+            if (item.first >= tick) {
+                gates.emplace_back(item);
+            }
+        }
+        return gates;
+    };
+    auto sessionGates = gatesFrom(session, restartTick);
+    auto replayedGates = gatesFrom(replayed, restartTick);
+    expectTrue(sessionGates.size() > 10, "gates recorded");
+    expectEqual(replayedGates.size(), sessionGates.size(), "gate changes");
+    bool match = replayedGates.size() == sessionGates.size();
+    for (size_t i = 0; match && i < sessionGates.size(); ++i) {
+        match = replayedGates[i].first == sessionGates[i].first && replayedGates[i].second == sessionGates[i].second;
+    }
+    expectTrue(match, "gates match session");
+
+    std::remove(SessionFilename);
+}
+
+CASE("replay from checkpoint while running") {
+    sim::TargetTrace session;
+    recordSession(session);
+    sim::TraceFile traceFile(SessionFilename);
+
+    // the clock is running at this tick, steps have been toggled and midi is received later on
+    const uint32_t checkpointTick = 4500;
+
+    sim::TraceCheckpoint checkpoint;
+    {
+        std::unique_ptr<SequencerApp> app;
+        sim::Simulator simulator(makeTarget(app));
+        SequencerCheckpoint checkpointHandler(app);
+        sim::TraceReplay replay(simulator, traceFile, &checkpointHandler);
+        replay.start();
+        replay.run(checkpointTick);
+        expectTrue(app->engine.clockRunning(), "clock running");
+        expectTrue(replay.saveCheckpoint(checkpoint), "checkpoint saved");
+    }
+    UNIT_TEST_PRINTF("checkpoint size %d bytes\n", int(checkpoint.data.size()));
+
+    // restore into a sequencer that starts with an empty project and a different uptime
+    std::unique_ptr<SequencerApp> app;
+    sim::TargetTrace replayed;
+    sim::TargetTraceRecorder recorder(replayed);
+    sim::Simulator simulator({
+        .create = [&app] () { app.reset(new SequencerApp()); },
+        .destroy = [&app] () { app.reset(); },
+        .update = [&app] () { app->update(); }
+    });
+    SequencerCheckpoint checkpointHandler(app);
+    sim::TraceReplay replay(simulator, traceFile, &checkpointHandler);
+    simulator.registerTargetOutputObserver(&recorder);
+    replay.registerTickObserver(&recorder);
+
+    expectTrue(replay.start(checkpoint, 1234), "checkpoint restored");
+    expectTrue(app->engine.clockRunning(), "clock running after restore");
+    replay.run(replay.endTick() + 1);
+
+    // all outputs after the checkpoint match the session
+    sim::TraceDiff traceDiff;
+    traceDiff.diff(outputsFrom(session, checkpointTick), outputsFrom(replayed, checkpointTick));
+    expectTrue(traceDiff.gate(0).count > 10, "gates recorded");
+    expectTrue(traceDiff.identical(), "outputs match session");
+
+    // a corrupted checkpoint is rejected
+    sim::TraceCheckpoint corrupted = checkpoint;
+    corrupted.data[corrupted.data.size() - 10] ^= 0x55;
+    expectFalse(checkpointHandler.restoreCheckpoint(corrupted.data), "corrupted checkpoint rejected");
+
+    std::remove(SessionFilename);
+}
+
+} // UNIT_TEST("TraceReplay")